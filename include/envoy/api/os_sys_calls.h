@@ -146,6 +146,11 @@ public:
    */
   virtual SysCallIntResult listen(os_fd_t sockfd, int backlog) PURE;
 
+  /**
+   * @see man 2 accept4. The accepted socket is non-blocking and close-on-exec.
+   */
+  virtual SysCallSocketResult accept(os_fd_t sockfd, sockaddr* addr, socklen_t* addrlen) PURE;
+
   /**
    * @see man 2 write
    */
@@ -20,6 +20,22 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see splice (man 2 splice). Both file offsets are always nullptr.
+   */
+  virtual SysCallSizeResult splice(int fd_in, int fd_out, size_t len, unsigned int flags) PURE;
+
+  /**
+   * @see pipe2 (man 2 pipe2)
+   */
+  virtual SysCallIntResult pipe2(int pipefd[2], int flags) PURE;
+
+  /**
+   * @see fcntl (man 2 fcntl). Only for commands that take an int argument, e.g. F_DUPFD_CLOEXEC
+   * and F_SETPIPE_SZ, or none, e.g. F_GETPIPE_SZ, in which case arg is ignored.
+   */
+  virtual SysCallIntResult fcntl(int fd, int cmd, int arg) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
@@ -369,6 +369,54 @@ public:
 
 using InstancePtr = std::unique_ptr<Instance>;
 
+/**
+ * Tracks the bytes held by the buffers charged to it, e.g. the buffers of a connection and of the
+ * codecs and filters that work on it. Buffers charge the account as they grow and credit it as they
+ * drain, so the balance is the bytes they hold at any point. Accounts belong to a single thread.
+ */
+class BufferMemoryAccount {
+public:
+  virtual ~BufferMemoryAccount() = default;
+
+  /**
+   * Charge the account for bytes added to one of its buffers.
+   * @param amount supplies the number of bytes.
+   */
+  virtual void charge(uint64_t amount) PURE;
+
+  /**
+   * Credit the account for bytes drained from one of its buffers.
+   * @param amount supplies the number of bytes.
+   */
+  virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * @return uint64_t the number of bytes held by the buffers charged to the account.
+   */
+  virtual uint64_t balance() const PURE;
+};
+
+using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
+
+/**
+ * Callback that resets a stream, to release the buffers charged to its account.
+ */
+using StreamResetCb = std::function<void()>;
+
+/**
+ * Account of the buffers of a stream, which can be reset when memory runs low.
+ */
+class StreamBufferMemoryAccount : public BufferMemoryAccount {
+public:
+  /**
+   * Stop considering the stream for resets. Must be called when the stream is destroyed, as the
+   * buffers charged to the account may keep it alive for longer.
+   */
+  virtual void clearResetCallback() PURE;
+};
+
+using StreamBufferMemoryAccountSharedPtr = std::shared_ptr<StreamBufferMemoryAccount>;
+
 /**
  * A factory for creating buffers which call callbacks when reaching high and low watermarks.
  */
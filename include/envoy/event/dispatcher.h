@@ -32,7 +32,9 @@ namespace Event {
  */
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(post_delay_us, Microseconds)                                                           \
+  HISTOGRAM(post_queue_depth, Unspecified)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
@@ -164,6 +166,15 @@ public:
    */
   virtual Event::TimerPtr createTimer(TimerCb cb) PURE;
 
+  /**
+   * Allocates a coarse timer, which only has millisecond granularity and may fire up to a
+   * millisecond late, but is cheaper to enable, re-enable and disable than createTimer() timers.
+   * Intended for timeouts that are frequently re-armed and rarely fire, such as idle timeouts.
+   * @see Timer for docs on how to use the timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createCoarseTimer(TimerCb cb) PURE;
+
   /**
    * Allocates a schedulable callback. @see SchedulableCallback for docs on how to use the wrapped
    * callback.
@@ -247,6 +258,13 @@ public:
    * Updates approximate monotonic time to current value.
    */
   virtual void updateApproximateMonotonicTime() PURE;
+
+  /**
+   * Returns the share of recent wall time the event loop spent running callbacks rather than
+   * waiting for events, between 0 (idle) and 1 (saturated). This is safe to call from any thread,
+   * e.g. to compare the load of workers.
+   */
+  virtual double loopUtilization() const PURE;
 };
 
 using DispatcherPtr = std::unique_ptr<Dispatcher>;
@@ -388,6 +388,10 @@ struct Http1Settings {
 
   // How header keys should be formatted when serializing HTTP/1.1 headers.
   HeaderKeyFormat header_key_format_{HeaderKeyFormat::Default};
+
+  // The maximum number of requests sent on an upstream connection ahead of their responses. 1
+  // disables pipelining.
+  uint32_t max_pipelined_requests_{1};
 };
 
 /**
@@ -80,6 +80,15 @@ public:
    */
   virtual Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                  Callbacks& callbacks) PURE;
+
+  /**
+   * Establish a new connection if the pool's pending and active streams, plus one more anticipated
+   * stream, times the given ratio exceed what its connected and connecting connections can serve.
+   * The connection circuit breaker is respected.
+   * @param prefetch_ratio supplies the number of streams to plan for per anticipated stream.
+   * @return true if a connection was created.
+   */
+  virtual bool maybePrefetch(double prefetch_ratio) PURE;
 };
 
 using InstancePtr = std::unique_ptr<Instance>;
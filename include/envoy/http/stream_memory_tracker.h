@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Tracks the memory accounts of the HTTP streams of a thread, so that the streams buffering the
+ * most data can be reset when memory runs low.
+ */
+class StreamMemoryTracker {
+public:
+  virtual ~StreamMemoryTracker() = default;
+
+  /**
+   * Creates an account for the buffers of a stream. The account is tracked until it is destroyed
+   * or its reset callback is cleared, so that resetLargestStreams() may reset the stream.
+   * @param parent supplies the account that charges are passed on to, e.g. the account of the
+   *   stream's connection. May be nullptr.
+   * @param reset_cb supplies the callback that resets the stream.
+   * @return a newly created StreamBufferMemoryAccountSharedPtr.
+   */
+  virtual Buffer::StreamBufferMemoryAccountSharedPtr
+  createStreamAccount(const Buffer::BufferMemoryAccountSharedPtr& parent,
+                      Buffer::StreamResetCb reset_cb) PURE;
+
+  /**
+   * Resets the tracked streams that buffer the most data, largest first. Each stream is reset at
+   * most once.
+   * @param max_reset supplies the maximum number of streams to reset.
+   * @param min_reset_bytes supplies the number of bytes a stream must buffer to be reset.
+   * @return uint64_t the number of bytes buffered by the streams that were reset.
+   */
+  virtual uint64_t resetLargestStreams(uint32_t max_reset, uint64_t min_reset_bytes) PURE;
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -91,6 +91,9 @@ public:
     Stats::Counter* bind_errors_;
     // Optional counter. Delayed close timeouts will not be tracked if this is nullptr.
     Stats::Counter* delayed_close_timeouts_;
+    // Optional histogram of the per call read size used on each read event. Read sizes will not be
+    // tracked if this is nullptr.
+    Stats::Histogram* read_size_;
   };
 
   ~Connection() override = default;
@@ -261,6 +264,32 @@ public:
    */
   virtual uint32_t bufferLimit() const PURE;
 
+  /**
+   * Charge the bytes held by the connection's buffers to an account. Codecs and filters charge
+   * their buffers to the connection's account as well, so it should be set before the filter chain
+   * is created.
+   * @param account supplies the account.
+   */
+  virtual void setBufferMemoryAccount(const Buffer::BufferMemoryAccountSharedPtr& account) PURE;
+
+  /**
+   * @return the account the connection's buffers are charged to, or nullptr if there is none.
+   */
+  virtual const Buffer::BufferMemoryAccountSharedPtr& bufferMemoryAccount() const PURE;
+
+  /**
+   * Release the memory held by the connection's buffers beyond what their content needs, e.g. the
+   * unused part of slices that reads only partially filled.
+   * @return uint64_t the number of bytes released.
+   */
+  virtual uint64_t shrinkBuffers() PURE;
+
+  /**
+   * @return uint64_t the number of bytes held in the connection's read and write buffers, i.e.
+   *         read from the socket but not yet consumed, or written but not yet sent.
+   */
+  virtual uint64_t bufferedBytes() const PURE;
+
   /**
    * @return boolean telling if the connection's local address has been restored to an original
    *         destination address, rather than the address the connection was accepted at.
@@ -277,6 +306,12 @@ public:
    */
   virtual const ConnectionSocket::OptionsSharedPtr& socketOptions() const PURE;
 
+  /**
+   * @return the IoHandle of the connection's socket. Reading from or writing to it directly
+   *         bypasses the transport socket and the connection's buffers.
+   */
+  virtual const IoHandle& ioHandle() const PURE;
+
   /**
    * The StreamInfo object associated with this connection. This is typically
    * used for logging purposes. Individual filters may add specific information
@@ -27,6 +27,12 @@ public:
    */
   virtual void incNumConnections() PURE;
 
+  /**
+   * @return double how busy the thread of the handler has recently been, from 0 (idle) to 1
+   *         (always running callbacks). May be called from any thread.
+   */
+  virtual double loopUtilization() const PURE;
+
   /**
    * Post a connected socket to this connection handler. This is used for cross-thread connection
    * transfer during the balancing process.
@@ -87,6 +87,15 @@ public:
    */
   virtual void enableListeners() PURE;
 
+  /**
+   * Reclaim memory held by the connections of all listeners: release the unused space of their
+   * buffers, then close the connections holding the most buffered bytes.
+   * @param max_close supplies the maximum number of connections to close.
+   * @param min_close_bytes supplies the number of buffered bytes a connection must hold to be
+   *        closed.
+   */
+  virtual void reclaimConnectionMemory(uint32_t max_close, uint64_t min_close_bytes) PURE;
+
   /**
    * @return the stat prefix used for per-handler stats.
    */
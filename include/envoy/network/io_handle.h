@@ -5,6 +5,7 @@
 #include "envoy/api/io_error.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
 #include "envoy/network/address.h"
 
 #include "absl/container/fixed_array.h"
@@ -13,8 +14,13 @@
 namespace Envoy {
 namespace Buffer {
 struct RawSlice;
+class Instance;
 } // namespace Buffer
 
+namespace Event {
+class Dispatcher;
+} // namespace Event
+
 using RawSliceArrays = absl::FixedArray<absl::FixedArray<Buffer::RawSlice>>;
 
 namespace Network {
@@ -64,6 +70,25 @@ public:
    */
   virtual Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) PURE;
 
+  /**
+   * Read data into a buffer. Unlike readv(), the handle may hand over memory it read into
+   * beforehand rather than copy it.
+   * @param buffer supplies the buffer to append the data to.
+   * @param max_length supplies the maximum length to read.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes read for success.
+   */
+  virtual Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) PURE;
+
+  /**
+   * Write data out of a buffer, and drain what was written from it. Unlike writev(), the handle
+   * may take over the buffer's memory until the data is written rather than copy it.
+   * @param buffer supplies the buffer to write from.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes written for success.
+   */
+  virtual Api::IoCallUint64Result write(Buffer::Instance& buffer) PURE;
+
   /**
    * Send a message to the address.
    * @param slices points to the location of data to be sent.
@@ -188,6 +213,27 @@ public:
    */
   virtual Api::SysCallIntResult setBlocking(bool blocking) PURE;
 
+  /**
+   * Shut down all or part of a full-duplex connection (see man 2 shutdown)
+   * @param how supplies which directions to shut down, e.g. ENVOY_SHUT_WR.
+   * @return a Api::SysCallIntResult with rc_ = 0 for success and rc_ = -1 for failure. If the call
+   * is successful, errno_ shouldn't be used.
+   */
+  virtual Api::SysCallIntResult shutdown(int how) PURE;
+
+  /**
+   * Create a file event that reports when the handle is ready for reading or writing. Handles that
+   * perform I/O asynchronously report readiness themselves rather than through fd(); callers
+   * that read or write fd() directly must create events for it with the dispatcher instead.
+   * @param dispatcher supplies the dispatcher the event belongs to.
+   * @param cb supplies the callback to invoke with the ready FileReadyType events.
+   * @param trigger supplies the trigger type of the event.
+   * @param events supplies the logical OR of the FileReadyType events to enable initially.
+   * @return Event::FileEventPtr the event.
+   */
+  virtual Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                              Event::FileTriggerType trigger, uint32_t events) PURE;
+
   /**
    * Get domain used by underlying socket (see man 2 socket)
    * @param domain updated to the underlying socket's domain if call is successful
@@ -173,6 +173,13 @@ public:
    * Called when a new connection is rejected.
    */
   virtual void onReject() PURE;
+
+  /**
+   * Called each time the listener is done accepting the connections that were pending when it
+   * woke up.
+   * @param accepted supplies the number of connections accepted, including rejected ones.
+   */
+  virtual void onAcceptBatch(uint32_t accepted) PURE;
 };
 
 /**
@@ -77,6 +77,12 @@ public:
    */
   virtual void setReadBufferReady() PURE;
 
+  /**
+   * @return uint64_t the number of bytes to try to read from the socket per call. This adapts to
+   *         how much data the connection has recently been reading per read event.
+   */
+  virtual uint64_t readSize() const PURE;
+
   /**
    * Raise a connection event to the connection. This can be used by a secure socket (e.g. TLS)
    * to raise a connected event when handshake is done.
@@ -239,6 +239,24 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return the CPUs to pin the worker threads to, one CPU per worker in turn. Empty when workers
+   *         are not pinned.
+   */
+  virtual const std::vector<uint32_t>& workerCpuAffinity() const PURE;
+
+  /**
+   * @return the CPUs to pin the main thread and the access log flush threads to. Empty when they
+   *         are not pinned.
+   */
+  virtual const std::vector<uint32_t>& mainThreadCpuAffinity() const PURE;
+
+  /**
+   * @return bool indicating whether pinned threads should prefer memory of the NUMA node of their
+   *         CPUs.
+   */
+  virtual bool numaLocalMemory() const PURE;
+
   /**
    * @return the names of extensions to disable.
    */
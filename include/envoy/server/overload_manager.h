@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "envoy/common/pure.h"
+#include "envoy/http/stream_memory_tracker.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/macros.h"
@@ -70,6 +71,12 @@ public:
 
   // Overload action to try to shrink the heap by releasing free memory.
   const std::string ShrinkHeap = "envoy.overload_actions.shrink_heap";
+
+  // Overload action to release the unused space of connection buffers, and close the connections
+  // holding the most buffered bytes.
+  const std::string ReclaimConnectionMemory = "envoy.overload_actions.reclaim_connection_memory";
+  // Overload action to reset the HTTP streams buffering the most data.
+  const std::string ResetHighMemoryStreams = "envoy.overload_actions.reset_high_memory_streams";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
@@ -107,6 +114,12 @@ public:
    */
   virtual ThreadLocalOverloadState& getThreadLocalOverloadState() PURE;
 
+  /**
+   * Get the thread-local tracker of the memory buffered by HTTP streams. The streams tracked by a
+   * worker's tracker are reset by the reset_high_memory_streams overload action.
+   */
+  virtual Http::StreamMemoryTracker& getThreadLocalStreamMemoryTracker() PURE;
+
   /**
    * Convenience method to get a statically allocated reference to the inactive overload
    * action state. Useful for code that needs to initialize a reference either to an
@@ -61,6 +61,12 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return true if the record layer of established connections should be offloaded to kernel
+   * TLS when the negotiated parameters allow it.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -89,7 +95,7 @@ public:
   virtual bool allowRenegotiation() const PURE;
 
   /**
-   * @return The maximum number of session keys to store.
+   * @return The maximum number of session keys to store per server name.
    */
   virtual size_t maxSessionKeys() const PURE;
 
@@ -134,6 +140,12 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return the maximum number of sessions to keep in the server-side session cache. If empty,
+   * the TLS library's built-in session cache is used; 0 disables stateful session resumption.
+   */
+  virtual absl::optional<uint32_t> maxSessionCacheSize() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
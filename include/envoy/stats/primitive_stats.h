@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 
 #include "common/common/assert.h"
 #include "common/common/non_copyable.h"
+#include "common/common/sharded_counter.h"
 
 #include "absl/strings/string_view.h"
 
@@ -37,25 +39,31 @@ private:
 using PrimitiveCounterReference = std::reference_wrapper<const PrimitiveCounter>;
 
 /**
- * Primitive, low-memory-overhead gauge with increment and decrement capabilities.
+ * Primitive gauge with increment and decrement capabilities. These gauges track things like the
+ * active requests of upstream hosts, which every worker updates, so each thread updates its own
+ * shard of the gauge and reads sum the shards. See ShardedCounter.
  */
 class PrimitiveGauge : NonCopyable {
 public:
   PrimitiveGauge() = default;
 
-  uint64_t value() const { return value_; }
+  // The shards aren't read at a single instant, so the sum may include a decrement without its
+  // matching increment and briefly be negative.
+  uint64_t value() const { return std::max<int64_t>(value_.value(), 0); }
+  // For load balancers and other per-request readers. See ShardedCounter::approximateValue().
+  uint64_t approximateValue() const { return std::max<int64_t>(value_.approximateValue(), 0); }
 
-  void add(uint64_t amount) { value_ += amount; }
+  void add(uint64_t amount) { value_.add(amount); }
   void dec() { sub(1); }
   void inc() { add(1); }
-  void set(uint64_t value) { value_ = value; }
+  void set(uint64_t value) { value_.set(value); }
   void sub(uint64_t amount) {
-    ASSERT(value_ >= amount);
-    value_ -= amount;
+    ASSERT(value() >= amount);
+    value_.sub(amount);
   }
 
 private:
-  std::atomic<uint64_t> value_{0};
+  ShardedCounter value_;
 };
 
 using PrimitiveGaugeReference = std::reference_wrapper<const PrimitiveGauge>;
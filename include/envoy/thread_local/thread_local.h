@@ -85,6 +85,18 @@ public:
   using UpdateCb = std::function<ThreadLocalObjectSharedPtr(ThreadLocalObjectSharedPtr)>;
   virtual void runOnAllThreads(const UpdateCb& update_cb) PURE;
   virtual void runOnAllThreads(const UpdateCb& update_cb, Event::PostCb complete_cb) PURE;
+
+  /**
+   * Publish an object shared by all threads without posting to them. Each thread picks up the
+   * latest published object on its next get(), and keeps the object it replaces alive until it
+   * returns to its event loop, so references obtained during the current event stay valid. This
+   * makes updates O(1) on the main thread regardless of the number of workers, at the cost of an
+   * atomic load on each get(). Since all threads share the object, it must be immutable or
+   * otherwise thread safe. A slot that publishes must not also use set() or the UpdateCb variants
+   * of runOnAllThreads().
+   * @param object supplies the object to publish.
+   */
+  virtual void publish(ThreadLocalObjectSharedPtr object) PURE;
 };
 
 using SlotPtr = std::unique_ptr<Slot>;
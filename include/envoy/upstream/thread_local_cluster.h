@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include "envoy/common/pure.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
@@ -7,6 +10,25 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * Learns from how long the hosts of a cluster take to respond, e.g. to route by latency.
+ */
+class HostResponseTimeObserver {
+public:
+  virtual ~HostResponseTimeObserver() = default;
+
+  /**
+   * Report how long one of the cluster's hosts took to respond to a request.
+   * @param host supplies the host that served the request.
+   * @param response_time supplies the time from sending the request to receiving the response.
+   */
+  virtual void onHostResponseTime(const HostDescription& host,
+                                  std::chrono::microseconds response_time) PURE;
+};
+
+using HostResponseTimeObserverSharedPtr = std::shared_ptr<HostResponseTimeObserver>;
+using HostResponseTimeObserverWeakPtr = std::weak_ptr<HostResponseTimeObserver>;
+
 /**
  * A thread local cluster instance that can be used for direct load balancing and host set
  * interactions. In general, an instance of ThreadLocalCluster can only be safely used in the
@@ -32,6 +54,14 @@ public:
    * @return LoadBalancer& the backing load balancer.
    */
   virtual LoadBalancer& loadBalancer() PURE;
+
+  /**
+   * @return HostResponseTimeObserverWeakPtr the observer that load balancers which route by
+   * latency, such as the peak EWMA load balancer, learn response times from. It is expired for
+   * other load balancers, and expires once the cluster goes away, so a request may keep it to
+   * report each of its tries.
+   */
+  virtual HostResponseTimeObserverWeakPtr hostResponseTimeObserver() PURE;
 };
 
 } // namespace Upstream
@@ -558,6 +558,8 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_prefetched)                                                                  \
+  COUNTER(upstream_cx_prefetched_used)                                                             \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -711,6 +713,19 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() const PURE;
 
+  /**
+   * @return how many streams the connection pools of this cluster should be able to serve without
+   *         waiting for a new connection, relative to their number of active streams. A value
+   *         above 1.0 makes the pools establish connections ahead of demand.
+   */
+  virtual double perUpstreamPrefetchRatio() const PURE;
+
+  /**
+   * @return true if each worker should establish a connection to hosts as soon as they are added
+   *         to this cluster.
+   */
+  virtual bool prefetchOnHostAdd() const PURE;
+
   /**
    * @return uint64_t features supported by the cluster. @see Features.
    */
@@ -775,6 +790,12 @@ public:
   virtual const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
   lbLeastRequestConfig() const PURE;
 
+  /**
+   * @return configuration for peak EWMA load balancing, only used if LB type is peak EWMA.
+   */
+  virtual const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const PURE;
+
   /**
    * @return configuration for ring hash load balancing, only used if type is set to ring_hash_lb.
    */
@@ -160,6 +160,26 @@ SysCallIntResult OsSysCallsImpl::listen(os_fd_t sockfd, int backlog) {
   return {rc, rc != -1 ? 0 : errno};
 }
 
+SysCallSocketResult OsSysCallsImpl::accept(os_fd_t sockfd, sockaddr* addr, socklen_t* addrlen) {
+#if defined(__linux__)
+  // Set the flags of the new socket in the same system call.
+  const os_fd_t rc = ::accept4(sockfd, addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  return {rc, SOCKET_VALID(rc) ? 0 : errno};
+#else
+  const os_fd_t rc = ::accept(sockfd, addr, addrlen);
+  if (SOCKET_INVALID(rc)) {
+    return {rc, errno};
+  }
+  if (::fcntl(rc, F_SETFL, ::fcntl(rc, F_GETFL, 0) | O_NONBLOCK) == -1 ||
+      ::fcntl(rc, F_SETFD, FD_CLOEXEC) == -1) {
+    const int error = errno;
+    ::close(rc);
+    return {INVALID_SOCKET, error};
+  }
+  return {rc, 0};
+#endif
+}
+
 SysCallSizeResult OsSysCallsImpl::write(os_fd_t sockfd, const void* buffer, size_t length) {
   const ssize_t rc = ::write(sockfd, buffer, length);
   return {rc, rc != -1 ? 0 : errno};
@@ -41,6 +41,7 @@ public:
   SysCallIntResult shutdown(os_fd_t sockfd, int how) override;
   SysCallIntResult socketpair(int domain, int type, int protocol, os_fd_t sv[2]) override;
   SysCallIntResult listen(os_fd_t sockfd, int backlog) override;
+  SysCallSocketResult accept(os_fd_t sockfd, sockaddr* addr, socklen_t* addrlen) override;
   SysCallSizeResult write(os_fd_t socket, const void* buffer, size_t length) override;
 };
 
@@ -334,6 +334,19 @@ SysCallIntResult OsSysCallsImpl::listen(os_fd_t sockfd, int backlog) {
   return {rc, rc != -1 ? 0 : ::WSAGetLastError()};
 }
 
+SysCallSocketResult OsSysCallsImpl::accept(os_fd_t sockfd, sockaddr* addr, socklen_t* addrlen) {
+  const os_fd_t rc = ::accept(sockfd, addr, addrlen);
+  if (SOCKET_INVALID(rc)) {
+    return {rc, ::WSAGetLastError()};
+  }
+  const SysCallIntResult result = setsocketblocking(rc, false);
+  if (result.rc_ == -1) {
+    ::closesocket(rc);
+    return {INVALID_SOCKET, result.errno_};
+  }
+  return {rc, 0};
+}
+
 SysCallSizeResult OsSysCallsImpl::write(os_fd_t sockfd, const void* buffer, size_t length) {
   const ssize_t rc = ::send(sockfd, static_cast<const char*>(buffer), length, 0);
   return {rc, rc != -1 ? 0 : ::WSAGetLastError()};
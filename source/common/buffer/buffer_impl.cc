@@ -315,18 +315,7 @@ Api::IoCallUint64Result OwnedImpl::read(Network::IoHandle& io_handle, uint64_t m
   if (max_length == 0) {
     return Api::ioCallUint64ResultNoError();
   }
-  constexpr uint64_t MaxSlices = 2;
-  RawSlice slices[MaxSlices];
-  const uint64_t num_slices = reserve(max_length, slices, MaxSlices);
-  Api::IoCallUint64Result result = io_handle.readv(max_length, slices, num_slices);
-  uint64_t bytes_to_commit = result.ok() ? result.rc_ : 0;
-  ASSERT(bytes_to_commit <= max_length);
-  for (uint64_t i = 0; i < num_slices; i++) {
-    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
-    bytes_to_commit -= slices[i].len_;
-  }
-  commit(slices, num_slices);
-  return result;
+  return io_handle.read(*this, max_length);
 }
 
 uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) {
@@ -483,13 +472,7 @@ bool OwnedImpl::startsWith(absl::string_view data) const {
 }
 
 Api::IoCallUint64Result OwnedImpl::write(Network::IoHandle& io_handle) {
-  constexpr uint64_t MaxSlices = 16;
-  RawSliceVector slices = getRawSlices(MaxSlices);
-  Api::IoCallUint64Result result = io_handle.writev(slices.begin(), slices.size());
-  if (result.ok() && result.rc_ > 0) {
-    drain(static_cast<uint64_t>(result.rc_));
-  }
-  return result;
+  return io_handle.write(*this);
 }
 
 OwnedImpl::OwnedImpl() = default;
@@ -512,6 +495,52 @@ std::string OwnedImpl::toString() const {
 
 void OwnedImpl::postProcess() {}
 
+uint64_t OwnedImpl::frontSliceCapacity() const {
+  for (const auto& slice : slices_) {
+    if (slice->dataSize() != 0) {
+      return slice->capacity();
+    }
+  }
+  return 0;
+}
+
+uint64_t OwnedImpl::shrink() {
+  uint64_t released = 0;
+  SliceDeque slices;
+  size_t index = 0;
+  while (index < slices_.size()) {
+    if (!slices_[index]->canCoalesce()) {
+      slices.emplace_back(std::move(slices_[index++]));
+      continue;
+    }
+    // Find the run of slices whose content can be copied into a single one.
+    size_t end = index;
+    uint64_t run_size = 0;
+    uint64_t run_capacity = 0;
+    while (end < slices_.size() && slices_[end]->canCoalesce()) {
+      run_size += slices_[end]->dataSize();
+      run_capacity += slices_[end]->capacity();
+      end++;
+    }
+    if (run_size == 0 || OwnedSlice::sliceSize(run_size) >= run_capacity) {
+      // Copying wouldn't free anything.
+      for (; index < end; index++) {
+        slices.emplace_back(std::move(slices_[index]));
+      }
+      continue;
+    }
+    SlicePtr slice = OwnedSlice::create(run_size);
+    released += run_capacity - slice->capacity();
+    for (; index < end; index++) {
+      slice->append(slices_[index]->data(), slices_[index]->dataSize());
+      slices_[index]->transferDrainTrackersTo(*slice);
+    }
+    slices.emplace_back(std::move(slice));
+  }
+  slices_ = std::move(slices);
+  return released;
+}
+
 void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
   slices_.emplace_back(OwnedSlice::create(data, size));
   length_ += size;
@@ -181,6 +181,12 @@ public:
     return copy_size;
   }
 
+  /**
+   * @return the total number of bytes in the slice, including the space in front of and after the
+   *         usable content.
+   */
+  uint64_t capacity() const { return capacity_; }
+
   /**
    * @return true if content in this Slice can be coalesced into another Slice.
    */
@@ -258,9 +264,6 @@ public:
     return slice;
   }
 
-private:
-  OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
-
   /**
    * Compute a slice size big enough to hold a specified amount of data.
    * @param data_size the minimum amount of data the slice must be able to store, in bytes.
@@ -272,6 +275,9 @@ private:
     return num_pages * PageSize - sizeof(OwnedSlice);
   }
 
+private:
+  OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
+
   uint8_t storage_[];
 };
 
@@ -553,6 +559,21 @@ public:
   // LibEventInstance
   void postProcess() override;
 
+  /**
+   * Copy the content of slices that are mostly empty, e.g. slices that reads only partially filled,
+   * into slices just big enough for it, and free the original ones. The content doesn't change.
+   * Must not be called while a reservation is outstanding.
+   * @return uint64_t the number of bytes of slice capacity released.
+   */
+  uint64_t shrink();
+
+  /**
+   * @return the number of bytes allocated for the first slice with content, including the space
+   *         in front of and after the content, or 0 if the buffer is empty. Referencing any of the
+   *         content keeps all of it allocated.
+   */
+  uint64_t frontSliceCapacity() const;
+
   /**
    * Create a new slice at the end of the buffer, and copy the supplied content into it.
    * @param data start of the content to copy.
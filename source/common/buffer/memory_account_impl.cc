@@ -0,0 +1,51 @@
+#include "common/buffer/memory_account_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+void BufferMemoryAccountImpl::charge(uint64_t amount) {
+  balance_ += amount;
+  if (parent_ != nullptr) {
+    parent_->charge(amount);
+  }
+}
+
+void BufferMemoryAccountImpl::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  if (parent_ != nullptr) {
+    parent_->credit(amount);
+  }
+}
+
+GaugeBufferMemoryAccount::~GaugeBufferMemoryAccount() { gauge_.sub(reported_); }
+
+void GaugeBufferMemoryAccount::charge(uint64_t amount) {
+  balance_ += amount;
+  if (balance_ >= reported_ + GaugeUpdateBytes) {
+    updateGauge();
+  }
+}
+
+void GaugeBufferMemoryAccount::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  // Report an empty account right away, so that the gauge goes back to zero when idle.
+  if (balance_ + GaugeUpdateBytes <= reported_ || (balance_ == 0 && reported_ != 0)) {
+    updateGauge();
+  }
+}
+
+void GaugeBufferMemoryAccount::updateGauge() {
+  if (balance_ > reported_) {
+    gauge_.add(balance_ - reported_);
+  } else {
+    gauge_.sub(reported_ - balance_);
+  }
+  reported_ = balance_;
+}
+
+} // namespace Buffer
+} // namespace Envoy
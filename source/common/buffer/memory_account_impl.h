@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/stats/stats.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Account that keeps its balance, and passes its charges and credits on to a parent account if it
+ * has one, e.g. from a connection to the account of its listener.
+ */
+class BufferMemoryAccountImpl : public BufferMemoryAccount, NonCopyable {
+public:
+  BufferMemoryAccountImpl() = default;
+  explicit BufferMemoryAccountImpl(BufferMemoryAccountSharedPtr parent)
+      : parent_(std::move(parent)) {}
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  uint64_t balance() const override { return balance_; }
+
+private:
+  const BufferMemoryAccountSharedPtr parent_;
+  uint64_t balance_{};
+};
+
+/**
+ * Account that reports its balance to a gauge, which may be shared by the accounts of several
+ * threads. The gauge is only updated once the balance has moved by GaugeUpdateBytes since the last
+ * update, so that threads don't contend on it for every buffer operation; it is up to that many
+ * bytes off per account.
+ */
+class GaugeBufferMemoryAccount : public BufferMemoryAccount, NonCopyable {
+public:
+  explicit GaugeBufferMemoryAccount(Stats::Gauge& gauge) : gauge_(gauge) {}
+  ~GaugeBufferMemoryAccount() override;
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  uint64_t balance() const override { return balance_; }
+
+  static constexpr uint64_t GaugeUpdateBytes = 16 * 1024;
+
+private:
+  void updateGauge();
+
+  Stats::Gauge& gauge_;
+  uint64_t balance_{};
+  // The balance as of the last gauge update.
+  uint64_t reported_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -6,6 +6,12 @@
 namespace Envoy {
 namespace Buffer {
 
+WatermarkBuffer::~WatermarkBuffer() {
+  if (account_ != nullptr) {
+    account_->credit(charged_);
+  }
+}
+
 void WatermarkBuffer::add(const void* data, uint64_t size) {
   OwnedImpl::add(data, size);
   checkHighAndOverflowWatermarks();
@@ -21,6 +27,11 @@ void WatermarkBuffer::add(const Instance& data) {
   checkHighAndOverflowWatermarks();
 }
 
+void WatermarkBuffer::addBufferFragment(BufferFragment& fragment) {
+  OwnedImpl::addBufferFragment(fragment);
+  checkHighAndOverflowWatermarks();
+}
+
 void WatermarkBuffer::prepend(absl::string_view data) {
   OwnedImpl::prepend(data);
   checkHighAndOverflowWatermarks();
@@ -87,7 +98,30 @@ void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_waterm
   checkLowWatermark();
 }
 
+void WatermarkBuffer::setAccount(const BufferMemoryAccountSharedPtr& account) {
+  if (account_ != nullptr) {
+    account_->credit(charged_);
+  }
+  account_ = account;
+  charged_ = 0;
+  updateAccount();
+}
+
+void WatermarkBuffer::updateAccount() {
+  if (account_ == nullptr) {
+    return;
+  }
+  const uint64_t length = OwnedImpl::length();
+  if (length > charged_) {
+    account_->charge(length - charged_);
+  } else if (length < charged_) {
+    account_->credit(charged_ - length);
+  }
+  charged_ = length;
+}
+
 void WatermarkBuffer::checkLowWatermark() {
+  updateAccount();
   if (!above_high_watermark_called_ ||
       (high_watermark_ != 0 && OwnedImpl::length() > low_watermark_)) {
     return;
@@ -98,6 +132,7 @@ void WatermarkBuffer::checkLowWatermark() {
 }
 
 void WatermarkBuffer::checkHighAndOverflowWatermarks() {
+  updateAccount();
   if (high_watermark_ == 0 || OwnedImpl::length() <= high_watermark_) {
     return;
   }
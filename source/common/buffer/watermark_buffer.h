@@ -22,12 +22,14 @@ public:
                   std::function<void()> above_overflow_watermark)
       : below_low_watermark_(below_low_watermark), above_high_watermark_(above_high_watermark),
         above_overflow_watermark_(above_overflow_watermark) {}
+  ~WatermarkBuffer() override;
 
   // Override all functions from Instance which can result in changing the size
   // of the underlying buffer.
   void add(const void* data, uint64_t size) override;
   void add(absl::string_view data) override;
   void add(const Instance& data) override;
+  void addBufferFragment(BufferFragment& fragment) override;
   void prepend(absl::string_view data) override;
   void prepend(Instance& data) override;
   void commit(RawSlice* iovecs, uint64_t num_iovecs) override;
@@ -46,9 +48,17 @@ public:
   // than the low watermark callbacks.
   bool highWatermarkTriggered() const { return above_high_watermark_called_; }
 
+  /**
+   * Charge the bytes the buffer holds, from now on, to an account rather than the previous one.
+   * @param account supplies the account, or nullptr to stop accounting.
+   */
+  void setAccount(const BufferMemoryAccountSharedPtr& account);
+  const BufferMemoryAccountSharedPtr& account() const { return account_; }
+
 private:
   void checkHighAndOverflowWatermarks();
   void checkLowWatermark();
+  void updateAccount();
 
   std::function<void()> below_low_watermark_;
   std::function<void()> above_high_watermark_;
@@ -65,6 +75,9 @@ private:
   bool above_high_watermark_called_{false};
   // Set to true when above_overflow_watermark_ is called (and isn't cleared).
   bool above_overflow_watermark_called_{false};
+  BufferMemoryAccountSharedPtr account_;
+  // The bytes charged to account_.
+  uint64_t charged_{0};
 };
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <limits>
 
 #include "envoy/common/resource.h"
 #include "envoy/runtime/runtime.h"
 
 #include "common/common/assert.h"
+#include "common/common/sharded_counter.h"
 
 #include "absl/types/optional.h"
 
@@ -17,7 +19,8 @@ namespace Envoy {
  * NOTE:
  * This implementation makes some assumptions which favor simplicity over correctness. Though
  * atomics are used, it is possible for resources to temporarily go above the supplied maximums.
- * This should not effect overall behavior.
+ * This should not effect overall behavior. The count is sharded per thread, see ShardedCounter, as
+ * limits such as the active requests of a cluster are updated by every worker.
  */
 class BasicResourceLimitImpl : public ResourceLimit {
 public:
@@ -26,15 +29,16 @@ public:
   BasicResourceLimitImpl(uint64_t max) : max_(max), runtime_(nullptr) {}
   BasicResourceLimitImpl() : max_(std::numeric_limits<uint64_t>::max()), runtime_(nullptr) {}
 
-  bool canCreate() override { return current_.load() < max(); }
+  bool canCreate() override { return approximateCount() < max(); }
 
-  void inc() override { ++current_; }
+  void inc() override { current_.add(1); }
 
   void dec() override { decBy(1); }
 
   void decBy(uint64_t amount) override {
-    ASSERT(current_ >= amount);
-    current_ -= amount;
+    // The other shards may hold the matching increments, so the count is checked as a whole.
+    ASSERT(count() >= amount);
+    current_.sub(amount);
   }
 
   uint64_t max() override {
@@ -43,13 +47,17 @@ public:
                : max_;
   }
 
-  uint64_t count() const override { return current_.load(); }
+  uint64_t count() const override { return std::max<int64_t>(current_.value(), 0); }
 
   void setMax(uint64_t new_max) { max_ = new_max; }
   void resetMax() { max_ = std::numeric_limits<uint64_t>::max(); }
 
 protected:
-  std::atomic<uint64_t> current_{};
+  // Used on every request, so it only sums the shards of other threads once per dispatcher
+  // iteration. See ShardedCounter::approximateValue().
+  uint64_t approximateCount() const { return std::max<int64_t>(current_.approximateValue(), 0); }
+
+  ShardedCounter current_;
 
 private:
   uint64_t max_;
@@ -0,0 +1,148 @@
+#include "common/common/cpu_affinity.h"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+
+#include "common/common/logger.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+
+namespace {
+// CPU numbers past this are rejected, as no cpu_set_t could hold them.
+constexpr uint32_t MaxCpu = 4095;
+} // namespace
+
+bool CpuAffinity::parseCpuList(absl::string_view list, std::vector<uint32_t>& cpus) {
+  cpus.clear();
+  for (absl::string_view range : absl::StrSplit(list, ',')) {
+    const std::vector<absl::string_view> bounds = absl::StrSplit(range, absl::MaxSplits('-', 1));
+    uint32_t first;
+    uint32_t last;
+    if (!absl::SimpleAtoi(bounds[0], &first) ||
+        !absl::SimpleAtoi(bounds.size() == 2 ? bounds[1] : bounds[0], &last) || first > last ||
+        last > MaxCpu) {
+      cpus.clear();
+      return false;
+    }
+    for (uint32_t cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return true;
+}
+
+#if defined(__linux__)
+bool CpuAffinity::applyToCurrentThread() const {
+  if (cpus_.empty()) {
+    return true;
+  }
+
+  cpu_set_t* set = CPU_ALLOC(MaxCpu + 1);
+  const size_t set_size = CPU_ALLOC_SIZE(MaxCpu + 1);
+  CPU_ZERO_S(set_size, set);
+  for (const uint32_t cpu : cpus_) {
+    CPU_SET_S(cpu, set_size, set);
+  }
+  // With a pid of 0, this applies to the calling thread only.
+  const int rc = sched_setaffinity(0, set_size, set);
+  const int error = errno;
+  CPU_FREE(set);
+  if (rc != 0) {
+    ENVOY_LOG_MISC(warn, "cannot pin thread to CPUs {}: {}", absl::StrJoin(cpus_, ","),
+                   errorDetails(error));
+    return false;
+  }
+  if (!numa_local_memory_) {
+    return true;
+  }
+
+  absl::optional<uint32_t> node = numaNode(cpus_[0]);
+  for (const uint32_t cpu : cpus_) {
+    if (numaNode(cpu) != node) {
+      node.reset();
+      break;
+    }
+  }
+  if (!node.has_value()) {
+    // The CPUs span several nodes. Go back to the default policy, in case the thread inherited the
+    // policy of a thread bound to another node.
+    ENVOY_LOG_MISC(debug, "CPUs {} are not all on one known NUMA node", absl::StrJoin(cpus_, ","));
+    return syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0) == 0;
+  }
+  std::vector<unsigned long> node_mask(*node / (8 * sizeof(unsigned long)) + 1);
+  node_mask[*node / (8 * sizeof(unsigned long))] |= 1UL << (*node % (8 * sizeof(unsigned long)));
+  // The kernel reads one bit less than the given maximum.
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, node_mask.data(),
+              node_mask.size() * 8 * sizeof(unsigned long) + 1) != 0) {
+    ENVOY_LOG_MISC(warn,
+                   "cannot bind the memory of the thread pinned to CPUs {} to NUMA node {}: {}",
+                   absl::StrJoin(cpus_, ","), *node, errorDetails(errno));
+    return false;
+  }
+  return true;
+}
+
+std::vector<uint32_t> CpuAffinity::currentThreadCpus() {
+  std::vector<uint32_t> cpus;
+  cpu_set_t* set = CPU_ALLOC(MaxCpu + 1);
+  const size_t set_size = CPU_ALLOC_SIZE(MaxCpu + 1);
+  CPU_ZERO_S(set_size, set);
+  if (sched_getaffinity(0, set_size, set) == 0) {
+    for (uint32_t cpu = 0; cpu <= MaxCpu; cpu++) {
+      if (CPU_ISSET_S(cpu, set_size, set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  CPU_FREE(set);
+  return cpus;
+}
+
+absl::optional<uint32_t> CpuAffinity::numaNode(uint32_t cpu) {
+  // The directory of a CPU links to the directory of its node.
+  const std::string path = absl::StrCat("/sys/devices/system/cpu/cpu", cpu);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return absl::nullopt;
+  }
+  absl::optional<uint32_t> node;
+  while (const dirent* entry = readdir(dir)) {
+    const absl::string_view name = entry->d_name;
+    uint32_t value;
+    if (absl::StartsWith(name, "node") && absl::SimpleAtoi(name.substr(4), &value)) {
+      node = value;
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+#else
+bool CpuAffinity::applyToCurrentThread() const {
+  if (cpus_.empty()) {
+    return true;
+  }
+  ENVOY_LOG_MISC(warn, "pinning threads to CPUs is not supported on this platform");
+  return false;
+}
+
+std::vector<uint32_t> CpuAffinity::currentThreadCpus() { return {}; }
+
+absl::optional<uint32_t> CpuAffinity::numaNode(uint32_t) { return absl::nullopt; }
+#endif
+
+} // namespace Envoy
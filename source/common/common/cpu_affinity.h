@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+
+/**
+ * The CPUs a thread runs on, and whether its memory should come from their NUMA node. Placement is
+ * only supported on Linux; elsewhere threads keep the placement they inherit.
+ */
+class CpuAffinity {
+public:
+  // A thread that keeps the placement it inherits.
+  CpuAffinity() = default;
+  CpuAffinity(std::vector<uint32_t> cpus, bool numa_local_memory)
+      : cpus_(std::move(cpus)), numa_local_memory_(numa_local_memory) {}
+
+  const std::vector<uint32_t>& cpus() const { return cpus_; }
+  bool numaLocalMemory() const { return numa_local_memory_; }
+
+  /**
+   * Pin the calling thread to the CPUs and, if numa local memory was asked for, make its
+   * allocations prefer the NUMA node of the CPUs, or use the default policy if they span several
+   * nodes. Does nothing without CPUs.
+   * @return bool whether the thread was placed as asked. Failures are logged.
+   */
+  bool applyToCurrentThread() const;
+
+  /**
+   * Parse a list of CPUs in the format of cpusets, e.g. "0-3,8,10-11".
+   * @param list supplies the list to parse.
+   * @param cpus returns the CPUs of the list, in order.
+   * @return bool whether the list is well formed.
+   */
+  static bool parseCpuList(absl::string_view list, std::vector<uint32_t>& cpus);
+
+  /**
+   * @return std::vector<uint32_t> the CPUs the calling thread may run on, in order. Empty if not
+   *         known.
+   */
+  static std::vector<uint32_t> currentThreadCpus();
+
+  /**
+   * @return absl::optional<uint32_t> the NUMA node of the CPU, if known.
+   */
+  static absl::optional<uint32_t> numaNode(uint32_t cpu);
+
+private:
+  std::vector<uint32_t> cpus_;
+  bool numa_local_memory_{};
+};
+
+} // namespace Envoy
@@ -25,6 +25,15 @@ namespace Envoy {
 #define UNREFERENCED_PARAMETER(X) ((void)(X))
 #endif
 
+/**
+ * Hint that the memory at X is about to be read. A no-op with compilers that have no such hint.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(X) __builtin_prefetch(X)
+#else
+#define PREFETCH(X)
+#endif
+
 /**
  * Construct On First Use idiom.
  * See https://isocpp.org/wiki/faq/ctors#static-init-order-on-first-use.
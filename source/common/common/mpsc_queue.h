@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Link of an element in an MpscQueue. Elements inherit from this, so that pushing them takes no
+ * allocation of its own.
+ */
+class MpscQueueNode {
+private:
+  std::atomic<MpscQueueNode*> next_{nullptr};
+
+  friend class MpscQueueBase;
+};
+
+/**
+ * Untyped part of MpscQueue. @see MpscQueue.
+ */
+class MpscQueueBase : NonCopyable {
+protected:
+  MpscQueueBase() : head_(&stub_), tail_(&stub_) {}
+
+  void push(MpscQueueNode& node) {
+    node.next_.store(nullptr, std::memory_order_relaxed);
+    // Swinging the head serializes producers. The queue is inconsistent until the previous head
+    // is linked to the new node, which pop() treats as not having pushed the node yet.
+    MpscQueueNode* prev = head_.exchange(&node, std::memory_order_acq_rel);
+    prev->next_.store(&node, std::memory_order_release);
+  }
+
+  MpscQueueNode* pop() {
+    MpscQueueNode* tail = tail_;
+    MpscQueueNode* next = tail->next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A producer is between swinging the head and linking its node.
+      return nullptr;
+    }
+    // The tail is the last node. Push the stub behind it so that it can be handed out without
+    // leaving the queue empty of nodes.
+    push(stub_);
+    next = tail->next_.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+private:
+  std::atomic<MpscQueueNode*> head_;
+  MpscQueueNode* tail_;
+  MpscQueueNode stub_;
+};
+
+/**
+ * Intrusive, unbounded, lock free multi producer single consumer FIFO queue (Dmitry Vyukov's
+ * algorithm). Any thread may push, while only one thread at a time may pop. Pushing never blocks
+ * and takes one atomic exchange.
+ *
+ * pop() may return nullptr while a concurrent push() is still completing, even though that push
+ * has already started, so callers that need to know whether the queue is empty have to track
+ * that separately, e.g. with a counter incremented before each push.
+ *
+ * The queue doesn't own its elements: popped elements belong to the caller again, and elements
+ * still queued when the queue is destroyed are leaked unless the owner pops them first.
+ */
+template <class T> class MpscQueue : MpscQueueBase {
+public:
+  /**
+   * Appends an element. Thread safe.
+   * @param element supplies the element, which must not be queued already.
+   */
+  void push(T& element) { MpscQueueBase::push(static_cast<MpscQueueNode&>(element)); }
+
+  /**
+   * Removes the oldest element. Must only be called by the consumer.
+   * @return T* the element, or nullptr if the queue is empty or the oldest push is in progress.
+   */
+  T* pop() { return static_cast<T*>(MpscQueueBase::pop()); }
+};
+
+} // namespace Envoy
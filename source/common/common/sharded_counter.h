@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "common/common/non_copyable.h"
+
+#include "absl/base/optimization.h"
+
+namespace Envoy {
+
+/**
+ * A signed counter that many threads update concurrently, such as the active requests of an
+ * upstream host. Each thread adds to one of several shards, picked by the order in which threads
+ * first update any sharded counter, and each shard has a cache line of its own so that workers
+ * don't contend on it. Reads sum the shards, so they cost more than updates, and may miss updates
+ * that other threads are making at the same time.
+ *
+ * Hot paths that read the counter on every decision, such as load balancers, can use
+ * approximateValue() instead, which sums the shards of other threads once per dispatcher iteration.
+ *
+ * A counter with a single shard is a plain atomic and allocates nothing.
+ */
+class ShardedCounter : NonCopyable {
+public:
+  ShardedCounter() : ShardedCounter(defaultShardCount()) {}
+  explicit ShardedCounter(uint32_t num_shards) : num_shards_(std::max<uint32_t>(num_shards, 1)) {
+    if (num_shards_ > 1) {
+      // C++14 operator new ignores alignments beyond that of max_align_t, so align the shards to
+      // cache lines by hand.
+      buffer_ = std::make_unique<char[]>((num_shards_ + 1) * CacheLineSize);
+      const uintptr_t address = reinterpret_cast<uintptr_t>(buffer_.get());
+      shards_ = reinterpret_cast<Shard*>((address + CacheLineSize - 1) & ~(CacheLineSize - 1));
+      for (uint32_t i = 0; i < num_shards_; i++) {
+        new (&shards_[i]) Shard();
+      }
+    }
+  }
+
+  int64_t value() const {
+    if (shards_ == nullptr) {
+      return value_.load(std::memory_order_relaxed);
+    }
+    int64_t value = 0;
+    for (uint32_t i = 0; i < num_shards_; i++) {
+      value += shards_[i].value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  /**
+   * @return the value of the counter, with the calling thread's shard read as it is and the other
+   *         shards as they were summed the first time this thread read the counter in its current
+   *         dispatcher iteration. Threads that don't run a dispatcher get value().
+   */
+  int64_t approximateValue() const {
+    const uint64_t iteration = threadIteration();
+    if (shards_ == nullptr || iteration == 0) {
+      return value();
+    }
+    const uint32_t index = threadIndex() % num_shards_;
+    Shard& own = shards_[index];
+    // Threads sharing a shard overwrite each other's sum, which only costs them a recount.
+    if (own.others_iteration_.load(std::memory_order_relaxed) != iteration) {
+      int64_t others = 0;
+      for (uint32_t i = 0; i < num_shards_; i++) {
+        if (i != index) {
+          others += shards_[i].value_.load(std::memory_order_relaxed);
+        }
+      }
+      own.others_.store(others, std::memory_order_relaxed);
+      own.others_iteration_.store(iteration, std::memory_order_relaxed);
+    }
+    return own.others_.load(std::memory_order_relaxed) +
+           own.value_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Called by each dispatcher at the start of every loop iteration, on its thread, so that the
+   * next approximateValue() of each counter sums the other shards again.
+   */
+  static void onDispatcherIteration() {
+    static std::atomic<uint64_t> next_iteration{0};
+    threadIteration() = ++next_iteration;
+  }
+
+  void add(int64_t amount) { shard().fetch_add(amount, std::memory_order_relaxed); }
+  void sub(int64_t amount) { shard().fetch_sub(amount, std::memory_order_relaxed); }
+
+  /**
+   * Set the value of the counter. Updates that other threads make at the same time may be lost.
+   */
+  void set(int64_t value) {
+    if (shards_ == nullptr) {
+      value_.store(value, std::memory_order_relaxed);
+      return;
+    }
+    shards_[0].value_.store(value, std::memory_order_relaxed);
+    for (uint32_t i = 1; i < num_shards_; i++) {
+      shards_[i].value_.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t numShards() const { return num_shards_; }
+
+  /**
+   * @return the number of shards of counters created without an explicit number.
+   */
+  static uint32_t defaultShardCount() {
+    return defaultShardCountStorage().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Set the number of shards of the counters created without an explicit number from now on. The
+   * server sets it to its number of workers at startup. It is capped at MaxDefaultShardCount to
+   * bound the memory of each counter, so on larger machines some workers share a shard.
+   */
+  static void setDefaultShardCount(uint32_t num_shards) {
+    num_shards = std::max<uint32_t>(num_shards, 1);
+    defaultShardCountStorage().store(
+        num_shards > MaxDefaultShardCount ? MaxDefaultShardCount : num_shards,
+        std::memory_order_relaxed);
+  }
+
+  static constexpr uint32_t MaxDefaultShardCount = 8;
+
+private:
+  static constexpr uintptr_t CacheLineSize = ABSL_CACHELINE_SIZE;
+
+  struct Shard {
+    std::atomic<int64_t> value_{0};
+    // The sum of the other shards for approximateValue(), and the dispatcher iteration it was
+    // taken in. Only the threads updating this shard use them.
+    std::atomic<int64_t> others_{0};
+    std::atomic<uint64_t> others_iteration_{0};
+    char padding_[CacheLineSize - 2 * sizeof(std::atomic<int64_t>) - sizeof(std::atomic<uint64_t>)];
+  };
+  static_assert(sizeof(Shard) == CacheLineSize, "shards must fill a cache line");
+
+  std::atomic<int64_t>& shard() {
+    return shards_ == nullptr ? value_ : shards_[threadIndex() % num_shards_].value_;
+  }
+
+  static uint32_t threadIndex() {
+    static std::atomic<uint32_t> next_index{0};
+    static thread_local const uint32_t index = next_index++;
+    return index;
+  }
+
+  // Iterations are numbered across all threads, so that a sum taken by another thread sharing the
+  // shard is never mistaken for one of this thread's current iteration. 0 means no dispatcher.
+  static uint64_t& threadIteration() {
+    static thread_local uint64_t iteration = 0;
+    return iteration;
+  }
+
+  static std::atomic<uint32_t>& defaultShardCountStorage() {
+    static std::atomic<uint32_t> num_shards{1};
+    return num_shards;
+  }
+
+  // Used when there is a single shard.
+  std::atomic<int64_t> value_{0};
+  const uint32_t num_shards_;
+  std::unique_ptr<char[]> buffer_;
+  Shard* shards_{};
+};
+
+} // namespace Envoy
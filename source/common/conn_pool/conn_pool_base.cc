@@ -14,12 +14,14 @@ ConnPoolImplBase::ConnPoolImplBase(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     const Network::TransportSocketOptionsSharedPtr& transport_socket_options)
     : host_(host), priority_(priority), dispatcher_(dispatcher), socket_options_(options),
-      transport_socket_options_(transport_socket_options) {}
+      transport_socket_options_(transport_socket_options),
+      prefetch_ratio_(host_->cluster().perUpstreamPrefetchRatio()) {}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
   ASSERT(ready_clients_.empty());
   ASSERT(busy_clients_.empty());
   ASSERT(connecting_clients_.empty());
+  ASSERT(ready_request_capacity_ == 0);
 }
 
 void ConnPoolImplBase::destructAllConnections() {
@@ -33,16 +35,61 @@ void ConnPoolImplBase::destructAllConnections() {
   dispatcher_.clearDeferredDeleteList();
 }
 
-void ConnPoolImplBase::tryCreateNewConnection() {
-  if (pending_requests_.size() <= connecting_request_capacity_) {
-    // There are already enough CONNECTING connections for the number
-    // of queued requests.
-    return;
+bool ConnPoolImplBase::shouldPrefetch(double prefetch_ratio,
+                                      uint32_t anticipated_new_streams) const {
+  if (prefetch_ratio <= 1.0 && anticipated_new_streams == 0) {
+    return false;
+  }
+  // Don't make unhealthy hosts or draining pools do extra work.
+  if (!drained_callbacks_.empty() || host_->health() == Upstream::Host::Health::Unhealthy) {
+    return false;
+  }
+
+  // Capacities are summed as doubles, as HTTP/2 clients without a stream limit report
+  // std::numeric_limits<uint64_t>::max() while connecting.
+  const double anticipated_streams =
+      (static_cast<double>(pending_requests_.size()) + num_active_requests_ +
+       anticipated_new_streams) *
+      prefetch_ratio;
+  return anticipated_streams > static_cast<double>(num_active_requests_) +
+                                   connecting_request_capacity_ + ready_request_capacity_;
+}
+
+void ConnPoolImplBase::setReadyRequestCapacity(ActiveClient& client, uint64_t capacity) {
+  ASSERT(ready_request_capacity_ >= client.ready_request_capacity_);
+  ready_request_capacity_ = ready_request_capacity_ - client.ready_request_capacity_ + capacity;
+  client.ready_request_capacity_ = capacity;
+}
+
+void ConnPoolImplBase::tryCreateNewConnections() {
+  // Without prefetching this creates at most one connection, as it always has. With prefetching a
+  // few connections may be needed to catch up with a burst of streams, but a single call is
+  // bounded so that one stream can't open a flood of connections.
+  const uint32_t max_new_connections = prefetch_ratio_ > 1.0 ? 3 : 1;
+  for (uint32_t i = 0; i < max_new_connections; i++) {
+    if (!tryCreateNewConnection(prefetch_ratio_, 0)) {
+      break;
+    }
+  }
+}
+
+bool ConnPoolImplBase::tryCreateNewConnection(double prefetch_ratio,
+                                              uint32_t anticipated_new_streams) {
+  // If there are already enough CONNECTING connections for the number of queued requests, a new
+  // connection can only be a prefetched one.
+  const bool prefetch = pending_requests_.size() <= connecting_request_capacity_;
+  if (prefetch && !shouldPrefetch(prefetch_ratio, anticipated_new_streams)) {
+    return false;
   }
 
   const bool can_create_connection =
       host_->cluster().resourceManager(priority_).connections().canCreate();
-  if (!can_create_connection) {
+  if (prefetch) {
+    // Prefetching is best effort and never overflows the connection circuit breaker.
+    if (!can_create_connection) {
+      return false;
+    }
+  } else if (!can_create_connection) {
     host_->cluster().stats().upstream_cx_overflow_.inc();
   }
   // If we are at the connection circuit-breaker limit due to other upstreams having
@@ -50,14 +97,24 @@ void ConnPoolImplBase::tryCreateNewConnection() {
   // prevent pending requests being queued to this upstream with no way to be processed.
   if (can_create_connection ||
       (ready_clients_.empty() && busy_clients_.empty() && connecting_clients_.empty())) {
-    ENVOY_LOG(debug, "creating a new connection");
+    ENVOY_LOG(debug, "creating a new {}connection", prefetch ? "prefetched " : "");
     ActiveClientPtr client = instantiateActiveClient();
     ASSERT(client->state_ == ActiveClient::State::CONNECTING);
     ASSERT(std::numeric_limits<uint64_t>::max() - connecting_request_capacity_ >=
            client->effectiveConcurrentRequestLimit());
     connecting_request_capacity_ += client->effectiveConcurrentRequestLimit();
+    if (prefetch) {
+      client->prefetched_ = true;
+      host_->cluster().stats().upstream_cx_prefetched_.inc();
+    }
     client->moveIntoList(std::move(client), owningList(client->state_));
+    return true;
   }
+  return false;
+}
+
+bool ConnPoolImplBase::maybePrefetchImpl(double prefetch_ratio) {
+  return tryCreateNewConnection(prefetch_ratio, 1);
 }
 
 void ConnPoolImplBase::attachRequestToClient(Envoy::ConnectionPool::ActiveClient& client,
@@ -72,6 +129,11 @@ void ConnPoolImplBase::attachRequestToClient(Envoy::ConnectionPool::ActiveClient
   } else {
     ENVOY_CONN_LOG(debug, "creating stream", client);
 
+    if (client.prefetched_) {
+      client.prefetched_ = false;
+      host_->cluster().stats().upstream_cx_prefetched_used_.inc();
+    }
+
     client.remaining_requests_--;
     if (client.remaining_requests_ == 0) {
       ENVOY_CONN_LOG(debug, "maximum requests per connection, DRAINING", client);
@@ -80,6 +142,11 @@ void ConnPoolImplBase::attachRequestToClient(Envoy::ConnectionPool::ActiveClient
     } else if (client.numActiveRequests() + 1 >= client.concurrent_request_limit_) {
       // As soon as the new request is created, the client will be maxed out.
       transitionActiveClientState(client, Envoy::ConnectionPool::ActiveClient::State::BUSY);
+    } else {
+      // The new request takes one of the requests the client has left, both in its lifetime and
+      // concurrently.
+      ASSERT(client.ready_request_capacity_ > 0);
+      setReadyRequestCapacity(client, client.ready_request_capacity_ - 1);
     }
 
     num_active_requests_++;
@@ -104,7 +171,7 @@ void ConnPoolImplBase::onRequestClosed(Envoy::ConnectionPool::ActiveClient& clie
   if (client.state_ == ActiveClient::State::DRAINING && client.numActiveRequests() == 0) {
     // Close out the draining client if we no longer have active requests.
     client.close();
-  } else if (client.state_ == ActiveClient::State::BUSY) {
+  } else if (client.state_ == ActiveClient::State::BUSY && client.readyForNewRequest()) {
     // A request was just ended, so we should be below the limit now.
     ASSERT(client.numActiveRequests() < client.concurrent_request_limit_);
 
@@ -112,6 +179,8 @@ void ConnPoolImplBase::onRequestClosed(Envoy::ConnectionPool::ActiveClient& clie
     if (!delay_attaching_request) {
       onUpstreamReady();
     }
+  } else if (client.state_ == ActiveClient::State::READY) {
+    setReadyRequestCapacity(client, client.currentUnusedCapacity());
   }
 }
 
@@ -120,6 +189,11 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", client);
     attachRequestToClient(client, context);
+    // Even with a ready client, the pool may want to prefetch a connection for the streams
+    // that are likely to follow this one.
+    if (prefetch_ratio_ > 1.0) {
+      tryCreateNewConnections();
+    }
     return nullptr;
   }
 
@@ -128,7 +202,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
 
     // This must come after newPendingRequest() because this function uses the
     // length of pending_requests_ to determine if a new connection is needed.
-    tryCreateNewConnection();
+    tryCreateNewConnections();
 
     return pending;
   } else {
@@ -171,6 +245,8 @@ void ConnPoolImplBase::transitionActiveClientState(ActiveClient& client,
   auto& old_list = owningList(client.state_);
   auto& new_list = owningList(new_state);
   client.state_ = new_state;
+  setReadyRequestCapacity(
+      client, new_state == ActiveClient::State::READY ? client.currentUnusedCapacity() : 0);
 
   // old_list and new_list can be equal when transitioning from BUSY to DRAINING.
   //
@@ -288,6 +364,7 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     // this forces part of its cleanup to happen now.
     client.releaseResources();
 
+    setReadyRequestCapacity(client, 0);
     dispatcher_.deferredDelete(client.removeFromList(owningList(client.state_)));
     if (incomplete_request) {
       checkForDrained();
@@ -297,7 +374,7 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
 
     // If we have pending requests and we just lost a connection we should make a new one.
     if (!pending_requests_.empty()) {
-      tryCreateNewConnection();
+      tryCreateNewConnections();
     }
   } else if (event == Network::ConnectionEvent::Connected) {
     client.conn_connect_ms_->complete();
@@ -360,8 +437,10 @@ void ConnPoolImplBase::onPendingRequestCancel(PendingRequest& request,
   // There's excess capacity if
   // pending_requests < connecting_request_capacity_ - capacity of most recent client.
   // It's calculated below with addition instead to avoid underflow issues, overflow being
-  // assumed to not be a problem across the connection pool.
-  if (policy == Envoy::ConnectionPool::CancelPolicy::CloseExcess && !connecting_clients_.empty() &&
+  // assumed to not be a problem across the connection pool. A pool that prefetches keeps the
+  // connection for the streams it anticipates.
+  if (policy == Envoy::ConnectionPool::CancelPolicy::CloseExcess && prefetch_ratio_ <= 1.0 &&
+      !connecting_clients_.empty() &&
       (pending_requests_.size() + connecting_clients_.front()->effectiveConcurrentRequestLimit() <=
        connecting_request_capacity_)) {
     auto& client = *connecting_clients_.front();
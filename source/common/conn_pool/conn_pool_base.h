@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 #include "envoy/common/conn_pool.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
@@ -43,8 +47,9 @@ public:
   void onConnectTimeout();
 
   // Returns the concurrent request limit, accounting for if the total request limit
-  // is less than the concurrent request limit.
-  uint64_t effectiveConcurrentRequestLimit() const {
+  // is less than the concurrent request limit. This is the capacity a connecting client is
+  // expected to bring, so it must not change while the client is connecting.
+  virtual uint64_t effectiveConcurrentRequestLimit() const {
     return std::min(remaining_requests_, concurrent_request_limit_);
   }
 
@@ -56,6 +61,21 @@ public:
   virtual bool closingWithIncompleteRequest() const PURE;
   // Returns the number of active requests on this connection.
   virtual size_t numActiveRequests() const PURE;
+  // Returns the number of requests this client can take right now. Clients without a limit report
+  // std::numeric_limits<uint32_t>::max(), so that the capacities of a pool's clients can be summed.
+  uint64_t currentUnusedCapacity() const {
+    const uint64_t active_requests = numActiveRequests();
+    if (active_requests >= concurrent_request_limit_) {
+      return 0;
+    }
+    return std::min<uint64_t>({remaining_requests_, concurrent_request_limit_ - active_requests,
+                               std::numeric_limits<uint32_t>::max()});
+  }
+  // Returns true if a busy connection can take another request. This is the case once it is below
+  // its concurrent request limit, unless the protocol imposes further conditions.
+  virtual bool readyForNewRequest() const {
+    return numActiveRequests() < concurrent_request_limit_;
+  }
 
   enum class State {
     CONNECTING, // Connection is not yet established.
@@ -76,6 +96,11 @@ public:
   Event::TimerPtr connect_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
+  // True if the connection was established ahead of demand and hasn't served a request yet.
+  bool prefetched_{false};
+  // The requests this client can take while READY, as counted in the pool's
+  // ready_request_capacity_.
+  uint64_t ready_request_capacity_{0};
 };
 
 // PendingRequest is the base class for a connection which has been created but not yet established.
@@ -151,9 +176,19 @@ public:
 
   virtual ConnectionPool::Cancellable* newPendingRequest(AttachContext& context) PURE;
 
-  // Creates a new connection if allowed by resourceManager, or if created to avoid
-  // starving this pool.
-  void tryCreateNewConnection();
+  // Creates new connections for the pending requests and, if the cluster prefetches, for the
+  // streams anticipated from the number of active streams.
+  void tryCreateNewConnections();
+
+  // Creates a new connection if the pending requests need one and it is allowed by
+  // resourceManager, or if created to avoid starving this pool. Otherwise creates a connection if
+  // prefetch_ratio calls for one, counting anticipated_new_streams on top of the pending and active
+  // ones, and the connection circuit breaker allows it. Returns true if a connection was created.
+  bool tryCreateNewConnection(double prefetch_ratio, uint32_t anticipated_new_streams);
+
+  // Creates a connection for one more anticipated stream if prefetch_ratio calls for it. Returns
+  // true if a connection was created.
+  bool maybePrefetchImpl(double prefetch_ratio);
 
   void attachRequestToClient(Envoy::ConnectionPool::ActiveClient& client, AttachContext& context);
 
@@ -174,12 +209,21 @@ public:
   }
 
 protected:
+  // Returns true if the streams anticipated from prefetch_ratio, plus anticipated_new_streams,
+  // exceed what the connected and connecting clients can serve.
+  bool shouldPrefetch(double prefetch_ratio, uint32_t anticipated_new_streams) const;
+
+  // Sets the capacity client contributes to ready_request_capacity_.
+  void setReadyRequestCapacity(ActiveClient& client, uint64_t capacity);
+
   const Upstream::HostConstSharedPtr host_;
   const Upstream::ResourcePriority priority_;
 
   Event::Dispatcher& dispatcher_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   const Network::TransportSocketOptionsSharedPtr transport_socket_options_;
+  // @see Upstream::ClusterInfo::perUpstreamPrefetchRatio.
+  const double prefetch_ratio_;
 
 protected:
   std::list<Instance::DrainedCb> drained_callbacks_;
@@ -205,6 +249,11 @@ protected:
   // The number of requests that can be immediately dispatched
   // if all CONNECTING connections become connected.
   uint64_t connecting_request_capacity_{0};
+
+  // The number of requests that can be immediately dispatched to READY connections. It is kept
+  // up to date as clients change state and take or finish requests, so that deciding whether to
+  // prefetch doesn't walk the clients.
+  uint64_t ready_request_capacity_{0};
 };
 
 } // namespace ConnectionPool
@@ -1,5 +1,6 @@
 #include "common/event/dispatcher_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -11,7 +12,7 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
-#include "common/common/lock_guard.h"
+#include "common/common/sharded_counter.h"
 #include "common/common/thread.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/libevent_scheduler.h"
@@ -20,6 +21,7 @@
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/dns_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/udp_listener_impl.h"
 
@@ -32,6 +34,11 @@
 namespace Envoy {
 namespace Event {
 
+namespace {
+// How much time each sample of the event loop utilization covers.
+constexpr std::chrono::milliseconds LoopUtilizationWindow(100);
+} // namespace
+
 DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                                Event::TimeSystem& time_system)
     : DispatcherImpl(name, std::make_unique<Buffer::WatermarkBufferFactory>(), api, time_system) {}
@@ -49,14 +56,26 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Buffer::WatermarkFactory
   SignalAction::registerFatalErrorHandler(*this);
 #endif
   updateApproximateMonotonicTimeInternal();
-  base_scheduler_.registerOnPrepareCallback(
-      std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
+  base_scheduler_.registerOnPrepareCallback(std::bind(&DispatcherImpl::onLoopPrepare, this));
+  base_scheduler_.registerOnCheckCallback(std::bind(&DispatcherImpl::onLoopCheck, this));
 }
 
 DispatcherImpl::~DispatcherImpl() {
 #ifdef ENVOY_HANDLE_SIGNALS
   SignalAction::removeFatalErrorHandler(*this);
 #endif
+  // Destroy callbacks that never ran. Their destructors may post more, which are popped as well.
+  while (PostCallbackPtr post_callback{post_callbacks_.pop()}) {
+  }
+}
+
+Network::IoUringWorker* DispatcherImpl::ioUringWorker() {
+  ASSERT(isThreadSafe());
+  if (!io_uring_worker_created_) {
+    io_uring_worker_created_ = true;
+    io_uring_worker_ = Network::IoUringWorker::create(*this);
+  }
+  return io_uring_worker_.get();
 }
 
 void DispatcherImpl::initializeStats(Stats::Scope& scope,
@@ -68,6 +87,7 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    post_stats_enabled_.store(true, std::memory_order_relaxed);
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -160,6 +180,14 @@ TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
   return createTimerInternal(cb);
 }
 
+TimerPtr DispatcherImpl::createCoarseTimer(TimerCb cb) {
+  ASSERT(isThreadSafe());
+  if (timer_wheel_ == nullptr) {
+    timer_wheel_ = std::make_unique<TimerWheel>(*scheduler_, timeSource(), *this);
+  }
+  return timer_wheel_->createTimer(cb, *this);
+}
+
 Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::function<void()> cb) {
   ASSERT(isThreadSafe());
   return base_scheduler_.createSchedulableCallback(cb);
@@ -186,12 +214,15 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+  auto post_callback = std::make_unique<PostCallback>(std::move(callback));
+  const bool do_post = pending_post_callbacks_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  if (do_post && post_stats_enabled_.load(std::memory_order_relaxed)) {
+    first_post_time_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  api_.timeSource().monotonicTime().time_since_epoch())
+                                  .count(),
+                              std::memory_order_relaxed);
   }
+  post_callbacks_.push(*post_callback.release());
 
   if (do_post) {
     post_cb_->scheduleCallbackCurrentIteration();
@@ -219,24 +250,70 @@ void DispatcherImpl::updateApproximateMonotonicTimeInternal() {
   approximate_monotonic_time_ = api_.timeSource().monotonicTime();
 }
 
+void DispatcherImpl::onLoopPrepare() {
+  updateApproximateMonotonicTimeInternal();
+  loop_prepare_time_ = approximate_monotonic_time_;
+  // The loop has been busy since it was done polling, unless this is its first iteration.
+  if (loop_check_time_ != MonotonicTime()) {
+    loop_busy_time_ += loop_prepare_time_ - loop_check_time_;
+    loop_window_time_ += loop_prepare_time_ - loop_check_time_;
+    updateLoopUtilization();
+  }
+}
+
+void DispatcherImpl::onLoopCheck() {
+  ShardedCounter::onDispatcherIteration();
+  loop_check_time_ = api_.timeSource().monotonicTime();
+  loop_window_time_ += loop_check_time_ - loop_prepare_time_;
+  updateLoopUtilization();
+}
+
+void DispatcherImpl::updateLoopUtilization() {
+  if (loop_window_time_ < LoopUtilizationWindow) {
+    return;
+  }
+  const double window_utilization =
+      static_cast<double>(loop_busy_time_.count()) / loop_window_time_.count();
+  // Weigh the last window as much as all the previous ones, so that the estimate follows changes
+  // of load within a few windows.
+  loop_utilization_.store(
+      (loop_utilization_.load(std::memory_order_relaxed) + window_utilization) / 2,
+      std::memory_order_relaxed);
+  loop_busy_time_ = MonotonicTime::duration::zero();
+  loop_window_time_ = MonotonicTime::duration::zero();
+}
+
 void DispatcherImpl::runPostCallbacks() {
+  const uint64_t pending = pending_post_callbacks_.load(std::memory_order_acquire);
+  if (pending == 0) {
+    return;
+  }
+  if (post_stats_enabled_.load(std::memory_order_relaxed)) {
+    // The time is missing if the queue was already filling up when stats were initialized.
+    const int64_t first_post_time_ns = first_post_time_ns_.load(std::memory_order_relaxed);
+    if (first_post_time_ns != 0) {
+      const auto delay = api_.timeSource().monotonicTime() -
+                         MonotonicTime(std::chrono::nanoseconds(first_post_time_ns));
+      stats_->post_delay_us_.recordValue(std::max<int64_t>(
+          0, std::chrono::duration_cast<std::chrono::microseconds>(delay).count()));
+    }
+    stats_->post_queue_depth_.recordValue(pending);
+  }
+
   while (true) {
-    // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
+    PostCallbackPtr post_callback{post_callbacks_.pop()};
+    if (post_callback == nullptr) {
+      if (pending_post_callbacks_.load(std::memory_order_acquire) != 0) {
+        // A producer has counted its callback but not finished pushing it, so it won't schedule
+        // post_cb_ itself. Come back for it rather than spinning.
+        post_cb_->scheduleCallbackNextIteration();
       }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+      return;
     }
-    callback();
+    // Decrement before running, so that a callback posted from within this one, or from another
+    // thread after it ran, schedules post_cb_ again if the queue has been drained by then.
+    pending_post_callbacks_.fetch_sub(1, std::memory_order_acq_rel);
+    post_callback->callback_();
   }
 }
 
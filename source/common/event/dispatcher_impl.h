@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <vector>
 
@@ -15,12 +15,18 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
+#include "common/event/timer_wheel.h"
 #include "common/signal/fatal_error_handler.h"
 
 namespace Envoy {
+namespace Network {
+class IoUringWorker;
+} // namespace Network
+
 namespace Event {
 
 /**
@@ -40,6 +46,12 @@ public:
    */
   event_base& base() { return base_scheduler_.base(); }
 
+  /**
+   * @return Network::IoUringWorker* the io_uring worker of the dispatcher, created on first use,
+   *         or nullptr if io_uring isn't available.
+   */
+  Network::IoUringWorker* ioUringWorker();
+
   // Event::Dispatcher
   const std::string& name() override { return name_; }
   TimeSource& timeSource() override { return api_.timeSource(); }
@@ -64,6 +76,7 @@ public:
   Network::UdpListenerPtr createUdpListener(Network::SocketSharedPtr&& socket,
                                             Network::UdpListenerCallbacks& cb) override;
   TimerPtr createTimer(TimerCb cb) override;
+  TimerPtr createCoarseTimer(TimerCb cb) override;
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
@@ -78,6 +91,9 @@ public:
   }
   MonotonicTime approximateMonotonicTime() const override;
   void updateApproximateMonotonicTime() override;
+  double loopUtilization() const override {
+    return loop_utilization_.load(std::memory_order_relaxed);
+  }
 
   // FatalErrorInterface
   void onFatalError() const override {
@@ -91,8 +107,19 @@ public:
   }
 
 private:
+  // A callback waiting in the post queue.
+  struct PostCallback : public MpscQueueNode {
+    explicit PostCallback(std::function<void()>&& callback) : callback_(std::move(callback)) {}
+
+    std::function<void()> callback_;
+  };
+  using PostCallbackPtr = std::unique_ptr<PostCallback>;
+
   TimerPtr createTimerInternal(TimerCb cb);
   void updateApproximateMonotonicTimeInternal();
+  void onLoopPrepare();
+  void onLoopCheck();
+  void updateLoopUtilization();
   void runPostCallbacks();
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
@@ -110,16 +137,35 @@ private:
   Buffer::WatermarkFactoryPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
+  // Created with the first coarse timer.
+  std::unique_ptr<TimerWheel> timer_wheel_;
   SchedulableCallbackPtr deferred_delete_cb_;
   SchedulableCallbackPtr post_cb_;
+  // Declared before the deferred delete lists, as connections waiting there may still use it.
+  std::unique_ptr<Network::IoUringWorker> io_uring_worker_;
+  bool io_uring_worker_created_{};
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ ABSL_GUARDED_BY(post_lock_);
+  MpscQueue<PostCallback> post_callbacks_;
+  // The number of callbacks pushed to post_callbacks_ and not yet popped. It is incremented before
+  // pushing, so it also counts pushes that post_callbacks_ doesn't hand out yet. Whoever raises it
+  // from zero schedules post_cb_.
+  std::atomic<uint64_t> pending_post_callbacks_{};
+  // When pending_post_callbacks_ was last raised from zero, in nanoseconds of monotonic time. Only
+  // tracked once stats have been initialized.
+  std::atomic<int64_t> first_post_time_ns_{};
+  std::atomic<bool> post_stats_enabled_{};
   const ScopeTrackedObject* current_object_{};
   bool deferred_deleting_{};
   MonotonicTime approximate_monotonic_time_;
+  // When the event loop last started and stopped polling, and how much of the current sample window
+  // of loopUtilization() it spent running callbacks.
+  MonotonicTime loop_prepare_time_;
+  MonotonicTime loop_check_time_;
+  MonotonicTime::duration loop_busy_time_{};
+  MonotonicTime::duration loop_window_time_{};
+  std::atomic<double> loop_utilization_{};
 };
 
 } // namespace Event
@@ -7,11 +7,6 @@ extern "C" {
 void event_base_free(event_base*);
 }
 
-struct evconnlistener;
-extern "C" {
-void evconnlistener_free(evconnlistener*);
-}
-
 namespace Envoy {
 namespace Event {
 namespace Libevent {
@@ -34,7 +29,6 @@ private:
 };
 
 using BasePtr = CSmartPtr<event_base, event_base_free>;
-using ListenerPtr = CSmartPtr<evconnlistener, evconnlistener_free>;
 
 } // namespace Libevent
 } // namespace Event
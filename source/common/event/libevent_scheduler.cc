@@ -63,6 +63,14 @@ void LibeventScheduler::registerOnPrepareCallback(OnPrepareCallback&& callback)
   evwatch_prepare_new(libevent_.get(), &onPrepareForCallback, this);
 }
 
+void LibeventScheduler::registerOnCheckCallback(OnCheckCallback&& callback) {
+  ASSERT(callback);
+  ASSERT(!check_callback_);
+
+  check_callback_ = std::move(callback);
+  evwatch_check_new(libevent_.get(), &onCheckForCallback, this);
+}
+
 void LibeventScheduler::initializeStats(DispatcherStats* stats) {
   stats_ = stats;
   // These are thread safe.
@@ -76,6 +84,12 @@ void LibeventScheduler::onPrepareForCallback(evwatch*, const evwatch_prepare_cb_
   self->callback_();
 }
 
+void LibeventScheduler::onCheckForCallback(evwatch*, const evwatch_check_cb_info*, void* arg) {
+  // `self` is `this`, passed in from evwatch_check_new.
+  auto self = static_cast<LibeventScheduler*>(arg);
+  self->check_callback_();
+}
+
 void LibeventScheduler::onPrepareForStats(evwatch*, const evwatch_prepare_cb_info* info,
                                           void* arg) {
   // `self` is `this`, passed in from evwatch_prepare_new.
@@ -18,6 +18,7 @@ namespace Event {
 class LibeventScheduler : public Scheduler, public CallbackScheduler {
 public:
   using OnPrepareCallback = std::function<void()>;
+  using OnCheckCallback = std::function<void()>;
   LibeventScheduler();
 
   // Scheduler
@@ -54,6 +55,14 @@ public:
    */
   void registerOnPrepareCallback(OnPrepareCallback&& callback);
 
+  /**
+   * Register callback to be called in the event loop right after polling for
+   * events, before any of them is handled. Must not be called more than once.
+   * |callback| must not be null. |callback| cannot be unregistered, therefore it
+   * has to be valid throughout the lifetime of |this|.
+   */
+  void registerOnCheckCallback(OnCheckCallback&& callback);
+
   /**
    * Start writing stats once thread-local storage is ready to receive them (see
    * ThreadLocalStoreImpl::initializeThreading).
@@ -62,6 +71,7 @@ public:
 
 private:
   static void onPrepareForCallback(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
+  static void onCheckForCallback(evwatch*, const evwatch_check_cb_info* info, void* arg);
   static void onPrepareForStats(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onCheckForStats(evwatch*, const evwatch_check_cb_info*, void* arg);
 
@@ -72,6 +82,8 @@ private:
   timeval prepare_time_{};   // timestamp immediately before polling
   timeval check_time_{};     // timestamp immediately after polling
   OnPrepareCallback callback_; // callback to be called from onPrepareForCallback()
+  // Callback to be called from onCheckForCallback().
+  OnCheckCallback check_callback_;
 };
 
 } // namespace Event
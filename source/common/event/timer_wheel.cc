@@ -0,0 +1,263 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+#include "envoy/common/scope_tracker.h"
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+constexpr uint32_t SlotMask = TimerWheel::Slots - 1;
+constexpr uint32_t WordsPerLevel = TimerWheel::Slots / 64;
+// About 136 years.
+constexpr int64_t MaxDelayMs = int64_t(INT32_MAX) * 1000;
+} // namespace
+
+class TimerWheel::CoarseTimerImpl : public Timer, public Link {
+public:
+  CoarseTimerImpl(TimerWheel& wheel, const TimerCb& cb, Dispatcher& dispatcher)
+      : wheel_(wheel), cb_(cb), dispatcher_(dispatcher) {
+    ASSERT(cb_);
+  }
+  ~CoarseTimerImpl() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override { wheel_.disable(*this); }
+  void enableTimer(const std::chrono::milliseconds& ms,
+                   const ScopeTrackedObject* object) override {
+    // Clip to a duration that can't overflow when converted, like TimerUtils::durationToTimeval().
+    enableDuration(std::chrono::milliseconds(std::min<int64_t>(ms.count(), MaxDelayMs)), object);
+  }
+  void enableHRTimer(const std::chrono::microseconds& us,
+                     const ScopeTrackedObject* object) override {
+    enableDuration(us, object);
+  }
+  bool enabled() override { return prev_ != nullptr; }
+
+  void fire() {
+    if (object_ == nullptr) {
+      cb_();
+      return;
+    }
+    ScopeTrackerScopeState scope(object_, dispatcher_);
+    object_ = nullptr;
+    cb_();
+  }
+
+  // The tick the timer expires at.
+  uint64_t expiry_{};
+
+private:
+  void enableDuration(const std::chrono::microseconds& d, const ScopeTrackedObject* object) {
+    if (d.count() < 0) {
+      throw EnvoyException(
+          fmt::format("Negative duration passed to enableTimer(): {}us", d.count()));
+    }
+    object_ = object;
+    wheel_.enable(*this, d);
+  }
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  Dispatcher& dispatcher_;
+  const ScopeTrackedObject* object_{};
+};
+
+TimerWheel::TimerWheel(Scheduler& base_scheduler, TimeSource& time_source,
+                       Dispatcher& dispatcher)
+    : time_source_(time_source), start_(time_source.monotonicTime()),
+      driver_timer_(base_scheduler.createTimer([this]() { onDriverTimer(); }, dispatcher)) {
+  for (auto& level : slots_) {
+    for (Slot& slot : level) {
+      slot.prev_ = slot.next_ = &slot;
+    }
+  }
+}
+
+TimerPtr TimerWheel::createTimer(const TimerCb& cb, Dispatcher& dispatcher) {
+  return std::make_unique<CoarseTimerImpl>(*this, cb, dispatcher);
+}
+
+uint64_t TimerWheel::currentTick() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                               start_)
+      .count();
+}
+
+void TimerWheel::enable(CoarseTimerImpl& timer, const std::chrono::microseconds& d) {
+  disable(timer);
+  const MonotonicTime::duration elapsed = time_source_.monotonicTime() - start_;
+  if (enabled_timers_ == 0 && !advancing_) {
+    // Nothing is pending, so there is no need to walk the ticks that went by since the wheel last
+    // advanced.
+    next_tick_ = std::max<uint64_t>(
+        next_tick_, std::chrono::floor<std::chrono::milliseconds>(elapsed).count());
+  }
+  // Round up, so that the timer doesn't fire before the full duration elapsed.
+  timer.expiry_ = std::chrono::ceil<std::chrono::milliseconds>(elapsed + d).count();
+  enabled_timers_++;
+  const uint64_t tick = place(timer);
+  if (!advancing_ && (!driver_tick_.has_value() || tick < *driver_tick_)) {
+    armDriverTimer();
+  }
+}
+
+void TimerWheel::disable(CoarseTimerImpl& timer) {
+  if (timer.prev_ != nullptr) {
+    unlink(timer);
+    enabled_timers_--;
+  }
+}
+
+uint64_t TimerWheel::place(CoarseTimerImpl& timer) {
+  // Timers that are overdue go to the slot processed next.
+  const uint64_t expiry = std::max(std::min(timer.expiry_, next_tick_ + MaxTicks), next_tick_);
+  const uint64_t delta = expiry - next_tick_;
+  uint32_t level = 0;
+  while (level + 1 < Levels && delta >> (SlotBits * (level + 1)) != 0) {
+    level++;
+  }
+  const uint32_t slot = (expiry >> (SlotBits * level)) & SlotMask;
+  link(slots_[level][slot], timer);
+  occupied_[level][slot / 64] |= uint64_t(1) << (slot % 64);
+  // The tick at which the slot expires or cascades.
+  return (expiry >> (SlotBits * level)) << (SlotBits * level);
+}
+
+absl::optional<uint64_t> TimerWheel::nextEventTick() {
+  absl::optional<uint64_t> next;
+  for (uint32_t level = 0; level < Levels; level++) {
+    // Slots of this level expire or cascade on multiples of 1 << shift ticks, when the ticks of
+    // all the lower levels wrap around.
+    const uint32_t shift = SlotBits * level;
+    const uint64_t base = ((next_tick_ + (uint64_t(1) << shift) - 1) >> shift) << shift;
+    const uint32_t from = (base >> shift) & SlotMask;
+    const absl::optional<uint32_t> slot = nextOccupiedSlot(level, from);
+    if (!slot.has_value()) {
+      continue;
+    }
+    const uint64_t tick = base + (uint64_t((*slot - from) & SlotMask) << shift);
+    if (!next.has_value() || tick < *next) {
+      next = tick;
+    }
+  }
+  return next;
+}
+
+absl::optional<uint32_t> TimerWheel::nextOccupiedSlot(uint32_t level, uint32_t from) {
+  // Look through the words of the level starting with the one of the first slot, and end with the
+  // slots of that word that come before it.
+  for (uint32_t i = 0; i <= WordsPerLevel; i++) {
+    const uint32_t word = ((from / 64) + i) % WordsPerLevel;
+    uint64_t bits = occupied_[level][word];
+    if (i == 0) {
+      bits &= ~uint64_t(0) << (from % 64);
+    } else if (i == WordsPerLevel) {
+      bits &= ~(~uint64_t(0) << (from % 64));
+    }
+    while (bits != 0) {
+      const uint32_t bit = __builtin_ctzll(bits);
+      const uint32_t slot = word * 64 + bit;
+      if (slots_[level][slot].next_ != &slots_[level][slot]) {
+        return slot;
+      }
+      // The timers of the slot were disabled since it was marked.
+      occupied_[level][word] &= ~(uint64_t(1) << bit);
+      bits &= bits - 1;
+    }
+  }
+  return absl::nullopt;
+}
+
+void TimerWheel::cascade(uint32_t level, uint32_t slot) {
+  Link timers;
+  moveAll(slots_[level][slot], timers);
+  occupied_[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+  while (timers.next_ != &timers) {
+    auto& timer = static_cast<CoarseTimerImpl&>(*timers.next_);
+    unlink(timer);
+    place(timer);
+  }
+}
+
+void TimerWheel::onDriverTimer() {
+  driver_tick_.reset();
+  const uint64_t now = currentTick();
+  advancing_ = true;
+  absl::optional<uint64_t> tick;
+  while ((tick = nextEventTick()).has_value() && *tick <= now) {
+    // Skip the ticks in between, which have nothing to expire or cascade.
+    next_tick_ = *tick;
+    const uint32_t index = next_tick_ & SlotMask;
+    if (index == 0) {
+      for (uint32_t level = 1; level < Levels; level++) {
+        const uint32_t slot = (next_tick_ >> (SlotBits * level)) & SlotMask;
+        cascade(level, slot);
+        if (slot != 0) {
+          break;
+        }
+      }
+    }
+
+    Link expired;
+    moveAll(slots_[0][index], expired);
+    occupied_[0][index / 64] &= ~(uint64_t(1) << (index % 64));
+    next_tick_++;
+    // Callbacks may disable, re-enable or free the timers that are still in the list.
+    while (expired.next_ != &expired) {
+      auto& timer = static_cast<CoarseTimerImpl&>(*expired.next_);
+      disable(timer);
+      timer.fire();
+    }
+  }
+  next_tick_ = std::max(next_tick_, now + 1);
+  advancing_ = false;
+  armDriverTimer();
+}
+
+void TimerWheel::armDriverTimer() {
+  driver_tick_ = nextEventTick();
+  if (!driver_tick_.has_value()) {
+    driver_timer_->disableTimer();
+    return;
+  }
+  const auto delay = std::chrono::ceil<std::chrono::microseconds>(
+      start_ + Tick * static_cast<int64_t>(*driver_tick_) - time_source_.monotonicTime());
+  driver_timer_->enableHRTimer(std::max(delay, std::chrono::microseconds(0)));
+}
+
+void TimerWheel::link(Link& head, Link& link) {
+  ASSERT(link.prev_ == nullptr);
+  link.prev_ = head.prev_;
+  link.next_ = &head;
+  head.prev_->next_ = &link;
+  head.prev_ = &link;
+}
+
+void TimerWheel::unlink(Link& link) {
+  link.prev_->next_ = link.next_;
+  link.next_->prev_ = link.prev_;
+  link.prev_ = link.next_ = nullptr;
+}
+
+void TimerWheel::moveAll(Link& from, Link& to) {
+  if (from.next_ == &from) {
+    to.prev_ = to.next_ = &to;
+    return;
+  }
+  to.next_ = from.next_;
+  to.prev_ = from.prev_;
+  to.next_->prev_ = &to;
+  to.prev_->next_ = &to;
+  from.prev_ = from.next_ = &from;
+}
+
+} // namespace Event
+} // namespace Envoy
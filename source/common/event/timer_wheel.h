@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Scheduler of coarse timers, kept in a hashed hierarchical timing wheel (Varghese and Lauck) with
+ * millisecond ticks. Enabling, re-enabling and disabling a timer are O(1), where timers of the
+ * underlying libevent scheduler cost O(log n) in its min-heap. In exchange, timers fire on tick
+ * boundaries: never early, but up to a tick late.
+ *
+ * Each of the Levels wheels has Slots slots; level 0 holds the timers expiring within Slots ticks,
+ * one slot per tick, and every further level covers Slots times more time per slot. When time
+ * reaches a slot of a higher level, its timers cascade down to lower ones. The wheel is driven by
+ * a single timer of the underlying scheduler, armed for the next tick at which a slot expires or
+ * cascades, so that a wheel of distant timers doesn't wake up the event loop every tick.
+ *
+ * Timers must be freed before the wheel, and the wheel belongs to the thread of its dispatcher.
+ */
+class TimerWheel : public Scheduler, NonCopyable {
+public:
+  TimerWheel(Scheduler& base_scheduler, TimeSource& time_source, Dispatcher& dispatcher);
+
+  // Scheduler
+  TimerPtr createTimer(const TimerCb& cb, Dispatcher& dispatcher) override;
+
+  static constexpr std::chrono::milliseconds Tick{1};
+  static constexpr uint32_t SlotBits = 8;
+  static constexpr uint32_t Slots = 1 << SlotBits;
+  static constexpr uint32_t Levels = 4;
+  // Timers further away than this are parked at the top level until they come into range.
+  static constexpr uint64_t MaxTicks = (uint64_t(1) << (SlotBits * Levels)) - 1;
+
+private:
+  class CoarseTimerImpl;
+
+  // A link of a circular doubly linked list. The lists of the slots have a sentinel link, timers
+  // are unlinked when their prev_ is nullptr.
+  struct Link {
+    Link* prev_{};
+    Link* next_{};
+  };
+
+  using Slot = Link;
+
+  uint64_t currentTick() const;
+  void enable(CoarseTimerImpl& timer, const std::chrono::microseconds& d);
+  void disable(CoarseTimerImpl& timer);
+  // Returns the tick at which the timer's slot expires or cascades.
+  uint64_t place(CoarseTimerImpl& timer);
+  absl::optional<uint64_t> nextEventTick();
+  absl::optional<uint32_t> nextOccupiedSlot(uint32_t level, uint32_t from);
+  void cascade(uint32_t level, uint32_t slot);
+  void onDriverTimer();
+  void armDriverTimer();
+
+  static void link(Link& head, Link& link);
+  static void unlink(Link& link);
+  static void moveAll(Link& from, Link& to);
+
+  TimeSource& time_source_;
+  const MonotonicTime start_;
+  TimerPtr driver_timer_;
+  std::array<std::array<Slot, Slots>, Levels> slots_;
+  // Slots that may be occupied. Bits are set when a timer is placed in a slot, and only cleared
+  // when the slot is found empty or expires, so that disabling a timer doesn't need to look at its
+  // neighbors.
+  std::array<std::array<uint64_t, Slots / 64>, Levels> occupied_{};
+  // The next tick to process: timers with an earlier expiry are due.
+  uint64_t next_tick_{};
+  // The tick the driver timer is armed for, if any.
+  absl::optional<uint64_t> driver_tick_;
+  uint64_t enabled_timers_{};
+  bool advancing_{};
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -36,7 +36,7 @@ CodecClient::CodecClient(Type type, Network::ClientConnectionPtr&& connection,
   connection_->connect();
 
   if (idle_timeout_) {
-    idle_timer_ = dispatcher.createTimer([this]() -> void { onIdleTimeout(); });
+    idle_timer_ = dispatcher.createCoarseTimer([this]() -> void { onIdleTimeout(); });
     enableIdleTimer();
   }
 
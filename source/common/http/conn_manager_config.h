@@ -55,6 +55,8 @@ namespace Http {
   COUNTER(downstream_rq_idle_timeout)                                                              \
   COUNTER(downstream_rq_non_relative_path)                                                         \
   COUNTER(downstream_rq_overload_close)                                                            \
+  COUNTER(downstream_rq_overload_reset)                                                            \
+  COUNTER(downstream_rq_overload_reset_bytes)                                                      \
   COUNTER(downstream_rq_response_before_rq_complete)                                               \
   COUNTER(downstream_rq_rx_reset)                                                                  \
   COUNTER(downstream_rq_timeout)                                                                   \
@@ -74,6 +76,7 @@ namespace Http {
   GAUGE(downstream_cx_upgrades_active, Accumulate)                                                 \
   GAUGE(downstream_rq_active, Accumulate)                                                          \
   HISTOGRAM(downstream_cx_length_ms, Milliseconds)                                                 \
+  HISTOGRAM(downstream_cx_read_size, Bytes)                                                        \
   HISTOGRAM(downstream_rq_time, Milliseconds)
 
 /**
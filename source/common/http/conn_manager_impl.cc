@@ -121,6 +121,8 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
                                  Server::OverloadActionNames::get().DisableHttpKeepAlive)
                            : Server::OverloadManager::getInactiveState()),
+      stream_memory_tracker_(
+          overload_manager ? &overload_manager->getThreadLocalStreamMemoryTracker() : nullptr),
       time_source_(time_source) {}
 
 const ResponseHeaderMap& ConnectionManagerImpl::continueHeader() {
@@ -141,7 +143,7 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().addConnectionCallbacks(*this);
 
   if (config_.idleTimeout()) {
-    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
         [this]() -> void { onIdleTimeout(); });
     connection_idle_timer_->enableTimer(config_.idleTimeout().value());
   }
@@ -157,7 +159,8 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().setConnectionStats(
       {stats_.named_.downstream_cx_rx_bytes_total_, stats_.named_.downstream_cx_rx_bytes_buffered_,
        stats_.named_.downstream_cx_tx_bytes_total_, stats_.named_.downstream_cx_tx_bytes_buffered_,
-       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_});
+       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_,
+       &stats_.named_.downstream_cx_read_size_});
 }
 
 ConnectionManagerImpl::~ConnectionManagerImpl() {
@@ -232,6 +235,9 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
     stream.stream_idle_timer_ = nullptr;
   }
   stream.disarmRequestTimeout();
+  if (stream.buffer_memory_account_ != nullptr) {
+    stream.buffer_memory_account_->clearResetCallback();
+  }
 
   stream.state_.destroyed_ = true;
   for (auto& filter : stream.decoder_filters_) {
@@ -583,15 +589,17 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.streamIdleTimeout().count()) {
     idle_timeout_ms_ = connection_manager_.config_.streamIdleTimeout();
-    stream_idle_timer_ = connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onIdleTimeout(); });
+    stream_idle_timer_ =
+        connection_manager_.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onIdleTimeout(); });
     resetIdleTimer();
   }
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout_ms_ = connection_manager_.config_.requestTimeout();
-    request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+    request_timer_ =
+        connection_manager.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onRequestTimeout(); });
     request_timer_->enableTimer(request_timeout_ms_, this);
   }
 
@@ -682,6 +690,30 @@ void ConnectionManagerImpl::ActiveStream::onStreamMaxDurationReached() {
   connection_manager_.doEndStream(*this);
 }
 
+void ConnectionManagerImpl::ActiveStream::onOverloadReset() {
+  const uint64_t buffered_bytes = buffer_memory_account_->balance();
+  ENVOY_STREAM_LOG(debug, "resetting stream buffering {} bytes to reclaim memory", *this,
+                   buffered_bytes);
+  connection_manager_.stats_.named_.downstream_rq_overload_reset_.inc();
+  connection_manager_.stats_.named_.downstream_rq_overload_reset_bytes_.add(buffered_bytes);
+  if (!stream_info_.responseCodeDetails().has_value()) {
+    stream_info_.setResponseCodeDetails(StreamInfo::ResponseCodeDetails::get().Overload);
+  }
+  connection_manager_.doEndStream(*this);
+}
+
+Buffer::BufferMemoryAccountSharedPtr ConnectionManagerImpl::ActiveStream::bufferMemoryAccount() {
+  Network::Connection& connection = connection_manager_.read_callbacks_->connection();
+  if (connection_manager_.stream_memory_tracker_ == nullptr) {
+    return connection.bufferMemoryAccount();
+  }
+  if (buffer_memory_account_ == nullptr) {
+    buffer_memory_account_ = connection_manager_.stream_memory_tracker_->createStreamAccount(
+        connection.bufferMemoryAccount(), [this]() { onOverloadReset(); });
+  }
+  return buffer_memory_account_;
+}
+
 void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
@@ -2326,6 +2358,7 @@ Buffer::WatermarkBufferPtr ConnectionManagerImpl::ActiveStreamDecoderFilter::cre
       [this]() -> void { this->requestDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->setAccount(parent_.bufferMemoryAccount());
   return buffer;
 }
 
@@ -2500,6 +2533,7 @@ Buffer::WatermarkBufferPtr ConnectionManagerImpl::ActiveStreamEncoderFilter::cre
       [this]() -> void { this->responseDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->setAccount(parent_.bufferMemoryAccount());
   return Buffer::WatermarkBufferPtr{buffer};
 }
 
@@ -679,6 +679,11 @@ private:
     void onRequestTimeout();
     // Per-stream alive duration reached.
     void onStreamMaxDurationReached();
+    // Per-stream reset to release buffered data under memory pressure.
+    void onOverloadReset();
+    // Return the account of the buffered request and response data, creating it on first use.
+    // Without a stream memory tracker, the data is charged to the connection account instead.
+    Buffer::BufferMemoryAccountSharedPtr bufferMemoryAccount();
     bool hasCachedRoute() { return cached_route_.has_value() && cached_route_.value(); }
 
     // Return local port of the connection.
@@ -736,6 +741,9 @@ private:
     // processing the next filter. The storage is created on demand. We need to store metadata
     // temporarily in the filter in case the filter has stopped all while processing headers.
     std::unique_ptr<MetadataMapVector> request_metadata_map_vector_{nullptr};
+    // Charged for the buffered request and response data, so that the stream can be reset when it
+    // buffers the most data of the worker and memory runs low.
+    Buffer::StreamBufferMemoryAccountSharedPtr buffer_memory_account_;
     uint32_t buffer_limit_{0};
     uint32_t high_watermark_count_{0};
     const std::string* decorated_operation_{nullptr};
@@ -802,6 +810,8 @@ private:
   // lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  // Tracks the stream accounts of the worker, or nullptr when there is no overload manager.
+  Http::StreamMemoryTracker* const stream_memory_tracker_;
   TimeSource& time_source_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_;
 };
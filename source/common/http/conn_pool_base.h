@@ -52,6 +52,7 @@ public:
   ConnectionPool::Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                          Http::ConnectionPool::Callbacks& callbacks) override;
   bool hasActiveConnections() const override;
+  bool maybePrefetch(double prefetch_ratio) override { return maybePrefetchImpl(prefetch_ratio); }
 
   // Creates a new PendingRequest and enqueues it into the request queue.
   ConnectionPool::Cancellable*
@@ -85,7 +86,7 @@ public:
          parent_.host()->cluster().stats().upstream_cx_rx_bytes_buffered_,
          parent_.host()->cluster().stats().upstream_cx_tx_bytes_total_,
          parent_.host()->cluster().stats().upstream_cx_tx_bytes_buffered_,
-         &parent_.host()->cluster().stats().bind_errors_, nullptr});
+         &parent_.host()->cluster().stats().bind_errors_, nullptr, nullptr});
   }
   void close() override { codec_client_->close(); }
   virtual Http::RequestEncoder& newStreamEncoder(Http::ResponseDecoder& response_decoder) PURE;
@@ -162,6 +162,17 @@ bool HeaderUtility::isConnect(const RequestHeaderMap& headers) {
   return headers.Method() && headers.Method()->value() == Http::Headers::get().MethodValues.Connect;
 }
 
+bool HeaderUtility::isIdempotentRequest(const RequestHeaderMap& headers) {
+  if (!headers.Method()) {
+    return false;
+  }
+  const absl::string_view method = headers.Method()->value().getStringView();
+  const auto& method_values = Http::Headers::get().MethodValues;
+  return method == method_values.Get || method == method_values.Head ||
+         method == method_values.Options || method == method_values.Trace ||
+         method == method_values.Put || method == method_values.Delete;
+}
+
 bool HeaderUtility::isConnectResponse(const RequestHeaderMapPtr& request_headers,
                                       const ResponseHeaderMap& response_headers) {
   return request_headers.get() && isConnect(*request_headers) &&
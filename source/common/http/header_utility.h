@@ -117,6 +117,12 @@ public:
    */
   static bool isConnect(const RequestHeaderMap& headers);
 
+  /**
+   * @brief a helper function to determine if the headers represent a request with an idempotent
+   * method, per https://tools.ietf.org/html/rfc7231#section-4.2.2.
+   */
+  static bool isIdempotentRequest(const RequestHeaderMap& headers);
+
   /**
    * @brief a helper function to determine if the headers represent an accepted CONNECT response.
    */
@@ -394,6 +394,7 @@ void RequestEncoderImpl::encodeHeaders(const RequestHeaderMap& headers, bool end
   if (Utility::isUpgrade(headers)) {
     upgrade_request_ = true;
   }
+  idempotent_request_ = HeaderUtility::isIdempotentRequest(headers);
 
   connection_.copyToBuffer(method->value().getStringView().data(), method->value().size());
   connection_.addCharToBuffer(' ');
@@ -407,6 +408,16 @@ void RequestEncoderImpl::encodeHeaders(const RequestHeaderMap& headers, bool end
   encodeHeadersBase(headers, absl::nullopt, end_stream);
 }
 
+void RequestEncoderImpl::resetStream(StreamResetReason reason) {
+  if (connection_.resetStreamCalled()) {
+    // Resetting any request resets the connection, and with it every request pipelined on it.
+    // Callbacks of those resets may reset the requests that the connection has not got to yet.
+    runResetCallbacks(reason);
+    return;
+  }
+  StreamEncoderImpl::resetStream(reason);
+}
+
 http_parser_settings ConnectionImpl::settings_{
     [](http_parser* parser) -> int {
       static_cast<ConnectionImpl*>(parser->data)->onMessageBeginBase();
@@ -469,6 +480,7 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
                      []() -> void { /* TODO(adisuissa): Handle overflow watermark */ }),
       max_headers_kb_(max_headers_kb), max_headers_count_(max_headers_count) {
   output_buffer_.setWatermarks(connection.bufferLimit());
+  output_buffer_.setAccount(connection.bufferMemoryAccount());
   http_parser_init(&parser_, type);
   parser_.data = this;
 }
@@ -1074,7 +1086,7 @@ ClientConnectionImpl::ClientConnectionImpl(Network::Connection& connection, Code
                      max_response_headers_count, formatter(settings), settings.enable_trailers_) {}
 
 bool ClientConnectionImpl::cannotHaveBody() {
-  if (pending_response_.has_value() && pending_response_.value().encoder_.headRequest()) {
+  if (!pending_responses_.empty() && pending_responses_.front().encoder_.headRequest()) {
     ASSERT(!pending_response_done_);
     return true;
   } else if (parser_.status_code == 204 || parser_.status_code == 304 ||
@@ -1091,30 +1103,39 @@ RequestEncoder& ClientConnectionImpl::newStream(ResponseDecoder& response_decode
   }
 
   // If reads were disabled due to flow control, we expect reads to always be enabled again before
-  // reusing this connection. This is done when the response is received.
-  ASSERT(connection_.readEnabled());
-
-  ASSERT(!pending_response_.has_value());
-  ASSERT(pending_response_done_);
-  pending_response_.emplace(*this, header_key_formatter_.get(), &response_decoder);
-  pending_response_done_ = false;
-  return pending_response_.value().encoder_;
+  // reusing this connection. This is done when the response is received. Pipelined requests are
+  // sent while an earlier response may still have reads disabled.
+  ASSERT(!pending_responses_.empty() || connection_.readEnabled());
+
+  if (pending_responses_.empty()) {
+    ASSERT(pending_response_done_);
+    pending_response_done_ = false;
+  }
+  pending_responses_.emplace_back(*this, header_key_formatter_.get(), &response_decoder);
+  RequestEncoderImpl& encoder = pending_responses_.back().encoder_;
+  // A pipelined request can start while the connection is above its high watermark, in which
+  // case it won't be told by onAboveHighWatermark().
+  if (connection_.aboveHighWatermark()) {
+    encoder.runHighWatermarkCallbacks();
+  }
+  return encoder;
 }
 
 int ClientConnectionImpl::onHeadersComplete() {
   // Handle the case where the client is closing a kept alive connection (by sending a 408
   // with a 'Connection: close' header). In this case we just let response flush out followed
   // by the remote close.
-  if (!pending_response_.has_value() && !resetStreamCalled()) {
+  if (pending_responses_.empty() && !resetStreamCalled()) {
     throw PrematureResponseException(static_cast<Http::Code>(parser_.status_code));
-  } else if (pending_response_.has_value()) {
+  } else if (!pending_responses_.empty()) {
     ASSERT(!pending_response_done_);
+    PendingResponse& response = pending_responses_.front();
     auto& headers = absl::get<ResponseHeaderMapPtr>(headers_or_trailers_);
     ENVOY_CONN_LOG(trace, "Client: onHeadersComplete size={}", connection_, headers->size());
     headers->setStatus(parser_.status_code);
 
     if (parser_.status_code >= 200 && parser_.status_code < 300 &&
-        pending_response_.value().encoder_.connectRequest()) {
+        response.encoder_.connectRequest()) {
       ENVOY_CONN_LOG(trace, "codec entering upgrade mode for CONNECT response.", connection_);
       handling_upgrade_ = true;
 
@@ -1151,7 +1172,7 @@ int ClientConnectionImpl::onHeadersComplete() {
       // http-parser treats 100 continue headers as their own complete response.
       // Swallow the spurious onMessageComplete and continue processing.
       ignore_message_complete_for_100_continue_ = true;
-      pending_response_.value().decoder_->decode100ContinueHeaders(std::move(headers));
+      response.decoder_->decode100ContinueHeaders(std::move(headers));
 
       // Reset to ensure no information from the continue headers is used for the response headers
       // in case the callee does not move the headers out.
@@ -1159,7 +1180,7 @@ int ClientConnectionImpl::onHeadersComplete() {
     } else if (cannotHaveBody() && !handling_upgrade_) {
       deferred_end_stream_headers_ = true;
     } else {
-      pending_response_.value().decoder_->decodeHeaders(std::move(headers), false);
+      response.decoder_->decodeHeaders(std::move(headers), false);
     }
   }
 
@@ -1169,17 +1190,17 @@ int ClientConnectionImpl::onHeadersComplete() {
 }
 
 bool ClientConnectionImpl::upgradeAllowed() const {
-  if (pending_response_.has_value()) {
-    return pending_response_->encoder_.upgradeRequest();
+  if (!pending_responses_.empty()) {
+    return pending_responses_.front().encoder_.upgradeRequest();
   }
   return false;
 }
 
 void ClientConnectionImpl::onBody(Buffer::Instance& data) {
   ASSERT(!deferred_end_stream_headers_);
-  if (pending_response_.has_value()) {
+  if (!pending_responses_.empty()) {
     ASSERT(!pending_response_done_);
-    pending_response_.value().decoder_->decodeData(data, false);
+    pending_responses_.front().decoder_->decodeData(data, false);
   }
 }
 
@@ -1189,12 +1210,12 @@ void ClientConnectionImpl::onMessageComplete() {
     ignore_message_complete_for_100_continue_ = false;
     return;
   }
-  if (pending_response_.has_value()) {
+  if (!pending_responses_.empty()) {
     ASSERT(!pending_response_done_);
     // After calling decodeData() with end stream set to true, we should no longer be able to reset.
-    PendingResponse& response = pending_response_.value();
-    // Encoder is used as part of decode* calls later in this function so pending_response_ can not
-    // be reset just yet. Preserve the state in pending_response_done_ instead.
+    PendingResponse& response = pending_responses_.front();
+    // Encoder is used as part of decode* calls later in this function so the response can not be
+    // removed just yet. Preserve the state in pending_response_done_ instead.
     pending_response_done_ = true;
 
     if (deferred_end_stream_headers_) {
@@ -1210,37 +1231,64 @@ void ClientConnectionImpl::onMessageComplete() {
     }
 
     // Reset to ensure no information from one requests persists to the next.
-    pending_response_.reset();
+    if (!pending_responses_.empty()) {
+      pending_responses_.pop_front();
+    }
+    pending_response_done_ = pending_responses_.empty();
     headers_or_trailers_.emplace<ResponseHeaderMapPtr>(nullptr);
   }
 }
 
 void ClientConnectionImpl::onResetStream(StreamResetReason reason) {
-  // Only raise reset if we did not already dispatch a complete response.
-  if (pending_response_.has_value() && !pending_response_done_) {
-    pending_response_.value().encoder_.runResetCallbacks(reason);
+  // Only raise reset if we did not already dispatch a complete response. The responses are moved
+  // out first, as the reset callbacks may close the connection. If the response at the front has
+  // already been dispatched in full, the first request reset here was also queued behind it.
+  bool awaiting_earlier_response = pending_response_done_;
+  std::list<PendingResponse> responses;
+  auto first_reset = pending_responses_.begin();
+  if (first_reset != pending_responses_.end() && pending_response_done_) {
+    ++first_reset;
+  }
+  responses.splice(responses.end(), pending_responses_, first_reset, pending_responses_.end());
+  if (pending_responses_.empty()) {
     pending_response_done_ = true;
-    pending_response_.reset();
+  }
+
+  for (PendingResponse& response : responses) {
+    // Requests queued behind another response were never answered, so idempotent ones are reset
+    // as refused streams, which can safely be retried.
+    response.encoder_.runResetCallbacks(awaiting_earlier_response &&
+                                                response.encoder_.idempotentRequest()
+                                            ? StreamResetReason::RemoteRefusedStreamReset
+                                            : reason);
+    awaiting_earlier_response = true;
   }
 }
 
 void ClientConnectionImpl::sendProtocolError(absl::string_view details) {
-  if (pending_response_.has_value()) {
+  if (!pending_responses_.empty()) {
     ASSERT(!pending_response_done_);
-    pending_response_.value().encoder_.setDetails(details);
+    pending_responses_.front().encoder_.setDetails(details);
   }
 }
 
 void ClientConnectionImpl::onAboveHighWatermark() {
   // This should never happen without an active stream/request.
-  pending_response_.value().encoder_.runHighWatermarkCallbacks();
+  ASSERT(!pending_responses_.empty());
+  for (PendingResponse& response : pending_responses_) {
+    response.encoder_.runHighWatermarkCallbacks();
+  }
 }
 
 void ClientConnectionImpl::onBelowLowWatermark() {
   // This can get called without an active stream/request when the response completion causes us to
   // close the connection, but in doing so go below low watermark.
-  if (pending_response_.has_value() && !pending_response_done_) {
-    pending_response_.value().encoder_.runLowWatermarkCallbacks();
+  auto it = pending_responses_.begin();
+  if (it != pending_responses_.end() && pending_response_done_) {
+    ++it;
+  }
+  for (; it != pending_responses_.end(); ++it) {
+    it->encoder_.runLowWatermarkCallbacks();
   }
 }
 
@@ -147,15 +147,20 @@ public:
   bool upgradeRequest() const { return upgrade_request_; }
   bool headRequest() const { return head_request_; }
   bool connectRequest() const { return connect_request_; }
+  bool idempotentRequest() const { return idempotent_request_; }
 
   // Http::RequestEncoder
   void encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
   void encodeTrailers(const RequestTrailerMap& trailers) override { encodeTrailersBase(trailers); }
 
+  // Http::Stream
+  void resetStream(StreamResetReason reason) override;
+
 private:
   bool upgrade_request_{};
   bool head_request_{};
   bool connect_request_{};
+  bool idempotent_request_{};
 };
 
 /**
@@ -579,12 +584,15 @@ private:
     }
   }
 
-  absl::optional<PendingResponse> pending_response_;
-  // TODO(mattklein123): The following bool tracks whether a pending response is complete before
-  // dispatching callbacks. This is needed so that pending_response_ stays valid during callbacks
-  // in order to access the stream, but to avoid invoking callbacks that shouldn't be called once
-  // the response is complete. The existence of this variable is hard to reason about and it should
-  // be combined with pending_response_ somehow in a follow up cleanup.
+  // The responses to the requests sent on this connection, in the order the requests were sent.
+  // The front one is the response being received. Requests are only sent ahead of the responses to
+  // earlier ones when the connection pool pipelines them.
+  std::list<PendingResponse> pending_responses_;
+  // TODO(mattklein123): The following bool tracks whether the front pending response is complete
+  // before dispatching callbacks. This is needed so that it stays valid during callbacks in order
+  // to access the stream, but to avoid invoking callbacks that shouldn't be called once the
+  // response is complete. The existence of this variable is hard to reason about and it should be
+  // combined with pending_responses_ somehow in a follow up cleanup.
   bool pending_response_done_{true};
   // Set true between receiving 100-Continue headers and receiving the spurious onMessageComplete.
   bool ignore_message_complete_for_100_continue_{};
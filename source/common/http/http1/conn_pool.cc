@@ -1,5 +1,6 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -15,6 +16,7 @@
 #include "common/http/codes.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
+#include "common/http/utility.h"
 #include "common/runtime/runtime_features.h"
 
 #include "absl/strings/match.h"
@@ -45,27 +47,50 @@ void ConnPoolImpl::onDownstreamReset(ActiveClient& client) {
   client.codec_client_->close();
 }
 
+void ConnPoolImpl::onEncodeComplete(ActiveClient& client) {
+  // A connection is kept busy while a request is being encoded. Once an idempotent request is
+  // fully sent, the next one may be pipelined behind it.
+  if (client.state_ == ActiveClient::State::BUSY && client.readyForNewRequest()) {
+    ENVOY_CONN_LOG(debug, "request complete, connection can pipeline", *client.codec_client_);
+    transitionActiveClientState(client, ActiveClient::State::READY);
+    if (!pending_requests_.empty()) {
+      scheduleOnUpstreamReady();
+    }
+  }
+}
+
 void ConnPoolImpl::onResponseComplete(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "response complete", *client.codec_client_);
 
-  if (!client.stream_wrapper_->encode_complete_) {
+  StreamWrapper& stream_wrapper = *client.stream_wrappers_.front();
+  if (!stream_wrapper.encode_complete_) {
     ENVOY_CONN_LOG(debug, "response before request complete", *client.codec_client_);
     onDownstreamReset(client);
-  } else if (client.stream_wrapper_->close_connection_ || client.codec_client_->remoteClosed()) {
+  } else if (stream_wrapper.close_connection_ || client.codec_client_->remoteClosed()) {
     ENVOY_CONN_LOG(debug, "saw upstream close connection", *client.codec_client_);
     onDownstreamReset(client);
   } else {
-    client.stream_wrapper_.reset();
-
-    if (!pending_requests_.empty() && !upstream_ready_enabled_) {
-      upstream_ready_enabled_ = true;
-      upstream_ready_cb_->scheduleCallbackCurrentIteration();
+    // Take the wrapper out of the list before destroying it, as its destructor may look at the
+    // requests still on the connection.
+    StreamWrapperPtr completed = std::move(client.stream_wrappers_.front());
+    client.stream_wrappers_.pop_front();
+    completed.reset();
+
+    if (!pending_requests_.empty()) {
+      scheduleOnUpstreamReady();
     }
 
     checkForDrained();
   }
 }
 
+void ConnPoolImpl::scheduleOnUpstreamReady() {
+  if (!upstream_ready_enabled_) {
+    upstream_ready_enabled_ = true;
+    upstream_ready_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
 ConnPoolImpl::StreamWrapper::StreamWrapper(ResponseDecoder& response_decoder, ActiveClient& parent)
     : RequestEncoderWrapper(parent.codec_client_->newStream(*this)),
       ResponseDecoderWrapper(response_decoder), parent_(parent) {
@@ -80,7 +105,16 @@ ConnPoolImpl::StreamWrapper::~StreamWrapper() {
   parent_.parent().onRequestClosed(parent_, true);
 }
 
-void ConnPoolImpl::StreamWrapper::onEncodeComplete() { encode_complete_ = true; }
+void ConnPoolImpl::StreamWrapper::encodeHeaders(const RequestHeaderMap& headers,
+                                                bool end_stream) {
+  idempotent_ = HeaderUtility::isIdempotentRequest(headers) && !Utility::isUpgrade(headers);
+  RequestEncoderWrapper::encodeHeaders(headers, end_stream);
+}
+
+void ConnPoolImpl::StreamWrapper::onEncodeComplete() {
+  encode_complete_ = true;
+  parent_.parent().onEncodeComplete(parent_);
+}
 
 void ConnPoolImpl::StreamWrapper::decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) {
   if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.fixed_connection_close")) {
@@ -115,19 +149,45 @@ void ConnPoolImpl::StreamWrapper::onDecodeComplete() {
 ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
     : Envoy::Http::ActiveClient(
           parent, parent.host_->cluster().maxRequestsPerConnection(),
-          1 // HTTP1 always has a concurrent-request-limit of 1 per connection.
-      ) {
+          // Without pipelining, HTTP1 has a concurrent-request-limit of 1 per connection.
+          parent.host_->cluster().http1Settings().max_pipelined_requests_) {
   parent.host_->cluster().stats().upstream_cx_http1_total_.inc();
 }
 
+uint64_t ConnPoolImpl::ActiveClient::effectiveConcurrentRequestLimit() const {
+  // Whether requests can be pipelined depends on the requests already sent, so a connecting client
+  // only counts for one request. Otherwise pending requests would wait for a single connection
+  // rather than each opening their own. Pipelining only adds capacity once connected.
+  return std::min<uint64_t>(remaining_requests_, 1);
+}
+
 bool ConnPoolImpl::ActiveClient::closingWithIncompleteRequest() const {
-  return (stream_wrapper_ != nullptr) && (!stream_wrapper_->decode_complete_);
+  return std::any_of(stream_wrappers_.begin(), stream_wrappers_.end(),
+                     [](const StreamWrapperPtr& wrapper) { return !wrapper->decode_complete_; });
+}
+
+bool ConnPoolImpl::ActiveClient::readyForNewRequest() const {
+  if (stream_wrappers_.size() >= concurrent_request_limit_) {
+    return false;
+  }
+  if (stream_wrappers_.empty()) {
+    return true;
+  }
+  // A request is only pipelined behind requests which have been fully sent and can be safely
+  // retried should the connection close before they are answered.
+  return stream_wrappers_.back()->encode_complete_ &&
+         std::all_of(stream_wrappers_.begin(), stream_wrappers_.end(),
+                     [](const StreamWrapperPtr& wrapper) { return wrapper->idempotent_; });
 }
 
 RequestEncoder& ConnPoolImpl::ActiveClient::newStreamEncoder(ResponseDecoder& response_decoder) {
-  ASSERT(!stream_wrapper_);
-  stream_wrapper_ = std::make_unique<StreamWrapper>(response_decoder, *this);
-  return *stream_wrapper_;
+  ASSERT(stream_wrappers_.empty() || readyForNewRequest());
+  stream_wrappers_.push_back(std::make_unique<StreamWrapper>(response_decoder, *this));
+  if (state_ == State::READY) {
+    // Nothing can be pipelined behind this request until it has been encoded.
+    parent().transitionActiveClientState(*this, State::BUSY);
+  }
+  return *stream_wrappers_.back();
 }
 
 CodecClientPtr ProdConnPoolImpl::createCodecClient(Upstream::Host::CreateConnectionData& data) {
@@ -42,6 +42,7 @@ protected:
     ~StreamWrapper() override;
 
     // StreamEncoderWrapper
+    void encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
     void onEncodeComplete() override;
 
     // StreamDecoderWrapper
@@ -57,6 +58,9 @@ protected:
     void onBelowWriteBufferLowWatermark() override {}
 
     ActiveClient& parent_;
+    // True if the request may be followed by other requests on the same connection before its
+    // response is received.
+    bool idempotent_{};
     bool encode_complete_{};
     bool close_connection_{};
     bool decode_complete_{};
@@ -71,14 +75,20 @@ protected:
     ConnPoolImpl& parent() { return static_cast<ConnPoolImpl&>(parent_); }
 
     // ConnPoolImplBase::ActiveClient
+    uint64_t effectiveConcurrentRequestLimit() const override;
     bool closingWithIncompleteRequest() const override;
+    bool readyForNewRequest() const override;
     RequestEncoder& newStreamEncoder(ResponseDecoder& response_decoder) override;
 
-    StreamWrapperPtr stream_wrapper_;
+    // The requests on this connection, in the order they were sent. There is more than one only
+    // when requests are pipelined.
+    std::list<StreamWrapperPtr> stream_wrappers_;
   };
 
   void onDownstreamReset(ActiveClient& client);
+  void onEncodeComplete(ActiveClient& client);
   void onResponseComplete(ActiveClient& client);
+  void scheduleOnUpstreamReady();
 
   Event::SchedulableCallbackPtr upstream_ready_cb_;
   bool upstream_ready_enabled_{false};
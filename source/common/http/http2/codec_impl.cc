@@ -1,5 +1,7 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -13,6 +15,7 @@
 #include "common/common/cleanup.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/http/codes.h"
 #include "common/http/exception.h"
@@ -100,6 +103,8 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   if (buffer_limit > 0) {
     setWriteBufferWatermarks(buffer_limit / 2, buffer_limit);
   }
+  pending_recv_data_.setAccount(parent_.connection_.bufferMemoryAccount());
+  pending_send_data_.setAccount(parent_.connection_.bufferMemoryAccount());
 }
 
 ConnectionImpl::StreamImpl::~StreamImpl() { ASSERT(stream_idle_timer_ == nullptr); }
@@ -110,7 +115,64 @@ void ConnectionImpl::StreamImpl::destroy() {
   parent_.stats_.pending_send_bytes_.sub(pending_send_data_.length());
 }
 
-static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
+// Headers whose values are usually unique to each request. Adding them to the HPACK dynamic table
+// would only evict entries that later header blocks could reuse, so they are sent as never indexed
+// literals. The request and client trace IDs are built-in inline headers; the remaining tracing
+// headers are registered here so that they can be found without comparing every header name.
+using NeverIndexedHandle =
+    CustomInlineHeaderRegistry::Handle<CustomInlineHeaderRegistry::Type::RequestHeaders>;
+using NeverIndexedHandles = std::array<NeverIndexedHandle, 10>;
+using RegisterNeverIndexedHeader =
+    RegisterCustomInlineHeader<CustomInlineHeaderRegistry::Type::RequestHeaders>;
+
+RegisterNeverIndexedHeader ot_span_context_handle(Headers::get().OtSpanContext);
+RegisterNeverIndexedHeader traceparent_handle(LowerCaseString("traceparent"));
+RegisterNeverIndexedHeader b3_handle(LowerCaseString("b3"));
+RegisterNeverIndexedHeader b3_trace_id_handle(LowerCaseString("x-b3-traceid"));
+RegisterNeverIndexedHeader b3_span_id_handle(LowerCaseString("x-b3-spanid"));
+RegisterNeverIndexedHeader b3_parent_span_id_handle(LowerCaseString("x-b3-parentspanid"));
+RegisterNeverIndexedHeader amzn_trace_id_handle(LowerCaseString("x-amzn-trace-id"));
+RegisterNeverIndexedHeader datadog_trace_id_handle(LowerCaseString("x-datadog-trace-id"));
+RegisterNeverIndexedHeader datadog_parent_id_handle(LowerCaseString("x-datadog-parent-id"));
+RegisterNeverIndexedHeader grpc_trace_bin_handle(LowerCaseString("grpc-trace-bin"));
+
+static const NeverIndexedHandles& neverIndexedRequestHandles() {
+  CONSTRUCT_ON_FIRST_USE(
+      NeverIndexedHandles,
+      {ot_span_context_handle.handle(), traceparent_handle.handle(), b3_handle.handle(),
+       b3_trace_id_handle.handle(), b3_span_id_handle.handle(), b3_parent_span_id_handle.handle(),
+       amzn_trace_id_handle.handle(), datadog_trace_id_handle.handle(),
+       datadog_parent_id_handle.handle(), grpc_trace_bin_handle.handle()});
+}
+
+ConnectionImpl::StreamImpl::NeverIndexedEntries
+ConnectionImpl::StreamImpl::neverIndexedEntries(const RequestHeaderMap& headers) {
+  NeverIndexedEntries entries;
+  for (const HeaderEntry* entry : {headers.RequestId(), headers.ClientTraceId()}) {
+    if (entry != nullptr) {
+      entries.push_back(entry);
+    }
+  }
+  for (const NeverIndexedHandle handle : neverIndexedRequestHandles()) {
+    const HeaderEntry* entry = headers.getInline(handle);
+    if (entry != nullptr) {
+      entries.push_back(entry);
+    }
+  }
+  return entries;
+}
+
+ConnectionImpl::StreamImpl::NeverIndexedEntries
+ConnectionImpl::StreamImpl::neverIndexedEntries(const ResponseHeaderMap& headers) {
+  NeverIndexedEntries entries;
+  if (headers.RequestId() != nullptr) {
+    entries.push_back(headers.RequestId());
+  }
+  return entries;
+}
+
+static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header,
+                         bool never_index) {
   uint8_t flags = 0;
   if (header.key().isReference()) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
@@ -118,6 +180,9 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
   if (header.value().isReference()) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_VALUE;
   }
+  if (never_index) {
+    flags |= NGHTTP2_NV_FLAG_NO_INDEX;
+  }
   const absl::string_view header_key = header.key().getStringView();
   const absl::string_view header_value = header.value().getStringView();
   headers.push_back({remove_const<uint8_t>(header_key.data()),
@@ -126,15 +191,24 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 }
 
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
-                                              const HeaderMap& headers) {
+                                              const HeaderMap& headers,
+                                              const NeverIndexedEntries& never_indexed) {
+  struct BuildContext {
+    std::vector<nghttp2_nv>& final_headers_;
+    const NeverIndexedEntries& never_indexed_;
+  };
+  BuildContext context{final_headers, never_indexed};
   final_headers.reserve(headers.size());
   headers.iterate(
       [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
-        std::vector<nghttp2_nv>* final_headers = static_cast<std::vector<nghttp2_nv>*>(context);
-        insertHeader(*final_headers, header);
+        auto* build_context = static_cast<BuildContext*>(context);
+        const NeverIndexedEntries& never_indexed = build_context->never_indexed_;
+        insertHeader(build_context->final_headers_, header,
+                     std::find(never_indexed.begin(), never_indexed.end(), &header) !=
+                         never_indexed.end());
         return HeaderMap::Iterate::Continue;
       },
-      &final_headers);
+      &context);
 }
 
 void ConnectionImpl::ServerStreamImpl::encode100ContinueHeaders(const ResponseHeaderMap& headers) {
@@ -169,7 +243,7 @@ void ConnectionImpl::ClientStreamImpl::encodeHeaders(const RequestHeaderMap& hea
     modified_headers = createHeaderMap<RequestHeaderMapImpl>(headers);
     upgrade_type_ = std::string(headers.getUpgradeValue());
     Http::Utility::transformUpgradeRequestFromH1toH2(*modified_headers);
-    buildHeaders(final_headers, *modified_headers);
+    buildHeaders(final_headers, *modified_headers, neverIndexedEntries(*modified_headers));
   } else if (headers.Method() && headers.Method()->value() == "CONNECT") {
     // If this is not an upgrade style connect (above branch) it is a bytestream
     // connect and should have :path and :protocol set accordingly
@@ -182,9 +256,9 @@ void ConnectionImpl::ClientStreamImpl::encodeHeaders(const RequestHeaderMap& hea
     if (!headers.Path()) {
       modified_headers->setPath("/");
     }
-    buildHeaders(final_headers, *modified_headers);
+    buildHeaders(final_headers, *modified_headers, neverIndexedEntries(*modified_headers));
   } else {
-    buildHeaders(final_headers, headers);
+    buildHeaders(final_headers, headers, neverIndexedEntries(headers));
   }
   encodeHeadersBase(final_headers, end_stream);
 }
@@ -201,9 +275,9 @@ void ConnectionImpl::ServerStreamImpl::encodeHeaders(const ResponseHeaderMap& he
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<ResponseHeaderMapImpl>(headers);
     Http::Utility::transformUpgradeResponseFromH1toH2(*modified_headers);
-    buildHeaders(final_headers, *modified_headers);
+    buildHeaders(final_headers, *modified_headers, neverIndexedEntries(*modified_headers));
   } else {
-    buildHeaders(final_headers, headers);
+    buildHeaders(final_headers, headers, neverIndexedEntries(headers));
   }
   encodeHeadersBase(final_headers, end_stream);
 }
@@ -525,8 +599,19 @@ Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
   // Make sure that dispatching_ is set to false after dispatching, even when
   // ConnectionImpl::dispatch returns early or throws an exception (consider removing if there is a
   // single return after exception removal (#10878)).
-  Cleanup cleanup([this]() { dispatching_ = false; });
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+  Cleanup cleanup([this]() {
+    dispatching_ = false;
+    dispatch_input_ = nullptr;
+    dispatch_slice_.reset();
+  });
+  // nghttp2 hands DATA payloads to onData() as pointers into the slice it is given. Dispatch the
+  // input one slice at a time, so that large payloads can be referenced from the streams' receive
+  // buffers rather than copied, while each referenced payload only keeps its own slice alive.
+  const uint64_t length = data.length();
+  dispatch_input_ = &data;
+  while (data.length() > 0) {
+    const Buffer::RawSlice slice = data.getRawSlices(1).front();
+    dispatch_slice_length_ = slice.len_;
     dispatching_ = true;
     ssize_t rc =
         nghttp2_session_mem_recv(session_, static_cast<const uint8_t*>(slice.mem_), slice.len_);
@@ -539,10 +624,16 @@ Http::Status ConnectionImpl::innerDispatch(Buffer::Instance& data) {
     }
 
     dispatching_ = false;
+    // A slice that payloads are referenced from has already been moved out of the input.
+    if (dispatch_slice_ != nullptr) {
+      dispatch_slice_.reset();
+    } else {
+      data.drain(slice.len_);
+    }
   }
 
-  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, data.length());
-  data.drain(data.length());
+  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, length);
+  dispatch_input_ = nullptr;
 
   // Decoding incoming frames can generate outbound frames so flush pending.
   sendPendingFrames();
@@ -557,7 +648,18 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
-  stream->pending_recv_data_.add(data, len);
+  if (len >= MinReferencedDataLength && referenceDispatchSlice(len)) {
+    // The fragment keeps the dispatched slice alive until the stream's consumer drains it.
+    auto fragment = new Buffer::BufferFragmentImpl(
+        data, len,
+        [slice = dispatch_slice_](const void*, size_t,
+                                  const Buffer::BufferFragmentImpl* this_fragment) {
+          delete this_fragment;
+        });
+    stream->pending_recv_data_.addBufferFragment(*fragment);
+  } else {
+    stream->pending_recv_data_.add(data, len);
+  }
   // Update the window to the peer unless some consumer of this stream's data has hit a flow control
   // limit and disabled reads on this stream
   if (!stream->buffers_overrun()) {
@@ -568,6 +670,21 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   return 0;
 }
 
+bool ConnectionImpl::referenceDispatchSlice(size_t len) {
+  // The slice's allocation is at least its content, so rule out small payloads before moving it.
+  if (dispatch_input_ == nullptr || len * 2 < dispatch_slice_length_) {
+    return false;
+  }
+  if (dispatch_slice_ == nullptr) {
+    dispatch_slice_ = std::make_shared<Buffer::OwnedImpl>();
+    dispatch_slice_->move(*dispatch_input_, dispatch_slice_length_);
+    ASSERT(dispatch_slice_->length() == dispatch_slice_length_);
+  }
+  // As the payload fills at least half of the slice's allocation, the memory it pins is at most
+  // twice what the receive buffer's watermarks account for.
+  return len * 2 >= dispatch_slice_->frontSliceCapacity();
+}
+
 void ConnectionImpl::goAway() {
   int rc = nghttp2_submit_goaway(session_, NGHTTP2_FLAG_NONE,
                                  nghttp2_session_get_last_proc_stream_id(session_),
@@ -588,6 +705,10 @@ int ConnectionImpl::onBeforeFrameReceived(const nghttp2_frame_hd* hd) {
   ENVOY_CONN_LOG(trace, "about to recv frame type={}, flags={}", connection_,
                  static_cast<uint64_t>(hd->type), static_cast<uint64_t>(hd->flags));
 
+  if (hd->type == NGHTTP2_HEADERS || hd->type == NGHTTP2_CONTINUATION) {
+    stats_.rx_header_bytes_compressed_.add(hd->length);
+  }
+
   // Track all the frames without padding here, since this is the only callback we receive
   // for some of them (e.g. CONTINUATION frame, frames sent on closed streams, etc.).
   // HEADERS frame is tracked in onBeginHeaders(), DATA frame is tracked in onFrameReceived().
@@ -750,6 +871,15 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
 
   case NGHTTP2_HEADERS:
   case NGHTTP2_DATA: {
+    if (frame->hd.type == NGHTTP2_HEADERS) {
+      // hd.length covers the whole header block, including any CONTINUATION frames.
+      uint64_t header_bytes = 0;
+      for (size_t i = 0; i < frame->headers.nvlen; i++) {
+        header_bytes += frame->headers.nva[i].namelen + frame->headers.nva[i].valuelen;
+      }
+      stats_.tx_header_bytes_.add(header_bytes);
+      stats_.tx_header_bytes_compressed_.add(frame->hd.length);
+    }
     StreamImpl* stream = getStream(frame->hd.stream_id);
     stream->local_end_stream_sent_ = frame->hd.flags & NGHTTP2_FLAG_END_STREAM;
     break;
@@ -1093,6 +1223,8 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
       callbacks_,
       [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
          const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
+        static_cast<ConnectionImpl*>(user_data)->stats_.rx_header_bytes_.add(name_length +
+                                                                             value_length);
         // TODO PERF: Can reference count here to avoid copies.
         HeaderString name;
         name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
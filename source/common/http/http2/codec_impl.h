@@ -25,6 +25,7 @@
 #include "common/http/status.h"
 #include "common/http/utility.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
 #include "nghttp2/nghttp2.h"
 
@@ -185,7 +186,12 @@ protected:
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
     int onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
-    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
+    // Entries of a header map that must be encoded as never indexed literals.
+    using NeverIndexedEntries = absl::InlinedVector<const HeaderEntry*, 4>;
+    static NeverIndexedEntries neverIndexedEntries(const RequestHeaderMap& headers);
+    static NeverIndexedEntries neverIndexedEntries(const ResponseHeaderMap& headers);
+    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers,
+                             const NeverIndexedEntries& never_indexed = {});
     void saveHeader(HeaderString&& name, HeaderString&& value);
     void encodeHeadersBase(const std::vector<nghttp2_nv>& final_headers, bool end_stream);
     virtual void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -507,6 +513,21 @@ private:
   void releaseOutboundFrame();
   void releaseOutboundControlFrame();
 
+  // Takes ownership of the input slice nghttp2 is reading, if it hasn't already, and returns true
+  // if a DATA payload of len bytes in it should be referenced rather than copied.
+  bool referenceDispatchSlice(size_t len);
+
+  // DATA payloads of at least this many bytes, and at least half of the memory allocated for the
+  // slice they arrived in, are referenced from that slice rather than copied. Smaller payloads are
+  // copied, so that they don't each pin a slice.
+  static constexpr size_t MinReferencedDataLength = 4096;
+
+  // The input being dispatched, and the length of its first slice, which nghttp2 is reading.
+  Buffer::Instance* dispatch_input_{};
+  size_t dispatch_slice_length_{};
+  // The slice nghttp2 is reading, once it has been moved out of the input because a DATA payload
+  // is referenced from it.
+  std::shared_ptr<Buffer::OwnedImpl> dispatch_slice_;
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
@@ -22,11 +22,15 @@ namespace Http2 {
   COUNTER(outbound_control_flood)                                                                  \
   COUNTER(outbound_flood)                                                                          \
   COUNTER(requests_rejected_with_underscores_in_headers)                                           \
+  COUNTER(rx_header_bytes)                                                                         \
+  COUNTER(rx_header_bytes_compressed)                                                              \
   COUNTER(rx_messaging_error)                                                                      \
   COUNTER(rx_reset)                                                                                \
   COUNTER(too_many_header_frames)                                                                  \
   COUNTER(trailers)                                                                                \
   COUNTER(tx_flush_timeout)                                                                        \
+  COUNTER(tx_header_bytes)                                                                         \
+  COUNTER(tx_header_bytes_compressed)                                                              \
   COUNTER(tx_reset)                                                                                \
   GAUGE(streams_active, Accumulate)                                                                \
   GAUGE(pending_send_bytes, Accumulate)
@@ -0,0 +1,103 @@
+#include "common/http/stream_memory_tracker_impl.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+class StreamMemoryTrackerImpl::Account : public Buffer::StreamBufferMemoryAccount, NonCopyable {
+public:
+  Account(StreamMemoryTrackerImpl& tracker, Buffer::BufferMemoryAccountSharedPtr parent,
+          Buffer::StreamResetCb reset_cb)
+      : tracker_(&tracker), parent_(std::move(parent)), reset_cb_(std::move(reset_cb)) {
+    tracker_->accounts_.insert(this);
+  }
+  ~Account() override { untrack(); }
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override {
+    balance_ += amount;
+    if (parent_ != nullptr) {
+      parent_->charge(amount);
+    }
+  }
+  void credit(uint64_t amount) override {
+    ASSERT(balance_ >= amount);
+    balance_ -= amount;
+    if (parent_ != nullptr) {
+      parent_->credit(amount);
+    }
+  }
+  uint64_t balance() const override { return balance_; }
+
+  // Buffer::StreamBufferMemoryAccount
+  void clearResetCallback() override { untrack(); }
+
+  void reset() {
+    // Untrack first, as the callback may destroy the account.
+    Buffer::StreamResetCb reset_cb = std::move(reset_cb_);
+    untrack();
+    reset_cb();
+  }
+
+  // Called when the tracker goes away before the account.
+  void detach() {
+    tracker_ = nullptr;
+    reset_cb_ = nullptr;
+  }
+
+private:
+  void untrack() {
+    if (tracker_ != nullptr) {
+      tracker_->accounts_.erase(this);
+      detach();
+    }
+  }
+
+  StreamMemoryTrackerImpl* tracker_;
+  const Buffer::BufferMemoryAccountSharedPtr parent_;
+  Buffer::StreamResetCb reset_cb_;
+  uint64_t balance_{};
+};
+
+StreamMemoryTrackerImpl::~StreamMemoryTrackerImpl() {
+  for (Account* account : accounts_) {
+    account->detach();
+  }
+}
+
+Buffer::StreamBufferMemoryAccountSharedPtr
+StreamMemoryTrackerImpl::createStreamAccount(const Buffer::BufferMemoryAccountSharedPtr& parent,
+                                             Buffer::StreamResetCb reset_cb) {
+  return std::make_shared<Account>(*this, parent, std::move(reset_cb));
+}
+
+uint64_t StreamMemoryTrackerImpl::resetLargestStreams(uint32_t max_reset,
+                                                      uint64_t min_reset_bytes) {
+  std::vector<std::pair<uint64_t, Account*>> candidates;
+  for (Account* account : accounts_) {
+    if (account->balance() > 0 && account->balance() >= min_reset_bytes) {
+      candidates.emplace_back(account->balance(), account);
+    }
+  }
+
+  const size_t num_reset = std::min<size_t>(max_reset, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + num_reset, candidates.end(),
+                    [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  uint64_t reset_bytes = 0;
+  for (size_t i = 0; i < num_reset; i++) {
+    // Resetting a stream may end others, e.g. by closing their connection, which untracks them.
+    if (!accounts_.contains(candidates[i].second)) {
+      continue;
+    }
+    reset_bytes += candidates[i].first;
+    candidates[i].second->reset();
+  }
+  return reset_bytes;
+}
+
+} // namespace Http
+} // namespace Envoy
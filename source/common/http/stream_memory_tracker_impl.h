@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/http/stream_memory_tracker.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Tracker that keeps the accounts of the streams of a thread in a set, and sorts them by balance
+ * only when streams are to be reset.
+ */
+class StreamMemoryTrackerImpl : public StreamMemoryTracker, NonCopyable {
+public:
+  ~StreamMemoryTrackerImpl() override;
+
+  // Http::StreamMemoryTracker
+  Buffer::StreamBufferMemoryAccountSharedPtr
+  createStreamAccount(const Buffer::BufferMemoryAccountSharedPtr& parent,
+                      Buffer::StreamResetCb reset_cb) override;
+  uint64_t resetLargestStreams(uint32_t max_reset, uint64_t min_reset_bytes) override;
+
+  size_t numTrackedAccounts() const { return accounts_.size(); }
+
+private:
+  class Account;
+
+  absl::flat_hash_set<Account*> accounts_;
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,227 @@
+#include "common/io/io_uring.h"
+
+#include <algorithm>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#define ENVOY_IO_URING 1
+#endif
+
+namespace Envoy {
+namespace Io {
+
+#ifdef ENVOY_IO_URING
+
+namespace {
+
+// Features the ring relies on: one mapping for both queues (5.4), no dropped completions (5.5),
+// and sockets that aren't ready being polled instead of blocking a worker thread (5.7).
+constexpr uint32_t RequiredFeatures =
+    IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+
+int ioUringSetup(uint32_t entries, struct io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, uint32_t opcode, const void* arg, uint32_t num_args) {
+  return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, num_args));
+}
+
+template <class T> T* offset(void* base, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+IoUringPtr IoUring::create(uint32_t entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = 2 * entries;
+
+  IoUringPtr ring(new IoUring());
+  ring->ring_fd_ = ioUringSetup(entries, &params);
+  if (ring->ring_fd_ < 0 || (params.features & RequiredFeatures) != RequiredFeatures) {
+    return nullptr;
+  }
+
+  // With IORING_FEAT_SINGLE_MMAP the completion queue shares the mapping of the submission queue.
+  ring->ring_size_ =
+      std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                       params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+  void* ring_mem = ::mmap(nullptr, ring->ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring->ring_fd_, IORING_OFF_SQ_RING);
+  if (ring_mem == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->ring_ = ring_mem;
+  ring->sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes_mem = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring->ring_fd_, IORING_OFF_SQES);
+  if (sqes_mem == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sqes_ = static_cast<struct io_uring_sqe*>(sqes_mem);
+
+  ring->sq_head_ = offset<uint32_t>(ring_mem, params.sq_off.head);
+  ring->sq_tail_ = offset<uint32_t>(ring_mem, params.sq_off.tail);
+  ring->sq_array_ = offset<uint32_t>(ring_mem, params.sq_off.array);
+  ring->sq_mask_ = *offset<uint32_t>(ring_mem, params.sq_off.ring_mask);
+  ring->sq_entries_ = params.sq_entries;
+  ring->cq_head_ = offset<uint32_t>(ring_mem, params.cq_off.head);
+  ring->cq_tail_ = offset<uint32_t>(ring_mem, params.cq_off.tail);
+  ring->cq_mask_ = *offset<uint32_t>(ring_mem, params.cq_off.ring_mask);
+  ring->cqes_ = offset<struct io_uring_cqe>(ring_mem, params.cq_off.cqes);
+  ring->sqe_tail_ = ring->sqe_submitted_ = *ring->sq_tail_;
+
+  ring->event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (ring->event_fd_ < 0 ||
+      ioUringRegister(ring->ring_fd_, IORING_REGISTER_EVENTFD, &ring->event_fd_, 1) != 0) {
+    return nullptr;
+  }
+  return ring;
+}
+
+bool IoUring::isSupported() {
+  static const bool supported = create(2) != nullptr;
+  return supported;
+}
+
+IoUring::~IoUring() {
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (ring_ != nullptr) {
+    ::munmap(ring_, ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    ::close(ring_fd_);
+  }
+  if (event_fd_ >= 0) {
+    ::close(event_fd_);
+  }
+}
+
+struct io_uring_sqe* IoUring::getSqe() {
+  if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    return nullptr;
+  }
+  const uint32_t index = sqe_tail_ & sq_mask_;
+  struct io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  sqe_tail_++;
+  return sqe;
+}
+
+bool IoUring::prepareReadv(os_fd_t fd, const struct iovec* iovecs, uint32_t num_iovecs,
+                           uint64_t user_data) {
+  struct io_uring_sqe* sqe = getSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = num_iovecs;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool IoUring::prepareWritev(os_fd_t fd, const struct iovec* iovecs, uint32_t num_iovecs,
+                            uint64_t user_data) {
+  struct io_uring_sqe* sqe = getSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = num_iovecs;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool IoUring::prepareCancel(uint64_t target_user_data, uint64_t user_data) {
+  struct io_uring_sqe* sqe = getSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = target_user_data;
+  sqe->user_data = user_data;
+  return true;
+}
+
+int IoUring::submit(uint32_t wait_for) {
+  const uint32_t to_submit = sqe_tail_ - sqe_submitted_;
+  if (to_submit == 0 && wait_for == 0) {
+    return 0;
+  }
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  int rc;
+  do {
+    rc = ioUringEnter(ring_fd_, to_submit, wait_for, wait_for > 0 ? IORING_ENTER_GETEVENTS : 0);
+    enter_calls_++;
+  } while (rc < 0 && errno == EINTR);
+  if (rc < 0) {
+    return -errno;
+  }
+  sqe_submitted_ += rc;
+  return rc;
+}
+
+uint32_t IoUring::forEveryCompletion(const CompletionCb& completion_cb) {
+  uint32_t head = *cq_head_;
+  const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  const uint32_t count = tail - head;
+  for (; head != tail; head++) {
+    const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    const uint64_t user_data = cqe.user_data;
+    const int32_t result = cqe.res;
+    // Release the entry before running the callback, which may submit more operations.
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    completion_cb(user_data, result);
+  }
+  return count;
+}
+
+#else
+
+IoUringPtr IoUring::create(uint32_t) { return nullptr; }
+
+bool IoUring::isSupported() { return false; }
+
+IoUring::~IoUring() = default;
+
+struct io_uring_sqe* IoUring::getSqe() {
+  return nullptr;
+}
+
+bool IoUring::prepareReadv(os_fd_t, const struct iovec*, uint32_t, uint64_t) { return false; }
+
+bool IoUring::prepareWritev(os_fd_t, const struct iovec*, uint32_t, uint64_t) { return false; }
+
+bool IoUring::prepareCancel(uint64_t, uint64_t) { return false; }
+
+int IoUring::submit(uint32_t) { return -ENOTSUP; }
+
+uint32_t IoUring::forEveryCompletion(const CompletionCb&) { return 0; }
+
+#endif
+
+} // namespace Io
+} // namespace Envoy
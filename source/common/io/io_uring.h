@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+// Defined by <linux/io_uring.h>, which only the implementation includes.
+// NOLINT(namespace-envoy)
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Envoy {
+namespace Io {
+
+class IoUring;
+using IoUringPtr = std::unique_ptr<IoUring>;
+
+/**
+ * A minimal io_uring(7) submission and completion queue pair, driven through raw system calls.
+ * Operations are queued with the prepare*() methods, handed to the kernel in one system call by
+ * submit(), and their results are collected with forEveryCompletion(). Completions are signalled
+ * on eventFd(), so that an event loop can wait for them alongside its other file events.
+ *
+ * Not thread safe: a ring belongs to the thread that drives it.
+ */
+class IoUring : NonCopyable {
+public:
+  /**
+   * Called for every completed operation.
+   * @param user_data supplies the user data the operation was prepared with.
+   * @param result supplies the result of the operation: what the equivalent system call would
+   *        return, or -errno on failure.
+   */
+  using CompletionCb = std::function<void(uint64_t user_data, int32_t result)>;
+
+  /**
+   * @param entries supplies the size of the submission queue. The completion queue is twice as
+   *        large, and the kernel doesn't drop completions that don't fit.
+   * @return IoUringPtr a ring, or nullptr if io_uring isn't available or lacks features this
+   *         class relies on (Linux 5.7 or later).
+   */
+  static IoUringPtr create(uint32_t entries);
+
+  /**
+   * @return bool whether create() would succeed.
+   */
+  static bool isSupported();
+
+  ~IoUring();
+
+  /**
+   * @return os_fd_t an eventfd that becomes readable when completions are available. Readers
+   *         should drain it before calling forEveryCompletion().
+   */
+  os_fd_t eventFd() const { return event_fd_; }
+
+  /**
+   * Queue a readv(2) of a socket. The iovecs and the memory they point to must stay valid until
+   * the operation completes.
+   * @return bool false if the submission queue is full. submit() makes room.
+   */
+  bool prepareReadv(os_fd_t fd, const struct iovec* iovecs, uint32_t num_iovecs,
+                    uint64_t user_data);
+
+  /**
+   * Queue a writev(2) to a socket. The iovecs and the memory they point to must stay valid until
+   * the operation completes.
+   * @return bool false if the submission queue is full. submit() makes room.
+   */
+  bool prepareWritev(os_fd_t fd, const struct iovec* iovecs, uint32_t num_iovecs,
+                     uint64_t user_data);
+
+  /**
+   * Queue the cancellation of a previously submitted operation, which then completes with
+   * -ECANCELED unless it has completed already.
+   * @param target_user_data supplies the user data of the operation to cancel.
+   * @param user_data supplies the user data of the cancellation itself.
+   * @return bool false if the submission queue is full. submit() makes room.
+   */
+  bool prepareCancel(uint64_t target_user_data, uint64_t user_data);
+
+  /**
+   * Hand all queued operations to the kernel.
+   * @param wait_for supplies the number of completions to wait for before returning.
+   * @return int the number of operations submitted, or -errno on failure.
+   */
+  int submit(uint32_t wait_for = 0);
+
+  /**
+   * @return uint32_t the number of operations queued but not yet submitted.
+   */
+  uint32_t pendingSubmissions() const { return sqe_tail_ - sqe_submitted_; }
+
+  /**
+   * Invoke a callback for every available completion, oldest first, and consume them.
+   * @return uint32_t the number of completions.
+   */
+  uint32_t forEveryCompletion(const CompletionCb& completion_cb);
+
+  /**
+   * @return uint64_t the number of io_uring_enter(2) system calls made so far.
+   */
+  uint64_t enterCalls() const { return enter_calls_; }
+
+private:
+  IoUring() = default;
+
+  io_uring_sqe* getSqe();
+
+  os_fd_t ring_fd_{INVALID_SOCKET};
+  os_fd_t event_fd_{INVALID_SOCKET};
+  void* ring_{};
+  size_t ring_size_{};
+  io_uring_sqe* sqes_{};
+  size_t sqes_size_{};
+
+  // Shared with the kernel.
+  uint32_t* sq_head_{};
+  uint32_t* sq_tail_{};
+  uint32_t* sq_array_{};
+  uint32_t* cq_head_{};
+  uint32_t* cq_tail_{};
+  io_uring_cqe* cqes_{};
+
+  uint32_t sq_mask_{};
+  uint32_t sq_entries_{};
+  uint32_t cq_mask_{};
+  // The tail of the entries prepared so far, and how far they have been submitted.
+  uint32_t sqe_tail_{};
+  uint32_t sqe_submitted_{};
+  uint64_t enter_calls_{};
+};
+
+} // namespace Io
+} // namespace Envoy
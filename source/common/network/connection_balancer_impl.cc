@@ -34,5 +34,58 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+void LoadAwareConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  Handlers handlers = versions_.empty() ? Handlers() : versions_.back();
+  handlers.push_back(&handler);
+  publish(std::move(handlers));
+}
+
+void LoadAwareConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  Handlers handlers = versions_.back();
+  handlers.erase(std::find(handlers.begin(), handlers.end(), &handler));
+  publish(std::move(handlers));
+}
+
+void LoadAwareConnectionBalancerImpl::publish(Handlers&& handlers) {
+  versions_.push_back(std::move(handlers));
+  handlers_.store(&versions_.back(), std::memory_order_release);
+}
+
+BalancedConnectionHandler&
+LoadAwareConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  BalancedConnectionHandler* target = &current_handler;
+  const Handlers* handlers = handlers_.load(std::memory_order_acquire);
+  if (handlers != nullptr && handlers->size() > 1) {
+    // Pick uniformly among the other handlers, so that a busy handler doesn't get to compare
+    // against itself: the current handler's place is taken by the last one.
+    size_t index = random_.random() % (handlers->size() - 1);
+    if ((*handlers)[index] == &current_handler) {
+      index = handlers->size() - 1;
+    }
+    BalancedConnectionHandler* other = (*handlers)[index];
+    if (lessLoaded(*other, current_handler)) {
+      target = other;
+    }
+  }
+
+  target->incNumConnections();
+  return *target;
+}
+
+bool LoadAwareConnectionBalancerImpl::lessLoaded(const BalancedConnectionHandler& a,
+                                                 const BalancedConnectionHandler& b) {
+  const double a_utilization = a.loopUtilization();
+  const double b_utilization = b.loopUtilization();
+  if (a_utilization + UtilizationTolerance < b_utilization) {
+    return true;
+  }
+  if (b_utilization + UtilizationTolerance < a_utilization) {
+    return false;
+  }
+  return a.numConnections() < b.numConnections();
+}
+
 } // namespace Network
 } // namespace Envoy
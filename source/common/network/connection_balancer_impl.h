@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <vector>
+
 #include "envoy/network/connection_balancer.h"
+#include "envoy/runtime/runtime.h"
 
 #include "absl/synchronization/mutex.h"
 
@@ -27,6 +32,43 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that sends each connection to the less loaded of two
+ * handlers: the one that accepted it, and one picked at random ("power of two choices"). A handler
+ * is less loaded if the event loop of its thread has been noticeably less busy, or, when both are
+ * about as busy, if it has fewer connections. Unlike connection counts, loop utilization accounts
+ * for connections that differ in cost, such as long lived HTTP/2 connections carrying many
+ * streams.
+ *
+ * Picking a handler takes no lock: registering and unregistering handlers publishes a new copy of
+ * the handler list, and the copies are only freed with the balancer, as a concurrent pick may still
+ * be reading them. Handlers change with listener updates, so the copies stay few.
+ */
+class LoadAwareConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  LoadAwareConnectionBalancerImpl(Runtime::RandomGenerator& random) : random_(random) {}
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+  // Handlers whose loop utilization differs by less than this are compared by connection count.
+  static constexpr double UtilizationTolerance = 0.1;
+
+private:
+  using Handlers = std::vector<BalancedConnectionHandler*>;
+
+  void publish(Handlers&& handlers) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  static bool lessLoaded(const BalancedConnectionHandler& a, const BalancedConnectionHandler& b);
+
+  Runtime::RandomGenerator& random_;
+  absl::Mutex lock_;
+  // Every version of the handler list, the last one being current.
+  std::list<Handlers> versions_ ABSL_GUARDED_BY(lock_);
+  std::atomic<const Handlers*> handlers_{};
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
@@ -39,6 +39,29 @@ void ConnectionImplUtility::updateBufferStats(uint64_t delta, uint64_t new_total
   }
 }
 
+void AdaptiveReadSize::setLimit(uint64_t limit) {
+  max_read_size_ = limit == 0 ? MaxReadSize : std::max(MinReadSize, std::min(limit, MaxReadSize));
+  read_size_ = std::min(read_size_, max_read_size_);
+}
+
+void AdaptiveReadSize::onRead(uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    small_reads_ = 0;
+    uint64_t read_size = read_size_ * 2;
+    while (read_size <= bytes_read && read_size < max_read_size_) {
+      read_size *= 2;
+    }
+    read_size_ = std::min(read_size, max_read_size_);
+  } else if (bytes_read < read_size_ / 2 && read_size_ > MinReadSize) {
+    if (++small_reads_ == ShrinkAfterReads) {
+      small_reads_ = 0;
+      read_size_ /= 2;
+    }
+  } else {
+    small_reads_ = 0;
+  }
+}
+
 std::atomic<uint64_t> ConnectionImpl::next_global_id_;
 
 ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
@@ -73,9 +96,18 @@ ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPt
 #endif
   // We never ask for both early close and read at the same time. If we are reading, we want to
   // consume all available data.
-  file_event_ = dispatcher_.createFileEvent(
-      ConnectionImpl::ioHandle().fd(), [this](uint32_t events) -> void { onFileEvent(events); },
-      trigger, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  // TLS reads and writes the fd directly rather than through the IoHandle, so it needs events for
+  // the fd itself. Everything else lets the IoHandle report readiness, which handles that complete
+  // I/O asynchronously rely on.
+  if (transport_socket_->ssl() == nullptr) {
+    file_event_ = ConnectionImpl::ioHandle().createFileEvent(
+        dispatcher_, [this](uint32_t events) -> void { onFileEvent(events); }, trigger,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+  } else {
+    file_event_ = dispatcher_.createFileEvent(
+        ConnectionImpl::ioHandle().fd(), [this](uint32_t events) -> void { onFileEvent(events); },
+        trigger, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
 
   transport_socket_->setTransportSocketCallbacks(*this);
 }
@@ -445,6 +477,7 @@ void ConnectionImpl::write(Buffer::Instance& data, bool end_stream, bool through
 
 void ConnectionImpl::setBufferLimits(uint32_t limit) {
   read_buffer_limit_ = limit;
+  read_size_.setLimit(limit);
 
   // Due to the fact that writes to the connection and flushing data from the connection are done
   // asynchronously, we have the option of either setting the watermarks aggressively, and regularly
@@ -470,6 +503,17 @@ void ConnectionImpl::setBufferLimits(uint32_t limit) {
   }
 }
 
+void ConnectionImpl::setBufferMemoryAccount(const Buffer::BufferMemoryAccountSharedPtr& account) {
+  ConnectionImplBase::setBufferMemoryAccount(account);
+  read_buffer_.setAccount(account);
+  static_cast<Buffer::WatermarkBuffer*>(write_buffer_.get())->setAccount(account);
+}
+
+uint64_t ConnectionImpl::shrinkBuffers() {
+  return read_buffer_.shrink() +
+         static_cast<Buffer::WatermarkBuffer*>(write_buffer_.get())->shrink();
+}
+
 void ConnectionImpl::onReadBufferLowWatermark() {
   ENVOY_CONN_LOG(debug, "onBelowReadBufferLowWatermark", *this);
   if (state() == State::Open) {
@@ -559,7 +603,11 @@ void ConnectionImpl::onReadReady() {
     return;
   }
 
+  if (connection_stats_ && connection_stats_->read_size_) {
+    connection_stats_->read_size_->recordValue(read_size_.readSize());
+  }
   IoResult result = transport_socket_->doRead(read_buffer_);
+  read_size_.onRead(result.bytes_processed_);
   uint64_t new_buffer_size = read_buffer_.length();
   updateReadBufferStats(result.bytes_processed_, new_buffer_size);
 
@@ -40,6 +40,42 @@ public:
                                 Stats::Counter& stat_total, Stats::Gauge& stat_current);
 };
 
+/**
+ * Picks the per call read size of a connection from the number of bytes it read on recent read
+ * events, so that connections exchanging small messages reserve small slices while bulk transfers
+ * read in few large calls.
+ */
+class AdaptiveReadSize {
+public:
+  // One page, which is the smallest slice the buffer allocates.
+  static constexpr uint64_t MinReadSize = 4096;
+  static constexpr uint64_t MaxReadSize = 65536;
+  // The number of consecutive read events using less than half of the read size after which it
+  // is halved.
+  static constexpr uint32_t ShrinkAfterReads = 4;
+
+  uint64_t readSize() const { return read_size_; }
+
+  /**
+   * Caps the read size, e.g. to the connection's buffer limit. The cap never goes below
+   * MinReadSize.
+   * @param limit supplies the cap, or 0 for MaxReadSize.
+   */
+  void setLimit(uint64_t limit);
+
+  /**
+   * Adjusts the read size after a read event. Reading at least the read size grows it at once to
+   * the next power of two above the bytes read, while it only shrinks after several small reads.
+   * @param bytes_read supplies the number of bytes read during the event.
+   */
+  void onRead(uint64_t bytes_read);
+
+private:
+  uint64_t max_read_size_{MaxReadSize};
+  uint64_t read_size_{MinReadSize};
+  uint32_t small_reads_{};
+};
+
 /**
  * Implementation of Network::Connection and Network::FilterManagerConnection.
  */
@@ -81,6 +117,11 @@ public:
   void write(Buffer::Instance& data, bool end_stream) override;
   void setBufferLimits(uint32_t limit) override;
   uint32_t bufferLimit() const override { return read_buffer_limit_; }
+  void setBufferMemoryAccount(const Buffer::BufferMemoryAccountSharedPtr& account) override;
+  uint64_t shrinkBuffers() override;
+  uint64_t bufferedBytes() const override {
+    return read_buffer_.length() + write_buffer_->length();
+  }
   bool localAddressRestored() const override { return socket_->localAddressRestored(); }
   bool aboveHighWatermark() const override { return write_buffer_above_high_watermark_; }
   const ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
@@ -116,6 +157,7 @@ public:
   // fair sharing of CPU resources, the underlying event loop does not make any fairness guarantees.
   // Reconsider how to make fairness happen.
   void setReadBufferReady() override { file_event_->activate(Event::FileReadyType::Read); }
+  uint64_t readSize() const override { return read_size_.readSize(); }
   void flushWriteBuffer() override;
 
   // Obtain global next connection ID. This should only be used in tests.
@@ -155,6 +197,7 @@ protected:
   // write_buffer_ invokes during its clean up.
   Buffer::InstancePtr write_buffer_;
   uint32_t read_buffer_limit_ = 0;
+  AdaptiveReadSize read_size_;
   bool connecting_{false};
   ConnectionEvent immediate_error_event_{ConnectionEvent::Connected};
   bool bind_error_{false};
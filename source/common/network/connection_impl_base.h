@@ -19,6 +19,12 @@ public:
   uint64_t id() const override { return id_; }
   void setConnectionStats(const ConnectionStats& stats) override;
   void setDelayedCloseTimeout(std::chrono::milliseconds timeout) override;
+  void setBufferMemoryAccount(const Buffer::BufferMemoryAccountSharedPtr& account) override {
+    buffer_memory_account_ = account;
+  }
+  const Buffer::BufferMemoryAccountSharedPtr& bufferMemoryAccount() const override {
+    return buffer_memory_account_;
+  }
 
 protected:
   void initializeDelayedCloseTimer();
@@ -50,6 +56,7 @@ protected:
   const uint64_t id_;
   std::list<ConnectionCallbacks*> callbacks_;
   std::unique_ptr<ConnectionStats> connection_stats_;
+  Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
 
 private:
   // Callback issued when a delayed close timeout triggers.
@@ -1,6 +1,7 @@
 #include "common/network/io_socket_handle_impl.h"
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/utility.h"
@@ -65,6 +66,31 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
       Api::OsSysCallsSingleton::get().writev(fd_, iov.begin(), num_slices_to_write));
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::read(Buffer::Instance& buffer, uint64_t max_length) {
+  constexpr uint64_t MaxSlices = 2;
+  Buffer::RawSlice slices[MaxSlices];
+  const uint64_t num_slices = buffer.reserve(max_length, slices, MaxSlices);
+  Api::IoCallUint64Result result = readv(max_length, slices, num_slices);
+  uint64_t bytes_to_commit = result.ok() ? result.rc_ : 0;
+  ASSERT(bytes_to_commit <= max_length);
+  for (uint64_t i = 0; i < num_slices; i++) {
+    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
+    bytes_to_commit -= slices[i].len_;
+  }
+  buffer.commit(slices, num_slices);
+  return result;
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
+  constexpr uint64_t MaxSlices = 16;
+  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
+  Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
+  if (result.ok() && result.rc_ > 0) {
+    buffer.drain(static_cast<uint64_t>(result.rc_));
+  }
+  return result;
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -392,6 +418,17 @@ Api::SysCallIntResult IoSocketHandleImpl::setBlocking(bool blocking) {
   return Api::OsSysCallsSingleton::get().setsocketblocking(fd_, blocking);
 }
 
+Api::SysCallIntResult IoSocketHandleImpl::shutdown(int how) {
+  return Api::OsSysCallsSingleton::get().shutdown(fd_, how);
+}
+
+Event::FileEventPtr IoSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                        Event::FileReadyCb cb,
+                                                        Event::FileTriggerType trigger,
+                                                        uint32_t events) {
+  return dispatcher.createFileEvent(fd_, cb, trigger, events);
+}
+
 absl::optional<int> IoSocketHandleImpl::domain() {
   sockaddr_storage addr;
   socklen_t len = sizeof(addr);
@@ -0,0 +1,529 @@
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include <algorithm>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+// Submission queue size of a worker's ring. Each handle has at most one read and one write in
+// flight, and operations that don't fit wait in the worker's backlog.
+constexpr uint32_t RingEntries = 1024;
+
+// User data of cancellations, whose own completions are ignored.
+constexpr uint64_t CancelUserData = 0;
+
+} // namespace
+
+IoUringWorkerPtr IoUringWorker::create(Event::Dispatcher& dispatcher) {
+  Io::IoUringPtr ring = Io::IoUring::create(RingEntries);
+  if (ring == nullptr) {
+    return nullptr;
+  }
+  return IoUringWorkerPtr(new IoUringWorker(std::move(ring), dispatcher));
+}
+
+IoUringWorker::IoUringWorker(Io::IoUringPtr&& ring, Event::Dispatcher& dispatcher)
+    : ring_(std::move(ring)),
+      event_fd_event_(dispatcher.createFileEvent(
+          ring_->eventFd(), [this](uint32_t) { onEventFd(); }, Event::FileTriggerType::Edge,
+          Event::FileReadyType::Read)),
+      submit_cb_(dispatcher.createSchedulableCallback([this]() { onSubmit(); })) {}
+
+IoUringWorker::~IoUringWorker() {
+  // The kernel may still write to the buffers of in flight requests, so cancel them and wait for
+  // their completions before freeing anything.
+  backlog_.clear();
+  uint32_t in_flight = 0;
+  for (auto& request : requests_) {
+    if (request.first->backlogged_) {
+      request.first->backlogged_ = false;
+      request.first->in_flight_ = false;
+    }
+    if (!request.first->in_flight_) {
+      continue;
+    }
+    in_flight++;
+    if (!ring_->prepareCancel(reinterpret_cast<uint64_t>(request.first), CancelUserData)) {
+      ring_->submit();
+      ring_->prepareCancel(reinterpret_cast<uint64_t>(request.first), CancelUserData);
+    }
+  }
+  while (in_flight > 0) {
+    if (ring_->submit(1) < 0) {
+      ENVOY_LOG(warn, "io_uring: giving up on {} in flight operations", in_flight);
+      // Leak the requests rather than let the kernel write to freed memory.
+      for (auto& request : requests_) {
+        if (request.first->in_flight_) {
+          request.second.release();
+        }
+      }
+      break;
+    }
+    ring_->forEveryCompletion([&in_flight](uint64_t user_data, int32_t) {
+      if (user_data != CancelUserData) {
+        reinterpret_cast<Request*>(user_data)->in_flight_ = false;
+        in_flight--;
+      }
+    });
+  }
+  for (auto& request : requests_) {
+    if (request.first->owns_fd_) {
+      Api::OsSysCallsSingleton::get().close(request.first->fd_);
+    }
+    if (request.first->handle_ != nullptr) {
+      ENVOY_LOG(debug, "io_uring: worker destroyed before its handle");
+    }
+  }
+}
+
+IoUringWorker::Request& IoUringWorker::allocateRequest(IoUringSocketHandleImpl& handle,
+                                                       Request::Type type) {
+  auto request = std::make_unique<Request>(handle, type);
+  Request& ref = *request;
+  requests_.emplace(&ref, std::move(request));
+  return ref;
+}
+
+void IoUringWorker::releaseRequest(Request& request) {
+  request.handle_ = nullptr;
+  if (!request.in_flight_) {
+    requests_.erase(&request);
+  }
+}
+
+void IoUringWorker::submitRead(os_fd_t fd, Request& request, uint32_t length) {
+  ASSERT(!request.in_flight_);
+  ASSERT(request.buffer_.length() == 0);
+  request.fd_ = fd;
+  request.num_slices_ = request.buffer_.reserve(length, request.slices_, Request::MaxSlices);
+  for (uint32_t i = 0; i < request.num_slices_; i++) {
+    request.iovecs_[i].iov_base = request.slices_[i].mem_;
+    request.iovecs_[i].iov_len = request.slices_[i].len_;
+  }
+  queue(Operation::Read, request);
+}
+
+void IoUringWorker::commitRead(Request& request, int32_t result) {
+  uint64_t bytes_to_commit = std::max(result, 0);
+  for (uint32_t i = 0; i < request.num_slices_; i++) {
+    request.slices_[i].len_ = std::min<uint64_t>(request.slices_[i].len_, bytes_to_commit);
+    bytes_to_commit -= request.slices_[i].len_;
+  }
+  request.buffer_.commit(request.slices_, request.num_slices_);
+  request.num_slices_ = 0;
+}
+
+void IoUringWorker::submitWrite(os_fd_t fd, Request& request) {
+  ASSERT(!request.in_flight_);
+  ASSERT(request.buffer_.length() > 0);
+  request.fd_ = fd;
+  const Buffer::RawSliceVector slices = request.buffer_.getRawSlices(Request::MaxSlices);
+  request.num_slices_ = slices.size();
+  for (uint32_t i = 0; i < request.num_slices_; i++) {
+    request.iovecs_[i].iov_base = slices[i].mem_;
+    request.iovecs_[i].iov_len = slices[i].len_;
+  }
+  queue(Operation::Write, request);
+}
+
+void IoUringWorker::cancel(Request& request) {
+  if (!request.in_flight_) {
+    return;
+  }
+  if (request.backlogged_) {
+    // The kernel doesn't know about the request yet, so complete it here.
+    backlog_.erase(std::remove_if(backlog_.begin(), backlog_.end(),
+                                  [&request](const std::pair<Operation, Request*>& entry) {
+                                    return entry.second == &request;
+                                  }),
+                   backlog_.end());
+    onCompletion(reinterpret_cast<uint64_t>(&request), -ECANCELED);
+    return;
+  }
+  queue(Operation::Cancel, request);
+}
+
+void IoUringWorker::flush() {
+  submit_cb_->cancel();
+  onSubmit();
+}
+
+void IoUringWorker::queue(Operation operation, Request& request) {
+  if (operation != Operation::Cancel) {
+    request.in_flight_ = true;
+  }
+  if (!backlog_.empty() || !prepare(operation, request)) {
+    if (operation != Operation::Cancel) {
+      request.backlogged_ = true;
+    }
+    backlog_.emplace_back(operation, &request);
+  }
+  if (!submit_cb_->enabled()) {
+    submit_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+bool IoUringWorker::prepare(Operation operation, Request& request) {
+  const uint64_t user_data = reinterpret_cast<uint64_t>(&request);
+  switch (operation) {
+  case Operation::Read:
+    return ring_->prepareReadv(request.fd_, request.iovecs_, request.num_slices_, user_data);
+  case Operation::Write:
+    return ring_->prepareWritev(request.fd_, request.iovecs_, request.num_slices_, user_data);
+  case Operation::Cancel:
+    return ring_->prepareCancel(user_data, CancelUserData);
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void IoUringWorker::onSubmit() {
+  while (true) {
+    while (!backlog_.empty() && prepare(backlog_.front().first, *backlog_.front().second)) {
+      backlog_.front().second->backlogged_ = false;
+      backlog_.pop_front();
+    }
+    if (ring_->pendingSubmissions() == 0) {
+      return;
+    }
+    const int rc = ring_->submit();
+    if (rc < 0) {
+      // Most likely EBUSY, as completions the kernel couldn't post yet wait for room in the
+      // completion queue. Reap them and retry on the next iteration.
+      ENVOY_LOG(debug, "io_uring: submit failed: {}", -rc);
+      submit_cb_->scheduleCallbackNextIteration();
+      return;
+    }
+    if (backlog_.empty()) {
+      return;
+    }
+  }
+}
+
+void IoUringWorker::onEventFd() {
+  // Reset the eventfd before reaping, so that completions posted meanwhile signal it again.
+  uint64_t value;
+  const iovec iov{&value, sizeof(value)};
+  Api::OsSysCallsSingleton::get().readv(ring_->eventFd(), &iov, 1);
+  ring_->forEveryCompletion(
+      [this](uint64_t user_data, int32_t result) { onCompletion(user_data, result); });
+}
+
+void IoUringWorker::onCompletion(uint64_t user_data, int32_t result) {
+  if (user_data == CancelUserData) {
+    return;
+  }
+  Request* request = reinterpret_cast<Request*>(user_data);
+  request->in_flight_ = false;
+  if (request->handle_ == nullptr) {
+    onOrphanCompleted(*request, result);
+    return;
+  }
+  request->handle_->onRequestCompleted(*request, result);
+}
+
+void IoUringWorker::onOrphanCompleted(Request& request, int32_t result) {
+  if (request.owns_fd_) {
+    // Finish the write, as the socket would have if it had taken all the data, then close it.
+    if (result == -EAGAIN || result == -EINTR || result > 0) {
+      request.buffer_.drain(std::max(result, 0));
+      if (request.buffer_.length() > 0) {
+        submitWrite(request.fd_, request);
+        return;
+      }
+    }
+    Api::OsSysCallsSingleton::get().close(request.fd_);
+  }
+  requests_.erase(&request);
+}
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(os_fd_t fd, IoUringWorker& worker)
+    : IoSocketHandleImpl(fd), worker_(worker) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (isOpen()) {
+    IoUringSocketHandleImpl::close();
+  }
+  if (file_event_ != nullptr) {
+    file_event_->onHandleDestroyed();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  if (!ioUringActive()) {
+    return IoSocketHandleImpl::close();
+  }
+  // Queued operations refer to the fd by number, so they have to reach the kernel before it can
+  // be reused.
+  worker_.flush();
+  worker_.cancel(*read_request_);
+  worker_.releaseRequest(*read_request_);
+  read_request_ = nullptr;
+  if (write_request_ == nullptr || !write_request_->in_flight_) {
+    if (write_request_ != nullptr) {
+      worker_.releaseRequest(*write_request_);
+      write_request_ = nullptr;
+    }
+    return IoSocketHandleImpl::close();
+  }
+  // Like data in the socket's send buffer, a pending write still goes out. It takes over the fd
+  // and closes it when done, so that the fd number isn't reused meanwhile.
+  write_request_->owns_fd_ = true;
+  worker_.releaseRequest(*write_request_);
+  write_request_ = nullptr;
+  SET_SOCKET_INVALID(fd_);
+  return Api::IoCallUint64Result(0, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+absl::optional<Api::IoCallUint64Result> IoUringSocketHandleImpl::readBlocked() {
+  if (read_request_->in_flight_) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN});
+  }
+  if (read_result_ <= 0) {
+    // End of stream or an error, which stick until the handle is closed.
+    return sysCallResultToIoCallResult(
+        Api::SysCallSizeResult{read_result_ == 0 ? 0 : -1, -read_result_});
+  }
+  return absl::nullopt;
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (!ioUringActive()) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+  absl::optional<Api::IoCallUint64Result> blocked = readBlocked();
+  if (blocked.has_value()) {
+    return std::move(blocked.value());
+  }
+
+  Buffer::OwnedImpl& read_buffer = read_request_->buffer_;
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length && read_buffer.length() > 0;
+       i++) {
+    const uint64_t length =
+        std::min<uint64_t>({slices[i].len_, max_length - bytes_read, read_buffer.length()});
+    read_buffer.copyOut(0, length, slices[i].mem_);
+    read_buffer.drain(length);
+    bytes_read += length;
+  }
+  if (read_buffer.length() == 0) {
+    submitRead();
+  }
+  return sysCallResultToIoCallResult(
+      Api::SysCallSizeResult{static_cast<ssize_t>(bytes_read), 0});
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      uint64_t max_length) {
+  if (!ioUringActive()) {
+    return IoSocketHandleImpl::read(buffer, max_length);
+  }
+  absl::optional<Api::IoCallUint64Result> blocked = readBlocked();
+  if (blocked.has_value()) {
+    return std::move(blocked.value());
+  }
+
+  // Hand the slices the kernel read into over to the caller. Only a partial slice is copied.
+  Buffer::OwnedImpl& read_buffer = read_request_->buffer_;
+  const uint64_t bytes_read = std::min(max_length, read_buffer.length());
+  buffer.move(read_buffer, bytes_read);
+  if (read_buffer.length() == 0) {
+    submitRead();
+  }
+  return sysCallResultToIoCallResult(
+      Api::SysCallSizeResult{static_cast<ssize_t>(bytes_read), 0});
+}
+
+absl::optional<Api::IoCallUint64Result> IoUringSocketHandleImpl::writeBlocked() {
+  if (write_errno_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, write_errno_});
+  }
+  if (write_request_ == nullptr) {
+    write_request_ = &worker_.allocateRequest(*this, IoUringWorker::Request::Type::Write);
+  } else if (write_request_->in_flight_) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN});
+  }
+  return absl::nullopt;
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (!ioUringActive()) {
+    return IoSocketHandleImpl::writev(slices, num_slice);
+  }
+  absl::optional<Api::IoCallUint64Result> blocked = writeBlocked();
+  if (blocked.has_value()) {
+    return std::move(blocked.value());
+  }
+
+  Buffer::OwnedImpl& write_buffer = write_request_->buffer_;
+  for (uint64_t i = 0; i < num_slice && write_buffer.length() < WriteSize; i++) {
+    write_buffer.add(slices[i].mem_,
+                     std::min<uint64_t>(slices[i].len_, WriteSize - write_buffer.length()));
+  }
+  const uint64_t length = write_buffer.length();
+  if (length > 0) {
+    submitWrite();
+  }
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{static_cast<ssize_t>(length), 0});
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (!ioUringActive()) {
+    return IoSocketHandleImpl::write(buffer);
+  }
+  absl::optional<Api::IoCallUint64Result> blocked = writeBlocked();
+  if (blocked.has_value()) {
+    return std::move(blocked.value());
+  }
+
+  // Take the caller's slices over until the kernel has written them. Only a partial slice is
+  // copied.
+  const uint64_t length = std::min<uint64_t>(buffer.length(), WriteSize);
+  if (length > 0) {
+    write_request_->buffer_.move(buffer, length);
+    submitWrite();
+  }
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{static_cast<ssize_t>(length), 0});
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (write_request_ != nullptr && write_request_->in_flight_ &&
+      (how == ENVOY_SHUT_WR || how == ENVOY_SHUT_RDWR)) {
+    pending_shutdown_ = how;
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::shutdown(how);
+}
+
+Event::FileEventPtr IoUringSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                             Event::FileReadyCb cb,
+                                                             Event::FileTriggerType trigger,
+                                                             uint32_t events) {
+  if (trigger != Event::FileTriggerType::Edge || !isOpen() || ioUringActive()) {
+    // Completions are only reported edge triggered, and to one file event.
+    return IoSocketHandleImpl::createFileEvent(dispatcher, cb, trigger, events);
+  }
+  read_request_ = &worker_.allocateRequest(*this, IoUringWorker::Request::Type::Read);
+  submitRead();
+  auto file_event = std::make_unique<IoUringFileEvent>(dispatcher, *this, cb, events);
+  file_event_ = file_event.get();
+  return file_event;
+}
+
+void IoUringSocketHandleImpl::onRequestCompleted(IoUringWorker::Request& request,
+                                                 int32_t result) {
+  if (&request == read_request_) {
+    if (result == -EAGAIN || result == -EINTR) {
+      submitRead();
+      return;
+    }
+    IoUringWorker::commitRead(request, result);
+    read_result_ = result;
+    notify(result > 0 ? Event::FileReadyType::Read
+                      : Event::FileReadyType::Read | Event::FileReadyType::Closed);
+    return;
+  }
+
+  ASSERT(&request == write_request_);
+  if (result < 0 && result != -EAGAIN && result != -EINTR) {
+    write_errno_ = -result;
+    request.buffer_.drain(request.buffer_.length());
+  } else {
+    request.buffer_.drain(std::max(result, 0));
+    if (request.buffer_.length() > 0) {
+      submitWrite();
+      return;
+    }
+    if (pending_shutdown_.has_value()) {
+      IoSocketHandleImpl::shutdown(pending_shutdown_.value());
+      pending_shutdown_.reset();
+    }
+  }
+  notify(Event::FileReadyType::Write);
+}
+
+uint32_t IoUringSocketHandleImpl::readyEvents() const {
+  if (!ioUringActive()) {
+    return 0;
+  }
+  uint32_t events = 0;
+  if (!read_request_->in_flight_) {
+    events |= Event::FileReadyType::Read;
+    if (read_result_ <= 0) {
+      events |= Event::FileReadyType::Closed;
+    }
+  }
+  if (write_request_ == nullptr || !write_request_->in_flight_) {
+    events |= Event::FileReadyType::Write;
+  }
+  return events;
+}
+
+void IoUringSocketHandleImpl::submitRead() {
+  read_result_ = 0;
+  worker_.submitRead(fd(), *read_request_, ReadSize);
+}
+
+void IoUringSocketHandleImpl::submitWrite() { worker_.submitWrite(fd(), *write_request_); }
+
+void IoUringSocketHandleImpl::notify(uint32_t events) {
+  if (file_event_ != nullptr) {
+    file_event_->onReady(events);
+  }
+}
+
+IoUringFileEvent::IoUringFileEvent(Event::Dispatcher& dispatcher, IoUringSocketHandleImpl& handle,
+                                   Event::FileReadyCb cb, uint32_t events)
+    : handle_(&handle), cb_(cb),
+      schedule_cb_(dispatcher.createSchedulableCallback([this]() { onSchedule(); })) {
+  setEnabled(events);
+}
+
+IoUringFileEvent::~IoUringFileEvent() {
+  if (handle_ != nullptr) {
+    handle_->onFileEventDestroyed();
+  }
+}
+
+void IoUringFileEvent::activate(uint32_t events) {
+  injected_ |= events;
+  schedule_cb_->scheduleCallbackCurrentIteration();
+}
+
+void IoUringFileEvent::setEnabled(uint32_t events) {
+  // Like epoll, report what the handle is ready for right away when (re)enabling events.
+  enabled_ = events;
+  ready_ = handle_ != nullptr ? handle_->readyEvents() : 0;
+  if ((ready_ & enabled_) != 0) {
+    schedule_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringFileEvent::onReady(uint32_t events) {
+  ready_ |= events;
+  if ((ready_ & enabled_) != 0) {
+    schedule_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringFileEvent::onSchedule() {
+  const uint32_t events = (ready_ & enabled_) | injected_;
+  ready_ &= ~enabled_;
+  injected_ = 0;
+  if (events != 0) {
+    cb_(events);
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+#include "common/io/io_uring.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+class IoUringSocketHandleImpl;
+
+/**
+ * Drives an io_uring ring on behalf of the IoUringSocketHandleImpls of one dispatcher. Operations
+ * are queued as handles ask for them and handed to the kernel in a single system call at the end
+ * of the event loop iteration; completions are reaped when the ring's eventfd becomes readable.
+ */
+class IoUringWorker : NonCopyable, protected Logger::Loggable<Logger::Id::io> {
+public:
+  /**
+   * A read or write of one handle, with the buffer it transfers. Requests are reused by their
+   * handle, and outlive it until the kernel is done with their buffer.
+   */
+  struct Request {
+    enum class Type { Read, Write };
+
+    // Most slices of buffer_ one operation reads into or writes from.
+    static constexpr uint32_t MaxSlices = 16;
+
+    Request(IoUringSocketHandleImpl& handle, Type type) : type_(type), handle_(&handle) {}
+
+    const Type type_;
+    // nullptr once the handle has been closed.
+    IoUringSocketHandleImpl* handle_;
+    // A read lands in space reserved at the end of the buffer, and is committed on completion so
+    // that the slices can be moved to the reader. A write sends the buffer's data, which was moved
+    // in from the writer, and drains what was written.
+    Buffer::OwnedImpl buffer_;
+    Buffer::RawSlice slices_[MaxSlices];
+    struct iovec iovecs_[MaxSlices];
+    uint32_t num_slices_{};
+    os_fd_t fd_{INVALID_SOCKET};
+    // Whether the kernel, or the backlog of operations waiting for room in the ring, has the
+    // request.
+    bool in_flight_{};
+    bool backlogged_{};
+    // Set on the pending write of a closed handle, which closes fd_ once it has written everything.
+    bool owns_fd_{};
+  };
+
+  /**
+   * @return std::unique_ptr<IoUringWorker> a worker for the dispatcher, or nullptr if io_uring
+   *         isn't available.
+   */
+  static std::unique_ptr<IoUringWorker> create(Event::Dispatcher& dispatcher);
+
+  ~IoUringWorker();
+
+  /**
+   * @return Request& a new request of the handle.
+   */
+  Request& allocateRequest(IoUringSocketHandleImpl& handle, Request::Type type);
+
+  /**
+   * Return a request its handle is done with. It's freed at once, or when the kernel completes it
+   * if it's in flight.
+   */
+  void releaseRequest(Request& request);
+
+  /**
+   * Read up to length bytes from the fd into space reserved in the request's buffer. The handle
+   * commits what was read with commitRead() once the request completes.
+   */
+  void submitRead(os_fd_t fd, Request& request, uint32_t length);
+
+  /**
+   * Commit what a completed read transferred to the request's buffer.
+   * @param result supplies the result of the read.
+   */
+  static void commitRead(Request& request, int32_t result);
+
+  /**
+   * Write the data of the request's buffer to the fd, or as much of it as one operation takes.
+   */
+  void submitWrite(os_fd_t fd, Request& request);
+
+  /**
+   * Cancel an in flight request, which then completes with -ECANCELED unless it completed already.
+   */
+  void cancel(Request& request);
+
+  /**
+   * Hand the queued operations to the kernel now rather than at the end of the loop iteration.
+   * Handles do this before closing their fd, as queued operations refer to it by number.
+   */
+  void flush();
+
+  /**
+   * @return const Io::IoUring& the worker's ring.
+   */
+  const Io::IoUring& ring() const { return *ring_; }
+
+private:
+  enum class Operation { Read, Write, Cancel };
+
+  IoUringWorker(Io::IoUringPtr&& ring, Event::Dispatcher& dispatcher);
+
+  void queue(Operation operation, Request& request);
+  bool prepare(Operation operation, Request& request);
+  void onSubmit();
+  void onEventFd();
+  void onCompletion(uint64_t user_data, int32_t result);
+  void onOrphanCompleted(Request& request, int32_t result);
+
+  Io::IoUringPtr ring_;
+  Event::FileEventPtr event_fd_event_;
+  Event::SchedulableCallbackPtr submit_cb_;
+  absl::flat_hash_map<Request*, std::unique_ptr<Request>> requests_;
+  // Operations that didn't fit in the submission queue, in order.
+  std::deque<std::pair<Operation, Request*>> backlog_;
+};
+
+using IoUringWorkerPtr = std::unique_ptr<IoUringWorker>;
+
+class IoUringFileEvent;
+
+/**
+ * IoHandle for connected sockets that reads and writes through an IoUringWorker. Once a file event
+ * has been created for it, a read is kept in flight until the handle is closed, and writes are
+ * completed in the background, one at a time; reads and writes never block or make a system call,
+ * and return EAGAIN until the pending operation completes. read() and write() hand buffer slices
+ * over to and from the kernel without copying them, while readv() and writev() copy. Readiness is
+ * reported through the file event the handle created, not through the fd. Until then the handle
+ * behaves like an IoSocketHandleImpl, so that listener filters can peek at the socket.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(os_fd_t fd, IoUringWorker& worker);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::SysCallIntResult shutdown(int how) override;
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+
+  /**
+   * @return bool whether reads and writes go through io_uring.
+   */
+  bool ioUringActive() const { return read_request_ != nullptr; }
+
+  /**
+   * Called by the worker when one of the handle's requests completes.
+   */
+  void onRequestCompleted(IoUringWorker::Request& request, int32_t result);
+
+  /**
+   * @return uint32_t the FileReadyType events the handle is ready for.
+   */
+  uint32_t readyEvents() const;
+
+  void onFileEventDestroyed() { file_event_ = nullptr; }
+
+  // Space reserved for the read kept in flight.
+  static constexpr uint32_t ReadSize = 16 * 1024;
+  // Most bytes a write takes from the caller.
+  static constexpr uint32_t WriteSize = 64 * 1024;
+
+private:
+  // Whether a read or write can't proceed now, with the result to return if so.
+  absl::optional<Api::IoCallUint64Result> readBlocked();
+  absl::optional<Api::IoCallUint64Result> writeBlocked();
+  void submitRead();
+  void submitWrite();
+  void notify(uint32_t events);
+
+  IoUringWorker& worker_;
+  IoUringFileEvent* file_event_{};
+
+  // Its buffer holds what the last read returned that hasn't been consumed yet.
+  IoUringWorker::Request* read_request_{};
+  // Result of the last read.
+  int32_t read_result_{};
+
+  IoUringWorker::Request* write_request_{};
+  // Error of the last write, returned by the next writev().
+  int write_errno_{};
+  // shutdown() of the write side, deferred until the pending write completes.
+  absl::optional<int> pending_shutdown_;
+};
+
+/**
+ * FileEvent of an IoUringSocketHandleImpl. Events fire edge triggered, from a callback scheduled
+ * on the dispatcher when the handle becomes ready.
+ */
+class IoUringFileEvent : public Event::FileEvent {
+public:
+  IoUringFileEvent(Event::Dispatcher& dispatcher, IoUringSocketHandleImpl& handle,
+                   Event::FileReadyCb cb, uint32_t events);
+  ~IoUringFileEvent() override;
+
+  // Event::FileEvent
+  void activate(uint32_t events) override;
+  void setEnabled(uint32_t events) override;
+
+  /**
+   * Called by the handle when it becomes ready for events.
+   */
+  void onReady(uint32_t events);
+
+  void onHandleDestroyed() { handle_ = nullptr; }
+
+private:
+  void onSchedule();
+
+  IoUringSocketHandleImpl* handle_;
+  Event::FileReadyCb cb_;
+  Event::SchedulableCallbackPtr schedule_cb_;
+  uint32_t enabled_{};
+  // Ready events, filtered by enabled_ when the callback runs.
+  uint32_t ready_{};
+  // Events injected by activate(), which fire regardless of enabled_.
+  uint32_t injected_{};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/network/exception.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
@@ -13,54 +14,97 @@
 #include "common/event/file_event_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
-
-#include "event2/listener.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 
 namespace Envoy {
 namespace Network {
 
 const absl::string_view ListenerImpl::GlobalMaxCxRuntimeKey =
     "overload.global_downstream_max_connections";
-
-bool ListenerImpl::rejectCxOverGlobalLimit() {
-  // Enforce the global connection limit if necessary, immediately closing the accepted connection.
+const absl::string_view ListenerImpl::IoUringRuntimeKey =
+    "envoy.reloadable_features.io_uring_downstream_connections";
+const absl::string_view ListenerImpl::MaxAcceptsPerWakeupRuntimeKey =
+    "listener.max_accepts_per_wakeup";
+
+ListenerImpl::AcceptBatchConfig ListenerImpl::acceptBatchConfig() {
+  AcceptBatchConfig config{DefaultMaxAcceptsPerWakeup, std::numeric_limits<uint64_t>::max(),
+                           nullptr};
   Runtime::Loader* runtime = Runtime::LoaderSingleton::getExisting();
-
   if (runtime == nullptr) {
     // The runtime singleton won't exist in most unit tests that do not need global downstream limit
     // enforcement. Therefore, there is no need to enforce limits if the singleton doesn't exist.
     // TODO(tonya11en): Revisit this once runtime is made globally available.
-    return false;
+    return config;
   }
 
-  // If the connection limit is not set, don't limit the connections, but still track them.
   // TODO(tonya11en): In integration tests, threadsafeSnapshot is necessary since the FakeUpstreams
   // use a listener and do not run in a worker thread. In practice, this code path will always be
   // run on a worker thread, but to prevent failed assertions in test environments, threadsafe
   // snapshots must be used. This must be revisited.
-  const uint64_t global_cx_limit = runtime->threadsafeSnapshot()->getInteger(
-      GlobalMaxCxRuntimeKey, std::numeric_limits<uint64_t>::max());
-  return AcceptedSocketImpl::acceptedSocketCount() >= global_cx_limit;
+  Runtime::SnapshotConstSharedPtr snapshot = runtime->threadsafeSnapshot();
+  config.max_accepts_ = std::max<uint64_t>(
+      1, snapshot->getInteger(MaxAcceptsPerWakeupRuntimeKey, DefaultMaxAcceptsPerWakeup));
+  // If the connection limit is not set, don't limit the connections, but still track them.
+  config.global_cx_limit_ =
+      snapshot->getInteger(GlobalMaxCxRuntimeKey, std::numeric_limits<uint64_t>::max());
+  if (snapshot->runtimeFeatureEnabled(IoUringRuntimeKey)) {
+    // Falls back to libevent if the kernel doesn't support io_uring.
+    config.io_uring_worker_ = dispatcher_.ioUringWorker();
+  }
+  return config;
 }
 
-void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                                  int remote_addr_len, void* arg) {
-  ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
+void ListenerImpl::onSocketEvent() {
+  const AcceptBatchConfig config = acceptBatchConfig();
+  uint32_t accepted = 0;
+  // Stop early if a callback disabled the listener.
+  while (accepted < config.max_accepts_ && enabled_) {
+    sockaddr_storage remote_addr;
+    socklen_t remote_addr_len = sizeof(remote_addr);
+    const Api::SysCallSocketResult result = Api::OsSysCallsSingleton::get().accept(
+        socket_->ioHandle().fd(), reinterpret_cast<sockaddr*>(&remote_addr), &remote_addr_len);
+    if (SOCKET_INVALID(result.rc_)) {
+      if (result.errno_ == SOCKET_ERROR_AGAIN) {
+        break;
+      }
+      if (result.errno_ == SOCKET_ERROR_INTR || result.errno_ == SOCKET_ERROR_CONN_ABORTED) {
+        // The connection went away before it was accepted, or the call was interrupted.
+        continue;
+      }
+      // This can happen if we run out of FDs or memory. In those cases just crash.
+      PANIC(fmt::format("listener accept failure: {}", errorDetails(result.errno_)));
+    }
+    accepted++;
+    onAccepted(result.rc_, remote_addr, remote_addr_len, config);
+  }
+  // Spurious wakeups, e.g. when another worker's listener accepted the connection first, aren't
+  // batches.
+  if (accepted > 0) {
+    cb_.onAcceptBatch(accepted);
+  }
+}
 
+void ListenerImpl::onAccepted(os_fd_t fd, const sockaddr_storage& remote_addr,
+                              socklen_t remote_addr_len, const AcceptBatchConfig& config) {
   // Wrap raw socket fd in IoHandle.
-  IoHandlePtr io_handle = SocketInterfaceSingleton::get().socket(fd);
+  IoHandlePtr io_handle;
+  if (config.io_uring_worker_ != nullptr) {
+    io_handle = std::make_unique<IoUringSocketHandleImpl>(fd, *config.io_uring_worker_);
+  } else {
+    io_handle = SocketInterfaceSingleton::get().socket(fd);
+  }
 
-  if (rejectCxOverGlobalLimit()) {
+  if (AcceptedSocketImpl::acceptedSocketCount() >= config.global_cx_limit_) {
     // The global connection limit has been reached.
     io_handle->close();
-    listener->cb_.onReject();
+    cb_.onReject();
     return;
   }
 
   // Get the local address from the new socket if the listener is listening on IP ANY
   // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
   const Address::InstanceConstSharedPtr& local_address =
-      listener->local_address_ ? listener->local_address_ : io_handle->localAddress();
+      local_address_ ? local_address_ : io_handle->localAddress();
 
   // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
   // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
@@ -70,56 +114,58 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
   // if the socket is a v4 socket, but for v6 sockets this will create an IPv4 remote address if an
   // IPv4 local_address was created from an IPv6 mapped IPv4 address.
   const Address::InstanceConstSharedPtr& remote_address =
-      (remote_addr->sa_family == AF_UNIX)
+      (remote_addr.ss_family == AF_UNIX)
           ? io_handle->peerAddress()
-          : Address::addressFromSockAddr(*reinterpret_cast<const sockaddr_storage*>(remote_addr),
-                                         remote_addr_len,
+          : Address::addressFromSockAddr(remote_addr, remote_addr_len,
                                          local_address->ip()->version() == Address::IpVersion::v6);
-  listener->cb_.onAccept(
+  cb_.onAccept(
       std::make_unique<AcceptedSocketImpl>(std::move(io_handle), local_address, remote_address));
 }
 
 void ListenerImpl::setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket) {
-  listener_.reset(
-      evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1, socket.ioHandle().fd()));
-
-  if (!listener_) {
-    throw CreateListenerException(
-        fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
+  // Listening on a socket that is already listening, e.g. one shared with another worker, one
+  // steered by incoming CPU or one inherited from the parent on hot restart, only updates its
+  // backlog.
+  const Api::SysCallIntResult result = socket.ioHandle().listen(ListenBacklog);
+  if (result.rc_ != 0) {
+    throw CreateListenerException(fmt::format("cannot listen() on socket: {}: {}",
+                                              socket.localAddress()->asString(),
+                                              errorDetails(result.errno_)));
   }
 
+  // Level triggered, so that connections left over by a full batch are accepted on the next
+  // iteration of the event loop.
+  file_event_ = dispatcher.createFileEvent(
+      socket.ioHandle().fd(), [this](uint32_t) { onSocketEvent(); },
+      Event::FileTriggerType::Level, Event::FileReadyType::Read);
+  enabled_ = true;
+
   if (!Network::Socket::applyOptions(socket.options(), socket,
                                      envoy::config::core::v3::SocketOption::STATE_LISTENING)) {
     throw CreateListenerException(fmt::format("cannot set post-listen socket option on socket: {}",
                                               socket.localAddress()->asString()));
   }
-
-  evconnlistener_set_error_cb(listener_.get(), errorCallback);
 }
 
 ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, SocketSharedPtr socket,
                            ListenerCallbacks& cb, bool bind_to_port)
-    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), listener_(nullptr) {
+    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb) {
   if (bind_to_port) {
     setupServerSocket(dispatcher, *socket_);
   }
 }
 
-void ListenerImpl::errorCallback(evconnlistener*, void*) {
-  // We should never get an error callback. This can happen if we run out of FDs or memory. In those
-  // cases just crash.
-  PANIC(fmt::format("listener accept failure: {}", errorDetails(errno)));
-}
-
 void ListenerImpl::enable() {
-  if (listener_.get()) {
-    evconnlistener_enable(listener_.get());
+  if (file_event_ != nullptr) {
+    file_event_->setEnabled(Event::FileReadyType::Read);
+    enabled_ = true;
   }
 }
 
 void ListenerImpl::disable() {
-  if (listener_.get()) {
-    evconnlistener_disable(listener_.get());
+  if (file_event_ != nullptr) {
+    file_event_->setEnabled(0);
+    enabled_ = false;
   }
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/common/platform.h"
+#include "envoy/event/file_event.h"
 #include "envoy/runtime/runtime.h"
 
 #include "absl/strings/string_view.h"
@@ -8,8 +10,13 @@
 namespace Envoy {
 namespace Network {
 
+class IoUringWorker;
+
 /**
- * libevent implementation of Network::Listener for TCP.
+ * libevent implementation of Network::Listener for TCP. Each time the listen socket becomes
+ * readable, up to the runtime value of MaxAcceptsPerWakeupRuntimeKey pending connections are
+ * accepted before returning to the event loop; the remaining ones are accepted on the next
+ * iteration.
  * TODO(conqerAtapple): Consider renaming the class to `TcpListenerImpl`.
  */
 class ListenerImpl : public BaseListenerImpl {
@@ -21,6 +28,11 @@ public:
   void enable() override;
 
   static const absl::string_view GlobalMaxCxRuntimeKey;
+  static const absl::string_view IoUringRuntimeKey;
+  static const absl::string_view MaxAcceptsPerWakeupRuntimeKey;
+  static constexpr uint32_t DefaultMaxAcceptsPerWakeup = 64;
+  // The backlog libevent's evconnlistener listened with before the listener accepted by itself.
+  static constexpr int ListenBacklog = 128;
 
 protected:
   void setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket);
@@ -28,15 +40,20 @@ protected:
   ListenerCallbacks& cb_;
 
 private:
-  static void listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                             int remote_addr_len, void* arg);
-  static void errorCallback(evconnlistener* listener, void* context);
-
-  // Returns true if global connection limit has been reached and the accepted socket should be
-  // rejected/closed. If the accepted socket is to be admitted, false is returned.
-  static bool rejectCxOverGlobalLimit();
-
-  Event::Libevent::ListenerPtr listener_;
+  // Runtime values read once per wakeup rather than once per accepted connection.
+  struct AcceptBatchConfig {
+    uint32_t max_accepts_;
+    uint64_t global_cx_limit_;
+    IoUringWorker* io_uring_worker_;
+  };
+
+  void onSocketEvent();
+  AcceptBatchConfig acceptBatchConfig();
+  void onAccepted(os_fd_t fd, const sockaddr_storage& remote_addr, socklen_t remote_addr_len,
+                  const AcceptBatchConfig& config);
+
+  Event::FileEventPtr file_event_;
+  bool enabled_{};
 };
 
 } // namespace Network
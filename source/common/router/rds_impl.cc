@@ -234,9 +234,7 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
   } else {
     initial_config = std::make_shared<NullConfigImpl>();
   }
-  tls_->set([initial_config](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<ThreadLocalConfig>(initial_config);
-  });
+  tls_->publish(std::make_shared<ThreadLocalConfig>(initial_config));
   // It should be 1:1 mapping due to shared rds config.
   ASSERT(subscription_->routeConfigProviders().empty());
   subscription_->routeConfigProviders().insert(this);
@@ -255,12 +253,8 @@ Router::ConfigConstSharedPtr RdsRouteConfigProviderImpl::config() {
 void RdsRouteConfigProviderImpl::onConfigUpdate() {
   ConfigConstSharedPtr new_config(new ConfigImpl(config_update_info_->routeConfiguration(),
                                                  factory_context_, validator_, false));
-  tls_->runOnAllThreads([new_config](ThreadLocal::ThreadLocalObjectSharedPtr previous)
-                            -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    auto prev_config = std::dynamic_pointer_cast<ThreadLocalConfig>(previous);
-    prev_config->config_ = new_config;
-    return previous;
-  });
+  // Route configs are immutable, so workers share them and pick up new ones on their next access.
+  tls_->publish(std::make_shared<ThreadLocalConfig>(new_config));
 
   const auto aliases = config_update_info_->resourceIdsInLastVhdsUpdate();
   // Regular (non-VHDS) RDS updates don't populate aliases fields in resources.
@@ -210,8 +210,8 @@ public:
 
 private:
   struct ThreadLocalConfig : public ThreadLocal::ThreadLocalObject {
-    ThreadLocalConfig(ConfigConstSharedPtr initial_config) : config_(std::move(initial_config)) {}
-    ConfigConstSharedPtr config_;
+    ThreadLocalConfig(ConfigConstSharedPtr config) : config_(std::move(config)) {}
+    const ConfigConstSharedPtr config_;
   };
 
   RdsRouteConfigProviderImpl(RdsRouteConfigSubscriptionSharedPtr&& subscription,
@@ -419,6 +419,9 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
     return Http::FilterHeadersStatus::StopIteration;
   }
   cluster_ = cluster->info();
+  if (cluster_->lbType() == Upstream::LoadBalancerType::PeakEwma) {
+    host_response_time_observer_ = cluster->hostResponseTimeObserver();
+  }
 
   // Set up stat prefixes, etc.
   request_vcluster_ = route_entry_->virtualCluster(headers);
@@ -815,6 +818,7 @@ void Filter::onResponseTimeout() {
       if (upstream_request->upstreamHost()) {
         upstream_request->upstreamHost()->stats().rq_timeout_.inc();
       }
+      reportHostResponseTime(*upstream_request);
 
       // If this upstream request already hit a "soft" timeout, then it
       // already recorded a timeout into outlier detection. Don't do it again.
@@ -873,6 +877,7 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
   if (upstream_request.upstreamHost()) {
     upstream_request.upstreamHost()->stats().rq_timeout_.inc();
   }
+  reportHostResponseTime(upstream_request);
 
   upstream_request.resetStream();
 
@@ -922,6 +927,31 @@ void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
   }
 }
 
+void Filter::reportHostResponseTime(UpstreamRequest& upstream_request) {
+  if (host_response_time_observer_.expired() || callbacks_->streamInfo().healthCheck() ||
+      upstream_request.upstreamHost() == nullptr) {
+    return;
+  }
+  // Time this try only, from its first byte sent, so that neither waiting for a connection nor
+  // earlier tries are charged to the host. A try that never sent anything says nothing about how
+  // the host responds; the outlier detector deals with connection failures.
+  const StreamInfo::UpstreamTiming& timing = upstream_request.upstreamTiming();
+  if (!timing.first_upstream_tx_byte_sent_.has_value()) {
+    return;
+  }
+  // A try that timed out or was reset is charged the time it has taken so far.
+  const MonotonicTime end = timing.last_upstream_rx_byte_received_.has_value()
+                                ? timing.last_upstream_rx_byte_received_.value()
+                                : callbacks_->dispatcher().timeSource().monotonicTime();
+  Upstream::HostResponseTimeObserverSharedPtr observer = host_response_time_observer_.lock();
+  if (observer != nullptr) {
+    // The peak EWMA LB needs better than millisecond resolution to tell fast hosts apart.
+    observer->onHostResponseTime(*upstream_request.upstreamHost(),
+                                 std::chrono::duration_cast<std::chrono::microseconds>(
+                                     end - timing.first_upstream_tx_byte_sent_.value()));
+  }
+}
+
 void Filter::chargeUpstreamAbort(Http::Code code, bool dropped, UpstreamRequest& upstream_request) {
   if (downstream_response_started_) {
     if (upstream_request.grpcRqSuccessDeferred()) {
@@ -1027,6 +1057,7 @@ void Filter::onUpstreamReset(Http::StreamResetReason reset_reason,
   // config param set to true.
   updateOutlierDetection(Upstream::Outlier::Result::LocalOriginConnectFailed, upstream_request,
                          absl::nullopt);
+  reportHostResponseTime(upstream_request);
 
   if (maybeRetryReset(reset_reason, upstream_request)) {
     return;
@@ -1334,6 +1365,8 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
       dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
 
+  reportHostResponseTime(upstream_request);
+
   if (cluster_->timeoutBudgetStats().has_value()) {
     cluster_->timeoutBudgetStats()->upstream_rq_timeout_budget_percent_used_.recordValue(
         FilterUtility::percentageOfTimeout(response_time, timeout_.global_timeout_));
@@ -508,6 +508,8 @@ private:
                                                 const Http::HeaderEntry& internal_redirect);
   void updateOutlierDetection(Upstream::Outlier::Result result, UpstreamRequest& upstream_request,
                               absl::optional<uint64_t> code);
+  // Reports how long the host took to answer, or has been failing to, to peak EWMA clusters.
+  void reportHostResponseTime(UpstreamRequest& upstream_request);
   void doRetry();
   // Called immediately after a non-5xx header is received from upstream, performs stats accounting
   // and handle difference between gRPC and non-gRPC requests.
@@ -521,6 +523,8 @@ private:
   RouteConstSharedPtr route_;
   const RouteEntry* route_entry_{};
   Upstream::ClusterInfoConstSharedPtr cluster_;
+  // Set for peak EWMA clusters, which learn from the response time of each try.
+  Upstream::HostResponseTimeObserverWeakPtr host_response_time_observer_;
   std::unique_ptr<Stats::StatNameDynamicStorage> alt_stat_prefix_;
   const VirtualCluster* request_vcluster_;
   Event::TimerPtr response_timeout_;
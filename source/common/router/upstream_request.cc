@@ -290,8 +290,8 @@ void UpstreamRequest::resetStream() {
 void UpstreamRequest::setupPerTryTimeout() {
   ASSERT(!per_try_timeout_);
   if (parent_.timeout().per_try_timeout_.count() > 0) {
-    per_try_timeout_ =
-        parent_.callbacks()->dispatcher().createTimer([this]() -> void { onPerTryTimeout(); });
+    per_try_timeout_ = parent_.callbacks()->dispatcher().createCoarseTimer(
+        [this]() -> void { onPerTryTimeout(); });
     per_try_timeout_->enableTimer(parent_.timeout().per_try_timeout_);
   }
 }
@@ -91,6 +91,8 @@ constexpr const char* disabled_runtime_features[] = {
     "envoy.reloadable_features.test_feature_false",
     // TODO(alyssawilk) flip true after the release.
     "envoy.reloadable_features.new_tcp_connection_pool",
+    // Opt-in: requires Linux 5.7 or later, and only covers plaintext downstream connections.
+    "envoy.reloadable_features.io_uring_downstream_connections",
 };
 
 RuntimeFeatures::RuntimeFeatures() {
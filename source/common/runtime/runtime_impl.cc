@@ -584,9 +584,8 @@ void RtdsSubscription::validateUpdateSize(uint32_t num_resources) {
 
 void LoaderImpl::loadNewSnapshot() {
   std::shared_ptr<SnapshotImpl> ptr = createNewSnapshot();
-  tls_->set([ptr](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(ptr);
-  });
+  // Snapshots are immutable, so workers share them and pick up new ones on their next access.
+  tls_->publish(ptr);
 
   {
     absl::MutexLock lock(&snapshot_mutex_);
@@ -396,7 +396,7 @@ OriginalConnPoolImpl::ActiveConn::ActiveConn(OriginalConnPoolImpl& parent)
                              parent_.host_->cluster().stats().upstream_cx_rx_bytes_buffered_,
                              parent_.host_->cluster().stats().upstream_cx_tx_bytes_total_,
                              parent_.host_->cluster().stats().upstream_cx_tx_bytes_buffered_,
-                             &parent_.host_->cluster().stats().bind_errors_, nullptr});
+                             &parent_.host_->cluster().stats().bind_errors_, nullptr, nullptr});
 
   // We just universally set no delay on connections. Theoretically we might at some point want
   // to make this configurable.
@@ -0,0 +1,223 @@
+#include "common/tcp_proxy/splicer.h"
+
+#include <algorithm>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace TcpProxy {
+
+Splicer::Splicer(Callbacks& callbacks) : callbacks_(callbacks) {}
+
+Splicer::~Splicer() {
+  // Drop the events before closing the descriptors they watch.
+  downstream_.file_event_.reset();
+  upstream_.file_event_.reset();
+
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  for (const os_fd_t fd : {downstream_.fd_, upstream_.fd_, pipes_[0].read_end_,
+                           pipes_[0].write_end_, pipes_[1].read_end_, pipes_[1].write_end_}) {
+    if (SOCKET_VALID(fd)) {
+      os_syscalls.close(fd);
+    }
+  }
+}
+
+#if defined(__linux__)
+
+SplicerPtr Splicer::create(Event::Dispatcher& dispatcher, os_fd_t downstream_fd,
+                           os_fd_t upstream_fd, uint32_t downstream_buffer_limit,
+                           uint32_t upstream_buffer_limit, Callbacks& callbacks) {
+  SplicerPtr splicer(new Splicer(callbacks));
+  Pipe& to_upstream = splicer->pipes_[static_cast<size_t>(Direction::DownstreamToUpstream)];
+  Pipe& to_downstream = splicer->pipes_[static_cast<size_t>(Direction::UpstreamToDownstream)];
+
+  // The connections own the original descriptors and close them before raising their close
+  // events. Working on duplicates keeps the file events below valid until the splicer is gone.
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  Api::SysCallIntResult result = os_syscalls.fcntl(downstream_fd, F_DUPFD_CLOEXEC, 0);
+  splicer->downstream_.fd_ = result.rc_;
+  if (SOCKET_VALID(splicer->downstream_.fd_)) {
+    result = os_syscalls.fcntl(upstream_fd, F_DUPFD_CLOEXEC, 0);
+    splicer->upstream_.fd_ = result.rc_;
+  }
+  if (SOCKET_INVALID(splicer->downstream_.fd_) || SOCKET_INVALID(splicer->upstream_.fd_) ||
+      !splicer->setUpPipe(to_upstream, upstream_buffer_limit, result) ||
+      !splicer->setUpPipe(to_downstream, downstream_buffer_limit, result)) {
+    ENVOY_LOG(debug, "failed to set up splice: {}", errorDetails(result.errno_));
+    return nullptr;
+  }
+
+  splicer->downstream_.ingress_ = &to_upstream;
+  splicer->downstream_.egress_ = &to_downstream;
+  splicer->upstream_.ingress_ = &to_downstream;
+  splicer->upstream_.egress_ = &to_upstream;
+  for (Endpoint* endpoint : {&splicer->downstream_, &splicer->upstream_}) {
+    endpoint->file_event_ = dispatcher.createFileEvent(
+        endpoint->fd_,
+        [splicer = splicer.get(), endpoint](uint32_t events) {
+          splicer->onFileEvent(*endpoint, events);
+        },
+        Event::FileTriggerType::Level, Event::FileReadyType::Read);
+  }
+  return splicer;
+}
+
+bool Splicer::setUpPipe(Pipe& pipe, uint32_t buffer_limit, Api::SysCallIntResult& result) {
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  int fds[2];
+  result = os_syscalls.pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+  if (result.rc_ != 0) {
+    return false;
+  }
+  pipe.read_end_ = fds[0];
+  pipe.write_end_ = fds[1];
+
+  // Try to make room for a whole buffer limit. Unprivileged processes can't grow a pipe beyond
+  // /proc/sys/fs/pipe-max-size, in which case the watermarks are scaled down to what the pipe
+  // can hold.
+  if (buffer_limit > 0) {
+    os_syscalls.fcntl(pipe.write_end_, F_SETPIPE_SZ, static_cast<int>(buffer_limit));
+  }
+  result = os_syscalls.fcntl(pipe.write_end_, F_GETPIPE_SZ, 0);
+  if (result.rc_ <= 0) {
+    return false;
+  }
+  const uint64_t capacity = result.rc_;
+  pipe.high_watermark_ = buffer_limit > 0 ? std::min<uint64_t>(buffer_limit, capacity) : capacity;
+  pipe.low_watermark_ = pipe.high_watermark_ / 2;
+  return true;
+}
+
+void Splicer::onFileEvent(Endpoint& endpoint, uint32_t events) {
+  if ((events & Event::FileReadyType::Write) && !flush(endpoint)) {
+    return;
+  }
+  if ((events & Event::FileReadyType::Read) && !fill(endpoint)) {
+    return;
+  }
+  updateEvents(downstream_);
+  updateEvents(upstream_);
+}
+
+bool Splicer::fill(Endpoint& endpoint) {
+  Pipe& pipe = *endpoint.ingress_;
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  while (readable(pipe)) {
+    const Api::SysCallSizeResult result =
+        os_syscalls.splice(endpoint.fd_, pipe.write_end_, pipe.high_watermark_ - pipe.buffered_,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result.rc_ > 0) {
+      pipe.buffered_ += result.rc_;
+    } else if (result.rc_ == 0) {
+      pipe.end_stream_ = true;
+    } else if (result.errno_ == EAGAIN) {
+      // EAGAIN doesn't tell an empty socket from a pipe that has run out of slots before reaching
+      // its high watermark. Only in the latter case, when the socket still has data to read, stop
+      // reading until some of the pipe has been flushed, so that a level triggered read event
+      // doesn't spin. Otherwise reading is only paused by the watermarks.
+      pipe.full_ = pipe.buffered_ > 0 && hasPendingData(endpoint);
+      break;
+    } else if (result.errno_ != EINTR) {
+      ENVOY_LOG(debug, "splice read error: {}", errorDetails(result.errno_));
+      downstream_.file_event_->setEnabled(0);
+      upstream_.file_event_->setEnabled(0);
+      callbacks_.onSpliceError(pipe.direction_, result.errno_);
+      return false;
+    }
+  }
+
+  if (!pipe.above_high_watermark_ && pipe.buffered_ >= pipe.high_watermark_) {
+    pipe.above_high_watermark_ = true;
+    callbacks_.onSpliceReadDisable(pipe.direction_, true);
+  }
+  return flush(&endpoint == &downstream_ ? upstream_ : downstream_);
+}
+
+bool Splicer::flush(Endpoint& endpoint) {
+  Pipe& pipe = *endpoint.egress_;
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  uint64_t bytes_written = 0;
+  int error = 0;
+  while (pipe.buffered_ > 0) {
+    const Api::SysCallSizeResult result = os_syscalls.splice(
+        pipe.read_end_, endpoint.fd_, pipe.buffered_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result.rc_ > 0) {
+      pipe.buffered_ -= result.rc_;
+      pipe.full_ = false;
+      bytes_written += result.rc_;
+    } else if (result.rc_ < 0 && result.errno_ == EINTR) {
+      continue;
+    } else {
+      if (result.rc_ < 0 && result.errno_ != EAGAIN) {
+        error = result.errno_;
+      }
+      break;
+    }
+  }
+
+  if (bytes_written > 0) {
+    callbacks_.onSplicedData(pipe.direction_, bytes_written);
+  }
+  if (error != 0) {
+    ENVOY_LOG(debug, "splice write error: {}", errorDetails(error));
+    downstream_.file_event_->setEnabled(0);
+    upstream_.file_event_->setEnabled(0);
+    callbacks_.onSpliceError(pipe.direction_, error);
+    return false;
+  }
+  if (pipe.above_high_watermark_ && pipe.buffered_ <= pipe.low_watermark_) {
+    pipe.above_high_watermark_ = false;
+    callbacks_.onSpliceReadDisable(pipe.direction_, false);
+  }
+  if (pipe.end_stream_ && pipe.buffered_ == 0 && !pipe.end_stream_reported_) {
+    pipe.end_stream_reported_ = true;
+    updateEvents(downstream_);
+    updateEvents(upstream_);
+    callbacks_.onSpliceEndStream(pipe.direction_);
+    return false;
+  }
+  return true;
+}
+
+bool Splicer::hasPendingData(const Endpoint& endpoint) const {
+  int pending = 0;
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().ioctl(endpoint.fd_, FIONREAD, &pending);
+  return result.rc_ != 0 || pending > 0;
+}
+
+bool Splicer::readable(const Pipe& pipe) const {
+  return !pipe.end_stream_ && !pipe.full_ && pipe.buffered_ < pipe.high_watermark_;
+}
+
+void Splicer::updateEvents(Endpoint& endpoint) {
+  uint32_t events = 0;
+  if (readable(*endpoint.ingress_)) {
+    events |= Event::FileReadyType::Read;
+  }
+  if (endpoint.egress_->buffered_ > 0) {
+    events |= Event::FileReadyType::Write;
+  }
+  endpoint.file_event_->setEnabled(events);
+}
+
+#else
+
+SplicerPtr Splicer::create(Event::Dispatcher&, os_fd_t, os_fd_t, uint32_t, uint32_t, Callbacks&) {
+  return nullptr;
+}
+
+#endif
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/common/platform.h"
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+class Splicer;
+using SplicerPtr = std::unique_ptr<Splicer>;
+
+/**
+ * Forwards data between a downstream and an upstream socket in both directions with splice(2),
+ * through one pipe per direction, so that the payload is never copied into user space.
+ *
+ * Each pipe stands in for the write buffer of the connection it drains into and uses the same
+ * watermarks as a WatermarkBuffer with that connection's buffer limit: reading from the source
+ * socket stops once the pipe holds high watermark bytes and resumes once it has drained to half
+ * of that.
+ *
+ * The splicer works on duplicates of the sockets, so the connections that own them must not read
+ * from or write to them while the splicer exists.
+ */
+class Splicer : Logger::Loggable<Logger::Id::filter> {
+public:
+  enum class Direction { DownstreamToUpstream, UpstreamToDownstream };
+
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called after bytes have been written to the destination socket of a direction.
+     * @param direction supplies the direction.
+     * @param bytes supplies the number of bytes written.
+     */
+    virtual void onSplicedData(Direction direction, uint64_t bytes) PURE;
+
+    /**
+     * Called when reading from the source socket of a direction is paused because the pipe went
+     * above its high watermark, or resumed because it drained below its low watermark.
+     * @param direction supplies the direction.
+     * @param disable supplies true if reading was paused, false if it was resumed.
+     */
+    virtual void onSpliceReadDisable(Direction direction, bool disable) PURE;
+
+    /**
+     * Called once the source socket of a direction reached end of stream and everything read
+     * from it has been written to the destination socket. The splicer may be destroyed from
+     * within this callback.
+     * @param direction supplies the direction.
+     */
+    virtual void onSpliceEndStream(Direction direction) PURE;
+
+    /**
+     * Called when reading or writing fails. The splicer may be destroyed from within this
+     * callback and must not be used afterwards.
+     * @param direction supplies the direction that failed.
+     * @param error supplies the errno of the failed call.
+     */
+    virtual void onSpliceError(Direction direction, int error) PURE;
+  };
+
+  /**
+   * @param dispatcher supplies the dispatcher of the two connections.
+   * @param downstream_fd supplies the downstream socket.
+   * @param upstream_fd supplies the upstream socket.
+   * @param downstream_buffer_limit supplies the buffer limit of the downstream connection, which
+   *        bounds the pipe draining into it. 0 means the default pipe capacity.
+   * @param upstream_buffer_limit supplies the buffer limit of the upstream connection.
+   * @param callbacks supplies the callbacks, which must outlive the splicer.
+   * @return SplicerPtr the splicer, or nullptr if splice isn't supported on this platform or the
+   *         pipes couldn't be set up.
+   */
+  static SplicerPtr create(Event::Dispatcher& dispatcher, os_fd_t downstream_fd,
+                           os_fd_t upstream_fd, uint32_t downstream_buffer_limit,
+                           uint32_t upstream_buffer_limit, Callbacks& callbacks);
+
+  ~Splicer();
+
+  /**
+   * @return the number of bytes read from the source of a direction but not yet written to its
+   *         destination.
+   */
+  uint64_t bufferedBytes(Direction direction) const {
+    return pipes_[static_cast<size_t>(direction)].buffered_;
+  }
+
+private:
+  struct Pipe {
+    const Direction direction_;
+    os_fd_t read_end_{INVALID_SOCKET};
+    os_fd_t write_end_{INVALID_SOCKET};
+    uint64_t buffered_{};
+    uint64_t high_watermark_{};
+    uint64_t low_watermark_{};
+    // Set while the pipe is above its high watermark.
+    bool above_high_watermark_{};
+    // Set when the kernel refused more data although the pipe is below its high watermark and
+    // the source socket has data to read. This happens when the pipe runs out of slots before
+    // bytes, as each slot may hold a partial page.
+    bool full_{};
+    // Set once the source socket reached end of stream.
+    bool end_stream_{};
+    bool end_stream_reported_{};
+  };
+
+  struct Endpoint {
+    os_fd_t fd_{INVALID_SOCKET};
+    Event::FileEventPtr file_event_;
+    // The pipe this socket is read into and the pipe that is written to this socket.
+    Pipe* ingress_{};
+    Pipe* egress_{};
+  };
+
+  explicit Splicer(Callbacks& callbacks);
+
+  // Sets result to the failed call, if any.
+  bool setUpPipe(Pipe& pipe, uint32_t buffer_limit, Api::SysCallIntResult& result);
+  void onFileEvent(Endpoint& endpoint, uint32_t events);
+  // Both return false if a callback that may have destroyed the splicer has been invoked.
+  bool fill(Endpoint& endpoint);
+  bool flush(Endpoint& endpoint);
+  // Returns true if the socket has data to read, or if that can't be told.
+  bool hasPendingData(const Endpoint& endpoint) const;
+  bool readable(const Pipe& pipe) const;
+  void updateEvents(Endpoint& endpoint);
+
+  Callbacks& callbacks_;
+  std::array<Pipe, 2> pipes_{
+      {{Direction::DownstreamToUpstream}, {Direction::UpstreamToDownstream}}};
+  Endpoint downstream_;
+  Endpoint upstream_;
+};
+
+} // namespace TcpProxy
+} // namespace Envoy
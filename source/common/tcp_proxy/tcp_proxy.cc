@@ -14,6 +14,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/access_log/access_log_impl.h"
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
@@ -22,6 +23,7 @@
 #include "common/common/utility.h"
 #include "common/config/well_known_names.h"
 #include "common/network/application_protocol.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -115,6 +117,7 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      use_splice_(config.use_splice()),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.random()) {
@@ -224,7 +227,7 @@ Filter::~Filter() {
 }
 
 TcpProxyStats Config::SharedConfig::generateStats(Stats::Scope& scope) {
-  return {ALL_TCP_PROXY_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope))};
+  return {ALL_TCP_PROXY_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
 void Filter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
@@ -249,7 +252,8 @@ void Filter::initialize(Network::ReadFilterCallbacks& callbacks, bool set_connec
         {config_->stats().downstream_cx_rx_bytes_total_,
          config_->stats().downstream_cx_rx_bytes_buffered_,
          config_->stats().downstream_cx_tx_bytes_total_,
-         config_->stats().downstream_cx_tx_bytes_buffered_, nullptr, nullptr});
+         config_->stats().downstream_cx_tx_bytes_buffered_, nullptr, nullptr,
+         &config_->stats().downstream_cx_read_size_});
   }
 }
 
@@ -515,12 +519,108 @@ void Filter::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
   Tcp::ConnectionPool::ConnectionData* latched_data = conn_data.get();
 
   upstream_ = std::make_unique<TcpUpstream>(std::move(conn_data), *upstream_callbacks_);
+  if (config_->useSplice()) {
+    maybeSplice(latched_data->connection(), host);
+  }
   onPoolReadyBase(host, latched_data->connection().localAddress(),
                   latched_data->connection().streamInfo().downstreamSslConnection());
   read_callbacks_->connection().streamInfo().setUpstreamFilterState(
       latched_data->connection().streamInfo().filterState());
 }
 
+void Filter::maybeSplice(Network::ClientConnection& upstream_connection,
+                         const Upstream::HostDescriptionConstSharedPtr& host) {
+  // Spliced data never passes through the transport sockets, so both of them must be plaintext.
+  Network::Connection& downstream_connection = read_callbacks_->connection();
+  // Bytes already buffered by either connection would be reordered with the spliced ones.
+  if (downstream_connection.bufferedBytes() > 0 || upstream_connection.bufferedBytes() > 0) {
+    ENVOY_CONN_LOG(debug, "not splicing, data is buffered", downstream_connection);
+    return;
+  }
+  if (downstream_connection.ssl() != nullptr || upstream_connection.ssl() != nullptr ||
+      host->transportSocketFactory().implementsSecureTransport()) {
+    return;
+  }
+  // Neither can a socket that io_uring keeps a read in flight on.
+  const auto* io_uring_handle =
+      dynamic_cast<const Network::IoUringSocketHandleImpl*>(&downstream_connection.ioHandle());
+  if (io_uring_handle != nullptr && io_uring_handle->ioUringActive()) {
+    return;
+  }
+
+  splicer_ = Splicer::create(
+      downstream_connection.dispatcher(), downstream_connection.ioHandle().fd(),
+      upstream_connection.ioHandle().fd(), downstream_connection.bufferLimit(),
+      upstream_connection.bufferLimit(), *this);
+  if (splicer_ == nullptr) {
+    return;
+  }
+
+  // The downstream connection is still read disabled from initialize() and stays that way. Both
+  // sockets are only read by the splicer from now on.
+  upstream_connection.readDisable(true);
+  config_->stats().downstream_cx_spliced_total_.inc();
+  ENVOY_CONN_LOG(debug, "splicing to upstream connection", downstream_connection);
+}
+
+void Filter::onSplicedData(Splicer::Direction direction, uint64_t bytes) {
+  Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+  if (direction == Splicer::Direction::DownstreamToUpstream) {
+    config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+    config_->stats().downstream_cx_rx_bytes_spliced_.add(bytes);
+    cluster_stats.upstream_cx_tx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesReceived(bytes);
+  } else {
+    config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+    config_->stats().downstream_cx_tx_bytes_spliced_.add(bytes);
+    cluster_stats.upstream_cx_rx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesSent(bytes);
+  }
+  resetIdleTimer();
+}
+
+void Filter::onSpliceReadDisable(Splicer::Direction direction, bool disable) {
+  // The pipes stand in for the write buffers, so account for them like their watermark callbacks.
+  if (direction == Splicer::Direction::DownstreamToUpstream) {
+    if (disable) {
+      config_->stats().downstream_flow_control_paused_reading_total_.inc();
+    } else {
+      config_->stats().downstream_flow_control_resumed_reading_total_.inc();
+    }
+  } else {
+    Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+    if (disable) {
+      cluster_stats.upstream_flow_control_paused_reading_total_.inc();
+    } else {
+      cluster_stats.upstream_flow_control_resumed_reading_total_.inc();
+    }
+  }
+}
+
+void Filter::onSpliceEndStream(Splicer::Direction direction) {
+  ENVOY_CONN_LOG(trace, "spliced end_stream, direction={}", read_callbacks_->connection(),
+                 static_cast<int>(direction));
+  // Half close the destination through its connection, which writes nothing but the FIN.
+  Buffer::OwnedImpl empty;
+  if (direction == Splicer::Direction::DownstreamToUpstream) {
+    ASSERT(upstream_ != nullptr);
+    upstream_->encodeData(empty, true);
+  } else {
+    read_callbacks_->connection().write(empty, true);
+  }
+
+  // Neither connection reads its socket, so neither notices the end of stream by itself.
+  if (++spliced_end_streams_ == 2) {
+    read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
+  }
+}
+
+void Filter::onSpliceError(Splicer::Direction, int error) {
+  ENVOY_CONN_LOG(debug, "splice failed: {}", read_callbacks_->connection(), errorDetails(error));
+  // This results in also closing the upstream connection.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+}
+
 void Filter::onPoolFailure(ConnectionPool::PoolFailureReason failure, absl::string_view,
                            Upstream::HostDescriptionConstSharedPtr host) {
   onPoolFailure(failure, host);
@@ -563,6 +663,11 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::LocalClose ||
+      event == Network::ConnectionEvent::RemoteClose) {
+    // The splicer holds duplicates of both sockets, which would otherwise keep them open.
+    splicer_.reset();
+  }
   if (upstream_) {
     Tcp::ConnectionPool::ConnectionDataPtr conn_data(upstream_->onDownstreamEvent(event));
     if (conn_data != nullptr &&
@@ -602,6 +707,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splicer_.reset();
     upstream_.reset();
     disableIdleTimer();
 
@@ -620,8 +726,10 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
     }
   } else if (event == Network::ConnectionEvent::Connected) {
     // Re-enable downstream reads now that the upstream connection is established
-    // so we have a place to send downstream data to.
-    read_callbacks_->connection().readDisable(false);
+    // so we have a place to send downstream data to, unless the splicer reads them.
+    if (splicer_ == nullptr) {
+      read_callbacks_->connection().readDisable(false);
+    }
 
     read_callbacks_->upstreamHost()->outlierDetector().putResult(
         Upstream::Outlier::Result::LocalOriginConnectSuccessFinal);
@@ -634,7 +742,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
       // The idle_timer_ can be moved to a Drainer, so related callbacks call into
       // the UpstreamCallbacks, which has the same lifetime as the timer, and can dispatch
       // the call to either TcpProxy or to Drainer, depending on the current state.
-      idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+      idle_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
           [upstream_callbacks = upstream_callbacks_]() { upstream_callbacks->onIdleTimeout(); });
       resetIdleTimer();
       read_callbacks_->connection().addBytesSentCallback([this](uint64_t) { resetIdleTimer(); });
@@ -26,6 +26,7 @@
 #include "common/network/hash_policy.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
+#include "common/tcp_proxy/splicer.h"
 #include "common/tcp_proxy/upstream.h"
 #include "common/upstream/load_balancer_impl.h"
 
@@ -35,10 +36,13 @@ namespace TcpProxy {
 /**
  * All tcp proxy stats. @see stats_macros.h
  */
-#define ALL_TCP_PROXY_STATS(COUNTER, GAUGE)                                                        \
+#define ALL_TCP_PROXY_STATS(COUNTER, GAUGE, HISTOGRAM)                                             \
   COUNTER(downstream_cx_no_route)                                                                  \
+  COUNTER(downstream_cx_rx_bytes_spliced)                                                          \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_spliced_total)                                                             \
   COUNTER(downstream_cx_total)                                                                     \
+  COUNTER(downstream_cx_tx_bytes_spliced)                                                          \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
   COUNTER(downstream_flow_control_resumed_reading_total)                                           \
@@ -46,13 +50,14 @@ namespace TcpProxy {
   COUNTER(upstream_flush_total)                                                                    \
   GAUGE(downstream_cx_rx_bytes_buffered, Accumulate)                                               \
   GAUGE(downstream_cx_tx_bytes_buffered, Accumulate)                                               \
-  GAUGE(upstream_flush_active, Accumulate)
+  GAUGE(upstream_flush_active, Accumulate)                                                         \
+  HISTOGRAM(downstream_cx_read_size, Bytes)
 
 /**
  * Struct definition for all tcp proxy stats. @see stats_macros.h
  */
 struct TcpProxyStats {
-  ALL_TCP_PROXY_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_TCP_PROXY_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 class Drainer;
@@ -137,6 +142,7 @@ public:
   const TcpProxyStats& stats() { return shared_config_->stats(); }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() { return access_logs_; }
   uint32_t maxConnectAttempts() const { return max_connect_attempts_; }
+  bool useSplice() const { return use_splice_; }
   const absl::optional<std::chrono::milliseconds>& idleTimeout() {
     return shared_config_->idleTimeout();
   }
@@ -203,6 +209,7 @@ private:
   uint64_t total_cluster_weight_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   const uint32_t max_connect_attempts_;
+  const bool use_splice_;
   ThreadLocal::SlotPtr upstream_drain_manager_slot_;
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
@@ -234,6 +241,7 @@ class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                Tcp::ConnectionPool::Callbacks,
                public Http::ConnectionPool::Callbacks,
+               Splicer::Callbacks,
                protected Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager);
@@ -258,6 +266,12 @@ public:
                    Upstream::HostDescriptionConstSharedPtr host,
                    const StreamInfo::StreamInfo& info) override;
 
+  // Splicer::Callbacks
+  void onSplicedData(Splicer::Direction direction, uint64_t bytes) override;
+  void onSpliceReadDisable(Splicer::Direction direction, bool disable) override;
+  void onSpliceEndStream(Splicer::Direction direction) override;
+  void onSpliceError(Splicer::Direction direction, int error) override;
+
   void onPoolReadyBase(Upstream::HostDescriptionConstSharedPtr& host,
                        const Network::Address::InstanceConstSharedPtr& local_address,
                        Ssl::ConnectionInfoConstSharedPtr ssl_info);
@@ -354,6 +368,8 @@ protected:
   void initialize(Network::ReadFilterCallbacks& callbacks, bool set_connection_stats);
   Network::FilterStatus initializeUpstreamConnection();
   bool maybeTunnel(const std::string& cluster_name);
+  void maybeSplice(Network::ClientConnection& upstream_connection,
+                   const Upstream::HostDescriptionConstSharedPtr& host);
   void onConnectTimeout();
   void onDownstreamEvent(Network::ConnectionEvent event);
   void onUpstreamData(Buffer::Instance& data, bool end_stream);
@@ -373,6 +389,9 @@ protected:
   std::shared_ptr<UpstreamCallbacks> upstream_callbacks_; // shared_ptr required for passing as a
                                                           // read filter.
   std::unique_ptr<GenericUpstream> upstream_;
+  // Set while data is spliced between the two sockets instead of passing through the connections.
+  SplicerPtr splicer_;
+  uint32_t spliced_end_streams_{};
   RouteConstSharedPtr route_;
   Network::TransportSocketOptionsSharedPtr transport_socket_options_;
   uint32_t connect_attempts_{};
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <cstdint>
 #include <list>
+#include <memory>
 
 #include "envoy/event/dispatcher.h"
 
@@ -19,6 +20,7 @@ InstanceImpl::~InstanceImpl() {
   ASSERT(std::this_thread::get_id() == main_thread_id_);
   ASSERT(shutdown_);
   thread_local_data_.data_.clear();
+  thread_local_data_.versions_.clear();
 }
 
 SlotPtr InstanceImpl::allocateSlot() {
@@ -40,22 +42,60 @@ SlotPtr InstanceImpl::allocateSlot() {
 }
 
 bool InstanceImpl::SlotImpl::currentThreadRegistered() {
+  if (version_.load(std::memory_order_relaxed) != 0) {
+    // Published objects are fetched on first access, so any thread with a dispatcher has one.
+    return thread_local_data_.dispatcher_ != nullptr;
+  }
   return thread_local_data_.data_.size() > index_;
 }
 
 void InstanceImpl::SlotImpl::runOnAllThreads(const UpdateCb& cb) {
+  ASSERT(version_ == 0);
   parent_.runOnAllThreads([this, cb]() { setThreadLocal(index_, cb(get())); });
 }
 
 void InstanceImpl::SlotImpl::runOnAllThreads(const UpdateCb& cb, Event::PostCb complete_cb) {
+  ASSERT(version_ == 0);
   parent_.runOnAllThreads([this, cb]() { setThreadLocal(index_, cb(get())); }, complete_cb);
 }
 
 ThreadLocalObjectSharedPtr InstanceImpl::SlotImpl::get() {
+  const uint64_t version = version_.load(std::memory_order_acquire);
+  if (version != 0 && (thread_local_data_.versions_.size() <= index_ ||
+                       thread_local_data_.versions_[index_] != version)) {
+    refreshPublished(version);
+  }
   ASSERT(currentThreadRegistered());
   return thread_local_data_.data_[index_];
 }
 
+void InstanceImpl::SlotImpl::publish(ThreadLocalObjectSharedPtr object) {
+  ASSERT(std::this_thread::get_id() == parent_.main_thread_id_);
+  ASSERT(!parent_.shutdown_);
+  std::atomic_store(&published_, std::move(object));
+  // Release ordering makes the object stored above visible to the threads that see the version.
+  version_.store(++parent_.last_published_version_, std::memory_order_release);
+}
+
+void InstanceImpl::SlotImpl::refreshPublished(uint64_t version) {
+  if (thread_local_data_.data_.size() <= index_) {
+    thread_local_data_.data_.resize(index_ + 1);
+  }
+  if (thread_local_data_.versions_.size() <= index_) {
+    thread_local_data_.versions_.resize(index_ + 1);
+  }
+  // A newer object may have been published since the version was loaded. The thread then picks
+  // it up again on its next access, which is harmless.
+  ThreadLocalObjectSharedPtr previous = std::move(thread_local_data_.data_[index_]);
+  thread_local_data_.data_[index_] = std::atomic_load(&published_);
+  thread_local_data_.versions_[index_] = version;
+  // The current event may still hold references into the previous object, e.g. from an earlier
+  // get() on this thread, so release it once the thread is back in its event loop.
+  if (previous != nullptr && thread_local_data_.dispatcher_ != nullptr) {
+    thread_local_data_.dispatcher_->post([previous]() {});
+  }
+}
+
 InstanceImpl::Bookkeeper::Bookkeeper(InstanceImpl& parent, std::unique_ptr<SlotImpl>&& slot)
     : parent_(parent), slot_(std::move(slot)),
       ref_count_(/*not used.*/ nullptr,
@@ -96,6 +136,11 @@ void InstanceImpl::Bookkeeper::runOnAllThreads(Event::PostCb cb, Event::PostCb m
                          main_callback);
 }
 
+void InstanceImpl::Bookkeeper::publish(ThreadLocalObjectSharedPtr object) {
+  // Nothing is posted, so there are no callbacks to keep track of.
+  slot_->publish(std::move(object));
+}
+
 void InstanceImpl::Bookkeeper::set(InitializeCb cb) {
   slot_->set([cb, ref_count = this->ref_count_](Event::Dispatcher& dispatcher)
                  -> ThreadLocalObjectSharedPtr { return cb(dispatcher); });
@@ -171,6 +216,9 @@ void InstanceImpl::removeSlot(SlotImpl& slot) {
     if (index < thread_local_data_.data_.size()) {
       thread_local_data_.data_[index] = nullptr;
     }
+    if (index < thread_local_data_.versions_.size()) {
+      thread_local_data_.versions_[index] = 0;
+    }
   });
 }
 
@@ -208,6 +256,7 @@ void InstanceImpl::runOnAllThreads(Event::PostCb cb, Event::PostCb all_threads_c
 void InstanceImpl::SlotImpl::set(InitializeCb cb) {
   ASSERT(std::this_thread::get_id() == parent_.main_thread_id_);
   ASSERT(!parent_.shutdown_);
+  ASSERT(version_ == 0);
 
   for (Event::Dispatcher& dispatcher : parent_.registered_threads_) {
     const uint32_t index = index_;
@@ -262,6 +311,7 @@ void InstanceImpl::shutdownThread() {
     it->reset();
   }
   thread_local_data_.data_.clear();
+  thread_local_data_.versions_.clear();
 }
 
 Event::Dispatcher& InstanceImpl::dispatcher() {
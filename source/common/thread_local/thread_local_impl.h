@@ -45,9 +45,19 @@ private:
       parent_.runOnAllThreads(cb, main_callback);
     }
     void set(InitializeCb cb) override;
+    void publish(ThreadLocalObjectSharedPtr object) override;
+
+    // Replaces the object of the current thread with the published one.
+    void refreshPublished(uint64_t version);
 
     InstanceImpl& parent_;
     const uint64_t index_;
+    // The version of published_, or 0 if the slot has never published. Versions are unique across
+    // slots, so that a thread never mistakes the object cached for a removed slot for the published
+    // object of a new slot at the same index.
+    std::atomic<uint64_t> version_{0};
+    // Only accessed with std::atomic_load() and std::atomic_store().
+    ThreadLocalObjectSharedPtr published_;
   };
 
   // A Wrapper of SlotImpl which on destruction returns the SlotImpl to the deferred delete queue
@@ -64,6 +74,7 @@ private:
     void runOnAllThreads(Event::PostCb cb) override;
     void runOnAllThreads(Event::PostCb cb, Event::PostCb main_callback) override;
     void set(InitializeCb cb) override;
+    void publish(ThreadLocalObjectSharedPtr object) override;
 
     InstanceImpl& parent_;
     std::unique_ptr<SlotImpl> slot_;
@@ -73,6 +84,8 @@ private:
   struct ThreadLocalData {
     Event::Dispatcher* dispatcher_{};
     std::vector<ThreadLocalObjectSharedPtr> data_;
+    // The published versions of the objects in data_, for slots that publish.
+    std::vector<uint64_t> versions_;
   };
 
   void recycle(std::unique_ptr<SlotImpl>&& slot);
@@ -99,6 +112,7 @@ private:
   std::thread::id main_thread_id_;
   Event::Dispatcher* main_thread_dispatcher_{};
   std::atomic<bool> shutdown_{};
+  uint64_t last_published_version_{};
 
   // Test only.
   friend class ThreadLocalInstanceImplTest;
@@ -54,6 +54,21 @@ void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
   }
 }
 
+// Forwards to an observer owned elsewhere, so that it can be handed out weakly.
+class HostResponseTimeObserverRef : public HostResponseTimeObserver {
+public:
+  explicit HostResponseTimeObserverRef(HostResponseTimeObserver& observer) : observer_(observer) {}
+
+  // Upstream::HostResponseTimeObserver
+  void onHostResponseTime(const HostDescription& host,
+                          std::chrono::microseconds response_time) override {
+    observer_.onHostResponseTime(host, response_time);
+  }
+
+private:
+  HostResponseTimeObserver& observer_;
+};
+
 } // namespace
 
 void ClusterManagerInitHelper::addCluster(Cluster& cluster) {
@@ -773,14 +788,15 @@ void ClusterManagerImpl::loadCluster(const envoy::config::cluster::v3::Cluster&
       cluster_entry_it->second->thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
           cluster_reference.prioritySet(), cluster_reference.info()->stats(),
           cluster_reference.info()->statsScope(), runtime_, random_,
-          cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig());
+          cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig(),
+          time_source_);
     }
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::Maglev) {
     if (!cluster_reference.info()->lbSubsetInfo().isEnabled()) {
       cluster_entry_it->second->thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
           cluster_reference.prioritySet(), cluster_reference.info()->stats(),
           cluster_reference.info()->statsScope(), runtime_, random_,
-          cluster_reference.info()->lbConfig());
+          cluster_reference.info()->lbConfig(), time_source_);
     }
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::ClusterProvided) {
     cluster_entry_it->second->thread_aware_lb_ = std::move(new_cluster_pair.second);
@@ -960,7 +976,8 @@ ProtobufTypes::MessagePtr ClusterManagerImpl::dumpClusterConfigs() {
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl(
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
     const absl::optional<std::string>& local_cluster_name)
-    : parent_(parent), thread_local_dispatcher_(dispatcher) {
+    : parent_(parent), thread_local_dispatcher_(dispatcher),
+      is_main_thread_(&dispatcher == &parent.dispatcher_) {
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_name) {
     ENVOY_LOG(debug, "adding TLS local cluster {}", local_cluster_name.value());
@@ -1148,6 +1165,8 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  cluster_entry->prefetchConnections(hosts_added);
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1244,7 +1263,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
         cluster->lbType(), priority_set_, parent_.local_priority_set_, cluster->stats(),
         cluster->statsScope(), parent.parent_.runtime_, parent.parent_.random_,
         cluster->lbSubsetInfo(), cluster->lbRingHashConfig(), cluster->lbLeastRequestConfig(),
-        cluster->lbConfig());
+        cluster->lbConfig(), parent.parent_.time_source_);
   } else {
     switch (cluster->lbType()) {
     case LoadBalancerType::LeastRequest: {
@@ -1254,6 +1273,16 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
           parent.parent_.random_, cluster->lbConfig(), cluster->lbLeastRequestConfig());
       break;
     }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      auto lb = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(), cluster->lbPeakEwmaConfig(),
+          parent.thread_local_dispatcher_.timeSource());
+      response_time_observer_ = std::make_shared<HostResponseTimeObserverRef>(*lb);
+      lb_ = std::move(lb);
+      break;
+    }
     case LoadBalancerType::Random: {
       ASSERT(lb_factory_ == nullptr);
       lb_ = std::make_unique<RandomLoadBalancer>(priority_set_, parent_.local_priority_set_,
@@ -1347,6 +1376,47 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   }
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::prefetchConnections(
+    const HostVector& hosts_added) {
+  // Each worker warms its own pools, so that the first requests routed to new hosts don't wait
+  // for a connection to be established.
+  if (!cluster_info_->prefetchOnHostAdd() || parent_.is_main_thread_) {
+    return;
+  }
+  // Requests pick the pool of their downstream protocol, which isn't known yet.
+  if (cluster_info_->features() & ClusterInfo::Features::USE_DOWNSTREAM_PROTOCOL) {
+    return;
+  }
+  for (const HostSharedPtr& host : hosts_added) {
+    prefetchConnection(host);
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::prefetchConnection(
+    const HostConstSharedPtr& host) {
+  if (host->health() == Host::Health::Unhealthy) {
+    return;
+  }
+
+  // This matches the hash key connPool() computes for a request without socket or transport
+  // socket options, so that such requests find the warmed pool. prefetchConnections() skips
+  // clusters that use the downstream protocol, so the upstream protocol doesn't depend on it.
+  const auto upstream_protocol = host->cluster().upstreamHttpProtocol(absl::nullopt);
+  const std::vector<uint8_t> hash_key = {uint8_t(upstream_protocol)};
+
+  ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+  ConnPoolsContainer::ConnPools::PoolOptRef pool =
+      container.pools_->getPool(ResourcePriority::Default, hash_key, [&]() {
+        return parent_.parent_.factory_.allocateConnPool(parent_.thread_local_dispatcher_, host,
+                                                         ResourcePriority::Default,
+                                                         upstream_protocol, nullptr, nullptr);
+      });
+
+  if (pool.has_value()) {
+    pool.value().get().maybePrefetch(1.0);
+  }
+}
+
 Tcp::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
     ResourcePriority priority, LoadBalancerContext* context) {
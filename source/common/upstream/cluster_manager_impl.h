@@ -27,6 +27,7 @@
 #include "common/config/grpc_mux_impl.h"
 #include "common/config/subscription_factory_impl.h"
 #include "common/http/async_client_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/load_stats_reporter.h"
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
@@ -353,10 +354,19 @@ private:
       Tcp::ConnectionPool::Instance* tcpConnPool(ResourcePriority priority,
                                                  LoadBalancerContext* context);
 
+      // Establishes a connection to each newly added host in the default priority HTTP connection
+      // pool of requests without socket or transport socket options, if the cluster asks for it.
+      // The main thread doesn't route requests, so it doesn't prefetch.
+      void prefetchConnections(const HostVector& hosts_added);
+      void prefetchConnection(const HostConstSharedPtr& host);
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
       LoadBalancer& loadBalancer() override { return *lb_; }
+      HostResponseTimeObserverWeakPtr hostResponseTimeObserver() override {
+        return response_time_observer_;
+      }
 
       ThreadLocalClusterManagerImpl& parent_;
       PrioritySetImpl priority_set_;
@@ -366,6 +376,9 @@ private:
       LoadBalancerFactorySharedPtr lb_factory_;
       // Current active LB.
       LoadBalancerPtr lb_;
+      // Set if lb_ is a peak EWMA LB, which learns from the response times of the hosts. Requests
+      // only hold it weakly, so it goes away with lb_.
+      HostResponseTimeObserverSharedPtr response_time_observer_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
     };
@@ -395,6 +408,7 @@ private:
 
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
+    const bool is_main_thread_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
 
     // These maps are owned by the ThreadLocalClusterManagerImpl instead of the ClusterEntry
@@ -220,8 +220,9 @@ void HealthCheckerImplBase::start() {
 HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
     : host_(host), parent_(parent),
-      interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
-      timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })) {
+      interval_timer_(
+          parent.dispatcher_.createCoarseTimer([this]() -> void { onIntervalBase(); })),
+      timeout_timer_(parent.dispatcher_.createCoarseTimer([this]() -> void { onTimeoutBase(); })) {
 
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent.incHealthy();
@@ -1,6 +1,10 @@
 #include "common/upstream/load_balancer_impl.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +26,13 @@ static const std::string RuntimeZoneEnabled = "upstream.zone_routing.enabled";
 static const std::string RuntimeMinClusterSize = "upstream.zone_routing.min_cluster_size";
 static const std::string RuntimePanicThreshold = "upstream.healthy_panic_threshold";
 
+// Cost of a peak EWMA host with active requests but no latency estimate yet. It is larger than the
+// cost of any host with a known latency, and grows with the active requests to still spread load
+// across several such hosts.
+constexpr double PeakEwmaUnknownLatencyPenalty = 1e12;
+// The chance of sampling a host at the start of its slow start window, relative to the normal one.
+constexpr double PeakEwmaMinSlowStartFactor = 0.1;
+
 // Distributes load between priorities based on the per priority availability and the normalized
 // total availability. Load is assigned to each priority according to how available each priority is
 // adjusted for the normalized total availability.
@@ -705,7 +716,10 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
   // so we will need to do better at delta tracking to scale (see
   // https://github.com/envoyproxy/envoy/issues/2874).
   priority_set.addPriorityUpdateCb(
-      [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
+      [this](uint32_t priority, const HostVector& hosts_added, const HostVector&) {
+        onHostsAdded(hosts_added);
+        refresh(priority);
+      });
 }
 
 void EdfLoadBalancerBase::initialize() {
@@ -818,8 +832,8 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
       continue;
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
+    const auto candidate_active_rq = candidate_host->stats().rq_active_.approximateValue();
+    const auto sampled_active_rq = sampled_host->stats().rq_active_.approximateValue();
     if (sampled_active_rq < candidate_active_rq) {
       candidate_host = sampled_host;
     }
@@ -828,6 +842,170 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+    Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>& peak_ewma_config,
+    TimeSource& time_source)
+    : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random, common_config),
+      choice_count_(
+          peak_ewma_config.has_value()
+              ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(peak_ewma_config.value(), choice_count, 2)
+              : 2),
+      decay_time_us_(1000.0 * std::max<uint64_t>(
+                                  1, peak_ewma_config.has_value()
+                                         ? PROTOBUF_GET_MS_OR_DEFAULT(peak_ewma_config.value(),
+                                                                      decay_time, 10000)
+                                         : 10000)),
+      slow_start_window_(peak_ewma_config.has_value()
+                             ? PROTOBUF_GET_MS_OR_DEFAULT(peak_ewma_config.value(),
+                                                          slow_start_window, 0)
+                             : 0),
+      time_source_(time_source) {
+  for (const auto& host_set : priority_set.hostSetsPerPriority()) {
+    for (const HostSharedPtr& host : host_set->hosts()) {
+      host_states_.emplace(host.get(), HostState{});
+    }
+  }
+  // Added hosts are tracked by onHostsAdded(), before the EDF schedule is rebuilt with them.
+  // Removals are applied once every priority of the update is done.
+  member_update_cb_handle_ = priority_set.addMemberUpdateCb(
+      [this](const HostVector&, const HostVector& hosts_removed) -> void {
+        onHostsRemoved(hosts_removed);
+      });
+  initialize();
+}
+
+PeakEwmaLoadBalancer::~PeakEwmaLoadBalancer() { member_update_cb_handle_->remove(); }
+
+void PeakEwmaLoadBalancer::onHostsAdded(const HostVector& hosts_added) {
+  // There is no load to shift away from the hosts of a cluster that was empty, so they skip slow
+  // start.
+  const bool slow_start = slow_start_window_.count() > 0 && !host_states_.empty();
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (const HostSharedPtr& host : hosts_added) {
+    // A host moving between priorities keeps its estimate.
+    const auto inserted = host_states_.emplace(host.get(), HostState{});
+    if (inserted.second && slow_start) {
+      inserted.first->second.added_time_ = now;
+    }
+  }
+}
+
+void PeakEwmaLoadBalancer::onHostsRemoved(const HostVector& hosts_removed) {
+  if (hosts_removed.empty()) {
+    return;
+  }
+
+  // A host moving between priorities on the workers may be reported as removed after it was added
+  // to its new priority. Rather than erasing the removed hosts, keep the hosts still present.
+  absl::flat_hash_map<const HostDescription*, HostState> host_states;
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    for (const HostSharedPtr& host : host_set->hosts()) {
+      const auto it = host_states_.find(host.get());
+      host_states.emplace(host.get(), it != host_states_.end() ? it->second : HostState{});
+    }
+  }
+  host_states_ = std::move(host_states);
+}
+
+void PeakEwmaLoadBalancer::onHostResponseTime(const HostDescription& host,
+                                              std::chrono::microseconds response_time) {
+  const auto it = host_states_.find(&host);
+  if (it == host_states_.end()) {
+    return;
+  }
+  HostState& state = it->second;
+  const MonotonicTime now = time_source_.monotonicTime();
+  const double response_time_us = response_time.count();
+  const double decay = decayFactor(state, now);
+  if (response_time_us > state.ewma_us_ * decay) {
+    state.ewma_us_ = response_time_us;
+  } else {
+    state.ewma_us_ = state.ewma_us_ * decay + response_time_us * (1 - decay);
+  }
+  state.last_update_ = now;
+}
+
+double PeakEwmaLoadBalancer::hostCost(const Host& host) const {
+  return cost(host, findState(host), time_source_.monotonicTime());
+}
+
+const PeakEwmaLoadBalancer::HostState* PeakEwmaLoadBalancer::findState(const Host& host) const {
+  const auto it = host_states_.find(&host);
+  return it != host_states_.end() ? &it->second : nullptr;
+}
+
+double PeakEwmaLoadBalancer::decayFactor(const HostState& state, MonotonicTime now) const {
+  const double elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - state.last_update_).count();
+  return std::exp(-std::max(elapsed_us, 0.0) / decay_time_us_);
+}
+
+double PeakEwmaLoadBalancer::decayedEwma(const HostState& state, MonotonicTime now) const {
+  return state.ewma_us_ != 0 ? state.ewma_us_ * decayFactor(state, now) : 0;
+}
+
+double PeakEwmaLoadBalancer::cost(const Host& host, const HostState* state,
+                                  MonotonicTime now) const {
+  const uint64_t active_rq = host.stats().rq_active_.approximateValue();
+  const double ewma_us = state != nullptr ? decayedEwma(*state, now) : 0;
+  if (ewma_us == 0 && active_rq != 0) {
+    return PeakEwmaUnknownLatencyPenalty + active_rq;
+  }
+  return ewma_us * (active_rq + 1);
+}
+
+double PeakEwmaLoadBalancer::slowStartFactor(const HostState* state, MonotonicTime now) const {
+  if (state == nullptr || !state->added_time_.has_value()) {
+    return 1;
+  }
+  const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+      now - state->added_time_.value());
+  if (age >= slow_start_window_) {
+    return 1;
+  }
+  return std::max(PeakEwmaMinSlowStartFactor,
+                  static_cast<double>(age.count()) / slow_start_window_.count());
+}
+
+double PeakEwmaLoadBalancer::hostWeight(const Host& host) {
+  // The unknown latency penalty would push a host so far out in the EDF schedule that it would not
+  // be picked again for a long time, so here the latency only scales the weight like the active
+  // requests do in LeastRequestLoadBalancer.
+  const MonotonicTime now = time_source_.monotonicTime();
+  const HostState* state = findState(host);
+  const double ewma_ms = state != nullptr ? decayedEwma(*state, now) / 1000 : 0;
+  return host.weight() * slowStartFactor(state, now) /
+         ((ewma_ms + 1) * (host.stats().rq_active_.approximateValue() + 1));
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
+                                                            const HostsSource&) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  HostSharedPtr candidate_host = nullptr;
+  double candidate_cost = 0;
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    const HostSharedPtr& sampled_host = hosts_to_use[random_.random() % hosts_to_use.size()];
+    const HostState* state = findState(*sampled_host);
+
+    // A host in slow start that loses the draw only wins if no other sampled host is eligible.
+    double sampled_cost = std::numeric_limits<double>::infinity();
+    const double slow_start_factor = slowStartFactor(state, now);
+    if (slow_start_factor >= 1 || random_.random() % 1000 < slow_start_factor * 1000) {
+      sampled_cost = cost(*sampled_host, state, now);
+    }
+
+    if (candidate_host == nullptr || sampled_cost < candidate_cost) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+
+  return candidate_host;
+}
+
 HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
   if (!hosts_source) {
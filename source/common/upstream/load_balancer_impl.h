@@ -1,18 +1,23 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <queue>
 #include <set>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/thread_local_cluster.h"
 #include "envoy/upstream/upstream.h"
 
 #include "common/protobuf/utility.h"
 #include "common/upstream/edf_scheduler.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -376,6 +381,9 @@ protected:
 
 private:
   void refresh(uint32_t priority);
+  // Called with the hosts added to a priority before its schedules are rebuilt, so that
+  // hostWeight() can tell the new hosts apart.
+  virtual void onHostsAdded(const HostVector&) {}
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
@@ -465,13 +473,84 @@ private:
     // be the only/best way of doing this. Essentially, it makes weight and active requests equally
     // important. Are they equally important in practice? There is no right answer here and we might
     // want to iterate on this as we gain more experience.
-    return static_cast<double>(host.weight()) / (host.stats().rq_active_.value() + 1);
+    return static_cast<double>(host.weight()) / (host.stats().rq_active_.approximateValue() + 1);
   }
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
   const uint32_t choice_count_;
 };
 
+/**
+ * Peak EWMA load balancer.
+ *
+ * Each worker keeps a moving average of the response times of every host, which the router feeds
+ * through ThreadLocalCluster::hostResponseTimeObserver(). The average decays exponentially with the
+ * time between responses, and a response slower than the current average replaces it outright (the
+ * "peak"). A host that starts to stall is thus avoided at once, while a host that recovers wins
+ * traffic back as its average decays. The cost of a host is its average multiplied by its active
+ * requests plus one. A host with active requests but no response yet costs more than any host
+ * with a known latency. This follows the peak EWMA balancer of Finagle.
+ *
+ * When all hosts have the same weight it samples N random healthy hosts and picks the one with the
+ * lowest cost. Otherwise, like LeastRequestLoadBalancer, it uses an RR EDF schedule where host
+ * weight is scaled by the latency and active requests at pick/insert time.
+ *
+ * Hosts that join a non-empty cluster can be put in slow start. Their chance of being sampled (or
+ * their weight) starts at 10% of the normal value and grows linearly to 100% over the window.
+ */
+class PeakEwmaLoadBalancer : public EdfLoadBalancerBase, public HostResponseTimeObserver {
+public:
+  PeakEwmaLoadBalancer(
+      const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+      Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+      const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+          peak_ewma_config,
+      TimeSource& time_source);
+  ~PeakEwmaLoadBalancer() override;
+
+  // Upstream::HostResponseTimeObserver
+  // Folds the response time into the latency estimate of the host. Reports for hosts that are no
+  // longer part of the cluster are ignored.
+  void onHostResponseTime(const HostDescription& host,
+                          std::chrono::microseconds response_time) override;
+
+  /**
+   * @return the current cost of sending a request to a host, see the class comment.
+   */
+  double hostCost(const Host& host) const;
+
+private:
+  struct HostState {
+    // Latency estimate in microseconds, as of last_update_. Zero until the first response.
+    double ewma_us_{};
+    MonotonicTime last_update_;
+    // Set if the host joined a non-empty cluster while slow start is enabled.
+    absl::optional<MonotonicTime> added_time_;
+  };
+
+  void onHostsRemoved(const HostVector& hosts_removed);
+  double decayFactor(const HostState& state, MonotonicTime now) const;
+  double decayedEwma(const HostState& state, MonotonicTime now) const;
+  double cost(const Host& host, const HostState* state, MonotonicTime now) const;
+  double slowStartFactor(const HostState* state, MonotonicTime now) const;
+  const HostState* findState(const Host& host) const;
+
+  // Upstream::EdfLoadBalancerBase
+  void onHostsAdded(const HostVector& hosts_added) override;
+  void refreshHostSource(const HostsSource&) override {}
+  double hostWeight(const Host& host) override;
+  HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                        const HostsSource& source) override;
+
+  const uint32_t choice_count_;
+  const double decay_time_us_;
+  const std::chrono::milliseconds slow_start_window_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<const HostDescription*, HostState> host_states_;
+  Common::CallbackHandle* member_update_cb_handle_{};
+};
+
 /**
  * Random load balancer that picks a random host out of all hosts.
  */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -13,15 +14,16 @@ namespace Upstream {
 /**
  * All Maglev load balancer stats. @see stats_macros.h
  */
-#define ALL_MAGLEV_LOAD_BALANCER_STATS(GAUGE)                                                      \
+#define ALL_MAGLEV_LOAD_BALANCER_STATS(GAUGE, HISTOGRAM)                                           \
   GAUGE(max_entries_per_host, Accumulate)                                                          \
-  GAUGE(min_entries_per_host, Accumulate)
+  GAUGE(min_entries_per_host, Accumulate)                                                          \
+  HISTOGRAM(rebuild_time_us, Microseconds)
 
 /**
  * Struct definition for all Maglev load balancer stats. @see stats_macros.h
  */
 struct MaglevLoadBalancerStats {
-  ALL_MAGLEV_LOAD_BALANCER_STATS(GENERATE_GAUGE_STRUCT)
+  ALL_MAGLEV_LOAD_BALANCER_STATS(GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -45,10 +47,9 @@ public:
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint64_t offset, uint64_t skip, double weight)
+        : offset_(offset), skip_(skip), weight_(weight) {}
 
-    HostConstSharedPtr host_;
     const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
@@ -60,7 +61,10 @@ private:
   uint64_t permutation(const TableBuildEntry& entry);
 
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
+  std::vector<HostConstSharedPtr> hosts_;
+  // Indexes into hosts_. This is a quarter of the size of a table of host pointers, and building
+  // it does not touch the hosts' reference counts.
+  std::vector<uint32_t> table_;
   MaglevLoadBalancerStats& stats_;
 };
 
@@ -72,7 +76,7 @@ public:
   MaglevLoadBalancer(const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
                      Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
-                     uint64_t table_size = MaglevTable::DefaultTableSize);
+                     TimeSource& time_source, uint64_t table_size = MaglevTable::DefaultTableSize);
 
   const MaglevLoadBalancerStats& stats() const { return stats_; }
 
@@ -80,15 +84,14 @@ private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double /* min_normalized_weight */, double max_normalized_weight) override {
-    return std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight,
-                                         table_size_, use_hostname_for_hashing_, stats_);
-  }
+                     double /* min_normalized_weight */, double max_normalized_weight,
+                     const HashingLoadBalancerSharedPtr& previous) override;
 
   static MaglevLoadBalancerStats generateStats(Stats::Scope& scope);
 
   Stats::ScopePtr scope_;
   MaglevLoadBalancerStats stats_;
+  TimeSource& time_source_;
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
 };
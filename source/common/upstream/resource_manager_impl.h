@@ -25,30 +25,39 @@ struct ManagedResourceImpl : public BasicResourceLimitImpl {
   }
 
   // Upstream::Resource
-  bool canCreate() override { return current_ < max(); }
+  bool canCreate() override { return approximateCount() < max(); }
   void inc() override {
     BasicResourceLimitImpl::inc();
-    updateRemaining();
-    open_gauge_.set(BasicResourceLimitImpl::canCreate() ? 0 : 1);
+    updateGauges();
   }
   void decBy(uint64_t amount) override {
     BasicResourceLimitImpl::decBy(amount);
-    updateRemaining();
-    open_gauge_.set(BasicResourceLimitImpl::canCreate() ? 0 : 1);
+    updateGauges();
   }
 
   /**
-   * We set the gauge instead of incrementing and decrementing because,
+   * We set the gauges instead of incrementing and decrementing because,
    * though atomics are used, it is possible for the current resource count
    * to be greater than the supplied max.
    */
-  void updateRemaining() {
+  void updateGauges() {
+    // The count sums a shard per worker, so it is read once for both gauges.
+    const uint64_t current = count();
+    const uint64_t max = this->max();
     /**
-     * We cannot use std::max here because max() and current_ are
+     * We cannot use std::max here because max and current are
      * unsigned and subtracting them may overflow.
      */
-    const uint64_t current_copy = current_;
-    remaining_.set(max() > current_copy ? max() - current_copy : 0);
+    const uint64_t remaining = max > current ? max - current : 0;
+    // Every worker updates these gauges, so they are only written when they change. This keeps
+    // workers from contending on their cache lines, most of all once the breaker has opened.
+    if (remaining_.value() != remaining) {
+      remaining_.set(remaining);
+    }
+    const uint64_t open = current < max ? 0 : 1;
+    if (open_gauge_.value() != open) {
+      open_gauge_.set(open);
+    }
   }
 
   /**
@@ -2,27 +2,76 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/stats/timespan_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Upstream {
 
+namespace {
+
+using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
+using HashKeyBuffer = absl::InlinedVector<char, 196>;
+
+// Computes the hash of the index'th ring entry of the host with the given hash key.
+uint64_t ringEntryHash(HashFunction hash_function, const std::string& key, uint64_t index,
+                       HashKeyBuffer& hash_key_buffer) {
+  hash_key_buffer.assign(key.begin(), key.end());
+  hash_key_buffer.emplace_back('_');
+  const std::string index_str = absl::StrCat("", index);
+  hash_key_buffer.insert(hash_key_buffer.end(), index_str.begin(), index_str.end());
+
+  absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()), hash_key_buffer.size());
+  return (hash_function == HashFunction::Cluster_RingHashLbConfig_HashFunction_MURMUR_HASH_2)
+             ? MurmurHash::murmurHash2_64(hash_key, MurmurHash::STD_HASH_SEED)
+             : HashUtil::xxHash64(hash_key);
+}
+
+// Orders ring entries by hash. Hash collisions are broken by host and index so that the order of
+// the ring does not depend on how it was built.
+template <class RingEntry> bool ringEntryLess(const RingEntry& lhs, const RingEntry& rhs) {
+  return std::tie(lhs.hash_, lhs.host_, lhs.index_) < std::tie(rhs.hash_, rhs.host_, rhs.index_);
+}
+
+} // namespace
+
+uint64_t EytzingerSearch::lowerBound(const uint64_t* hashes, uint64_t size, uint64_t h) {
+  // Each step picks the child from a comparison rather than a branch, so there are no
+  // mispredictions. The last node the walk went left from is the first hash of at least h.
+  uint64_t node = 1;
+  uint64_t found = 0;
+  while (node <= size) {
+    // The 16 nodes four levels below this one are adjacent. Fetch them while walking down.
+    PREFETCH(hashes + (node * 16 <= size ? node * 16 : 0));
+    const bool right = hashes[node] < h;
+    found = right ? found : node;
+    node = 2 * node + right;
+  }
+  return found;
+}
+
 RingHashLoadBalancer::RingHashLoadBalancer(
     const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
     const absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig>& config,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config),
       scope_(scope.createScope("ring_hash_lb.")), stats_(generateStats(*scope_)),
+      time_source_(time_source),
       min_ring_size_(config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value(), minimum_ring_size,
                                                               DefaultMinRingSize)
                             : DefaultMinRingSize),
@@ -44,7 +93,20 @@ RingHashLoadBalancer::RingHashLoadBalancer(
 }
 
 RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scope) {
-  return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
+  return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
+}
+
+ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr RingHashLoadBalancer::createLoadBalancer(
+    const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
+    double, const HashingLoadBalancerSharedPtr& previous) {
+  Stats::HistogramCompletableTimespanImpl rebuild_time(stats_.rebuild_time_us_, time_source_);
+  // All the load balancers passed back to us are rings that we built.
+  auto ring = std::make_shared<Ring>(normalized_host_weights, min_normalized_weight,
+                                     min_ring_size_, max_ring_size_, hash_function_,
+                                     use_hostname_for_hashing_,
+                                     static_cast<const Ring*>(previous.get()), stats_);
+  rebuild_time.complete();
+  return ring;
 }
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
@@ -52,56 +114,30 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t a
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  int64_t midp = 0;
-  while (true) {
-    midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      midp = 0;
-      break;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      break;
-    }
-
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
-
-    if (lowp > highp) {
-      midp = 0;
-      break;
-    }
-  }
-
   // If a retry host predicate is being applied, behave as if this host was not in the ring.
   // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
-  // when the offset causes us to select the same host at another location in the ring.
+  // when the offset causes us to select the same host at another location in the ring. Retries
+  // need the position of the entry on the sorted ring, so they search that instead of the tree.
   if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+    const auto it = std::lower_bound(
+        ring_.begin(), ring_.end(), h,
+        [](const RingEntry& entry, uint64_t hash) -> bool { return entry.hash_ < hash; });
+    const uint64_t position = it == ring_.end() ? 0 : it - ring_.begin();
+    return hosts_[ring_[(position + attempt) % ring_.size()].host_].host_;
   }
 
-  return ring_[midp].host_;
+  // Hashes past the last entry wrap around to node 0, which holds the host of the first entry.
+  const uint64_t node = EytzingerSearch::lowerBound(search_hashes_.data(), ring_.size(), h);
+  return hosts_[search_hosts_[node]].host_;
 }
 
-using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_host_weights,
                                  double min_normalized_weight, uint64_t min_ring_size,
                                  uint64_t max_ring_size, HashFunction hash_function,
-                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats)
-    : stats_(stats) {
+                                 bool use_hostname_for_hashing, const Ring* previous,
+                                 RingHashLoadBalancerStats& stats)
+    : hash_function_(hash_function), use_hostname_for_hashing_(use_hostname_for_hashing),
+      stats_(stats) {
   ENVOY_LOG(trace, "ring hash: building ring");
 
   // We can't do anything sensible with no hosts.
@@ -117,12 +153,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   const double scale =
       std::min(std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
                static_cast<double>(max_ring_size));
-
-  // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
 
-  // Populate the hash ring by walking through the (host, weight) pairs in
+  // Work out the number of hashes of each host by walking through the (host, weight) pairs in
   // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
   // aren't necessarily whole numbers, we maintain running sums -- current_hashes and
   // target_hashes -- which allows us to populate the ring in a mostly stable way.
@@ -139,56 +172,38 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   // For stats reporting, keep track of the minimum and maximum actual number of hashes per host.
   // Users should hopefully pay attention to these numbers and alert if min_hashes_per_host is too
   // low, since that implies an inaccurate request distribution.
-
-  absl::InlinedVector<char, 196> hash_key_buffer;
   double current_hashes = 0.0;
   double target_hashes = 0.0;
   uint64_t min_hashes_per_host = ring_size;
   uint64_t max_hashes_per_host = 0;
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& entry : normalized_host_weights) {
-    const auto& host = entry.first;
-    const std::string& address_string =
-        use_hostname_for_hashing ? host->hostname() : host->address()->asString();
-    ASSERT(!address_string.empty());
-
-    hash_key_buffer.assign(address_string.begin(), address_string.end());
-    hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
-
-    // As noted above: maintain current_hashes and target_hashes as running sums across the entire
-    // host set. `i` is needed only to construct the hash key, and tally min/max hashes per host.
+    ASSERT(!hashKey(*entry.first).empty());
     target_hashes += scale * entry.second;
     uint64_t i = 0;
     while (current_hashes < target_hashes) {
-      const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
-
-      absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
-                                 hash_key_buffer.size());
-
-      const uint64_t hash =
-          (hash_function == HashFunction::Cluster_RingHashLbConfig_HashFunction_MURMUR_HASH_2)
-              ? MurmurHash::murmurHash2_64(hash_key, MurmurHash::STD_HASH_SEED)
-              : HashUtil::xxHash64(hash_key);
-
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
       ++i;
       ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
     }
+    ASSERT(i <= std::numeric_limits<uint32_t>::max());
+    hosts_.push_back({entry.first, i});
     min_hashes_per_host = std::min(i, min_hashes_per_host);
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+  // The hash of each ring entry only depends on the host's hash key and the entry's index, so the
+  // entries that both rings have can be carried over from the previous ring rather than hashed
+  // and sorted again.
+  if (previous == nullptr || !buildFrom(*previous)) {
+    build();
+  }
+  if (!ring_.empty()) {
+    buildSearchTree();
+  }
+
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (const auto& entry : ring_) {
-      ENVOY_LOG(trace, "ring hash: host={} hash={}",
-                use_hostname_for_hashing ? entry.host_->hostname()
-                                         : entry.host_->address()->asString(),
+      ENVOY_LOG(trace, "ring hash: host={} hash={}", hashKey(*hosts_[entry.host_].host_),
                 entry.hash_);
     }
   }
@@ -198,5 +213,111 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
 }
 
+const std::string& RingHashLoadBalancer::Ring::hashKey(const Host& host) const {
+  return use_hostname_for_hashing_ ? host.hostname() : host.address()->asString();
+}
+
+void RingHashLoadBalancer::Ring::build() {
+  uint64_t ring_size = 0;
+  for (const RingHost& host : hosts_) {
+    ring_size += host.hashes_;
+  }
+  ring_.reserve(ring_size);
+
+  HashKeyBuffer hash_key_buffer;
+  for (uint32_t i = 0; i < hosts_.size(); ++i) {
+    const std::string& key = hashKey(*hosts_[i].host_);
+    for (uint32_t j = 0; j < hosts_[i].hashes_; ++j) {
+      ring_.push_back({ringEntryHash(hash_function_, key, j, hash_key_buffer), i, j});
+    }
+  }
+
+  std::sort(ring_.begin(), ring_.end(), ringEntryLess<RingEntry>);
+}
+
+bool RingHashLoadBalancer::Ring::buildFrom(const Ring& previous) {
+  // Match the hosts with the hosts of the previous ring by hash key. Duplicate hash keys make the
+  // match ambiguous, so those rings are built from scratch.
+  absl::flat_hash_map<absl::string_view, uint32_t> previous_hosts;
+  previous_hosts.reserve(previous.hosts_.size());
+  for (uint32_t i = 0; i < previous.hosts_.size(); ++i) {
+    if (!previous_hosts.emplace(previous.hashKey(*previous.hosts_[i].host_), i).second) {
+      return false;
+    }
+  }
+
+  // For each host of the previous ring, its index in this ring and the number of its entries that
+  // are still on the ring. For each host of this ring, the index of its first new entry.
+  constexpr uint32_t NoHost = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> new_host(previous.hosts_.size(), NoHost);
+  std::vector<uint64_t> kept_hashes(previous.hosts_.size(), 0);
+  std::vector<uint64_t> first_new_hash(hosts_.size(), 0);
+  for (uint32_t i = 0; i < hosts_.size(); ++i) {
+    const auto it = previous_hosts.find(hashKey(*hosts_[i].host_));
+    if (it == previous_hosts.end()) {
+      continue;
+    }
+    if (new_host[it->second] != NoHost) {
+      return false;
+    }
+    new_host[it->second] = i;
+    kept_hashes[it->second] = std::min(previous.hosts_[it->second].hashes_, hosts_[i].hashes_);
+    first_new_hash[i] = kept_hashes[it->second];
+  }
+
+  uint64_t ring_size = 0;
+  std::vector<RingEntry> added;
+  HashKeyBuffer hash_key_buffer;
+  for (uint32_t i = 0; i < hosts_.size(); ++i) {
+    ring_size += hosts_[i].hashes_;
+    const std::string& key = hashKey(*hosts_[i].host_);
+    for (uint32_t j = first_new_hash[i]; j < hosts_[i].hashes_; ++j) {
+      added.push_back({ringEntryHash(hash_function_, key, j, hash_key_buffer), i, j});
+    }
+  }
+  std::sort(added.begin(), added.end(), ringEntryLess<RingEntry>);
+
+  // Merge the new entries into the entries kept from the previous ring, which are already sorted.
+  ring_.reserve(ring_size);
+  auto next_added = added.begin();
+  for (const RingEntry& entry : previous.ring_) {
+    if (entry.index_ >= kept_hashes[entry.host_]) {
+      continue;
+    }
+    const RingEntry kept{entry.hash_, new_host[entry.host_], entry.index_};
+    while (next_added != added.end() && ringEntryLess(*next_added, kept)) {
+      ring_.push_back(*next_added++);
+    }
+    ring_.push_back(kept);
+  }
+  ring_.insert(ring_.end(), next_added, added.end());
+  ASSERT(ring_.size() == ring_size);
+
+  // The kept entries break hash collisions by their host index in the previous ring, which may
+  // differ in this one. Sort any collisions again so the ring is the same as one built from
+  // scratch.
+  for (auto run = ring_.begin(); run != ring_.end();) {
+    const auto run_end = std::find_if(run + 1, ring_.end(), [&run](const RingEntry& entry) {
+      return entry.hash_ != run->hash_;
+    });
+    if (run_end - run > 1) {
+      std::sort(run, run_end, ringEntryLess<RingEntry>);
+    }
+    run = run_end;
+  }
+
+  return true;
+}
+
+void RingHashLoadBalancer::Ring::buildSearchTree() {
+  search_hashes_.resize(ring_.size() + 1);
+  search_hosts_.resize(ring_.size() + 1);
+  search_hosts_[0] = ring_[0].host_;
+  EytzingerSearch::layOut(ring_.size(), [this](uint64_t node, uint64_t entry) {
+    search_hashes_[node] = ring_[entry].hash_;
+    search_hosts_[node] = ring_[entry].host_;
+  });
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
@@ -16,16 +18,53 @@ namespace Upstream {
 /**
  * All ring hash load balancer stats. @see stats_macros.h
  */
-#define ALL_RING_HASH_LOAD_BALANCER_STATS(GAUGE)                                                   \
+#define ALL_RING_HASH_LOAD_BALANCER_STATS(GAUGE, HISTOGRAM)                                        \
   GAUGE(max_hashes_per_host, Accumulate)                                                           \
   GAUGE(min_hashes_per_host, Accumulate)                                                           \
-  GAUGE(size, Accumulate)
+  GAUGE(size, Accumulate)                                                                          \
+  HISTOGRAM(rebuild_time_us, Microseconds)
 
 /**
  * Struct definition for all ring hash load balancer stats. @see stats_macros.h
  */
 struct RingHashLoadBalancerStats {
-  ALL_RING_HASH_LOAD_BALANCER_STATS(GENERATE_GAUGE_STRUCT)
+  ALL_RING_HASH_LOAD_BALANCER_STATS(GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Lower bound search of sorted hashes laid out in Eytzinger (breadth-first) order: an implicit
+ * binary search tree in which the children of the node at index k are at 2k and 2k + 1. Index 0 is
+ * not part of the tree. The first levels of the tree share a few cache lines, and the levels below
+ * a node are adjacent, so they can be prefetched.
+ */
+class EytzingerSearch {
+public:
+  /**
+   * Lays out a sorted array of the given size by calling place(node, i) for each of its indexes,
+   * with the node of the tree that holds index i.
+   */
+  template <class Place> static void layOut(uint64_t size, const Place& place) {
+    uint64_t next = 0;
+    layOut(1, size, next, place);
+  }
+
+  /**
+   * @param hashes supplies the tree, with size nodes starting at index 1.
+   * @return the node of the first hash that is at least h, or 0 if every hash is less than h.
+   */
+  static uint64_t lowerBound(const uint64_t* hashes, uint64_t size, uint64_t h);
+
+private:
+  template <class Place>
+  static void layOut(uint64_t node, uint64_t size, uint64_t& next, const Place& place) {
+    // An in-order walk of a binary search tree visits its nodes in sorted order.
+    if (node > size) {
+      return;
+    }
+    layOut(2 * node, size, next, place);
+    place(node, next++);
+    layOut(2 * node + 1, size, next, place);
+  }
 };
 
 /**
@@ -44,7 +83,8 @@ public:
       const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
       Runtime::Loader& runtime, Runtime::RandomGenerator& random,
       const absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig>& config,
-      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+      TimeSource& time_source);
 
   const RingHashLoadBalancerStats& stats() const { return stats_; }
 
@@ -53,18 +93,42 @@ private:
 
   struct RingEntry {
     uint64_t hash_;
+    // Index of the host in Ring::hosts_.
+    uint32_t host_;
+    // Which of the host's hashes this is, i.e. the suffix of the hash key.
+    uint32_t index_;
+  };
+
+  struct RingHost {
     HostConstSharedPtr host_;
+    uint64_t hashes_;
   };
 
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
-         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats);
+         bool use_hostname_for_hashing, const Ring* previous, RingHashLoadBalancerStats& stats);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+    const std::string& hashKey(const Host& host) const;
+    void build();
+    bool buildFrom(const Ring& previous);
+    void buildSearchTree();
+
+    const HashFunction hash_function_;
+    const bool use_hostname_for_hashing_;
+    std::vector<RingHost> hosts_;
+    // The ring entries, sorted by hash. Lookups use the search tree below; the sorted ring is used
+    // by retries and to build the next ring.
     std::vector<RingEntry> ring_;
+    // The hashes of ring_ laid out for EytzingerSearch. Along with search_hosts_ and the sorted
+    // ring, each entry takes 28 bytes rather than the 16 of the sorted ring alone.
+    std::vector<uint64_t> search_hashes_;
+    // The host indexes of the entries of search_hashes_. Index 0 holds the host of the first entry
+    // of the ring, which hashes past the last entry wrap around to.
+    std::vector<uint32_t> search_hosts_;
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -73,16 +137,14 @@ private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double /* max_normalized_weight */) override {
-    return std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
-                                  max_ring_size_, hash_function_, use_hostname_for_hashing_,
-                                  stats_);
-  }
+                     double min_normalized_weight, double /* max_normalized_weight */,
+                     const HashingLoadBalancerSharedPtr& previous) override;
 
   static RingHashLoadBalancerStats generateStats(Stats::Scope& scope);
 
   Stats::ScopePtr scope_;
   RingHashLoadBalancerStats stats_;
+  TimeSource& time_source_;
 
   static const uint64_t DefaultMinRingSize = 1024;
   static const uint64_t DefaultMaxRingSize = 1024 * 1024 * 8;
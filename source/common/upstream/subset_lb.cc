@@ -8,6 +8,7 @@
 #include "envoy/runtime/runtime.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/config/metadata.h"
 #include "common/config/well_known_names.h"
 #include "common/protobuf/utility.h"
@@ -26,10 +27,12 @@ SubsetLoadBalancer::SubsetLoadBalancer(
         lb_ring_hash_config,
     const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
         least_request_config,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : lb_type_(lb_type), lb_ring_hash_config_(lb_ring_hash_config),
       least_request_config_(least_request_config), common_config_(common_config), stats_(stats),
-      scope_(scope), runtime_(runtime), random_(random), fallback_policy_(subsets.fallbackPolicy()),
+      scope_(scope), runtime_(runtime), random_(random), time_source_(time_source),
+      fallback_policy_(subsets.fallbackPolicy()),
       default_subset_metadata_(subsets.defaultSubset().fields().begin(),
                                subsets.defaultSubset().fields().end()),
       subset_selectors_(subsets.subsetSelectors()), original_priority_set_(priority_set),
@@ -63,6 +66,7 @@ SubsetLoadBalancer::SubsetLoadBalancer(
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   refreshSubsets();
+  rebuildSubsetIndex();
 
   initSubsetSelectorMap();
 
@@ -85,6 +89,7 @@ SubsetLoadBalancer::SubsetLoadBalancer(
         }
 
         purgeEmptySubsets(subsets_);
+        rebuildSubsetIndex();
       });
 }
 
@@ -292,43 +297,16 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   return entry->priority_subset_->lb_->chooseHost(context);
 }
 
-// Iterates over the given metadata match criteria (which must be lexically sorted by key) and find
-// a matching LbSubsetEntryPtr, if any.
-SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
-    const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
-  const LbSubsetMap* subsets = &subsets_;
-
-  // Because the match_criteria and the host metadata used to populate subsets_ are sorted in the
-  // same order, we can iterate over the criteria and perform a lookup for each key and value,
-  // starting with the root LbSubsetMap and using the previous iteration's LbSubsetMap thereafter
-  // (tracked in subsets). If ever a criterion's key or value is not found, there is no subset for
-  // this criteria. If we reach the last criterion, we've found the LbSubsetEntry for the criteria,
-  // which may or may not have a subset attached to it.
-  for (uint32_t i = 0; i < match_criteria.size(); i++) {
-    const Router::MetadataMatchCriterion& match_criterion = *match_criteria[i];
-    const auto& subset_it = subsets->find(match_criterion.name());
-    if (subset_it == subsets->end()) {
-      // No subsets with this key (at this level in the hierarchy).
-      break;
-    }
-
-    const ValueSubsetMap& vs_map = subset_it->second;
-    const auto& vs_it = vs_map.find(match_criterion.value());
-    if (vs_it == vs_map.end()) {
-      // No subsets with this value.
-      break;
-    }
-
-    const LbSubsetEntryPtr& entry = vs_it->second;
-    if (i + 1 == match_criteria.size()) {
-      // We've reached the end of the criteria, and they all matched.
-      return entry;
-    }
-
-    subsets = &entry->children_;
-  }
-
-  return nullptr;
+// Finds the LbSubsetEntryPtr matching the given metadata match criteria (which must be lexically
+// sorted by key), if any.
+SubsetLoadBalancer::LbSubsetEntryPtr
+SubsetLoadBalancer::findSubset(const MetadataMatchCriteriaVector& match_criteria) {
+  // The index holds the entries of subsets_ that have a subset attached by the key-values leading
+  // to them. Because the match_criteria and the host metadata used to populate subsets_ are sorted
+  // in the same order, an entry matches the criteria exactly when its key-values equal the
+  // criteria.
+  const auto it = subset_index_.find(match_criteria);
+  return it != subset_index_.end() ? it->second : nullptr;
 }
 
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
@@ -613,6 +591,65 @@ void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
   }
 }
 
+void SubsetLoadBalancer::rebuildSubsetIndex() {
+  subset_index_.clear();
+  SubsetIndexKey path;
+  indexSubsets(subsets_, path);
+}
+
+// Adds each entry of subsets with a subset attached, and recursively their children, to the index
+// under path extended with the entry's key-value. Entries without a subset are only intermediate
+// levels of subsets_ and would be treated as missing by chooseHost anyway, so they are left out to
+// keep the index from growing with the square of the number of keys of long selectors.
+void SubsetLoadBalancer::indexSubsets(const LbSubsetMap& subsets, SubsetIndexKey& path) {
+  const size_t parent_hash = path.hash_;
+  for (const auto& vsm : subsets) {
+    for (const auto& em : vsm.second) {
+      path.kvs_.emplace_back(&vsm.first, &em.first);
+      path.hash_ = hashKeyValue(parent_hash, vsm.first, em.first);
+      if (em.second->initialized()) {
+        subset_index_.emplace(path, em.second);
+      }
+      indexSubsets(em.second->children_, path);
+      path.kvs_.pop_back();
+    }
+  }
+  path.hash_ = parent_hash;
+}
+
+// Folds a key-value into the hash of the key-values before it. The value's hash was computed once
+// by HashedValue, so this only hashes the key and a word.
+size_t SubsetLoadBalancer::hashKeyValue(size_t seed, absl::string_view name,
+                                        const HashedValue& value) {
+  const size_t value_hash = value.hash();
+  return HashUtil::xxHash64(
+      absl::string_view(reinterpret_cast<const char*>(&value_hash), sizeof(value_hash)),
+      HashUtil::xxHash64(name, seed));
+}
+
+size_t SubsetLoadBalancer::SubsetIndexHash::operator()(
+    const MetadataMatchCriteriaVector& match_criteria) const {
+  size_t hash = 0;
+  for (const auto& match_criterion : match_criteria) {
+    hash = hashKeyValue(hash, match_criterion->name(), match_criterion->value());
+  }
+  return hash;
+}
+
+bool SubsetLoadBalancer::SubsetIndexEq::operator()(
+    const SubsetIndexKey& key, const MetadataMatchCriteriaVector& match_criteria) const {
+  if (key.kvs_.size() != match_criteria.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < match_criteria.size(); i++) {
+    if (*key.kvs_[i].first != match_criteria[i]->name() ||
+        *key.kvs_[i].second != match_criteria[i]->value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Initialize a new HostSubsetImpl and LoadBalancer from the SubsetLoadBalancer, filtering hosts
 // with the given predicate.
 SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb,
@@ -655,7 +692,7 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
     // can also use a thread aware sub-LB properly. The following works fine but is not optimal.
     thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
         *this, subset_lb.stats_, subset_lb.scope_, subset_lb.runtime_, subset_lb.random_,
-        subset_lb.lb_ring_hash_config_, subset_lb.common_config_);
+        subset_lb.lb_ring_hash_config_, subset_lb.common_config_, subset_lb.time_source_);
     thread_aware_lb_->initialize();
     lb_ = thread_aware_lb_->factory()->create();
     break;
@@ -666,15 +703,17 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
     // can also use a thread aware sub-LB properly. The following works fine but is not optimal.
     thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
         *this, subset_lb.stats_, subset_lb.scope_, subset_lb.runtime_, subset_lb.random_,
-        subset_lb.common_config_);
+        subset_lb.common_config_, subset_lb.time_source_);
     thread_aware_lb_->initialize();
     lb_ = thread_aware_lb_->factory()->create();
     break;
 
   case LoadBalancerType::OriginalDst:
   case LoadBalancerType::ClusterProvided:
+  case LoadBalancerType::PeakEwma:
     // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::ClusterProvided
     // is impossible because the subset LB returns a null load balancer from its factory.
+    // LoadBalancerType::PeakEwma cannot be combined with subsets in the cluster config.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
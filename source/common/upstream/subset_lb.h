@@ -6,6 +6,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
@@ -16,6 +17,7 @@
 #include "common/protobuf/utility.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -31,7 +33,8 @@ public:
           lb_ring_hash_config,
       const absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>&
           least_request_config,
-      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+      const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+      TimeSource& time_source);
   ~SubsetLoadBalancer() override;
 
   // Upstream::LoadBalancer
@@ -123,6 +126,40 @@ private:
   using ValueSubsetMap = std::unordered_map<HashedValue, LbSubsetEntryPtr>;
   using LbSubsetMap = std::unordered_map<std::string, ValueSubsetMap>;
   using SubsetSelectorFallbackParamsRef = std::reference_wrapper<SubsetSelectorFallbackParams>;
+  using MetadataMatchCriteriaVector = std::vector<Router::MetadataMatchCriterionConstSharedPtr>;
+
+  // The key-values leading to an entry of subsets_. They point to the keys of the LbSubsetMap and
+  // ValueSubsetMap of the path, so that the index shares the names and values that subsets_
+  // interned rather than copying them.
+  struct SubsetIndexKey {
+    std::vector<std::pair<const std::string*, const HashedValue*>> kvs_;
+    // Hash of kvs_, chained through hashKeyValue() the way SubsetIndexHash hashes metadata match
+    // criteria.
+    size_t hash_{};
+  };
+
+  // Hashes and compares SubsetIndexKeys, and metadata match criteria against them, so that the
+  // index can be probed with the criteria of a request without building a key.
+  struct SubsetIndexHash {
+    using is_transparent = void;
+    size_t operator()(const SubsetIndexKey& key) const { return key.hash_; }
+    size_t operator()(const MetadataMatchCriteriaVector& match_criteria) const;
+  };
+  struct SubsetIndexEq {
+    using is_transparent = void;
+    bool operator()(const SubsetIndexKey& lhs, const SubsetIndexKey& rhs) const {
+      return lhs.kvs_ == rhs.kvs_;
+    }
+    bool operator()(const SubsetIndexKey& key,
+                    const MetadataMatchCriteriaVector& match_criteria) const;
+    bool operator()(const MetadataMatchCriteriaVector& match_criteria,
+                    const SubsetIndexKey& key) const {
+      return (*this)(key, match_criteria);
+    }
+  };
+
+  using SubsetIndex =
+      absl::flat_hash_map<SubsetIndexKey, LbSubsetEntryPtr, SubsetIndexHash, SubsetIndexEq>;
 
   class LoadBalancerContextWrapper : public LoadBalancerContext {
   public:
@@ -211,13 +248,15 @@ private:
 
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
 
-  LbSubsetEntryPtr
-  findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  LbSubsetEntryPtr findSubset(const MetadataMatchCriteriaVector& matches);
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
                                       uint32_t idx);
   void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr)> cb);
   void purgeEmptySubsets(LbSubsetMap& subsets);
+  void rebuildSubsetIndex();
+  void indexSubsets(const LbSubsetMap& subsets, SubsetIndexKey& path);
+  static size_t hashKeyValue(size_t seed, absl::string_view name, const HashedValue& value);
 
   std::vector<SubsetMetadata> extractSubsetMetadata(const std::set<std::string>& subset_keys,
                                                     const Host& host);
@@ -232,6 +271,7 @@ private:
   Stats::Scope& scope_;
   Runtime::Loader& runtime_;
   Runtime::RandomGenerator& random_;
+  TimeSource& time_source_;
 
   const envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetFallbackPolicy
       fallback_policy_;
@@ -250,6 +290,10 @@ private:
 
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // The entries of subsets_ with a subset attached, by the full path of key-values leading to
+  // them, so that finding the subset for a request's metadata match criteria is a single hash
+  // lookup. Rebuilt after each host set update, as the update may add and remove entries.
+  SubsetIndex subset_index_;
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
@@ -107,6 +107,8 @@ void ThreadAwareLoadBalancerBase::refresh() {
   auto degraded_per_priority_load =
       std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
 
+  priority_builds_.resize(priority_set_.hostSetsPerPriority().size());
+
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
     (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
@@ -121,8 +123,21 @@ void ThreadAwareLoadBalancerBase::refresh() {
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight);
-    per_priority_state->current_lb_ =
-        createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+
+    // Priority updates rebuild every priority, but usually only one of them changed. The hashing
+    // load balancers only depend on the normalized weights, so reuse the last one when those are
+    // the same.
+    PriorityBuild& build = priority_builds_[priority];
+    if (build.lb_ == nullptr || normalized_host_weights != build.normalized_host_weights_ ||
+        min_normalized_weight != build.min_normalized_weight_ ||
+        max_normalized_weight != build.max_normalized_weight_) {
+      build.lb_ = createLoadBalancer(normalized_host_weights, min_normalized_weight,
+                                     max_normalized_weight, build.lb_);
+      build.normalized_host_weights_ = std::move(normalized_host_weights);
+      build.min_normalized_weight_ = min_normalized_weight;
+      build.max_normalized_weight_ = max_normalized_weight;
+    }
+    per_priority_state->current_lb_ = build.lb_;
   }
 
   {
@@ -82,12 +82,32 @@ private:
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
   };
 
+  // The inputs and the result of the last build for a priority. Builds only happen on the main
+  // thread, so this is not shared with the workers.
+  struct PriorityBuild {
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{};
+    double max_normalized_weight_{};
+    HashingLoadBalancerSharedPtr lb_;
+  };
+
+  /**
+   * Build the hashing load balancer for a priority.
+   * @param normalized_host_weights supplies the hosts and their weights, which sum to 1.
+   * @param min_normalized_weight supplies the smallest weight in normalized_host_weights.
+   * @param max_normalized_weight supplies the largest weight in normalized_host_weights.
+   * @param previous supplies the load balancer last built by this object for the same priority,
+   *        or nullptr. Implementations may reuse its state to build the new one incrementally,
+   *        but the result must be the same as a build from scratch.
+   */
   virtual HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double max_normalized_weight) PURE;
+                     double min_normalized_weight, double max_normalized_weight,
+                     const HashingLoadBalancerSharedPtr& previous) PURE;
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  std::vector<PriorityBuild> priority_builds_;
 };
 
 } // namespace Upstream
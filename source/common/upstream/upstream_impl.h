@@ -537,6 +537,8 @@ public:
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
+  double perUpstreamPrefetchRatio() const override { return per_upstream_prefetch_ratio_; }
+  bool prefetchOnHostAdd() const override { return prefetch_on_host_add_; }
   uint64_t features() const override { return features_; }
   const Http::Http1Settings& http1Settings() const override { return http1_settings_; }
   const envoy::config::core::v3::Http2ProtocolOptions& http2Options() const override {
@@ -557,6 +559,10 @@ public:
   lbLeastRequestConfig() const override {
     return lb_least_request_config_;
   }
+  const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const override {
+    return lb_peak_ewma_config_;
+  }
   const absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig>&
   lbRingHashConfig() const override {
     return lb_ring_hash_config_;
@@ -630,6 +636,8 @@ private:
   const std::chrono::milliseconds connect_timeout_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  const double per_upstream_prefetch_ratio_;
+  const bool prefetch_on_host_add_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
   mutable ClusterStats stats_;
@@ -648,6 +656,7 @@ private:
   absl::optional<envoy::config::cluster::v3::Cluster::LeastRequestLbConfig>
       lb_least_request_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> lb_ring_hash_config_;
+  absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::OriginalDstLbConfig> lb_original_dst_config_;
   absl::optional<envoy::config::core::v3::TypedExtensionConfig> upstream_config_;
   const bool added_via_api_;
@@ -172,6 +172,12 @@ EXTENSIONS = {
     "envoy.transport_sockets.tap":                      "//source/extensions/transport_sockets/tap:config",
     "envoy.transport_sockets.quic":                     "//source/extensions/quic_listeners/quiche:quic_transport_socket_factory_lib",
 
+    #
+    # TLS private key providers
+    #
+
+    "envoy.tls.key_providers.thread_pool":              "//source/extensions/private_key_providers/thread_pool:config",
+
     #
     # Retry host predicates
     #
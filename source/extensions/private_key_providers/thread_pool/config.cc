@@ -0,0 +1,62 @@
+#include "extensions/private_key_providers/thread_pool/config.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.validate.h"
+#include "envoy/common/exception.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
+
+#include "common/config/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/private_key_providers/thread_pool/crypto_thread_pool.h"
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(crypto_thread_pool);
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+ThreadPoolPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& proto_config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  envoy::extensions::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+      config;
+  Config::Utility::translateOpaqueConfig(proto_config.typed_config(), ProtobufWkt::Struct(),
+                                         factory_context.messageValidationVisitor(), config);
+  MessageUtil::validate(config, factory_context.messageValidationVisitor());
+
+  const uint32_t thread_count = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, thread_count, std::max(1U, std::thread::hardware_concurrency()));
+  CryptoThreadPoolSharedPtr pool =
+      factory_context.singletonManager().getTyped<CryptoThreadPool>(
+          SINGLETON_MANAGER_REGISTERED_NAME(crypto_thread_pool), [&factory_context, thread_count] {
+            return std::make_shared<CryptoThreadPool>(factory_context.api().threadFactory(),
+                                                      thread_count);
+          });
+
+  // The pool is process-wide, so a configuration asking for a different size can't be honored.
+  if (config.has_thread_count() && pool->threadCount() != thread_count) {
+    throw EnvoyException(fmt::format("thread pool private key provider: thread_count {} conflicts "
+                                     "with the existing crypto thread pool of {} threads",
+                                     thread_count, pool->threadCount()));
+  }
+
+  return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(config, factory_context.api(),
+                                                              std::move(pool));
+}
+
+REGISTER_FACTORY(ThreadPoolPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
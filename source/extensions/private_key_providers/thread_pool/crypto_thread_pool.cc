@@ -0,0 +1,65 @@
+#include "extensions/private_key_providers/thread_pool/crypto_thread_pool.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+CryptoThreadPool::CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count) {
+  ASSERT(thread_count > 0);
+  threads_.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(thread_factory.createThread([this]() -> void { threadRoutine(); },
+                                                      Thread::Options{"envoy-crypto"}));
+  }
+  ENVOY_LOG(debug, "started {} private key operation threads", thread_count);
+}
+
+CryptoThreadPool::~CryptoThreadPool() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    jobs_available_.notifyAll();
+  }
+
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void CryptoThreadPool::post(std::function<void()> job) {
+  Thread::LockGuard lock(lock_);
+  jobs_.emplace_back(std::move(job));
+  jobs_available_.notifyOne();
+}
+
+void CryptoThreadPool::threadRoutine() {
+  while (true) {
+    std::function<void()> job;
+
+    {
+      Thread::LockGuard lock(lock_);
+      while (jobs_.empty() && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        jobs_available_.wait(lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    job();
+  }
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * A fixed-size pool of threads that runs CPU-heavy private key operations off the workers. Jobs
+ * are run in the order they were posted. Jobs still queued when the pool is destroyed are dropped.
+ */
+class CryptoThreadPool : public Singleton::Instance, Logger::Loggable<Logger::Id::connection> {
+public:
+  CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count);
+  ~CryptoThreadPool() override;
+
+  /**
+   * Queue a job to run on one of the pool threads. Thread safe.
+   * @param job supplies the job to run.
+   */
+  void post(std::function<void()> job);
+
+  /**
+   * @return the number of threads in the pool.
+   */
+  size_t threadCount() const { return threads_.size(); }
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar jobs_available_;
+  std::list<std::function<void()>> jobs_ ABSL_GUARDED_BY(lock_);
+  bool exit_ ABSL_GUARDED_BY(lock_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using CryptoThreadPoolSharedPtr = std::shared_ptr<CryptoThreadPool>;
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,293 @@
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+PrivateKeyOperation::PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                         Event::Dispatcher& dispatcher,
+                                         bssl::UniquePtr<EVP_PKEY> pkey, Type type,
+                                         uint16_t signature_algorithm, const uint8_t* in,
+                                         size_t in_len)
+    : cb_(&cb), dispatcher_(dispatcher), pkey_(std::move(pkey)), type_(type),
+      signature_algorithm_(signature_algorithm), input_(in, in + in_len) {}
+
+void PrivateKeyOperation::run() {
+  success_ = type_ == Type::Sign ? sign() : decrypt();
+
+  Thread::LockGuard lock(lock_);
+  if (!cancelled_) {
+    dispatcher_.post([operation = shared_from_this()]() -> void { operation->onComplete(); });
+  }
+}
+
+void PrivateKeyOperation::cancel() {
+  Thread::LockGuard lock(lock_);
+  cancelled_ = true;
+  cb_ = nullptr;
+}
+
+void PrivateKeyOperation::onComplete() {
+  if (cb_ == nullptr) {
+    return;
+  }
+  done_ = true;
+  cb_->onPrivateKeyMethodComplete();
+}
+
+bool PrivateKeyOperation::sign() {
+  if (SSL_get_signature_algorithm_key_type(signature_algorithm_) != EVP_PKEY_id(pkey_.get())) {
+    return false;
+  }
+
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm_);
+  if (md == nullptr) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, pkey_.get())) {
+    return false;
+  }
+
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm_) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       // -1 sets the salt length to the digest length, as required by TLS.
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1))) {
+    return false;
+  }
+
+  size_t out_len = EVP_PKEY_size(pkey_.get());
+  output_.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), output_.data(), &out_len, input_.data(), input_.size())) {
+    return false;
+  }
+  output_.resize(out_len);
+  return true;
+}
+
+bool PrivateKeyOperation::decrypt() {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+  if (rsa == nullptr) {
+    return false;
+  }
+
+  size_t out_len = RSA_size(rsa);
+  output_.resize(out_len);
+  if (!RSA_decrypt(rsa, &out_len, output_.data(), output_.size(), input_.data(), input_.size(),
+                   RSA_NO_PADDING)) {
+    return false;
+  }
+  output_.resize(out_len);
+  return true;
+}
+
+ssl_private_key_result_t PrivateKeyOperation::result(uint8_t* out, size_t* out_len,
+                                                     size_t max_out) const {
+  ASSERT(done_);
+  if (!success_ || output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+
+  std::copy(output_.begin(), output_.end(), out);
+  *out_len = output_.size();
+  return ssl_private_key_success;
+}
+
+ThreadPoolPrivateKeyConnection::ThreadPoolPrivateKeyConnection(
+    Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher,
+    bssl::UniquePtr<EVP_PKEY> pkey, CryptoThreadPool& pool)
+    : cb_(cb), dispatcher_(dispatcher), pkey_(std::move(pkey)), pool_(pool) {}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (pending_ != nullptr) {
+    pending_->cancel();
+  }
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::start(PrivateKeyOperation::Type type,
+                                                               uint16_t signature_algorithm,
+                                                               const uint8_t* in, size_t in_len) {
+  if (pending_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+
+  pending_ = std::make_shared<PrivateKeyOperation>(cb_, dispatcher_, bssl::UpRef(pkey_), type,
+                                                   signature_algorithm, in, in_len);
+  pool_.post([operation = pending_]() -> void { operation->run(); });
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                                  size_t max_out) {
+  if (pending_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+
+  if (!pending_->done()) {
+    // The pool hasn't finished the operation yet, retry.
+    return ssl_private_key_retry;
+  }
+
+  const ssl_private_key_result_t result = pending_->result(out, out_len, max_out);
+  pending_.reset();
+  return result;
+}
+
+namespace {
+
+ThreadPoolPrivateKeyConnections* getConnections(SSL* ssl) {
+  return static_cast<ThreadPoolPrivateKeyConnections*>(
+      SSL_get_ex_data(ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ThreadPoolPrivateKeyConnection* getConnection(SSL* ssl) {
+  ThreadPoolPrivateKeyConnections* connections = getConnections(ssl);
+  if (connections == nullptr || connections->empty()) {
+    return nullptr;
+  }
+  if (connections->size() == 1) {
+    return connections->front().get();
+  }
+  // More than one certificate of the context uses this provider. Use the key that matches the
+  // certificate selected for the handshake.
+  X509* cert = SSL_get_certificate(ssl);
+  if (cert == nullptr) {
+    return nullptr;
+  }
+  bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(cert));
+  if (public_key == nullptr) {
+    return nullptr;
+  }
+  for (const auto& connection : *connections) {
+    if (EVP_PKEY_cmp(public_key.get(), connection->pkey()) == 1) {
+      return connection.get();
+    }
+  }
+  return nullptr;
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(PrivateKeyOperation::Type::Sign, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(PrivateKeyOperation::Type::Decrypt, 0, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->complete(out, out_len, max_out);
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+} // namespace
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, createIndex());
+}
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& config,
+    Api::Api& api, CryptoThreadPoolSharedPtr pool)
+    : pool_(std::move(pool)) {
+  const std::string private_key = Config::DataSource::read(config.private_key(), false, api);
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey == nullptr) {
+    throw EnvoyException("Failed to load private key for the thread pool private key provider");
+  }
+  if (EVP_PKEY_id(pkey.get()) != EVP_PKEY_RSA && EVP_PKEY_id(pkey.get()) != EVP_PKEY_EC) {
+    throw EnvoyException("The thread pool private key provider only supports RSA and ECDSA keys");
+  }
+  pkey_ = std::move(pkey);
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  ThreadPoolPrivateKeyConnections* connections = getConnections(ssl);
+  if (connections == nullptr) {
+    connections = new ThreadPoolPrivateKeyConnections();
+    SSL_set_ex_data(ssl, connectionIndex(), connections);
+  }
+  connections->push_back(
+      std::make_unique<ThreadPoolPrivateKeyConnection>(cb, dispatcher, bssl::UpRef(pkey_), *pool_));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ThreadPoolPrivateKeyConnections* connections = getConnections(ssl);
+  if (connections == nullptr) {
+    return;
+  }
+  connections->erase(std::remove_if(connections->begin(), connections->end(),
+                                    [this](const ThreadPoolPrivateKeyConnectionPtr& connection) {
+                                      return connection->pkey() == pkey_.get();
+                                    }),
+                     connections->end());
+  if (connections->empty()) {
+    SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+    delete connections;
+  }
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  if (EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa != nullptr && RSA_check_fips(rsa);
+  }
+  const EC_KEY* ec_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ec_key != nullptr && EC_KEY_check_fips(ec_key);
+}
+
+Ssl::BoringSslPrivateKeyMethodSharedPtr
+ThreadPoolPrivateKeyMethodProvider::getBoringSslPrivateKeyMethod() {
+  return method_;
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
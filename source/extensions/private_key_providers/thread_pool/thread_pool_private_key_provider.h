@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/private_key/private_key_callbacks.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "extensions/private_key_providers/thread_pool/crypto_thread_pool.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * A single private key operation, shared between the connection that started it and the pool
+ * thread that performs it.
+ */
+class PrivateKeyOperation : public std::enable_shared_from_this<PrivateKeyOperation> {
+public:
+  enum class Type { Sign, Decrypt };
+
+  PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher,
+                      bssl::UniquePtr<EVP_PKEY> pkey, Type type, uint16_t signature_algorithm,
+                      const uint8_t* in, size_t in_len);
+
+  /**
+   * Runs the operation and posts its completion to the owning dispatcher. Called on a pool thread.
+   */
+  void run();
+
+  /**
+   * Stops the completion from being delivered to the connection. Called on the owning dispatcher,
+   * before the connection goes away.
+   */
+  void cancel();
+
+  /**
+   * @return true once the result has been delivered on the owning dispatcher.
+   */
+  bool done() const { return done_; }
+
+  /**
+   * Copies the result of a completed operation.
+   * @return ssl_private_key_success if the operation succeeded and fits in max_out.
+   */
+  ssl_private_key_result_t result(uint8_t* out, size_t* out_len, size_t max_out) const;
+
+private:
+  bool sign();
+  bool decrypt();
+  void onComplete();
+
+  // Only accessed on the owning dispatcher.
+  Ssl::PrivateKeyConnectionCallbacks* cb_;
+  bool done_{};
+
+  Event::Dispatcher& dispatcher_;
+  const bssl::UniquePtr<EVP_PKEY> pkey_;
+  const Type type_;
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  // Written on the pool thread before the completion is posted, and only read on the owning
+  // dispatcher afterwards.
+  std::vector<uint8_t> output_;
+  bool success_{};
+
+  // Guards against posting to the dispatcher after the connection has gone away, since the
+  // dispatcher may not outlive it.
+  Thread::MutexBasicLockable lock_;
+  bool cancelled_ ABSL_GUARDED_BY(lock_){false};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * Per-connection state of a provider.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 Event::Dispatcher& dispatcher, bssl::UniquePtr<EVP_PKEY> pkey,
+                                 CryptoThreadPool& pool);
+  ~ThreadPoolPrivateKeyConnection();
+
+  ssl_private_key_result_t start(PrivateKeyOperation::Type type, uint16_t signature_algorithm,
+                                 const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+  const EVP_PKEY* pkey() const { return pkey_.get(); }
+
+private:
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  CryptoThreadPool& pool_;
+  PrivateKeyOperationSharedPtr pending_;
+};
+
+using ThreadPoolPrivateKeyConnectionPtr = std::unique_ptr<ThreadPoolPrivateKeyConnection>;
+
+/**
+ * The state of each provider registered with a connection, stored in the SSL object's ex_data.
+ * Several certificates of a context, e.g. an RSA and an ECDSA one, can use this provider, and a
+ * handshake only uses the key of the certificate it selected.
+ */
+using ThreadPoolPrivateKeyConnections = std::vector<ThreadPoolPrivateKeyConnectionPtr>;
+
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider,
+                                           Logger::Loggable<Logger::Id::connection> {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Api::Api& api, CryptoThreadPoolSharedPtr pool);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override;
+
+  static int connectionIndex();
+
+private:
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  const CryptoThreadPoolSharedPtr pool_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -72,6 +72,14 @@ public:
     // As quic connection is not HTTP1.1, this method shouldn't be called by HCM.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
+  uint64_t shrinkBuffers() override {
+    // Buffers are owned by QUICHE.
+    return 0;
+  }
+  uint64_t bufferedBytes() const override {
+    // Buffers are owned by QUICHE.
+    return 0;
+  }
   bool localAddressRestored() const override {
     // SO_ORIGINAL_DST not supported by QUIC.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -79,6 +87,10 @@ public:
   bool aboveHighWatermark() const override;
 
   const Network::ConnectionSocket::OptionsSharedPtr& socketOptions() const override;
+  const Network::IoHandle& ioHandle() const override {
+    // QUIC connections share the listener's UDP socket.
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
   StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
   const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
   absl::string_view transportFailureReason() const override { return transport_failure_reason_; }
@@ -35,6 +35,20 @@ public:
     }
     return io_handle_.writev(slices, num_slice);
   }
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.read(buffer, max_length);
+  }
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.write(buffer);
+  }
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Envoy::Network::Address::Ip* self_ip,
                                   const Network::Address::Instance& peer_address) override {
@@ -81,6 +95,11 @@ public:
   Api::SysCallIntResult setBlocking(bool blocking) override {
     return io_handle_.setBlocking(blocking);
   }
+  Api::SysCallIntResult shutdown(int how) override { return io_handle_.shutdown(how); }
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override {
+    return io_handle_.createFileEvent(dispatcher, cb, trigger, events);
+  }
   absl::optional<int> domain() override { return io_handle_.domain(); }
   Network::Address::InstanceConstSharedPtr localAddress() override {
     return io_handle_.localAddress();
@@ -22,6 +22,7 @@ public:
   const Network::IoHandle& ioHandle() const override { return parent_.ioHandle(); }
   Network::Connection& connection() override { return parent_.connection(); }
   bool shouldDrainReadBuffer() override { return false; }
+  uint64_t readSize() const override { return parent_.readSize(); }
   /*
    * No-op for these two methods to hold back the callbacks.
    */
@@ -43,6 +43,7 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -94,6 +95,7 @@ private:
   Envoy::Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool kernel_tls_offload_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -150,6 +152,9 @@ public:
   bool disableStatelessSessionResumption() const override {
     return disable_stateless_session_resumption_;
   }
+  absl::optional<uint32_t> maxSessionCacheSize() const override {
+    return max_session_cache_size_;
+  }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -168,6 +173,7 @@ private:
   ServerContextConfig::SessionTicketKey getSessionTicketKey(const std::string& key_data);
 
   absl::optional<std::chrono::seconds> session_timeout_;
+  absl::optional<uint32_t> max_session_cache_size_;
   const bool disable_stateless_session_resumption_;
 };
 
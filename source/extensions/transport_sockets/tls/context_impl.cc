@@ -25,6 +25,7 @@
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
@@ -65,6 +66,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
                          TimeSource& time_source)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
       tls_max_version_(config.maxProtocolVersion()),
+      kernel_tls_offload_(config.kernelTlsOffload()),
       stat_name_set_(scope.symbolTable().makeSet("TransportSockets::Tls")),
       unknown_ssl_cipher_(stat_name_set_->add("unknown_ssl_cipher")),
       unknown_ssl_curve_(stat_name_set_->add("unknown_ssl_curve")),
@@ -866,7 +868,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
 }
@@ -923,48 +925,101 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
     SSL_set_renegotiate_mode(ssl_con.get(), ssl_renegotiate_freely);
   }
 
-  if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
-      // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-        // Remove single-use session key (TLS 1.3) after first use.
-        if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
-        }
-      }
-    } else {
-      // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-      }
+  return ssl_con;
+}
+
+int ClientContextImpl::sessionKeyUpstreamIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(
+        0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+          delete static_cast<std::string*>(ptr);
+        });
+    RELEASE_ASSERT(index >= 0, "");
+    return index;
+  }());
+}
+
+void ClientContextImpl::setRemoteAddress(SSL* ssl,
+                                         const Network::Address::Instance& remote_address) {
+  if (max_session_keys_ == 0) {
+    return;
+  }
+  // The session can only be chosen once the upstream address is known, which isn't the case yet
+  // in newSsl(). The SNI value, if any, was set by newSsl().
+  const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  auto upstream = std::make_unique<std::string>(absl::StrCat(
+      server_name != nullptr ? server_name : "", "/", remote_address.asStringView()));
+  setSessionKey(ssl, *upstream);
+  SSL_set_ex_data(ssl, sessionKeyUpstreamIndex(), upstream.release());
+}
+
+void ClientContextImpl::setSessionKey(SSL* ssl, const std::string& upstream) {
+  if (session_keys_single_use_) {
+    // Stored single-use session keys, use write/write locks.
+    absl::WriterMutexLock l(&session_keys_mu_);
+    auto it = session_keys_.find(upstream);
+    if (it == session_keys_.end() || it->second.empty()) {
+      stats_.session_cache_miss_.inc();
+      return;
     }
+    // Use the most recently stored session key, since it has the highest
+    // probability of still being recognized/accepted by the server.
+    SSL_SESSION* session = it->second.front().get();
+    SSL_set_session(ssl, session);
+    stats_.session_cache_hit_.inc();
+    // Remove single-use session key (TLS 1.3) after first use.
+    if (SSL_SESSION_should_be_single_use(session)) {
+      it->second.pop_front();
+    }
+  } else {
+    // Never stored single-use session keys, use read/write locks.
+    absl::ReaderMutexLock l(&session_keys_mu_);
+    auto it = session_keys_.find(upstream);
+    if (it == session_keys_.end() || it->second.empty()) {
+      stats_.session_cache_miss_.inc();
+      return;
+    }
+    // Use the most recently stored session key, since it has the highest
+    // probability of still being recognized/accepted by the server.
+    SSL_set_session(ssl, it->second.front().get());
+    stats_.session_cache_hit_.inc();
   }
-
-  return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
   // In case we ever store single-use session key (TLS 1.3),
   // we need to switch to using write/write locks.
   if (SSL_SESSION_should_be_single_use(session)) {
     session_keys_single_use_ = true;
   }
+  const auto* upstream = static_cast<const std::string*>(
+      SSL_get_ex_data(ssl, sessionKeyUpstreamIndex()));
+  if (upstream == nullptr) {
+    // The connection's upstream address was never set, so the session can't be attributed to an
+    // upstream. Leave the session to BoringSSL, which frees it.
+    return 0;
+  }
+
   absl::WriterMutexLock l(&session_keys_mu_);
+  auto it = session_keys_.find(*upstream);
+  if (it == session_keys_.end()) {
+    if (session_keys_.size() >= MaxSessionKeyUpstreams) {
+      // Drop the keys of an arbitrary upstream to keep memory bounded when connecting to an
+      // unbounded set of hosts (e.g. with auto_sni).
+      stats_.session_cache_evicted_.add(session_keys_.begin()->second.size());
+      session_keys_.erase(session_keys_.begin());
+    }
+    it = session_keys_.emplace(*upstream, std::deque<bssl::UniquePtr<SSL_SESSION>>()).first;
+  }
+  auto& session_keys = it->second;
   // Evict oldest entries.
-  while (session_keys_.size() >= max_session_keys_) {
-    session_keys_.pop_back();
+  while (session_keys.size() >= max_session_keys_) {
+    session_keys.pop_back();
+    stats_.session_cache_evicted_.inc();
   }
   // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
+  session_keys.push_front(bssl::UniquePtr<SSL_SESSION>(session));
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
@@ -993,6 +1048,11 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used. We do this early because it can throw an EnvoyException.
   const SessionContextID session_id = generateHashForSessionContextId(server_names);
 
+  const absl::optional<uint32_t> max_session_cache_size = config.maxSessionCacheSize();
+  if (max_session_cache_size.has_value() && max_session_cache_size.value() > 0) {
+    session_cache_ = std::make_unique<ServerSessionCache>(max_session_cache_size.value());
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -1042,12 +1102,53 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
     }
 
+    if (max_session_cache_size.has_value() && session_cache_ == nullptr) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_cache_ != nullptr) {
+      // Replace BoringSSL's internal cache, which is a single locked LRU per SSL_CTX, with the
+      // sharded cache owned by this context.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            // The returned session already carries a reference owned by BoringSSL.
+            *out_copy = 0;
+            return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                ->getSession(id, id_len);
+          });
+    }
+
     int rc =
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
   }
 }
 
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  const size_t evicted = session_cache_->insert(bssl::UniquePtr<SSL_SESSION>(session));
+  stats_.session_cache_evicted_.add(evicted);
+  return 1; // Tell BoringSSL that we took ownership of the session.
+}
+
+SSL_SESSION* ServerContextImpl::getSession(const uint8_t* id, int id_len) {
+  const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                           time_source_.systemTime().time_since_epoch())
+                           .count();
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(
+      absl::string_view(reinterpret_cast<const char*>(id), static_cast<size_t>(id_len)), now);
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session.release();
+}
+
 ServerContextImpl::SessionContextID
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
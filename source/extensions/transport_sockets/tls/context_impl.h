@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/network/address.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -18,7 +19,9 @@
 #include "common/stats/symbol_table_impl.h"
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
@@ -36,6 +39,11 @@ namespace Tls {
   COUNTER(connection_error)                                                                        \
   COUNTER(handshake)                                                                               \
   COUNTER(session_reused)                                                                          \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(session_cache_evicted)                                                                   \
+  COUNTER(ktls_offloaded)                                                                          \
+  COUNTER(ktls_offload_skipped)                                                                    \
   COUNTER(no_certificate)                                                                          \
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
@@ -53,6 +61,14 @@ class ContextImpl : public virtual Envoy::Ssl::Context {
 public:
   virtual bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options);
 
+  /**
+   * Called with the remote address of the connection an SSL object created by newSsl() is used
+   * for, before the handshake starts.
+   * @param ssl the connection's SSL object
+   * @param remote_address the remote address of the connection
+   */
+  virtual void setRemoteAddress(SSL*, const Network::Address::Instance&) {}
+
   /**
    * Logs successful TLS handshake and updates stats.
    * @param ssl the connection to log
@@ -101,6 +117,12 @@ public:
 
   std::vector<Ssl::PrivateKeyMethodProviderSharedPtr> getPrivateKeyMethodProviders();
 
+  /**
+   * @return true if established connections should try to offload their record layer to kernel
+   * TLS.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
               TimeSource& time_source);
@@ -193,6 +215,7 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool kernel_tls_offload_;
   mutable Stats::StatNameSetPtr stat_name_set_;
   const Stats::StatName unknown_ssl_cipher_;
   const Stats::StatName unknown_ssl_curve_;
@@ -212,16 +235,29 @@ public:
                     TimeSource& time_source);
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
+  void setRemoteAddress(SSL* ssl, const Network::Address::Instance& remote_address) override;
 
 private:
-  int newSessionKey(SSL_SESSION* session);
+  // Upper bound on the number of distinct upstreams for which session keys are stored.
+  static constexpr size_t MaxSessionKeyUpstreams = 1024;
+
+  // The SSL-library index used for storing the upstream, as a std::string of its server name and
+  // address, that a connection's session keys are stored under.
+  static int sessionKeyUpstreamIndex();
+
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
+  void setSessionKey(SSL* ssl, const std::string& upstream);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
 
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
   absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
+  // Session keys are stored per SNI value and upstream address, so that a context used to connect
+  // to multiple hosts never offers a session to a host other than the one that issued it, even
+  // when the hosts share an SNI value or none is sent.
+  absl::flat_hash_map<std::string, std::deque<bssl::UniquePtr<SSL_SESSION>>>
+      session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
   bool session_keys_single_use_{false};
 };
 
@@ -244,7 +280,14 @@ private:
 
   SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
+  // Callbacks for the external session cache, installed when the server session cache size is
+  // configured.
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(const uint8_t* id, int id_len);
+
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  // Shared by all workers, since the SSL_CTXs owned by this context are.
+  ServerSessionCachePtr session_cache_;
 };
 
 } // namespace Tls
@@ -0,0 +1,237 @@
+#include "extensions/transport_sockets/tls/ktls.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+#include "absl/container/inlined_vector.h"
+#include "openssl/mem.h"
+#include "openssl/nid.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+
+// Older libc headers don't carry these even when the kernel supports them.
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#if defined(__linux__)
+namespace {
+
+constexpr uint8_t RecordTypeAlert = 21;
+constexpr uint8_t RecordTypeApplicationData = 23;
+constexpr uint8_t AlertLevelWarning = 1;
+constexpr uint8_t AlertCloseNotify = 0;
+
+void writeSequence(uint64_t seq, unsigned char* out) {
+  for (int i = 7; i >= 0; i--) {
+    out[i] = static_cast<unsigned char>(seq & 0xff);
+    seq >>= 8;
+  }
+}
+
+// Both AES-GCM crypto info structs share the same layout and differ only in key size.
+template <class CryptoInfo>
+void fillCryptoInfo(CryptoInfo& info, uint16_t cipher_type, const uint8_t* key,
+                    const uint8_t* salt, uint64_t seq) {
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  writeSequence(seq, info.rec_seq);
+  // BoringSSL uses the record sequence number as the explicit nonce, and so does the kernel once
+  // it's seeded with it.
+  writeSequence(seq, info.iv);
+}
+
+union CryptoInfo {
+  tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+  tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+};
+
+} // namespace
+
+OffloadResult offload(SSL* ssl, os_fd_t fd) {
+  // Data already read off the socket by BoringSSL can't be handed over, so only offload at a
+  // record boundary.
+  if (SSL_in_init(ssl) || SSL_has_pending(ssl) || SSL_version(ssl) != TLS1_2_VERSION) {
+    return OffloadResult::Skipped;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return OffloadResult::Skipped;
+  }
+
+  size_t key_len;
+  uint16_t cipher_type;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+    cipher_type = TLS_CIPHER_AES_GCM_128;
+    break;
+  case NID_aes_256_gcm:
+    key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+    cipher_type = TLS_CIPHER_AES_GCM_256;
+    break;
+  default:
+    return OffloadResult::Skipped;
+  }
+
+  // The TLSv1.2 key block is laid out as client MAC key, server MAC key, client key, server key,
+  // client IV and server IV. AEAD ciphers have no MAC keys and only use the IVs as salt.
+  const size_t salt_len = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_len + salt_len) ||
+      !SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return OffloadResult::Skipped;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_len;
+  const uint8_t* client_salt = server_key + key_len;
+  const uint8_t* server_salt = client_salt + salt_len;
+  const bool is_server = SSL_is_server(ssl);
+
+  CryptoInfo tx;
+  CryptoInfo rx;
+  socklen_t info_len;
+  if (cipher_type == TLS_CIPHER_AES_GCM_128) {
+    fillCryptoInfo(tx.aes_gcm_128, cipher_type, is_server ? server_key : client_key,
+                   is_server ? server_salt : client_salt, SSL_get_write_sequence(ssl));
+    fillCryptoInfo(rx.aes_gcm_128, cipher_type, is_server ? client_key : server_key,
+                   is_server ? client_salt : server_salt, SSL_get_read_sequence(ssl));
+    info_len = sizeof(tx.aes_gcm_128);
+  } else {
+    fillCryptoInfo(tx.aes_gcm_256, cipher_type, is_server ? server_key : client_key,
+                   is_server ? server_salt : client_salt, SSL_get_write_sequence(ssl));
+    fillCryptoInfo(rx.aes_gcm_256, cipher_type, is_server ? client_key : server_key,
+                   is_server ? client_salt : server_salt, SSL_get_read_sequence(ssl));
+    info_len = sizeof(tx.aes_gcm_256);
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  OffloadResult result = OffloadResult::Offloaded;
+  // A socket with the TLS ULP attached but no keys installed behaves like a plain TCP socket, so
+  // failing either of the first two steps leaves the connection usable by BoringSSL.
+  if (os_syscalls.setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")).rc_ != 0 ||
+      os_syscalls.setsockopt(fd, SOL_TLS, TLS_TX, &tx, info_len).rc_ != 0) {
+    result = OffloadResult::Skipped;
+  } else if (os_syscalls.setsockopt(fd, SOL_TLS, TLS_RX, &rx, info_len).rc_ != 0) {
+    result = OffloadResult::Failed;
+  }
+  OPENSSL_cleanse(&tx, sizeof(tx));
+  OPENSSL_cleanse(&rx, sizeof(rx));
+  return result;
+}
+
+Api::SysCallSizeResult readv(os_fd_t fd, Buffer::RawSlice* slices, uint64_t num_slices,
+                             RecordType& record_type) {
+  absl::InlinedVector<iovec, 2> iov(num_slices);
+  uint64_t num_slices_for_read = 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      iov[num_slices_for_read].iov_base = slices[i].mem_;
+      iov[num_slices_for_read].iov_len = slices[i].len_;
+      ++num_slices_for_read;
+    }
+  }
+
+  alignas(cmsghdr) char cbuf[CMSG_SPACE(sizeof(uint8_t))];
+  memset(cbuf, 0, sizeof(cbuf));
+  msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_iov = iov.data();
+  hdr.msg_iovlen = num_slices_for_read;
+  hdr.msg_control = cbuf;
+  hdr.msg_controllen = sizeof(cbuf);
+
+  record_type = RecordType::ApplicationData;
+  const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().recvmsg(fd, &hdr, 0);
+  if (result.rc_ <= 0 || hdr.msg_controllen == 0) {
+    return result;
+  }
+
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    if (cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE) {
+      continue;
+    }
+    const uint8_t type = *reinterpret_cast<const uint8_t*>(CMSG_DATA(cmsg));
+    if (type == RecordTypeApplicationData) {
+      break;
+    }
+    record_type = RecordType::Other;
+    if (type == RecordTypeAlert && result.rc_ >= 2) {
+      // The alert body is level followed by description; gather it in case it straddles slices.
+      uint8_t alert[2];
+      size_t copied = 0;
+      for (uint64_t i = 0; i < num_slices_for_read && copied < sizeof(alert); i++) {
+        const size_t n = std::min(sizeof(alert) - copied, iov[i].iov_len);
+        memcpy(alert + copied, iov[i].iov_base, n);
+        copied += n;
+      }
+      if (alert[1] == AlertCloseNotify) {
+        record_type = RecordType::CloseNotify;
+      }
+    }
+    break;
+  }
+  return result;
+}
+
+Api::SysCallSizeResult sendCloseNotify(os_fd_t fd) {
+  uint8_t alert[2] = {AlertLevelWarning, AlertCloseNotify};
+  iovec iov;
+  iov.iov_base = alert;
+  iov.iov_len = sizeof(alert);
+
+  alignas(cmsghdr) char cbuf[CMSG_SPACE(sizeof(uint8_t))];
+  memset(cbuf, 0, sizeof(cbuf));
+  msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  hdr.msg_control = cbuf;
+  hdr.msg_controllen = sizeof(cbuf);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *reinterpret_cast<uint8_t*>(CMSG_DATA(cmsg)) = RecordTypeAlert;
+
+  return Api::OsSysCallsSingleton::get().sendmsg(fd, &hdr, 0);
+}
+
+#else
+
+OffloadResult offload(SSL*, os_fd_t) { return OffloadResult::Skipped; }
+
+Api::SysCallSizeResult readv(os_fd_t, Buffer::RawSlice*, uint64_t, RecordType&) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+Api::SysCallSizeResult sendCloseNotify(os_fd_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
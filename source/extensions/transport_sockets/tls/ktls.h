@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+enum class OffloadResult {
+  // The record layer now lives in the kernel; the socket must only be used with plain reads and
+  // writes from here on.
+  Offloaded,
+  // The connection can't be offloaded and is unchanged; BoringSSL keeps handling records.
+  Skipped,
+  // Offloading failed half-way and the connection is no longer usable.
+  Failed,
+};
+
+/**
+ * Hands the symmetric keys and sequence numbers of an established connection to the kernel
+ * (TCP_ULP "tls" with TLS_TX and TLS_RX). Only TLSv1.2 connections using AES-GCM, with no
+ * handshake still in progress and no records buffered by BoringSSL, are offloaded.
+ * @param ssl supplies the connection whose handshake has completed.
+ * @param fd supplies the connection's socket.
+ * @return OffloadResult the outcome of the attempt.
+ */
+OffloadResult offload(SSL* ssl, os_fd_t fd);
+
+enum class RecordType { ApplicationData, CloseNotify, Other };
+
+/**
+ * Reads decrypted data from an offloaded socket. The kernel returns at most one non-data record
+ * per call, in which case its type is reported and the slices shouldn't be committed.
+ * @param fd supplies the offloaded socket.
+ * @param slices supplies the slices to read into.
+ * @param num_slices supplies the number of slices.
+ * @param record_type receives the type of the record that was read.
+ * @return the result of recvmsg().
+ */
+Api::SysCallSizeResult readv(os_fd_t fd, Buffer::RawSlice* slices, uint64_t num_slices,
+                             RecordType& record_type);
+
+/**
+ * Sends a close_notify alert on an offloaded socket.
+ * @param fd supplies the offloaded socket.
+ * @return the result of sendmsg().
+ */
+Api::SysCallSizeResult sendCloseNotify(os_fd_t fd);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
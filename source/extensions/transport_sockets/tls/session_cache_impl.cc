@@ -0,0 +1,90 @@
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ServerSessionCache::ServerSessionCache(size_t max_size)
+    : max_size_per_shard_(max_size / std::min(MaxShards, max_size)) {
+  ASSERT(max_size > 0);
+  const size_t num_shards = std::min(MaxShards, max_size);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; i++) {
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+}
+
+absl::string_view ServerSessionCache::sessionId(const SSL_SESSION* session) {
+  unsigned int id_len = 0;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_len);
+  return {reinterpret_cast<const char*>(id), id_len};
+}
+
+ServerSessionCache::Shard& ServerSessionCache::shardFor(absl::string_view id) {
+  return *shards_[absl::Hash<absl::string_view>()(id) % shards_.size()];
+}
+
+size_t ServerSessionCache::insert(bssl::UniquePtr<SSL_SESSION> session) {
+  std::string id(sessionId(session.get()));
+  Shard& shard = shardFor(id);
+  size_t evicted = 0;
+
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.index_.find(id);
+  if (it != shard.index_.end()) {
+    shard.lru_.erase(it->second);
+    shard.index_.erase(it);
+  }
+  while (shard.lru_.size() >= max_size_per_shard_) {
+    shard.index_.erase(shard.lru_.back().first);
+    shard.lru_.pop_back();
+    evicted++;
+  }
+  shard.lru_.emplace_front(std::move(id), std::move(session));
+  shard.index_.emplace(shard.lru_.front().first, shard.lru_.begin());
+  return evicted;
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerSessionCache::lookup(absl::string_view id, uint64_t now) {
+  Shard& shard = shardFor(id);
+
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.index_.find(id);
+  if (it == shard.index_.end()) {
+    return nullptr;
+  }
+  SSL_SESSION* session = it->second->second.get();
+  // BoringSSL doesn't tell an external cache about the sessions it finds expired, so expired
+  // sessions are dropped here rather than being left for LRU eviction.
+  const uint64_t created = SSL_SESSION_get_time(session);
+  if (now >= created && now - created >= SSL_SESSION_get_timeout(session)) {
+    auto entry = it->second;
+    shard.index_.erase(it);
+    shard.lru_.erase(entry);
+    return nullptr;
+  }
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+  SSL_SESSION_up_ref(session);
+  return bssl::UniquePtr<SSL_SESSION>(session);
+}
+
+size_t ServerSessionCache::size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex_);
+    size += shard->lru_.size();
+  }
+  return size;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Bounded cache of server-side TLS sessions used for stateful (session ID based) resumption.
+ * The cache is split into independently locked shards, each of which evicts its least recently
+ * used session once full, so that handshakes running concurrently on different workers rarely
+ * contend on the same lock.
+ */
+class ServerSessionCache {
+public:
+  /**
+   * @param max_size the maximum number of sessions held across all shards. Must be non-zero.
+   */
+  explicit ServerSessionCache(size_t max_size);
+
+  /**
+   * Adds a session to the cache, replacing any session with the same ID.
+   * @param session supplies the session. The cache takes ownership of the passed reference.
+   * @return the number of sessions evicted to make room for the new one.
+   */
+  size_t insert(bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * Looks up a session by ID and marks it as recently used. A session that has outlived its
+   * timeout is removed instead.
+   * @param id supplies the session ID.
+   * @param now supplies the current time, in seconds since the epoch.
+   * @return a new reference to the session, or nullptr if it isn't cached or has expired.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view id, uint64_t now);
+
+  /**
+   * @return the number of sessions currently cached.
+   */
+  size_t size() const;
+
+  /**
+   * @return the ID of a session as a string_view that is valid for the lifetime of the session.
+   */
+  static absl::string_view sessionId(const SSL_SESSION* session);
+
+private:
+  static constexpr size_t MaxShards = 16;
+
+  struct Shard {
+    using Entry = std::pair<std::string, bssl::UniquePtr<SSL_SESSION>>;
+
+    mutable absl::Mutex mutex_;
+    // Most recently used sessions are at the front.
+    std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator>
+        index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shardFor(absl::string_view id);
+
+  const size_t max_size_per_shard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+using ServerSessionCachePtr = std::unique_ptr<ServerSessionCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
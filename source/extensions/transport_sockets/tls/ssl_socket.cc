@@ -7,6 +7,7 @@
 #include "common/common/hex.h"
 #include "common/http/headers.h"
 
+#include "extensions/transport_sockets/tls/ktls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -67,6 +68,10 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
     provider->registerPrivateKeyMethod(rawSsl(), *this, callbacks_->connection().dispatcher());
   }
 
+  if (callbacks_->connection().remoteAddress() != nullptr) {
+    ctx_->setRemoteAddress(rawSsl(), *callbacks_->connection().remoteAddress());
+  }
+
   BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
   SSL_set_bio(rawSsl(), bio, bio);
 }
@@ -105,16 +110,20 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_) {
+    return doKernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
   while (keep_reading) {
     // We use 2 slices here so that we can use the remainder of an existing buffer chain element
-    // if there is extra space. 16K read is arbitrary and can be tuned later.
+    // if there is extra space.
     Buffer::RawSlice slices[2];
     uint64_t slices_to_commit = 0;
-    uint64_t num_slices = read_buffer.reserve(16384, slices, 2);
+    uint64_t num_slices = read_buffer.reserve(callbacks_->readSize(), slices, 2);
     for (uint64_t i = 0; i < num_slices; i++) {
       auto result = sslReadIntoSlice(slices[i]);
       if (result.commit_slice_) {
@@ -156,6 +165,56 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  while (true) {
+    Buffer::RawSlice slices[2];
+    const uint64_t num_slices = read_buffer.reserve(callbacks_->readSize(), slices, 2);
+    KernelTls::RecordType record_type;
+    const Api::SysCallSizeResult result =
+        KernelTls::readv(callbacks_->ioHandle().fd(), slices, num_slices, record_type);
+    ENVOY_CONN_LOG(trace, "ktls read returns: {}", callbacks_->connection(), result.rc_);
+    if (result.rc_ < 0) {
+      if (result.errno_ != SOCKET_ERROR_AGAIN) {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (record_type == KernelTls::RecordType::CloseNotify) {
+      end_stream = true;
+      break;
+    }
+    if (result.rc_ == 0 || record_type != KernelTls::RecordType::ApplicationData) {
+      // Same as BoringSSL: a truncated stream, a fatal alert or a renegotiation attempt ends the
+      // connection.
+      ENVOY_CONN_LOG(debug, "ktls read: unexpected {}", callbacks_->connection(),
+                     result.rc_ == 0 ? "end of stream" : "record");
+      action = PostIoAction::Close;
+      break;
+    }
+
+    uint64_t remaining = result.rc_;
+    uint64_t slices_to_commit = 0;
+    while (remaining > 0) {
+      slices[slices_to_commit].len_ = std::min<uint64_t>(slices[slices_to_commit].len_, remaining);
+      remaining -= slices[slices_to_commit].len_;
+      slices_to_commit++;
+    }
+    read_buffer.commit(slices, slices_to_commit);
+    bytes_read += result.rc_;
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setReadBufferReady();
+      break;
+    }
+  }
+
+  ENVOY_CONN_LOG(trace, "ktls read {} bytes", callbacks_->connection(), bytes_read);
+
+  return {action, bytes_read, end_stream};
+}
+
 void SslSocket::onPrivateKeyMethodComplete() {
   ASSERT(isThreadSafe());
   ASSERT(state_ == SocketState::HandshakeInProgress);
@@ -175,6 +234,9 @@ PostIoAction SslSocket::doHandshake() {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     state_ = SocketState::HandshakeComplete;
     ctx_->logHandshake(rawSsl());
+    if (ctx_->kernelTlsOffload() && !offloadToKernel()) {
+      return PostIoAction::Close;
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -201,6 +263,28 @@ PostIoAction SslSocket::doHandshake() {
   }
 }
 
+bool SslSocket::offloadToKernel() {
+  switch (KernelTls::offload(rawSsl(), callbacks_->ioHandle().fd())) {
+  case KernelTls::OffloadResult::Offloaded:
+    ENVOY_CONN_LOG(debug, "TLS record layer offloaded to the kernel", callbacks_->connection());
+    ctx_->stats().ktls_offloaded_.inc();
+    kernel_tls_ = true;
+    return true;
+  case KernelTls::OffloadResult::Skipped:
+    ENVOY_CONN_LOG(debug, "TLS record layer not offloaded to the kernel", callbacks_->connection());
+    ctx_->stats().ktls_offload_skipped_.inc();
+    return true;
+  case KernelTls::OffloadResult::Failed:
+    // The transmit keys are already in the kernel but the receive keys aren't, so neither side
+    // can be used anymore.
+    failure_reason_ = "TLS error: kernel TLS offload failed";
+    ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason_);
+    ctx_->stats().connection_error_.inc();
+    return false;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -237,6 +321,10 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
@@ -285,6 +373,29 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel frames and encrypts whatever is written to the socket, so this is the same as a
+  // plain socket write.
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = write_buffer.write(callbacks_->ioHandle());
+    ENVOY_CONN_LOG(trace, "ktls write returns: {}", callbacks_->connection(), result.rc_);
+    if (!result.ok()) {
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    total_bytes_written += result.rc_;
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(state_ == SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -293,9 +404,17 @@ void SslSocket::shutdownSsl() {
   ASSERT(state_ != SocketState::PreHandshake);
   if (state_ != SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(rawSsl());
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (kernel_tls_) {
+      // BoringSSL's write sequence number is stale once the kernel owns the record layer, so the
+      // close_notify alert has to be sent through the kernel too.
+      const Api::SysCallSizeResult result =
+          KernelTls::sendCloseNotify(callbacks_->ioHandle().fd());
+      ENVOY_CONN_LOG(debug, "ktls shutdown: rc={}", callbacks_->connection(), result.rc_);
+    } else {
+      int rc = SSL_shutdown(rawSsl());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     state_ = SocketState::ShutdownSent;
   }
 }
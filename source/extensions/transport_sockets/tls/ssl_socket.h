@@ -132,6 +132,9 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  bool offloadToKernel();
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   void drainErrorQueue();
   void shutdownSsl();
   bool isThreadSafe() const {
@@ -144,6 +147,9 @@ private:
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
   SocketState state_;
+  // True once the record layer has been handed to kernel TLS. From then on the socket is read
+  // and written directly and BoringSSL is only kept around for connection info.
+  bool kernel_tls_{};
 
   SslSocketInfoConstSharedPtr info_;
 };
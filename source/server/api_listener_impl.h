@@ -123,11 +123,18 @@ protected:
       void write(Buffer::Instance&, bool) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
       void setBufferLimits(uint32_t) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
       uint32_t bufferLimit() const override { return 65000; }
+      void setBufferMemoryAccount(const Buffer::BufferMemoryAccountSharedPtr&) override {}
+      const Buffer::BufferMemoryAccountSharedPtr& bufferMemoryAccount() const override {
+        return buffer_memory_account_;
+      }
+      uint64_t shrinkBuffers() override { return 0; }
+      uint64_t bufferedBytes() const override { return 0; }
       bool localAddressRestored() const override { return false; }
       bool aboveHighWatermark() const override { return false; }
       const Network::ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
         return options_;
       }
+      const Network::IoHandle& ioHandle() const override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
       StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
       const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
       void setDelayedCloseTimeout(std::chrono::milliseconds) override {}
@@ -136,6 +143,7 @@ protected:
       SyntheticReadCallbacks& parent_;
       StreamInfo::StreamInfoImpl stream_info_;
       Network::ConnectionSocket::OptionsSharedPtr options_;
+      const Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
       std::list<Network::ConnectionCallbacks*> callbacks_;
     };
 
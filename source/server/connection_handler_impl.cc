@@ -1,5 +1,8 @@
 #include "server/connection_handler_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/exception.h"
@@ -7,6 +10,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/timespan.h"
 
+#include "common/buffer/memory_account_impl.h"
 #include "common/event/deferred_task.h"
 #include "common/network/connection_impl.h"
 #include "common/network/utility.h"
@@ -107,6 +111,43 @@ void ConnectionHandlerImpl::enableListeners() {
   }
 }
 
+void ConnectionHandlerImpl::reclaimConnectionMemory(uint32_t max_close, uint64_t min_close_bytes) {
+  std::vector<std::pair<uint64_t, ActiveTcpConnection*>> candidates;
+  for (auto& listener : listeners_) {
+    if (!listener.second.tcp_listener_.has_value()) {
+      continue;
+    }
+    ActiveTcpListener& tcp_listener = listener.second.tcp_listener_->get();
+    for (auto& filter_chain_connections : tcp_listener.connections_by_context_) {
+      for (auto& active_connection : filter_chain_connections.second->connections_) {
+        Network::Connection& connection = *active_connection->connection_;
+        const uint64_t released = connection.shrinkBuffers();
+        if (released > 0) {
+          tcp_listener.stats_.downstream_cx_buffer_bytes_released_.add(released);
+        }
+        const Buffer::BufferMemoryAccountSharedPtr& account = connection.bufferMemoryAccount();
+        if (account != nullptr && account->balance() > 0 &&
+            account->balance() >= min_close_bytes) {
+          candidates.emplace_back(account->balance(), active_connection.get());
+        }
+      }
+    }
+  }
+
+  // Closing only defers the deletion of the connections, so the candidates stay valid.
+  const size_t num_close = std::min<size_t>(max_close, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + num_close, candidates.end(),
+                    [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  for (size_t i = 0; i < num_close; i++) {
+    ActiveTcpConnection& active_connection = *candidates[i].second;
+    ENVOY_CONN_LOG(debug, "closing connection holding {} buffered bytes to reclaim memory",
+                   *active_connection.connection_, candidates[i].first);
+    ListenerStats& stats = active_connection.active_connections_.listener_.stats_;
+    stats.downstream_cx_overload_memory_close_.inc();
+    active_connection.connection_->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
 void ConnectionHandlerImpl::ActiveTcpListener::removeConnection(ActiveTcpConnection& connection) {
   ENVOY_CONN_LOG(debug, "adding to cleanup list", *connection.connection_);
   ActiveConnections& active_connections = connection.active_connections_;
@@ -149,7 +190,9 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
                                                             Network::ListenerConfig& config)
     : ConnectionHandlerImpl::ActiveListenerImplBase(parent, &config), parent_(parent),
       listener_(std::move(listener)), listener_filters_timeout_(config.listenerFiltersTimeout()),
-      continue_on_listener_filters_timeout_(config.continueOnListenerFiltersTimeout()) {
+      continue_on_listener_filters_timeout_(config.continueOnListenerFiltersTimeout()),
+      memory_account_(std::make_shared<Buffer::GaugeBufferMemoryAccount>(
+          stats_.downstream_cx_buffered_bytes_)) {
   config.connectionBalancer().registerHandler(*this);
 }
 
@@ -405,6 +448,9 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
   auto& active_connections = getOrCreateActiveConnections(*filter_chain);
   auto server_conn_ptr = parent_.dispatcher_.createServerConnection(
       std::move(socket), std::move(transport_socket), *stream_info);
+  // Before the filter chain is created, so that codecs and filters charge the connection's account.
+  server_conn_ptr->setBufferMemoryAccount(
+      std::make_shared<Buffer::BufferMemoryAccountImpl>(memory_account_));
   ActiveTcpConnectionPtr active_connection(
       new ActiveTcpConnection(active_connections, std::move(server_conn_ptr),
                               parent_.dispatcher_.timeSource(), std::move(stream_info)));
@@ -27,14 +27,18 @@ namespace Envoy {
 namespace Server {
 
 #define ALL_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                              \
+  COUNTER(downstream_cx_buffer_bytes_released)                                                     \
   COUNTER(downstream_cx_destroy)                                                                   \
   COUNTER(downstream_cx_overflow)                                                                  \
+  COUNTER(downstream_cx_overload_memory_close)                                                     \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_global_cx_overflow)                                                           \
   COUNTER(downstream_pre_cx_timeout)                                                               \
   COUNTER(no_filter_chain_match)                                                                   \
   GAUGE(downstream_cx_active, Accumulate)                                                          \
+  GAUGE(downstream_cx_buffered_bytes, Accumulate)                                                  \
   GAUGE(downstream_pre_cx_active, Accumulate)                                                      \
+  HISTOGRAM(downstream_cx_accept_batch_size, Unspecified)                                          \
   HISTOGRAM(downstream_cx_length_ms, Milliseconds)
 
 /**
@@ -79,6 +83,7 @@ public:
   void stopListeners() override;
   void disableListeners() override;
   void enableListeners() override;
+  void reclaimConnectionMemory(uint32_t max_close, uint64_t min_close_bytes) override;
   const std::string& statPrefix() const override { return per_handler_stat_prefix_; }
 
   /**
@@ -131,6 +136,9 @@ private:
     // Network::ListenerCallbacks
     void onAccept(Network::ConnectionSocketPtr&& socket) override;
     void onReject() override { stats_.downstream_global_cx_overflow_.inc(); }
+    void onAcceptBatch(uint32_t accepted) override {
+      stats_.downstream_cx_accept_batch_size_.recordValue(accepted);
+    }
 
     // ActiveListenerImplBase
     Network::Listener* listener() override { return listener_.get(); }
@@ -144,6 +152,7 @@ private:
       ++num_listener_connections_;
       config_->openConnections().inc();
     }
+    double loopUtilization() const override { return parent_.dispatcher_.loopUtilization(); }
     void post(Network::ConnectionSocketPtr&& socket) override;
 
     /**
@@ -182,6 +191,9 @@ private:
     const bool continue_on_listener_filters_timeout_;
     std::list<ActiveTcpSocketPtr> sockets_;
     std::unordered_map<const Network::FilterChain*, ActiveConnectionsPtr> connections_by_context_;
+    // Parent of the accounts of the listener's connections, which reports to the
+    // downstream_cx_buffered_bytes gauge.
+    const Buffer::BufferMemoryAccountSharedPtr memory_account_;
 
     // The number of connections currently active on this listener. This is typically used for
     // connection balancing across per-handler listeners.
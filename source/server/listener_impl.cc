@@ -1,5 +1,10 @@
 #include "server/listener_impl.h"
 
+#if defined(__linux__)
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+#include "envoy/api/os_sys_calls.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/listener/v3/listener.pb.h"
 #include "envoy/config/listener/v3/listener_components.pb.h"
@@ -11,9 +16,12 @@
 #include "envoy/stats/scope.h"
 
 #include "common/access_log/access_log_impl.h"
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/network/connection_balancer_impl.h"
+#include "common/network/listener_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
@@ -58,9 +66,12 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(ListenerComponentFactory& facto
                                                  Network::Socket::Type socket_type,
                                                  const Network::Socket::OptionsSharedPtr& options,
                                                  bool bind_to_port,
-                                                 const std::string& listener_name, bool reuse_port)
+                                                 const std::string& listener_name, bool reuse_port,
+                                                 bool steer_by_incoming_cpu)
     : factory_(factory), local_address_(address), socket_type_(socket_type), options_(options),
-      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port) {
+      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port),
+      steer_by_incoming_cpu_(steer_by_incoming_cpu),
+      steering_group_(steer_by_incoming_cpu ? std::make_shared<SteeringGroup>() : nullptr) {
 
   bool create_socket = false;
   if (local_address_->type() == Network::Address::Type::Ip) {
@@ -114,7 +125,7 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::createListenSocketAndApplyOpti
     }
 
     // Add the options to the socket_ so that STATE_LISTENING options can be
-    // set in the worker after listen()/evconnlistener_new() is called.
+    // set in the worker after listen() is called and the listener is set up.
     socket->addOptions(options_);
   }
   return socket;
@@ -139,12 +150,123 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
     }
   });
 
-  if (socket) {
-    return socket;
+  if (!socket) {
+    socket = createListenSocketAndApplyOptions();
+  }
+  if (steer_by_incoming_cpu_ && socket != nullptr && bind_to_port_) {
+    return steerByIncomingCpu(std::move(socket));
   }
+  return socket;
+}
 
-  return createListenSocketAndApplyOptions();
+Network::SocketSharedPtr
+ListenSocketFactoryImpl::steerByIncomingCpu(Network::SocketSharedPtr&& socket) {
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  // Workers ask for their socket from their own thread.
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  absl::optional<uint32_t> cpu;
+  const Api::SysCallIntResult affinity_result =
+      Api::LinuxOsSysCallsSingleton::get().sched_getaffinity(0, sizeof(cpus), &cpus);
+  if (affinity_result.rc_ == 0 && CPU_COUNT(&cpus) == 1) {
+    for (uint32_t i = 0; i < CPU_SETSIZE; i++) {
+      if (CPU_ISSET(i, &cpus)) {
+        cpu = i;
+        break;
+      }
+    }
+  }
+
+  // The kernel gives the sockets of a SO_REUSEPORT group their index in the order they start
+  // listening, so listen while recording the socket rather than when the worker sets up its
+  // listener, which then only updates the backlog.
+  Network::Socket* raw_socket = socket.get();
+  absl::MutexLock lock(&steering_group_->lock_);
+  const Api::SysCallIntResult listen_result =
+      raw_socket->ioHandle().listen(Network::ListenerImpl::ListenBacklog);
+  if (listen_result.rc_ != 0) {
+    throw Network::CreateListenerException(
+        fmt::format("{}: cannot listen() on {}: {}", listener_name_, local_address_->asString(),
+                    errorDetails(listen_result.errno_)));
+  }
+  steering_group_->sockets_.emplace_back(raw_socket, cpu);
+  attachSteeringFilter(*steering_group_, listener_name_);
+
+  // Closing a socket moves the last socket of the group to its index. Do the same to the record
+  // once the socket is released, closing it under the lock so that both change together.
+  return Network::SocketSharedPtr(
+      raw_socket, [group = steering_group_, socket = std::move(socket),
+                   listener_name = listener_name_](Network::Socket*) mutable {
+        absl::MutexLock lock(&group->lock_);
+        auto& sockets = group->sockets_;
+        auto it = std::find_if(sockets.begin(), sockets.end(),
+                               [&socket](const std::pair<const Network::Socket*,
+                                                         absl::optional<uint32_t>>& entry) {
+                                 return entry.first == socket.get();
+                               });
+        ASSERT(it != sockets.end());
+        *it = sockets.back();
+        sockets.pop_back();
+        if (socket->isOpen()) {
+          socket->close();
+        }
+        socket.reset();
+        if (!sockets.empty()) {
+          attachSteeringFilter(*group, listener_name);
+        }
+      });
+#else
+  ENVOY_LOG(warn, "{}: incoming CPU steering is not supported on this platform", listener_name_);
+  return std::move(socket);
+#endif
+}
+
+void ListenSocketFactoryImpl::attachSteeringFilter(SteeringGroup& group,
+                                                   const std::string& listener_name) {
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  std::vector<absl::optional<uint32_t>> socket_cpus;
+  socket_cpus.reserve(group.sockets_.size());
+  for (const auto& socket : group.sockets_) {
+    socket_cpus.push_back(socket.second);
+  }
+
+  // The program applies to the whole group, whichever socket it's attached to.
+  std::vector<sock_filter> filter = buildIncomingCpuSteeringFilter(socket_cpus);
+  sock_fprog prog;
+  prog.len = filter.size();
+  prog.filter = filter.data();
+  const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().setsockopt(
+      group.sockets_.back().first->ioHandle().fd(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+      sizeof(prog));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "{}: cannot attach the incoming CPU steering program: {}", listener_name,
+              errorDetails(result.errno_));
+  }
+#else
+  UNREFERENCED_PARAMETER(group);
+  UNREFERENCED_PARAMETER(listener_name);
+#endif
+}
+
+#if defined(__linux__)
+std::vector<sock_filter> ListenSocketFactoryImpl::buildIncomingCpuSteeringFilter(
+    const std::vector<absl::optional<uint32_t>>& socket_cpus) {
+  std::vector<sock_filter> filter;
+  filter.push_back(
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+  for (uint32_t index = 0; index < socket_cpus.size(); index++) {
+    // Leave room for the two instructions that end the program.
+    if (socket_cpus[index].has_value() && filter.size() + 4 <= BPF_MAXINSNS) {
+      filter.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, *socket_cpus[index], 0, 1));
+      filter.push_back(BPF_STMT(BPF_RET | BPF_K, index));
+    }
+  }
+  // CPUs no worker is pinned to have their connections spread by CPU number.
+  filter.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(socket_cpus.size())));
+  filter.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+  return filter;
 }
+#endif
 
 ListenerFactoryContextBaseImpl::ListenerFactoryContextBaseImpl(
     Envoy::Server::Instance& server, ProtobufMessage::ValidationVisitor& validation_visitor,
@@ -380,6 +502,13 @@ void ListenerImpl::buildListenSocketOptions(Network::Socket::Type socket_type) {
   if (config_.reuse_port()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
   }
+  if (config_.reuse_port_steering() != envoy::config::listener::v3::Listener::HASH &&
+      (!config_.reuse_port() || socket_type != Network::Socket::Type::Stream)) {
+    throw EnvoyException(
+        fmt::format("error adding listener '{}': reuse_port_steering requires reuse_port on a "
+                    "TCP listener",
+                    address_->asString()));
+  }
   if (!config_.socket_options().empty()) {
     addListenSocketOptions(
         Network::SocketOptionFactory::buildLiteralOptions(config_.socket_options()));
@@ -452,9 +581,17 @@ void ListenerImpl::buildFilterChains() {
 void ListenerImpl::buildSocketOptions() {
   // TCP specific setup.
   if (config_.has_connection_balance_config()) {
-    // Currently exact balance is the only supported type and there are no options.
-    ASSERT(config_.connection_balance_config().has_exact_balance());
-    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+    switch (config_.connection_balance_config().balance_type_case()) {
+    case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kExactBalance:
+      connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+      break;
+    case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kLoadAwareBalance:
+      connection_balancer_ =
+          std::make_unique<Network::LoadAwareConnectionBalancerImpl>(parent_.server_.random());
+      break;
+    default:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
   } else {
     connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
   }
@@ -1,6 +1,11 @@
 #pragma once
 
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
 #include <memory>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -21,6 +26,8 @@
 #include "server/filter_chain_manager_impl.h"
 
 #include "absl/base/call_once.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Server {
@@ -43,7 +50,8 @@ public:
                           Network::Address::InstanceConstSharedPtr address,
                           Network::Socket::Type socket_type,
                           const Network::Socket::OptionsSharedPtr& options, bool bind_to_port,
-                          const std::string& listener_name, bool reuse_port);
+                          const std::string& listener_name, bool reuse_port,
+                          bool steer_by_incoming_cpu);
 
   // Network::ListenSocketFactory
   Network::Socket::Type socketType() const override { return socket_type_; }
@@ -66,10 +74,35 @@ public:
     return absl::nullopt;
   }
 
+#if defined(__linux__)
+  /**
+   * @return the classic BPF program that steers connections to the socket of the worker pinned to
+   *         the CPU that received them, given the CPU each socket's worker is pinned to, if any,
+   *         at the socket's index in the SO_REUSEPORT group.
+   */
+  static std::vector<sock_filter>
+  buildIncomingCpuSteeringFilter(const std::vector<absl::optional<uint32_t>>& socket_cpus);
+#endif
+
 protected:
   Network::SocketSharedPtr createListenSocketAndApplyOptions();
 
 private:
+  // The sockets handed out by a factory that steers by incoming CPU, which outlives the factory as
+  // long as any of them does.
+  struct SteeringGroup {
+    absl::Mutex lock_;
+    // Each live socket, with the CPU its worker is pinned to if any, at the index the kernel gives
+    // it in the SO_REUSEPORT group.
+    std::vector<std::pair<const Network::Socket*, absl::optional<uint32_t>>>
+        sockets_ ABSL_GUARDED_BY(lock_);
+  };
+  using SteeringGroupSharedPtr = std::shared_ptr<SteeringGroup>;
+
+  Network::SocketSharedPtr steerByIncomingCpu(Network::SocketSharedPtr&& socket);
+  static void attachSteeringFilter(SteeringGroup& group, const std::string& listener_name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(group.lock_);
+
   ListenerComponentFactory& factory_;
   // Initially, its port number might be 0. Once a socket is created, its port
   // will be set to the binding port.
@@ -79,8 +112,10 @@ private:
   bool bind_to_port_;
   const std::string& listener_name_;
   const bool reuse_port_;
+  const bool steer_by_incoming_cpu_;
   Network::SocketSharedPtr socket_;
   absl::once_flag steal_once_;
+  const SteeringGroupSharedPtr steering_group_;
 };
 
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
@@ -261,7 +261,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
       enable_dispatcher_stats_(enable_dispatcher_stats) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
     workers_.emplace_back(
-        worker_factory.createWorker(server.overloadManager(), absl::StrCat("worker_", i)));
+        worker_factory.createWorker(i, server.overloadManager(), absl::StrCat("worker_", i)));
   }
 }
 
@@ -992,7 +992,9 @@ Network::ListenSocketFactorySharedPtr ListenerManagerImpl::createListenSocketFac
   Network::Socket::Type socket_type = Network::Utility::protobufAddressSocketType(proto_address);
   return std::make_shared<ListenSocketFactoryImpl>(
       factory_, listener.address(), socket_type, listener.listenSocketOptions(),
-      listener.bindToPort(), listener.name(), reuse_port);
+      listener.bindToPort(), listener.name(), reuse_port,
+      listener.config().reuse_port_steering() ==
+          envoy::config::listener::v3::Listener::INCOMING_CPU);
 }
 
 ApiListenerOptRef ListenerManagerImpl::apiListener() {
@@ -7,6 +7,7 @@
 
 #include "envoy/admin/v3/server_info.pb.h"
 
+#include "common/common/cpu_affinity.h"
 #include "common/common/fmt.h"
 #include "common/common/logger.h"
 #include "common/common/macros.h"
@@ -148,6 +149,17 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::ValueArg<std::string> worker_cpu_affinity(
+      "", "worker-cpu-affinity",
+      "CPUs to pin the worker threads to, one per worker in turn, e.g. '0-3,8'", false, "",
+      "string", cmd);
+  TCLAP::ValueArg<std::string> main_thread_cpu_affinity(
+      "", "main-thread-cpu-affinity",
+      "CPUs to pin the main thread and the access log flush threads to, e.g. '4'", false, "",
+      "string", cmd);
+  TCLAP::SwitchArg numa_local_memory(
+      "", "numa-local-memory", "Make pinned threads prefer memory of the NUMA node of their CPUs",
+      cmd, false);
 
   TCLAP::ValueArg<bool> use_fake_symbol_table("", "use-fake-symbol-table",
                                               "Use fake symbol table implementation", false, false,
@@ -179,6 +191,18 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   mutex_tracing_enabled_ = enable_mutex_tracing.getValue();
   fake_symbol_table_enabled_ = use_fake_symbol_table.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  numa_local_memory_ = numa_local_memory.getValue();
+
+  if (worker_cpu_affinity.isSet() &&
+      !CpuAffinity::parseCpuList(worker_cpu_affinity.getValue(), worker_cpu_affinity_)) {
+    throw MalformedArgvException(
+        fmt::format("error: invalid CPU list '{}'", worker_cpu_affinity.getValue()));
+  }
+  if (main_thread_cpu_affinity.isSet() &&
+      !CpuAffinity::parseCpuList(main_thread_cpu_affinity.getValue(), main_thread_cpu_affinity_)) {
+    throw MalformedArgvException(
+        fmt::format("error: invalid CPU list '{}'", main_thread_cpu_affinity.getValue()));
+  }
 
   if (log_level.isSet()) {
     log_level_ = parseAndValidateLogLevel(log_level.getValue());
@@ -384,6 +408,13 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  for (const uint32_t cpu : workerCpuAffinity()) {
+    command_line_options->add_worker_cpu_affinity(cpu);
+  }
+  for (const uint32_t cpu : mainThreadCpuAffinity()) {
+    command_line_options->add_main_thread_cpu_affinity(cpu);
+  }
+  command_line_options->set_numa_local_memory(numaLocalMemory());
   command_line_options->set_restart_epoch(restartEpoch());
   for (const auto& e : disabledExtensions()) {
     command_line_options->add_disabled_extensions(e);
@@ -90,6 +90,11 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setWorkerCpuAffinity(const std::vector<uint32_t>& cpus) { worker_cpu_affinity_ = cpus; }
+  void setMainThreadCpuAffinity(const std::vector<uint32_t>& cpus) {
+    main_thread_cpu_affinity_ = cpus;
+  }
+  void setNumaLocalMemory(bool numa_local_memory) { numa_local_memory_ = numa_local_memory; }
   void setAllowUnkownFields(bool allow_unknown_static_fields) {
     allow_unknown_static_fields_ = allow_unknown_static_fields;
   }
@@ -149,6 +154,11 @@ public:
   Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  const std::vector<uint32_t>& workerCpuAffinity() const override { return worker_cpu_affinity_; }
+  const std::vector<uint32_t>& mainThreadCpuAffinity() const override {
+    return main_thread_cpu_affinity_;
+  }
+  bool numaLocalMemory() const override { return numa_local_memory_; }
   const std::vector<std::string>& disabledExtensions() const override {
     return disabled_extensions_;
   }
@@ -198,6 +208,9 @@ private:
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
+  std::vector<uint32_t> worker_cpu_affinity_;
+  std::vector<uint32_t> main_thread_cpu_affinity_;
+  bool numa_local_memory_{false};
   bool fake_symbol_table_enabled_;
   std::vector<std::string> disabled_extensions_;
   uint32_t count_;
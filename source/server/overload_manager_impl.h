@@ -16,6 +16,7 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
+#include "common/http/stream_memory_tracker_impl.h"
 
 namespace Envoy {
 namespace Server {
@@ -62,6 +63,7 @@ public:
   bool registerForAction(const std::string& action, Event::Dispatcher& dispatcher,
                          OverloadActionCb callback) override;
   ThreadLocalOverloadState& getThreadLocalOverloadState() override;
+  Http::StreamMemoryTracker& getThreadLocalStreamMemoryTracker() override;
 
   // Stop the overload manager timer and wait for any pending resource updates to complete.
   // After this returns, overload manager clients should not receive any more callbacks
@@ -90,6 +92,11 @@ private:
     Stats::Counter& skipped_updates_counter_;
   };
 
+  // The thread-local state, along with the thread's stream memory tracker.
+  struct ThreadLocalOverloadStateImpl : public ThreadLocalOverloadState {
+    Http::StreamMemoryTrackerImpl stream_memory_tracker_;
+  };
+
   struct ActionCallback {
     ActionCallback(Event::Dispatcher& dispatcher, OverloadActionCb callback)
         : dispatcher_(dispatcher), callback_(callback) {}
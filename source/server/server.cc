@@ -24,8 +24,10 @@
 
 #include "common/api/api_impl.h"
 #include "common/api/os_sys_calls_impl.h"
+#include "common/common/cpu_affinity.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/mutex_tracer_impl.h"
+#include "common/common/sharded_counter.h"
 #include "common/common/utility.h"
 #include "common/common/version.h"
 #include "common/config/utility.h"
@@ -73,7 +75,7 @@ InstanceImpl::InstanceImpl(
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(new ConnectionHandlerImpl(*dispatcher_)),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
-      worker_factory_(thread_local_, *api_, hooks),
+      worker_factory_(thread_local_, *api_, hooks, options),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
       terminated_(false),
@@ -82,6 +84,19 @@ InstanceImpl::InstanceImpl(
       grpc_context_(store.symbolTable()), http_context_(store.symbolTable()),
       process_context_(std::move(process_context)), main_thread_id_(std::this_thread::get_id()),
       server_contexts_(*this) {
+  // Threads started from here on inherit the placement of the main thread, among them the access
+  // log flush threads. Workers replace it with their own, and those that aren't pinned with where
+  // the process may run, so capture that first.
+  if (!options.mainThreadCpuAffinity().empty()) {
+    process_affinity_ = CpuAffinity(CpuAffinity::currentThreadCpus(), options.numaLocalMemory());
+    if (process_affinity_.cpus().empty()) {
+      ENVOY_LOG(warn, "cannot get the CPUs of the process, not pinning the main thread");
+    } else {
+      worker_factory_.setUnpinnedAffinity(process_affinity_);
+      CpuAffinity(options.mainThreadCpuAffinity(), options.numaLocalMemory())
+          .applyToCurrentThread();
+    }
+  }
   try {
     if (!options.logPath().empty()) {
       try {
@@ -131,6 +146,9 @@ InstanceImpl::~InstanceImpl() {
   ENVOY_LOG(debug, "destroying listener manager");
   listener_manager_.reset();
   ENVOY_LOG(debug, "destroyed listener manager");
+
+  // So that another server started in this process, e.g. by a test, sees the same CPUs.
+  process_affinity_.applyToCurrentThread();
 }
 
 Upstream::ClusterManager& InstanceImpl::clusterManager() { return *config_.clusterManager(); }
@@ -336,6 +354,9 @@ void InstanceImpl::initialize(const Options& options,
   initialization_timer_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
       server_stats_->initialization_time_ms_, timeSource());
   server_stats_->concurrency_.set(options_.concurrency());
+  // Give the counters that workers update, such as the active requests of hosts, a shard per
+  // worker. This must happen before the cluster manager and listeners create them.
+  ShardedCounter::setDefaultShardCount(options_.concurrency());
   server_stats_->hot_restart_epoch_.set(options_.restartEpoch());
 
   assert_action_registration_ = Assert::setDebugAssertionFailureRecordAction(
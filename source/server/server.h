@@ -25,6 +25,7 @@
 #include "common/access_log/access_log_manager_impl.h"
 #include "common/common/assert.h"
 #include "common/common/cleanup.h"
+#include "common/common/cpu_affinity.h"
 #include "common/common/logger_delegates.h"
 #include "common/grpc/async_client_manager_impl.h"
 #include "common/grpc/context_impl.h"
@@ -331,6 +332,9 @@ private:
   std::unique_ptr<Ssl::ContextManager> ssl_context_manager_;
   ProdListenerComponentFactory listener_component_factory_;
   ProdWorkerFactory worker_factory_;
+  // Where the process may run, captured before the main thread is pinned, if it is. The main
+  // thread gets it back on destruction.
+  CpuAffinity process_affinity_;
   std::unique_ptr<ListenerManager> listener_manager_;
   absl::node_hash_map<Stage, LifecycleNotifierCallbacks> stage_callbacks_;
   absl::node_hash_map<Stage, LifecycleNotifierCompletionCallbacks> stage_completable_callbacks_;
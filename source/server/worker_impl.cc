@@ -1,5 +1,6 @@
 #include "server/worker_impl.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -9,29 +10,57 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/runtime/runtime_features.h"
+
 #include "server/connection_handler_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager,
+namespace {
+// How often connection memory is reclaimed while the overload action is active.
+constexpr std::chrono::milliseconds ReclaimConnectionMemoryInterval(1000);
+// How often the streams buffering the most data are reset while the overload action is active.
+constexpr std::chrono::milliseconds ResetHighMemoryStreamsInterval(1000);
+} // namespace
+
+ProdWorkerFactory::ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api,
+                                     ListenerHooks& hooks, const Options& options)
+    : tls_(tls), api_(api), hooks_(hooks), options_(options) {}
+
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager,
                                           const std::string& worker_name) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher(worker_name));
+  CpuAffinity cpu_affinity = unpinned_affinity_;
+  const std::vector<uint32_t>& cpus = options_.workerCpuAffinity();
+  if (!cpus.empty()) {
+    // Each worker gets a single CPU of the list, so that workers don't migrate between CPUs.
+    cpu_affinity = CpuAffinity({cpus[index % cpus.size()]}, options_.numaLocalMemory());
+  }
   return WorkerPtr{
       new WorkerImpl(tls_, hooks_, std::move(dispatcher),
                      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(*dispatcher)},
-                     overload_manager, api_)};
+                     overload_manager, api_, std::move(cpu_affinity))};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       CpuAffinity cpu_affinity)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      overload_manager_(overload_manager), api_(api), cpu_affinity_(std::move(cpu_affinity)) {
   tls_.registerThread(*dispatcher_, false);
-  overload_manager.registerForAction(
+  overload_manager_.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
       [this](OverloadActionState state) { stopAcceptingConnectionsCb(state); });
+  overload_manager_.registerForAction(
+      OverloadActionNames::get().ReclaimConnectionMemory, *dispatcher_,
+      [this](OverloadActionState state) { reclaimConnectionMemoryCb(state); });
+  overload_manager_.registerForAction(
+      OverloadActionNames::get().ResetHighMemoryStreams, *dispatcher_,
+      [this](OverloadActionState state) { resetHighMemoryStreamsCb(state); });
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -99,7 +128,24 @@ void WorkerImpl::start(GuardDog& guard_dog) {
       [this, &guard_dog]() -> void { threadRoutine(guard_dog); }, options);
 }
 
-void WorkerImpl::initializeStats(Stats::Scope& scope) { dispatcher_->initializeStats(scope); }
+void WorkerImpl::initializeStats(Stats::Scope& scope) {
+  dispatcher_->initializeStats(scope);
+  if (cpu_affinity_.cpus().size() != 1) {
+    return;
+  }
+  const uint32_t cpu = cpu_affinity_.cpus()[0];
+  scope
+      .gaugeFromString(absl::StrCat(dispatcher_->name(), ".cpu"),
+                       Stats::Gauge::ImportMode::NeverImport)
+      .set(cpu);
+  const absl::optional<uint32_t> numa_node = CpuAffinity::numaNode(cpu);
+  if (numa_node.has_value()) {
+    scope
+        .gaugeFromString(absl::StrCat(dispatcher_->name(), ".numa_node"),
+                         Stats::Gauge::ImportMode::NeverImport)
+        .set(*numa_node);
+  }
+}
 
 void WorkerImpl::stop() {
   // It's possible for the server to cleanly shut down while cluster initialization during startup
@@ -122,6 +168,8 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
 }
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  // Place the thread before the dispatcher runs, so that what it allocates from here on is local.
+  cpu_affinity_.applyToCurrentThread();
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
@@ -133,6 +181,8 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
   ENVOY_LOG(debug, "worker exited dispatch loop");
   guard_dog.stopWatching(watch_dog_);
+  reclaim_connection_memory_timer_.reset();
+  reset_high_memory_streams_timer_.reset();
 
   // We must close all active connections before we actually exit the thread. This prevents any
   // destructors from running on the main thread which might reference thread locals. Destroying
@@ -153,5 +203,57 @@ void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
   }
 }
 
+void WorkerImpl::reclaimConnectionMemoryCb(OverloadActionState state) {
+  switch (state) {
+  case OverloadActionState::Active:
+    if (reclaim_connection_memory_timer_ == nullptr) {
+      reclaim_connection_memory_timer_ =
+          dispatcher_->createTimer([this]() { reclaimConnectionMemory(); });
+    }
+    reclaimConnectionMemory();
+    break;
+  case OverloadActionState::Inactive:
+    if (reclaim_connection_memory_timer_ != nullptr) {
+      reclaim_connection_memory_timer_->disableTimer();
+    }
+    break;
+  }
+}
+
+void WorkerImpl::reclaimConnectionMemory() {
+  handler_->reclaimConnectionMemory(
+      Runtime::getInteger("envoy.overload.reclaim_connection_memory.max_connections", 10),
+      Runtime::getInteger("envoy.overload.reclaim_connection_memory.min_bytes", 1024 * 1024));
+  reclaim_connection_memory_timer_->enableTimer(ReclaimConnectionMemoryInterval);
+}
+
+void WorkerImpl::resetHighMemoryStreamsCb(OverloadActionState state) {
+  switch (state) {
+  case OverloadActionState::Active:
+    if (reset_high_memory_streams_timer_ == nullptr) {
+      reset_high_memory_streams_timer_ =
+          dispatcher_->createTimer([this]() { resetHighMemoryStreams(); });
+    }
+    resetHighMemoryStreams();
+    break;
+  case OverloadActionState::Inactive:
+    if (reset_high_memory_streams_timer_ != nullptr) {
+      reset_high_memory_streams_timer_->disableTimer();
+    }
+    break;
+  }
+}
+
+void WorkerImpl::resetHighMemoryStreams() {
+  Http::StreamMemoryTracker& tracker = overload_manager_.getThreadLocalStreamMemoryTracker();
+  const uint64_t reset_bytes = tracker.resetLargestStreams(
+      Runtime::getInteger("envoy.overload.reset_high_memory_streams.max_streams", 10),
+      Runtime::getInteger("envoy.overload.reset_high_memory_streams.min_bytes", 64 * 1024));
+  if (reset_bytes > 0) {
+    ENVOY_LOG(debug, "reset streams buffering {} bytes", reset_bytes);
+  }
+  reset_high_memory_streams_timer_->enableTimer(ResetHighMemoryStreamsInterval);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -7,9 +7,11 @@
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
+#include "envoy/server/options.h"
 #include "envoy/server/worker.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/cpu_affinity.h"
 #include "common/common/logger.h"
 
 #include "server/listener_hooks.h"
@@ -19,17 +21,26 @@ namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    const Options& options);
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager,
+  WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
                          const std::string& worker_name) override;
 
+  /**
+   * Set what workers that aren't pinned run on. Workers inherit the affinity of the main thread,
+   * so the server sets this to the CPUs of the process before it pins the main thread.
+   */
+  void setUnpinnedAffinity(CpuAffinity affinity) { unpinned_affinity_ = std::move(affinity); }
+
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  const Options& options_;
+  // What workers that aren't pinned run on. By default they keep what they inherit.
+  CpuAffinity unpinned_affinity_;
 };
 
 /**
@@ -39,7 +50,7 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, CpuAffinity cpu_affinity);
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
@@ -58,14 +69,24 @@ public:
 private:
   void threadRoutine(GuardDog& guard_dog);
   void stopAcceptingConnectionsCb(OverloadActionState state);
+  void reclaimConnectionMemoryCb(OverloadActionState state);
+  void reclaimConnectionMemory();
+  void resetHighMemoryStreamsCb(OverloadActionState state);
+  void resetHighMemoryStreams();
 
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
+  OverloadManager& overload_manager_;
   Api::Api& api_;
+  const CpuAffinity cpu_affinity_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
+  // Repeats the reclaim while the reclaim_connection_memory overload action stays active.
+  Event::TimerPtr reclaim_connection_memory_timer_;
+  // Repeats the resets while the reset_high_memory_streams overload action stays active.
+  Event::TimerPtr reset_high_memory_streams_timer_;
 };
 
 } // namespace Server
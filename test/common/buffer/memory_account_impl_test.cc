@@ -0,0 +1,66 @@
+#include <memory>
+
+#include "common/buffer/memory_account_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+TEST(BufferMemoryAccountImplTest, ChargesParent) {
+  auto parent = std::make_shared<BufferMemoryAccountImpl>();
+  BufferMemoryAccountImpl account1(parent);
+  BufferMemoryAccountImpl account2(parent);
+
+  account1.charge(100);
+  account2.charge(50);
+  EXPECT_EQ(100, account1.balance());
+  EXPECT_EQ(50, account2.balance());
+  EXPECT_EQ(150, parent->balance());
+
+  account1.credit(100);
+  EXPECT_EQ(0, account1.balance());
+  EXPECT_EQ(50, parent->balance());
+}
+
+TEST(GaugeBufferMemoryAccountTest, UpdatesGaugeInSteps) {
+  Stats::IsolatedStoreImpl store;
+  Stats::Gauge& gauge = store.gaugeFromString("buffered", Stats::Gauge::ImportMode::Accumulate);
+  const uint64_t step = GaugeBufferMemoryAccount::GaugeUpdateBytes;
+  {
+    GaugeBufferMemoryAccount account(gauge);
+    account.charge(step - 1);
+    EXPECT_EQ(step - 1, account.balance());
+    EXPECT_EQ(0, gauge.value());
+
+    account.charge(1);
+    EXPECT_EQ(step, gauge.value());
+
+    account.charge(3 * step);
+    EXPECT_EQ(4 * step, gauge.value());
+    account.credit(step - 1);
+    EXPECT_EQ(4 * step, gauge.value());
+    account.credit(1);
+    EXPECT_EQ(3 * step, gauge.value());
+
+    account.credit(2 * step);
+    EXPECT_EQ(step, gauge.value());
+
+    // The gauge goes back to zero as soon as the account is empty.
+    account.credit(step - 10);
+    EXPECT_EQ(step, gauge.value());
+    account.credit(10);
+    EXPECT_EQ(0, gauge.value());
+
+    account.charge(2 * step);
+    EXPECT_EQ(2 * step, gauge.value());
+  }
+  // What the account reported is taken back when it's destroyed.
+  EXPECT_EQ(0, gauge.value());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -1059,6 +1059,74 @@ TEST_F(OwnedImplTest, MoveSmallSliceIntoNotEnoughFreeSpace) {
   TestBufferMove(4096 - 127, 128, 2);
 }
 
+// Shrinking copies the content of mostly empty slices into slices that fit it.
+TEST_F(OwnedImplTest, Shrink) {
+  Buffer::OwnedImpl buffer;
+  // Like reads, reserve large slices and only partially fill them.
+  auto add_partial_slice = [&buffer](char c) {
+    RawSlice iovec;
+    ASSERT_EQ(1, buffer.reserve(16384, &iovec, 1));
+    memset(iovec.mem_, c, 100);
+    iovec.len_ = 100;
+    buffer.commit(&iovec, 1);
+  };
+  add_partial_slice('a');
+  // Fragments can't be copied, and split the slices around them into separate runs.
+  char input[] = "fragment";
+  BufferFragmentImpl frag(input, 8, nullptr);
+  buffer.addBufferFragment(frag);
+  add_partial_slice('b');
+  buffer.add("c");
+
+  testing::MockFunction<void()> tracker;
+  buffer.addDrainTracker(tracker.AsStdFunction());
+  const std::string content = buffer.toString();
+  const uint64_t large_slice = OwnedSlice::sliceSize(16384);
+  const uint64_t small_slice = OwnedSlice::sliceSize(100);
+  expectSlices({{100, static_cast<int>(large_slice) - 100, static_cast<int>(large_slice)},
+                {8, 0, 8},
+                {101, static_cast<int>(large_slice) - 101, static_cast<int>(large_slice)}},
+               buffer);
+
+  EXPECT_EQ(2 * (large_slice - small_slice), buffer.shrink());
+  EXPECT_EQ(content, buffer.toString());
+  EXPECT_EQ(209, buffer.length());
+  expectSlices({{100, static_cast<int>(small_slice) - 100, static_cast<int>(small_slice)},
+                {8, 0, 8},
+                {101, static_cast<int>(small_slice) - 101, static_cast<int>(small_slice)}},
+               buffer);
+
+  // Nothing is left to release.
+  EXPECT_EQ(0, buffer.shrink());
+
+  // Drain trackers move along with the content.
+  EXPECT_CALL(tracker, Call());
+  buffer.drain(buffer.length());
+}
+
+// The front slice capacity is that of the first slice with content, including drained space.
+TEST_F(OwnedImplTest, FrontSliceCapacity) {
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(0, buffer.frontSliceCapacity());
+
+  RawSlice iovec;
+  ASSERT_EQ(1, buffer.reserve(16384, &iovec, 1));
+  memset(iovec.mem_, 'a', 100);
+  iovec.len_ = 100;
+  buffer.commit(&iovec, 1);
+  char input[] = "fragment";
+  BufferFragmentImpl frag(input, 8, nullptr);
+  buffer.addBufferFragment(frag);
+  EXPECT_EQ(OwnedSlice::sliceSize(16384), buffer.frontSliceCapacity());
+  buffer.drain(50);
+  EXPECT_EQ(OwnedSlice::sliceSize(16384), buffer.frontSliceCapacity());
+
+  buffer.drain(50);
+  EXPECT_EQ(8, buffer.frontSliceCapacity());
+  buffer.drain(buffer.length());
+  EXPECT_EQ(0, buffer.frontSliceCapacity());
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/memory_account_impl.h"
 #include "common/buffer/watermark_buffer.h"
 #include "common/network/io_socket_handle_impl.h"
 
@@ -69,6 +70,18 @@ TEST_F(WatermarkBufferTest, AddBuffer) {
   EXPECT_EQ(11, buffer_.length());
 }
 
+TEST_F(WatermarkBufferTest, AddBufferFragment) {
+  BufferFragmentImpl fragment(TEN_BYTES, 10, nullptr);
+  buffer_.addBufferFragment(fragment);
+  EXPECT_EQ(0, times_high_watermark_called_);
+  BufferFragmentImpl another_fragment("a", 1, nullptr);
+  buffer_.addBufferFragment(another_fragment);
+  EXPECT_EQ(1, times_high_watermark_called_);
+  EXPECT_EQ(11, buffer_.length());
+  // The fragments go away with this test, so drain them before the buffer does.
+  buffer_.drain(11);
+}
+
 TEST_F(WatermarkBufferTest, Prepend) {
   std::string suffix = "World!", prefix = "Hello, ";
 
@@ -517,6 +530,44 @@ TEST_F(WatermarkBufferTest, MoveWatermarksOverflow) {
   EXPECT_EQ(1, overflow_watermark_buffer1);
 }
 
+TEST_F(WatermarkBufferTest, MemoryAccount) {
+  auto account = std::make_shared<BufferMemoryAccountImpl>();
+  buffer_.add(TEN_BYTES, 10);
+  // What the buffer already holds is charged when the account is set.
+  buffer_.setAccount(account);
+  EXPECT_EQ(10, account->balance());
+
+  buffer_.prepend("abc");
+  EXPECT_EQ(13, account->balance());
+  OwnedImpl other;
+  other.move(buffer_, 5);
+  EXPECT_EQ(8, account->balance());
+  buffer_.move(other);
+  EXPECT_EQ(13, account->balance());
+  buffer_.drain(12);
+  EXPECT_EQ(1, account->balance());
+
+  // Moving to another account credits the previous one.
+  auto account2 = std::make_shared<BufferMemoryAccountImpl>();
+  buffer_.setAccount(account2);
+  EXPECT_EQ(0, account->balance());
+  EXPECT_EQ(1, account2->balance());
+
+  {
+    WatermarkBuffer buffer2([]() -> void {}, []() -> void {}, []() -> void {});
+    buffer2.setAccount(account2);
+    buffer2.add(TEN_BYTES, 10);
+    EXPECT_EQ(11, account2->balance());
+  }
+  // Destroyed buffers credit their account.
+  EXPECT_EQ(1, account2->balance());
+
+  buffer_.setAccount(nullptr);
+  EXPECT_EQ(0, account2->balance());
+  buffer_.add(TEN_BYTES, 10);
+  EXPECT_EQ(0, account2->balance());
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
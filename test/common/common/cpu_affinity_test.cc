@@ -0,0 +1,64 @@
+#include <vector>
+
+#include "common/common/cpu_affinity.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(CpuAffinityTest, ParseCpuList) {
+  std::vector<uint32_t> cpus;
+  EXPECT_TRUE(CpuAffinity::parseCpuList("3", cpus));
+  EXPECT_EQ(std::vector<uint32_t>({3}), cpus);
+  EXPECT_TRUE(CpuAffinity::parseCpuList("0-3,8,10-11", cpus));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}), cpus);
+  // Order is kept, so that workers can be spread in a given order.
+  EXPECT_TRUE(CpuAffinity::parseCpuList("4,0,5-5", cpus));
+  EXPECT_EQ(std::vector<uint32_t>({4, 0, 5}), cpus);
+}
+
+TEST(CpuAffinityTest, ParseInvalidCpuList) {
+  std::vector<uint32_t> cpus{1};
+  EXPECT_FALSE(CpuAffinity::parseCpuList("", cpus));
+  EXPECT_TRUE(cpus.empty());
+  EXPECT_FALSE(CpuAffinity::parseCpuList("1,", cpus));
+  EXPECT_FALSE(CpuAffinity::parseCpuList("a", cpus));
+  EXPECT_FALSE(CpuAffinity::parseCpuList("-1", cpus));
+  EXPECT_FALSE(CpuAffinity::parseCpuList("3-1", cpus));
+  EXPECT_FALSE(CpuAffinity::parseCpuList("1-2-3", cpus));
+  EXPECT_FALSE(CpuAffinity::parseCpuList("0-100000", cpus));
+  EXPECT_TRUE(cpus.empty());
+}
+
+TEST(CpuAffinityTest, EmptyKeepsPlacement) {
+  EXPECT_TRUE(CpuAffinity().applyToCurrentThread());
+}
+
+#if defined(__linux__)
+TEST(CpuAffinityTest, ApplyToCurrentThread) {
+  const std::vector<uint32_t> initial = CpuAffinity::currentThreadCpus();
+  ASSERT_FALSE(initial.empty());
+
+  // Run in a separate thread, so that the placement of the test thread is left alone.
+  Thread::threadFactoryForTest()
+      .createThread([&initial]() {
+        EXPECT_TRUE(CpuAffinity({initial[0]}, true).applyToCurrentThread());
+        EXPECT_EQ(std::vector<uint32_t>({initial[0]}), CpuAffinity::currentThreadCpus());
+        EXPECT_TRUE(CpuAffinity(initial, false).applyToCurrentThread());
+        EXPECT_EQ(initial, CpuAffinity::currentThreadCpus());
+      })
+      ->join();
+}
+
+TEST(CpuAffinityTest, ApplyUnavailableCpu) {
+  Thread::threadFactoryForTest()
+      .createThread([]() { EXPECT_FALSE(CpuAffinity({4095}, false).applyToCurrentThread()); })
+      ->join();
+}
+#endif
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,82 @@
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "common/common/mpsc_queue.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+struct Element : public MpscQueueNode {
+  explicit Element(uint32_t value) : value_(value) {}
+
+  uint32_t value_;
+};
+
+TEST(MpscQueueTest, Fifo) {
+  MpscQueue<Element> queue;
+  EXPECT_EQ(nullptr, queue.pop());
+
+  std::array<Element, 3> elements{{Element(0), Element(1), Element(2)}};
+  for (Element& element : elements) {
+    queue.push(element);
+  }
+  for (Element& element : elements) {
+    EXPECT_EQ(&element, queue.pop());
+  }
+  EXPECT_EQ(nullptr, queue.pop());
+
+  // Popped elements can be pushed again, including the one that was last in the queue.
+  queue.push(elements[2]);
+  queue.push(elements[0]);
+  EXPECT_EQ(&elements[2], queue.pop());
+  queue.push(elements[1]);
+  EXPECT_EQ(&elements[0], queue.pop());
+  EXPECT_EQ(&elements[1], queue.pop());
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+// Every element pushed by concurrent producers is popped exactly once, in order for each producer.
+TEST(MpscQueueTest, ConcurrentProducers) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t elements_per_thread = 10000;
+  MpscQueue<Element> queue;
+  std::array<std::vector<std::unique_ptr<Element>>, num_threads> elements;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    for (uint32_t j = 0; j < elements_per_thread; j++) {
+      elements[i].push_back(std::make_unique<Element>(i * elements_per_thread + j));
+    }
+  }
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&queue, &elements, i]() {
+      for (auto& element : elements[i]) {
+        queue.push(*element);
+      }
+    }));
+  }
+
+  std::array<uint32_t, num_threads> next{};
+  uint32_t popped = 0;
+  while (popped < num_threads * elements_per_thread) {
+    const Element* element = queue.pop();
+    if (element == nullptr) {
+      continue;
+    }
+    const uint32_t thread = element->value_ / elements_per_thread;
+    EXPECT_EQ(next[thread]++, element->value_ % elements_per_thread);
+    popped++;
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+} // namespace
+} // namespace Envoy
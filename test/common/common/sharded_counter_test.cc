@@ -0,0 +1,112 @@
+#include <vector>
+
+#include "common/common/sharded_counter.h"
+#include "common/common/thread.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(ShardedCounterTest, SingleShard) {
+  ShardedCounter counter(1);
+  EXPECT_EQ(1U, counter.numShards());
+  EXPECT_EQ(0, counter.value());
+  counter.add(5);
+  counter.sub(2);
+  EXPECT_EQ(3, counter.value());
+  counter.set(10);
+  EXPECT_EQ(10, counter.value());
+}
+
+TEST(ShardedCounterTest, ZeroShardsMeansOne) { EXPECT_EQ(1U, ShardedCounter(0).numShards()); }
+
+// The matching increments and decrements of different threads land in different shards, so the
+// value is only meaningful as the sum of all of them.
+TEST(ShardedCounterTest, MultipleThreads) {
+  ShardedCounter counter(4);
+  EXPECT_EQ(4U, counter.numShards());
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+
+  counter.add(1000);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < 8; i++) {
+    threads.push_back(thread_factory.createThread([&counter, i]() {
+      for (uint32_t j = 0; j < 1000; j++) {
+        if (i % 2 == 0) {
+          counter.add(2);
+        } else {
+          counter.sub(1);
+        }
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(5000, counter.value());
+
+  // A thread may decrement what another one incremented, which briefly makes its shard negative.
+  threads.clear();
+  threads.push_back(thread_factory.createThread([&counter]() { counter.sub(5000); }));
+  threads.back()->join();
+  EXPECT_EQ(0, counter.value());
+
+  counter.set(7);
+  EXPECT_EQ(7, counter.value());
+}
+
+// A thread running a dispatcher sees its own updates at once and those of other threads as of the
+// start of its dispatcher iteration.
+TEST(ShardedCounterTest, ApproximateValue) {
+  ShardedCounter counter(2);
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  absl::Notification reader_started;
+  absl::Notification writer_done;
+
+  // Fresh threads take consecutive shards, so the reader and the writer don't share one.
+  Thread::ThreadPtr reader = thread_factory.createThread([&]() {
+    // Without a dispatcher iteration, the value is exact.
+    counter.add(1);
+    EXPECT_EQ(1, counter.approximateValue());
+
+    ShardedCounter::onDispatcherIteration();
+    EXPECT_EQ(1, counter.approximateValue());
+    reader_started.Notify();
+    writer_done.WaitForNotification();
+    EXPECT_EQ(6, counter.value());
+    // The writer's update shows up in the next iteration, but the reader's own ones at once.
+    counter.add(1);
+    EXPECT_EQ(2, counter.approximateValue());
+
+    ShardedCounter::onDispatcherIteration();
+    EXPECT_EQ(7, counter.approximateValue());
+  });
+  reader_started.WaitForNotification();
+  Thread::ThreadPtr writer = thread_factory.createThread([&]() {
+    counter.add(5);
+    writer_done.Notify();
+  });
+  writer->join();
+  reader->join();
+  EXPECT_EQ(7, counter.value());
+}
+
+TEST(ShardedCounterTest, DefaultShardCount) {
+  EXPECT_EQ(1U, ShardedCounter::defaultShardCount());
+  EXPECT_EQ(1U, ShardedCounter().numShards());
+
+  ShardedCounter::setDefaultShardCount(4);
+  EXPECT_EQ(4U, ShardedCounter().numShards());
+  ShardedCounter::setDefaultShardCount(1000);
+  EXPECT_EQ(8U, ShardedCounter().numShards());
+  ShardedCounter::setDefaultShardCount(0);
+  EXPECT_EQ(1U, ShardedCounter().numShards());
+}
+
+} // namespace
+} // namespace Envoy
@@ -1,8 +1,10 @@
+#include <array>
 #include <functional>
 
 #include "envoy/thread/thread.h"
 
 #include "common/api/api_impl.h"
+#include "common/common/cleanup.h"
 #include "common/common/lock_guard.h"
 #include "common/event/deferred_task.h"
 #include "common/event/dispatcher_impl.h"
@@ -298,6 +300,10 @@ TEST_F(DispatcherImplTest, InitializeStats) {
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_queue_depth", Stats::Histogram::Unit::Unspecified));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -333,8 +339,8 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
-    // or else this would deadlock.
+    // This also ensures that no lock is held while callbacks are called, or else this
+    // would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
 
@@ -355,6 +361,43 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
   }
 }
 
+// Posts from several threads at once must all run, in order for each thread.
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t posts_per_thread = 10000;
+  std::array<uint32_t, num_threads> next_post{};
+  uint32_t posts_run = 0;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(api_->threadFactory().createThread([&, i]() {
+      for (uint32_t j = 0; j < posts_per_thread; j++) {
+        dispatcher_->post([&, i, j]() {
+          EXPECT_EQ(j, next_post[i]++);
+          if (++posts_run == num_threads * posts_per_thread) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  for (uint32_t i = 0; i < num_threads; i++) {
+    EXPECT_EQ(posts_per_thread, next_post[i]);
+  }
+}
+
 TEST_F(DispatcherImplTest, Timer) {
   timerTest([](Timer& timer) { timer.enableTimer(std::chrono::milliseconds(0)); });
   timerTest([](Timer& timer) { timer.enableTimer(std::chrono::milliseconds(50)); });
@@ -429,6 +472,32 @@ TEST_F(NotStartedDispatcherImplTest, IsThreadSafe) {
   EXPECT_TRUE(dispatcher_->isThreadSafe());
 }
 
+// Callbacks that never ran are destroyed with the dispatcher, including any that their
+// destructors post.
+TEST_F(NotStartedDispatcherImplTest, DestroyPendingPosts) {
+  class PostOnDestruct {
+  public:
+    PostOnDestruct(Dispatcher& dispatcher, ReadyWatcher& destroyed)
+        : dispatcher_(dispatcher), destroyed_(destroyed) {}
+    ~PostOnDestruct() {
+      destroyed_.ready();
+      auto cleanup = std::make_shared<Cleanup>([&destroyed = destroyed_]() { destroyed.ready(); });
+      dispatcher_.post([cleanup]() {});
+    }
+
+    Dispatcher& dispatcher_;
+    ReadyWatcher& destroyed_;
+  };
+
+  ReadyWatcher destroyed;
+  auto post_on_destruct = std::make_shared<PostOnDestruct>(*dispatcher_, destroyed);
+  dispatcher_->post([post_on_destruct]() {});
+  post_on_destruct.reset();
+
+  EXPECT_CALL(destroyed, ready()).Times(2);
+  dispatcher_.reset();
+}
+
 class DispatcherMonotonicTimeTest : public testing::Test {
 protected:
   DispatcherMonotonicTimeTest()
@@ -472,6 +541,26 @@ TEST_F(DispatcherMonotonicTimeTest, ApproximateMonotonicTime) {
   dispatcher_->run(Dispatcher::RunType::Block);
 }
 
+// Callbacks that keep the event loop busy for whole sample windows push its utilization towards 1.
+TEST(DispatcherLoopUtilizationTest, BusyLoop) {
+  Event::SimulatedTimeSystem time_system;
+  Api::ApiPtr api = Api::createApiForTest(time_system);
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  EXPECT_EQ(0, dispatcher->loopUtilization());
+
+  double last_utilization = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    dispatcher->post([&time_system]() {
+      time_system.advanceTimeAsync(std::chrono::milliseconds(200));
+    });
+    dispatcher->run(Dispatcher::RunType::NonBlock);
+    EXPECT_GE(dispatcher->loopUtilization(), last_utilization);
+    last_utilization = dispatcher->loopUtilization();
+  }
+  EXPECT_GT(last_utilization, 0.5);
+  EXPECT_LE(last_utilization, 1);
+}
+
 TEST(TimerImplTest, TimerEnabledDisabled) {
   Api::ApiPtr api = Api::createApiForTest();
   DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
@@ -0,0 +1,61 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/common/thread.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+// Posts callbacks from state.range(0) threads at once to a single dispatcher running on its own
+// thread, and waits for all of them to run.
+static void BM_DispatcherPost(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  constexpr uint32_t posts_per_thread = 10000;
+  if (!Libevent::Global::initialized()) {
+    Libevent::Global::initialize();
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  std::atomic<uint64_t> posts_run{0};
+
+  Thread::ThreadPtr dispatcher_thread = api->threadFactory().createThread(
+      [&dispatcher]() { dispatcher->run(Dispatcher::RunType::RunUntilExit); });
+
+  uint64_t posts_expected = 0;
+  for (auto _ : state) {
+    posts_expected += num_threads * posts_per_thread;
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; i++) {
+      threads.push_back(api->threadFactory().createThread([&dispatcher, &posts_run]() {
+        for (uint32_t j = 0; j < posts_per_thread; j++) {
+          dispatcher->post([&posts_run]() { posts_run.fetch_add(1, std::memory_order_relaxed); });
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+    while (posts_run.load(std::memory_order_relaxed) < posts_expected) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(posts_expected);
+
+  dispatcher->exit();
+  dispatcher_thread->join();
+}
+BENCHMARK(BM_DispatcherPost)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+} // namespace Event
+} // namespace Envoy
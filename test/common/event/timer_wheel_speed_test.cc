@@ -0,0 +1,52 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the cost of re-enabling one of state.range(1) pending timers, as connections do with
+// their idle timeouts on every read and write, for libevent timers (Arg 0) and coarse timers kept
+// in the dispatcher's timer wheel (Arg 1).
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+static void BM_TimerRearm(benchmark::State& state) {
+  const bool coarse = state.range(0) != 0;
+  const uint32_t num_timers = state.range(1);
+  if (!Libevent::Global::initialized()) {
+    Libevent::Global::initialize();
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+
+  std::mt19937 random(0);
+  std::uniform_int_distribution<uint32_t> timeout_ms(60000, 300000);
+  std::vector<TimerPtr> timers;
+  for (uint32_t i = 0; i < num_timers; i++) {
+    timers.push_back(coarse ? dispatcher->createCoarseTimer([]() {})
+                            : dispatcher->createTimer([]() {}));
+    timers.back()->enableTimer(std::chrono::milliseconds(timeout_ms(random)));
+  }
+
+  uint32_t i = 0;
+  for (auto _ : state) {
+    timers[i]->enableTimer(std::chrono::milliseconds(timeout_ms(random)));
+    if (++i == num_timers) {
+      i = 0;
+    }
+  }
+}
+BENCHMARK(BM_TimerRearm)->Ranges({{0, 1}, {1000, 1000000}});
+
+} // namespace Event
+} // namespace Envoy
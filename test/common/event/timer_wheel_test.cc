@@ -0,0 +1,209 @@
+#include <chrono>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TimerWheelTest : public testing::Test {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  // Moves time forward, running the timers that are due.
+  void advance(std::chrono::microseconds duration) {
+    time_system_.advanceTimeAsync(duration);
+    dispatcher_->run(Dispatcher::RunType::NonBlock);
+  }
+
+  // Moves time forward a microsecond at a time until the timer fires, and returns how long it took.
+  std::chrono::microseconds timeToFire(Timer& timer) {
+    const MonotonicTime start = time_system_.monotonicTime();
+    while (true) {
+      dispatcher_->run(Dispatcher::RunType::NonBlock);
+      if (!timer.enabled()) {
+        break;
+      }
+      time_system_.advanceTimeAsync(std::chrono::microseconds(1));
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(time_system_.monotonicTime() -
+                                                                 start);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST_F(TimerWheelTest, EnabledDisabled) {
+  TimerPtr timer = dispatcher_->createCoarseTimer([] {});
+  EXPECT_FALSE(timer->enabled());
+  timer->enableTimer(std::chrono::milliseconds(0));
+  EXPECT_TRUE(timer->enabled());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+
+  timer->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_TRUE(timer->enabled());
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  // Disabling again is harmless.
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, NegativeDurationThrows) {
+  TimerPtr timer = dispatcher_->createCoarseTimer([] {});
+  EXPECT_THROW(timer->enableTimer(std::chrono::milliseconds(-1)), EnvoyException);
+  EXPECT_THROW(timer->enableHRTimer(std::chrono::microseconds(-1)), EnvoyException);
+  EXPECT_FALSE(timer->enabled());
+}
+
+// Timers fire on the first tick at which their duration has fully elapsed.
+TEST_F(TimerWheelTest, FiresOnTickBoundaries) {
+  TimerPtr timer = dispatcher_->createCoarseTimer([] {});
+
+  timer->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_EQ(std::chrono::milliseconds(10), timeToFire(*timer));
+
+  timer->enableHRTimer(std::chrono::microseconds(1500));
+  EXPECT_EQ(std::chrono::milliseconds(2), timeToFire(*timer));
+
+  // Half way through a tick, a timer can't fire before the next tick plus its duration.
+  advance(std::chrono::microseconds(500));
+  timer->enableTimer(std::chrono::milliseconds(5));
+  EXPECT_EQ(std::chrono::microseconds(5500), timeToFire(*timer));
+}
+
+// Timers in the higher levels of the wheel cascade down, and fire in order, neither early nor more
+// than a tick late.
+TEST_F(TimerWheelTest, TimersFireInOrderAcrossLevels) {
+  const std::vector<std::chrono::milliseconds> durations = {
+      std::chrono::milliseconds(3),     std::chrono::milliseconds(255),
+      std::chrono::milliseconds(256),   std::chrono::milliseconds(1000),
+      std::chrono::milliseconds(65535), std::chrono::milliseconds(65536),
+      std::chrono::hours(5),            std::chrono::hours(24 * 60)};
+  const MonotonicTime start = time_system_.monotonicTime();
+  std::vector<MonotonicTime> fired;
+  std::vector<TimerPtr> timers;
+  // Enable them in reverse order, so that they don't fire in insertion order by accident.
+  for (auto it = durations.rbegin(); it != durations.rend(); ++it) {
+    timers.push_back(dispatcher_->createCoarseTimer(
+        [this, &fired]() { fired.push_back(time_system_.monotonicTime()); }));
+    timers.back()->enableTimer(*it);
+  }
+
+  // Step through time in strides that don't line up with any level of the wheel.
+  const std::chrono::milliseconds stride(419999);
+  while (fired.size() < durations.size()) {
+    advance(stride);
+  }
+  for (size_t i = 0; i < durations.size(); i++) {
+    EXPECT_GE(fired[i] - start, durations[i]);
+    EXPECT_LE(fired[i] - start, durations[i] + stride);
+  }
+
+  // Stepping through a tick at a time fires them exactly on time.
+  fired.clear();
+  const MonotonicTime restart = time_system_.monotonicTime();
+  for (size_t i = 0; i < 6; i++) {
+    timers[durations.size() - 1 - i]->enableTimer(durations[i]);
+  }
+  while (fired.size() < 6) {
+    advance(std::chrono::milliseconds(1));
+  }
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_EQ(fired[i] - restart, durations[i]);
+  }
+}
+
+// Timers re-enabled before they fire only fire once, at their last deadline.
+TEST_F(TimerWheelTest, Reschedule) {
+  ReadyWatcher watcher;
+  TimerPtr timer = dispatcher_->createCoarseTimer([&watcher]() { watcher.ready(); });
+  timer->enableTimer(std::chrono::milliseconds(100));
+  advance(std::chrono::milliseconds(50));
+  timer->enableTimer(std::chrono::seconds(100));
+  advance(std::chrono::milliseconds(50));
+  timer->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_CALL(watcher, ready()).Times(0);
+  advance(std::chrono::milliseconds(9));
+  EXPECT_CALL(watcher, ready());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+  advance(std::chrono::seconds(100));
+}
+
+// Callbacks may disable, re-enable and free the timers that expire in the same tick.
+TEST_F(TimerWheelTest, CallbacksChangeTimersOfTheSameTick) {
+  ReadyWatcher watcher1;
+  ReadyWatcher watcher2;
+  ReadyWatcher watcher3;
+  TimerPtr timer2;
+  TimerPtr timer3;
+  TimerPtr timer1 = dispatcher_->createCoarseTimer([&]() {
+    watcher1.ready();
+    timer2->enableTimer(std::chrono::milliseconds(5));
+    timer3.reset();
+  });
+  timer2 = dispatcher_->createCoarseTimer([&watcher2]() { watcher2.ready(); });
+  timer3 = dispatcher_->createCoarseTimer([&watcher3]() { watcher3.ready(); });
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(10));
+  timer3->enableTimer(std::chrono::milliseconds(10));
+
+  InSequence s;
+  EXPECT_CALL(watcher1, ready());
+  advance(std::chrono::milliseconds(10));
+  EXPECT_TRUE(timer2->enabled());
+  EXPECT_CALL(watcher2, ready());
+  advance(std::chrono::milliseconds(5));
+}
+
+// A timer re-enabled for zero from its callback fires again on the next tick, not in a loop.
+TEST_F(TimerWheelTest, ReenableFromCallback) {
+  uint32_t calls = 0;
+  TimerPtr timer;
+  timer = dispatcher_->createCoarseTimer([&]() {
+    calls++;
+    timer->enableTimer(std::chrono::milliseconds(0));
+  });
+  timer->enableTimer(std::chrono::milliseconds(0));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, calls);
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, calls);
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(2, calls);
+  timer->disableTimer();
+}
+
+TEST_F(TimerWheelTest, Scope) {
+  MockScopedTrackedObject scope;
+  // If the scope is tracked while the timer runs, a fatal error dumps its state.
+  EXPECT_CALL(scope, dumpState(_, _));
+  TimerPtr timer = dispatcher_->createCoarseTimer(
+      [this]() { static_cast<DispatcherImpl*>(dispatcher_.get())->onFatalError(); });
+  timer->enableTimer(std::chrono::milliseconds(5), &scope);
+  advance(std::chrono::milliseconds(5));
+  EXPECT_FALSE(timer->enabled());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -2927,6 +2927,46 @@ TEST_F(HttpConnectionManagerImplTest, MaxStreamDurationCallbackResetStream) {
   EXPECT_EQ(1U, stats_.named_.downstream_rq_rx_reset_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, OverloadResetOfStreamBufferingData) {
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> Http::Status {
+    RequestDecoder* decoder = &conn_manager_->newStream(response_encoder_);
+    RequestHeaderMapPtr headers{
+        new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "POST"}}};
+    decoder->decodeHeaders(std::move(headers), false);
+
+    Buffer::OwnedImpl fake_data("hello");
+    decoder->decodeData(fake_data, false);
+    return Http::okStatus();
+  }));
+
+  setupFilterChain(1, 0);
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[0], decodeData(_, false))
+      .WillOnce(Return(FilterDataStatus::StopIterationAndBuffer));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  // Streams buffering less than the minimum are left alone.
+  Http::StreamMemoryTracker& tracker = overload_manager_.stream_memory_tracker_;
+  EXPECT_EQ(0, tracker.resetLargestStreams(1, 6));
+  EXPECT_EQ(0U, stats_.named_.downstream_rq_overload_reset_.value());
+
+  expectOnDestroy();
+  EXPECT_EQ(5, tracker.resetLargestStreams(1, 5));
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_reset_.value());
+  EXPECT_EQ(5U, stats_.named_.downstream_rq_overload_reset_bytes_.value());
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_rx_reset_.value());
+  EXPECT_EQ("overload",
+            decoder_filters_[0]->callbacks_->streamInfo().responseCodeDetails().value());
+
+  // The stream is not reset twice.
+  EXPECT_EQ(0, tracker.resetLargestStreams(1, 0));
+}
+
 TEST_F(HttpConnectionManagerImplTest, Http10Rejected) {
   setup(false, "");
   RequestDecoder* decoder = nullptr;
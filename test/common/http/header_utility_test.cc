@@ -529,6 +529,18 @@ TEST(HeaderIsValidTest, IsConnect) {
   EXPECT_FALSE(HeaderUtility::isConnect(Http::TestRequestHeaderMapImpl{}));
 }
 
+TEST(HeaderIsValidTest, IsIdempotentRequest) {
+  for (const char* method : {"GET", "HEAD", "OPTIONS", "TRACE", "PUT", "DELETE"}) {
+    EXPECT_TRUE(
+        HeaderUtility::isIdempotentRequest(Http::TestRequestHeaderMapImpl{{":method", method}}));
+  }
+  for (const char* method : {"POST", "PATCH", "CONNECT"}) {
+    EXPECT_FALSE(
+        HeaderUtility::isIdempotentRequest(Http::TestRequestHeaderMapImpl{{":method", method}}));
+  }
+  EXPECT_FALSE(HeaderUtility::isIdempotentRequest(Http::TestRequestHeaderMapImpl{}));
+}
+
 TEST(HeaderIsValidTest, IsConnectResponse) {
   RequestHeaderMapPtr connect_request{new TestRequestHeaderMapImpl{{":method", "CONNECT"}}};
   RequestHeaderMapPtr get_request{new TestRequestHeaderMapImpl{{":method", "GET"}}};
@@ -2518,6 +2518,102 @@ TEST_F(Http1ClientConnectionImplTest, LowWatermarkDuringClose) {
   EXPECT_TRUE(status.ok());
 }
 
+// Verify that responses to pipelined requests are delivered in the order the requests were sent.
+TEST_F(Http1ClientConnectionImplTest, PipelinedResponses) {
+  initialize();
+
+  InSequence s;
+
+  NiceMock<MockResponseDecoder> response_decoder1;
+  Http::RequestEncoder& request_encoder1 = codec_->newStream(response_decoder1);
+  TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  request_encoder1.encodeHeaders(headers, true);
+
+  NiceMock<MockResponseDecoder> response_decoder2;
+  Http::RequestEncoder& request_encoder2 = codec_->newStream(response_decoder2);
+  request_encoder2.encodeHeaders(headers, true);
+
+  EXPECT_CALL(response_decoder1,
+              decodeHeaders_(HeaderHasValueRef(Headers::get().Status, "200"), false));
+  EXPECT_CALL(response_decoder1, decodeData(BufferStringEqual("a"), false));
+  EXPECT_CALL(response_decoder1, decodeData(_, true));
+  EXPECT_CALL(response_decoder2,
+              decodeHeaders_(HeaderHasValueRef(Headers::get().Status, "503"), true));
+  Buffer::OwnedImpl response("HTTP/1.1 200 OK\r\nContent-Length: 1\r\n\r\na"
+                             "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n");
+  auto status = codec_->dispatch(response);
+  EXPECT_TRUE(status.ok());
+
+  // Both requests are answered, so a further response is premature.
+  Buffer::OwnedImpl response3("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
+  status = codec_->dispatch(response3);
+  EXPECT_TRUE(isPrematureResponseError(status));
+}
+
+// Verify that when the connection is reset, idempotent requests queued behind the response being
+// received are reset as refused streams so that they can be retried.
+TEST_F(Http1ClientConnectionImplTest, PipelinedRequestsResetAsRefused) {
+  initialize();
+
+  NiceMock<MockResponseDecoder> response_decoder1;
+  Http::RequestEncoder& request_encoder1 = codec_->newStream(response_decoder1);
+  Http::MockStreamCallbacks callbacks1;
+  request_encoder1.getStream().addCallbacks(callbacks1);
+  TestRequestHeaderMapImpl get_headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  request_encoder1.encodeHeaders(get_headers, true);
+
+  NiceMock<MockResponseDecoder> response_decoder2;
+  Http::RequestEncoder& request_encoder2 = codec_->newStream(response_decoder2);
+  Http::MockStreamCallbacks callbacks2;
+  request_encoder2.getStream().addCallbacks(callbacks2);
+  request_encoder2.encodeHeaders(get_headers, true);
+
+  NiceMock<MockResponseDecoder> response_decoder3;
+  Http::RequestEncoder& request_encoder3 = codec_->newStream(response_decoder3);
+  Http::MockStreamCallbacks callbacks3;
+  request_encoder3.getStream().addCallbacks(callbacks3);
+  TestRequestHeaderMapImpl post_headers{
+      {":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  request_encoder3.encodeHeaders(post_headers, true);
+
+  EXPECT_CALL(callbacks1, onResetStream(StreamResetReason::ConnectionTermination, _));
+  EXPECT_CALL(callbacks2, onResetStream(StreamResetReason::RemoteRefusedStreamReset, _));
+  EXPECT_CALL(callbacks3, onResetStream(StreamResetReason::ConnectionTermination, _));
+  request_encoder3.getStream().resetStream(StreamResetReason::ConnectionTermination);
+
+  // Resetting a request after the connection has been reset does not raise its callbacks again.
+  request_encoder1.getStream().resetStream(StreamResetReason::ConnectionTermination);
+}
+
+// Verify that when the connection is closed as a response completes, the idempotent request queued
+// behind it is reset as a refused stream and the completed request is not reset.
+TEST_F(Http1ClientConnectionImplTest, PipelinedRequestResetAsRefusedAfterCompletedResponse) {
+  initialize();
+
+  NiceMock<MockResponseDecoder> response_decoder1;
+  Http::RequestEncoder& request_encoder1 = codec_->newStream(response_decoder1);
+  Http::MockStreamCallbacks callbacks1;
+  request_encoder1.getStream().addCallbacks(callbacks1);
+  TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  request_encoder1.encodeHeaders(headers, true);
+
+  NiceMock<MockResponseDecoder> response_decoder2;
+  Http::RequestEncoder& request_encoder2 = codec_->newStream(response_decoder2);
+  Http::MockStreamCallbacks callbacks2;
+  request_encoder2.getStream().addCallbacks(callbacks2);
+  request_encoder2.encodeHeaders(headers, true);
+
+  EXPECT_CALL(callbacks1, onResetStream(_, _)).Times(0);
+  EXPECT_CALL(callbacks2, onResetStream(StreamResetReason::RemoteRefusedStreamReset, _));
+  EXPECT_CALL(response_decoder1, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](ResponseHeaderMapPtr&, bool) {
+        request_encoder1.getStream().resetStream(StreamResetReason::ConnectionTermination);
+      }));
+  Buffer::OwnedImpl response("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+  auto status = codec_->dispatch(response);
+  EXPECT_TRUE(status.ok());
+}
+
 TEST_F(Http1ServerConnectionImplTest, LargeTrailersRejected) {
   // Default limit of 60 KiB
   std::string long_string = "big: " + std::string(60 * 1024, 'q') + "\r\n\r\n\r\n";
@@ -210,9 +210,9 @@ struct ActiveTestRequest {
     EXPECT_CALL(callbacks_.pool_ready_, ready());
   }
 
-  void startRequest() {
+  void startRequest(const std::string& method = "GET") {
     callbacks_.outer_encoder_->encodeHeaders(
-        TestRequestHeaderMapImpl{{":path", "/"}, {":method", "GET"}}, true);
+        TestRequestHeaderMapImpl{{":path", "/"}, {":method", method}}, true);
   }
 
   Http1ConnPoolImplTest& parent_;
@@ -1101,6 +1101,180 @@ TEST_F(Http1ConnPoolImplTest, PendingRequestIsConsideredActive) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_destroy_local_.value());
 }
 
+/**
+ * Verify that a pool with a prefetch ratio establishes connections ahead of demand, and counts
+ * the prefetched connections that end up serving requests.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchWithRatio) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  ON_CALL(*cluster_, perUpstreamPrefetchRatio()).WillByDefault(Return(1.5));
+  upstream_ready_cb_ = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  conn_pool_ = std::make_unique<ConnPoolImplForTest>(dispatcher_, cluster_, upstream_ready_cb_);
+
+  // The first request needs a connection, and 1.5 anticipated streams call for a second one.
+  {
+    InSequence s;
+    conn_pool_->expectClientCreate();
+    conn_pool_->expectClientCreate();
+  }
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  EXPECT_EQ(2U, conn_pool_->test_clients_.size());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetched_.value());
+
+  r1.expectNewStream();
+  EXPECT_CALL(*conn_pool_->test_clients_[0].connect_timer_, disableTimer());
+  conn_pool_->test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*conn_pool_->test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_->test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetched_used_.value());
+
+  // The second request uses the prefetched connection, and with both connections busy the pool
+  // prefetches a third one.
+  conn_pool_->expectClientCreate();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  EXPECT_EQ(3U, conn_pool_->test_clients_.size());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetched_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetched_used_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_overflow_.value());
+
+  r1.startRequest();
+  r1.completeResponse(false);
+  r2.startRequest();
+  r2.completeResponse(false);
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy()).Times(3);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that prefetching doesn't overflow the connection circuit breaker.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchRespectsCircuitBreaker) {
+  ON_CALL(*cluster_, perUpstreamPrefetchRatio()).WillByDefault(Return(3.0));
+  upstream_ready_cb_ = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+  conn_pool_ = std::make_unique<ConnPoolImplForTest>(dispatcher_, cluster_, upstream_ready_cb_);
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  EXPECT_EQ(1U, conn_pool_->test_clients_.size());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetched_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_overflow_.value());
+
+  r1.startRequest();
+  r1.completeResponse(false);
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that maybePrefetch() establishes a connection for one anticipated stream.
+ */
+TEST_F(Http1ConnPoolImplTest, MaybePrefetch) {
+  conn_pool_->expectClientCreate();
+  EXPECT_TRUE(conn_pool_->maybePrefetch(1.0));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetched_.value());
+
+  // The connecting connection already covers the anticipated stream.
+  EXPECT_FALSE(conn_pool_->maybePrefetch(1.0));
+
+  // A request doesn't need a new connection, and uses the prefetched one once it is connected.
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  r1.expectNewStream();
+  EXPECT_CALL(*conn_pool_->test_clients_[0].connect_timer_, disableTimer());
+  conn_pool_->test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetched_used_.value());
+
+  r1.startRequest();
+  r1.completeResponse(false);
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that with pipelining enabled, an idempotent request is sent on a connection once the
+ * request ahead of it has been sent, and the connection frees up as the responses arrive.
+ */
+TEST_F(Http1ConnPoolImplTest, PipelineIdempotentRequests) {
+  cluster_->http1_settings_.max_pipelined_requests_ = 2;
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+
+  // The second request shares the first connection.
+  ActiveTestRequest r2(*this, 0, ActiveTestRequest::Type::Immediate);
+  r2.startRequest();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(2U, conn_pool_->test_clients_[0].codec_client_->numActiveRequests());
+
+  r1.completeResponse(false);
+  EXPECT_EQ(1U, conn_pool_->test_clients_[0].codec_client_->numActiveRequests());
+  r2.completeResponse(false);
+  EXPECT_FALSE(conn_pool_->hasActiveConnections());
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that nothing is pipelined behind a non-idempotent request.
+ */
+TEST_F(Http1ConnPoolImplTest, NoPipeliningAfterNonIdempotentRequest) {
+  cluster_->http1_settings_.max_pipelined_requests_ = 2;
+
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest("POST");
+
+  // The second request needs a connection of its own.
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Verify that pipelining does not make requests waiting for a connection share one: whether a
+ * request can be pipelined is only known once the requests ahead of it have been sent.
+ */
+TEST_F(Http1ConnPoolImplTest, PendingRequestsEachCreateConnection) {
+  cluster_->http1_settings_.max_pipelined_requests_ = 4;
+
+  conn_pool_->expectClientCreate();
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  conn_pool_->expectClientCreate();
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Pending);
+  conn_pool_->expectClientCreate();
+  ActiveTestRequest r3(*this, 2, ActiveTestRequest::Type::Pending);
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_total_.value());
+
+  ActiveTestRequest* requests[] = {&r1, &r2, &r3};
+  for (size_t i = 0; i < 3; i++) {
+    requests[i]->expectNewStream();
+    EXPECT_CALL(*conn_pool_->test_clients_[i].connect_timer_, disableTimer());
+    conn_pool_->test_clients_[i].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+    requests[i]->startRequest("POST");
+  }
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_total_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+  r3.completeResponse(false);
+
+  conn_pool_->drainConnections();
+  EXPECT_CALL(*conn_pool_, onClientDestroy()).Times(3);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 } // namespace
 } // namespace Http1
 } // namespace Http
@@ -0,0 +1,114 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/http/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+/**
+ * A client and a server codec connected back to back. Whatever either side writes is buffered
+ * until flush() dispatches it to the other side, as a network connection would.
+ */
+class CodecPair {
+public:
+  CodecPair()
+      : http2_options_(Http::Utility::initializeAndValidateOptions(
+            envoy::config::core::v3::Http2ProtocolOptions())) {
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_server_.move(data); }));
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_client_.move(data); }));
+    ON_CALL(server_callbacks_, newStream(_, _))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        }));
+
+    client_ = std::make_unique<TestClientConnectionImpl>(
+        client_connection_, client_callbacks_, stats_store_, http2_options_,
+        Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+        ProdNghttp2SessionFactory::get());
+    server_ = std::make_unique<TestServerConnectionImpl>(
+        server_connection_, server_callbacks_, stats_store_, http2_options_,
+        Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  }
+
+  void flush() {
+    while (to_server_.length() > 0 || to_client_.length() > 0) {
+      if (to_server_.length() > 0) {
+        Buffer::OwnedImpl data;
+        data.move(to_server_);
+        RELEASE_ASSERT(server_->dispatch(data).ok(), "");
+      }
+      if (to_client_.length() > 0) {
+        Buffer::OwnedImpl data;
+        data.move(to_client_);
+        RELEASE_ASSERT(client_->dispatch(data).ok(), "");
+      }
+    }
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  const envoy::config::core::v3::Http2ProtocolOptions http2_options_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  std::unique_ptr<TestClientConnectionImpl> client_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  std::unique_ptr<TestServerConnectionImpl> server_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  ResponseEncoder* response_encoder_{};
+  Buffer::OwnedImpl to_server_;
+  Buffer::OwnedImpl to_client_;
+};
+
+/**
+ * Measure the throughput of request bodies of state.range(0) bytes, sent from the client to the
+ * server codec, one stream at a time.
+ */
+static void http2RequestBody(benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const std::string body(body_size, 'a');
+  TestRequestHeaderMapImpl request_headers{
+      {":method", "POST"}, {":path", "/"}, {":scheme", "http"}, {":authority", "host"}};
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+
+  CodecPair codecs;
+  for (auto _ : state) {
+    RequestEncoder& request_encoder = codecs.client_->newStream(codecs.response_decoder_);
+    request_encoder.encodeHeaders(request_headers, false);
+    Buffer::OwnedImpl request_body(body);
+    request_encoder.encodeData(request_body, true);
+    codecs.flush();
+
+    codecs.response_encoder_->encodeHeaders(response_headers, true);
+    codecs.flush();
+    codecs.client_connection_.dispatcher_.clearDeferredDeleteList();
+    codecs.server_connection_.dispatcher_.clearDeferredDeleteList();
+  }
+  state.SetBytesProcessed(state.iterations() * body_size);
+}
+BENCHMARK(http2RequestBody)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024)->Arg(1024 * 1024);
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -635,6 +635,210 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   response_encoder_->encodeTrailers(TestResponseTrailerMapImpl{{"trailing", "header"}});
 }
 
+// Verify that large DATA payloads, which are referenced from the dispatched input rather than
+// copied, are delivered intact and remain valid after dispatch returns.
+TEST_P(Http2CodecImplTest, LargeClientBodyReferencedFromInput) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  std::string body;
+  for (uint32_t i = 0; body.size() < 256 * 1024; i++) {
+    body.append(std::to_string(i));
+  }
+  Buffer::OwnedImpl received;
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .Times(AtLeast(1))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) { received.move(data); }));
+  Buffer::OwnedImpl request_body(body);
+  request_encoder_->encodeData(request_body, true);
+
+  EXPECT_EQ(body, received.toString());
+  EXPECT_EQ(0, request_body.length());
+}
+
+// Verify that DATA payloads are delivered intact when the input arrives in slices of varying size
+// that split frames, as each slice is dispatched, and referenced from, on its own.
+TEST_P(Http2CodecImplTest, LargeClientBodyDispatchedInSlices) {
+  initialize();
+
+  Buffer::OwnedImpl client_output;
+  ON_CALL(client_connection_, write(_, _))
+      .WillByDefault(
+          Invoke([&](Buffer::Instance& data, bool) -> void { client_output.move(data); }));
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_encoder_->encodeHeaders(request_headers, false);
+  std::string body;
+  for (uint32_t i = 0; body.size() < 48 * 1024; i++) {
+    body.append(std::to_string(i));
+  }
+  Buffer::OwnedImpl request_body(body);
+  request_encoder_->encodeData(request_body, true);
+
+  // Split the client's output into slices of alternating sizes, backed by storage that outlives
+  // the dispatch.
+  const std::string output = client_output.toString();
+  std::vector<std::unique_ptr<Buffer::BufferFragmentImpl>> fragments;
+  Buffer::OwnedImpl input;
+  const size_t slice_sizes[] = {1000, 20000, 5000};
+  for (size_t offset = 0, i = 0; offset < output.size(); i++) {
+    const size_t size = std::min(slice_sizes[i % 3], output.size() - offset);
+    fragments.push_back(std::make_unique<Buffer::BufferFragmentImpl>(
+        output.data() + offset, size,
+        [](const void*, size_t, const Buffer::BufferFragmentImpl*) {}));
+    input.addBufferFragment(*fragments.back());
+    offset += size;
+  }
+
+  setupDefaultConnectionMocks();
+  Buffer::OwnedImpl received;
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .Times(AtLeast(1))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) { received.move(data); }));
+  // Dispatch directly, as the connection wrapper would copy the input into a buffer of its own.
+  auto status = server_->dispatch(input);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0, input.length());
+
+  EXPECT_EQ(body, received.toString());
+}
+
+// Verify that a DATA payload is only referenced from the slice it arrived in when it fills at
+// least half of the memory allocated for that slice, as it keeps all of that memory alive.
+TEST_P(Http2CodecImplTest, LargeClientBodyReferencedOnlyFromFilledSlice) {
+  initialize();
+
+  Buffer::OwnedImpl client_output;
+  ON_CALL(client_connection_, write(_, _))
+      .WillByDefault(
+          Invoke([&](Buffer::Instance& data, bool) -> void { client_output.move(data); }));
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_encoder_->encodeHeaders(request_headers, false);
+  // A 16KiB DATA frame followed by an 8KiB one.
+  Buffer::OwnedImpl request_body(std::string(24 * 1024, 'a'));
+  request_encoder_->encodeData(request_body, false);
+  const std::string output = client_output.toString();
+  client_output.drain(client_output.length());
+
+  setupDefaultConnectionMocks();
+  Buffer::OwnedImpl received;
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(request_decoder_, decodeData(_, false))
+      .Times(AtLeast(1))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) { received.move(data); }));
+
+  // In a slice just big enough for the input, the 16KiB payload is referenced, so the slice stays
+  // allocated until the payload is consumed.
+  {
+    bool released = false;
+    Buffer::OwnedImpl input(output);
+    input.addDrainTracker([&released]() { released = true; });
+    auto status = server_->dispatch(input);
+    EXPECT_TRUE(status.ok());
+    EXPECT_FALSE(released);
+    EXPECT_EQ(24 * 1024U, received.length());
+    received.drain(received.length());
+    EXPECT_TRUE(released);
+  }
+
+  request_body.add(std::string(24 * 1024, 'a'));
+  request_encoder_->encodeData(request_body, false);
+  const std::string output2 = client_output.toString();
+
+  // In a slice that a large read only partly filled, both payloads are copied.
+  {
+    bool released = false;
+    Buffer::OwnedImpl input;
+    Buffer::RawSlice iovec;
+    input.reserve(64 * 1024, &iovec, 1);
+    ASSERT_GE(iovec.len_, output2.size());
+    memcpy(iovec.mem_, output2.data(), output2.size());
+    iovec.len_ = output2.size();
+    input.commit(&iovec, 1);
+    input.addDrainTracker([&released]() { released = true; });
+    auto status = server_->dispatch(input);
+    EXPECT_TRUE(status.ok());
+    EXPECT_TRUE(released);
+    EXPECT_EQ(24 * 1024U, received.length());
+  }
+}
+
+// Verify that the size of header blocks before and after HPACK encoding is counted on both ends.
+TEST_P(Http2CodecImplTest, HeaderBytesStats) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  request_encoder_->encodeHeaders(request_headers, true);
+
+  const uint64_t header_bytes = request_headers.byteSize();
+  EXPECT_EQ(header_bytes, client_stats_store_.counter("http2.tx_header_bytes").value());
+  EXPECT_EQ(header_bytes, server_stats_store_.counter("http2.rx_header_bytes").value());
+  const uint64_t compressed_bytes =
+      client_stats_store_.counter("http2.tx_header_bytes_compressed").value();
+  EXPECT_GT(compressed_bytes, 0);
+  EXPECT_EQ(compressed_bytes,
+            server_stats_store_.counter("http2.rx_header_bytes_compressed").value());
+}
+
+// Verify that request IDs, which are unique to each request, are not added to the HPACK dynamic
+// table.
+TEST_P(Http2CodecImplTest, RequestIdNeverIndexed) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.setRequestId("8f5c4b1c-0b71-4a4d-8b3e-5e3f1b3d0001");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+  const size_t table_size = nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session());
+
+  MockResponseDecoder response_decoder;
+  RequestEncoder* request_encoder = &client_->newStream(response_decoder);
+  request_headers.setRequestId("8f5c4b1c-0b71-4a4d-8b3e-5e3f1b3d0002");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder->encodeHeaders(request_headers, false);
+  EXPECT_EQ(table_size, nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session()));
+}
+
+// Verify that tracing headers found through their inline handles are not added to the HPACK
+// dynamic table, while other headers still are.
+TEST_P(Http2CodecImplTest, TracingHeadersNeverIndexed) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("traceparent", "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01");
+  request_headers.addCopy("x-b3-traceid", "80f198ee56343ba864fe8b2a57d3eff7");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+  const size_t table_size = nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session());
+
+  MockResponseDecoder response_decoder;
+  RequestEncoder* request_encoder = &client_->newStream(response_decoder);
+  request_headers.setCopy(LowerCaseString("traceparent"),
+                          "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203332-01");
+  request_headers.setCopy(LowerCaseString("x-b3-traceid"), "80f198ee56343ba864fe8b2a57d3eff8");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder->encodeHeaders(request_headers, false);
+  EXPECT_EQ(table_size, nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session()));
+
+  request_encoder = &client_->newStream(response_decoder);
+  request_headers.addCopy("x-custom", "value");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder->encodeHeaders(request_headers, false);
+  EXPECT_LT(table_size, nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session()));
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
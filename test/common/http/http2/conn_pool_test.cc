@@ -587,6 +587,39 @@ TEST_F(Http2ConnPoolImplTest, MaxConcurrentRequestsPerStream) {
   EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
 }
 
+// Verifies that prefetching counts the streams that ready connections can still take.
+TEST_F(Http2ConnPoolImplTest, PrefetchCountsReadyCapacity) {
+  cluster_->http2_options_.mutable_max_concurrent_streams()->set_value(4);
+  ON_CALL(*cluster_, perUpstreamPrefetchRatio()).WillByDefault(Return(1.5));
+  pool_ = std::make_unique<TestConnPoolImpl>(dispatcher_, host_,
+                                             Upstream::ResourcePriority::Default, nullptr, nullptr);
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+
+  // 3 anticipated streams fit in the 2 active streams and the 2 more the connection can take.
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_EQ(1U, test_clients_.size());
+
+  // 4.5 anticipated streams don't fit in 3 active streams and 1 more.
+  expectClientCreate();
+  ActiveTestRequest r3(*this, 0, true);
+  EXPECT_EQ(2U, test_clients_.size());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetched_.value());
+
+  completeRequest(r1);
+  completeRequest(r2);
+  completeRequest(r3);
+
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 // Verifies that requests are queued up in the conn pool until the connection becomes ready.
 TEST_F(Http2ConnPoolImplTest, PendingRequests) {
   InSequence s;
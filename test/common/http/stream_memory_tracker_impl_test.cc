@@ -0,0 +1,85 @@
+#include <memory>
+#include <vector>
+
+#include "common/buffer/memory_account_impl.h"
+#include "common/http/stream_memory_tracker_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+TEST(StreamMemoryTrackerImplTest, ResetsLargestStreamsFirst) {
+  StreamMemoryTrackerImpl tracker;
+  auto parent = std::make_shared<Buffer::BufferMemoryAccountImpl>();
+  std::vector<int> resets;
+  std::vector<Buffer::StreamBufferMemoryAccountSharedPtr> accounts;
+  for (int i = 0; i < 4; i++) {
+    accounts.push_back(
+        tracker.createStreamAccount(parent, [&resets, i]() { resets.push_back(i); }));
+  }
+  EXPECT_EQ(4, tracker.numTrackedAccounts());
+  accounts[0]->charge(100);
+  accounts[1]->charge(400);
+  accounts[2]->charge(300);
+  accounts[3]->charge(10);
+  EXPECT_EQ(810, parent->balance());
+
+  EXPECT_EQ(700, tracker.resetLargestStreams(2, 50));
+  EXPECT_EQ(std::vector<int>({1, 2}), resets);
+  EXPECT_EQ(2, tracker.numTrackedAccounts());
+
+  // Streams are reset once, and only when they buffer at least the minimum.
+  resets.clear();
+  EXPECT_EQ(100, tracker.resetLargestStreams(10, 50));
+  EXPECT_EQ(std::vector<int>({0}), resets);
+  EXPECT_EQ(0, tracker.resetLargestStreams(10, 50));
+  EXPECT_EQ(1, tracker.numTrackedAccounts());
+}
+
+TEST(StreamMemoryTrackerImplTest, UntracksClearedAndDestroyedAccounts) {
+  StreamMemoryTrackerImpl tracker;
+  bool reset = false;
+  Buffer::StreamBufferMemoryAccountSharedPtr account1 =
+      tracker.createStreamAccount(nullptr, [&reset]() { reset = true; });
+  Buffer::StreamBufferMemoryAccountSharedPtr account2 =
+      tracker.createStreamAccount(nullptr, [&reset]() { reset = true; });
+  account1->charge(100);
+  account2->charge(100);
+
+  account1->clearResetCallback();
+  account2.reset();
+  EXPECT_EQ(0, tracker.numTrackedAccounts());
+  EXPECT_EQ(0, tracker.resetLargestStreams(10, 0));
+  EXPECT_FALSE(reset);
+  account1->credit(100);
+}
+
+TEST(StreamMemoryTrackerImplTest, ResetMayEndOtherStreams) {
+  StreamMemoryTrackerImpl tracker;
+  Buffer::StreamBufferMemoryAccountSharedPtr account2;
+  Buffer::StreamBufferMemoryAccountSharedPtr account1 =
+      tracker.createStreamAccount(nullptr, [&account2]() { account2.reset(); });
+  account2 = tracker.createStreamAccount(nullptr, []() { FAIL(); });
+  account1->charge(200);
+  account2->charge(100);
+
+  EXPECT_EQ(200, tracker.resetLargestStreams(10, 0));
+  EXPECT_EQ(nullptr, account2);
+}
+
+TEST(StreamMemoryTrackerImplTest, AccountsOutliveTracker) {
+  Buffer::StreamBufferMemoryAccountSharedPtr account;
+  {
+    StreamMemoryTrackerImpl tracker;
+    account = tracker.createStreamAccount(nullptr, []() {});
+  }
+  account->charge(10);
+  account->clearResetCallback();
+  EXPECT_EQ(10, account->balance());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,115 @@
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/io/io_uring.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    ring_ = IoUring::create(4);
+    // io_uring is optional: without it there is nothing to test beyond create() failing cleanly.
+    EXPECT_EQ(IoUring::isSupported(), ring_ != nullptr);
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds_).rc_);
+  }
+
+  void TearDown() override {
+    os_sys_calls_.close(fds_[0]);
+    os_sys_calls_.close(fds_[1]);
+  }
+
+  // Waits for and returns the next completions.
+  std::vector<std::pair<uint64_t, int32_t>> waitForCompletions(uint32_t count) {
+    std::vector<std::pair<uint64_t, int32_t>> completions;
+    while (completions.size() < count) {
+      EXPECT_GE(ring_->submit(1), 0);
+      ring_->forEveryCompletion([&completions](uint64_t user_data, int32_t result) {
+        completions.emplace_back(user_data, result);
+      });
+    }
+    return completions;
+  }
+
+protected:
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  IoUringPtr ring_;
+  os_fd_t fds_[2];
+};
+
+TEST_F(IoUringTest, ReadAndWrite) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char write_data[] = "hello";
+  const iovec write_iov{write_data, 5};
+  EXPECT_TRUE(ring_->prepareWritev(fds_[0], &write_iov, 1, 1));
+  EXPECT_EQ(1, ring_->pendingSubmissions());
+  EXPECT_EQ(1, ring_->submit());
+  EXPECT_EQ(0, ring_->pendingSubmissions());
+  auto completions = waitForCompletions(1);
+  EXPECT_EQ(1, completions[0].first);
+  EXPECT_EQ(5, completions[0].second);
+
+  char read_data[16];
+  const iovec read_iov{read_data, sizeof(read_data)};
+  EXPECT_TRUE(ring_->prepareReadv(fds_[1], &read_iov, 1, 2));
+  completions = waitForCompletions(1);
+  EXPECT_EQ(2, completions[0].first);
+  EXPECT_EQ(5, completions[0].second);
+  EXPECT_EQ(0, memcmp(read_data, "hello", 5));
+
+  // Completions were signalled on the eventfd.
+  uint64_t value = 0;
+  const iovec value_iov{&value, sizeof(value)};
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(value)),
+            os_sys_calls_.readv(ring_->eventFd(), &value_iov, 1).rc_);
+  EXPECT_GT(value, 0);
+}
+
+TEST_F(IoUringTest, CancelPendingRead) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char read_data[16];
+  const iovec read_iov{read_data, sizeof(read_data)};
+  EXPECT_TRUE(ring_->prepareReadv(fds_[1], &read_iov, 1, 1));
+  EXPECT_EQ(1, ring_->submit());
+  EXPECT_TRUE(ring_->prepareCancel(1, 2));
+  auto completions = waitForCompletions(2);
+  std::sort(completions.begin(), completions.end());
+  EXPECT_EQ(1, completions[0].first);
+  EXPECT_EQ(-ECANCELED, completions[0].second);
+  EXPECT_EQ(2, completions[1].first);
+  EXPECT_EQ(0, completions[1].second);
+}
+
+TEST_F(IoUringTest, FullSubmissionQueue) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char write_data[] = "x";
+  const iovec write_iov{write_data, 1};
+  uint32_t prepared = 0;
+  while (ring_->prepareWritev(fds_[0], &write_iov, 1, prepared)) {
+    prepared++;
+  }
+  EXPECT_EQ(4, prepared);
+  EXPECT_EQ(4, ring_->submit());
+  EXPECT_EQ(4, waitForCompletions(4).size());
+  EXPECT_TRUE(ring_->prepareWritev(fds_[0], &write_iov, 1, prepared));
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
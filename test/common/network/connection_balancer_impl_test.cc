@@ -0,0 +1,91 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class LoadAwareConnectionBalancerImplTest : public testing::Test {
+public:
+  LoadAwareConnectionBalancerImplTest() : balancer_(random_) {
+    for (auto& handler : handlers_) {
+      balancer_.registerHandler(handler);
+    }
+  }
+
+  // Sets the load of a handler.
+  void setLoad(uint32_t index, double utilization, uint64_t connections) {
+    ON_CALL(handlers_[index], loopUtilization()).WillByDefault(Return(utilization));
+    ON_CALL(handlers_[index], numConnections()).WillByDefault(Return(connections));
+  }
+
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<MockBalancedConnectionHandler> handlers_[3];
+  LoadAwareConnectionBalancerImpl balancer_;
+};
+
+// A connection moves to the randomly picked handler if its loop is noticeably less busy, even if it
+// has more connections.
+TEST_F(LoadAwareConnectionBalancerImplTest, PrefersLessBusyLoop) {
+  setLoad(0, 0.9, 10);
+  setLoad(1, 0.2, 100);
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(handlers_[0], incNumConnections()).Times(0);
+  EXPECT_CALL(handlers_[1], incNumConnections());
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[0]));
+
+  // The other way around, it stays.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
+  EXPECT_CALL(handlers_[1], incNumConnections());
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[1]));
+}
+
+// Handlers about as busy are compared by connection count.
+TEST_F(LoadAwareConnectionBalancerImplTest, ComparesConnectionsWithinTolerance) {
+  setLoad(0, 0.5, 10);
+  setLoad(1, 0.5 + LoadAwareConnectionBalancerImpl::UtilizationTolerance / 2, 5);
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(handlers_[1], incNumConnections());
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[0]));
+
+  // Ties stay on the current handler.
+  setLoad(1, 0.5, 10);
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(handlers_[0], incNumConnections());
+  EXPECT_EQ(&handlers_[0], &balancer_.pickTargetHandler(handlers_[0]));
+}
+
+// Picking the current handler at random compares it with the last one instead.
+TEST_F(LoadAwareConnectionBalancerImplTest, PickedSelf) {
+  setLoad(1, 0.9, 10);
+  setLoad(2, 0.1, 10);
+  EXPECT_CALL(random_, random()).WillOnce(Return(3));
+  EXPECT_CALL(handlers_[2], incNumConnections());
+  EXPECT_EQ(&handlers_[2], &balancer_.pickTargetHandler(handlers_[1]));
+}
+
+// Unregistered handlers are no longer picked, and a single handler keeps all connections.
+TEST_F(LoadAwareConnectionBalancerImplTest, Unregister) {
+  setLoad(0, 1, 100);
+  balancer_.unregisterHandler(handlers_[1]);
+  balancer_.unregisterHandler(handlers_[2]);
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_CALL(handlers_[0], incNumConnections());
+  EXPECT_EQ(&handlers_[0], &balancer_.pickTargetHandler(handlers_[0]));
+
+  balancer_.unregisterHandler(handlers_[0]);
+  EXPECT_CALL(handlers_[0], incNumConnections());
+  EXPECT_EQ(&handlers_[0], &balancer_.pickTargetHandler(handlers_[0]));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
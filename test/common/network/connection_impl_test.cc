@@ -32,6 +32,7 @@
 
 using testing::_;
 using testing::AnyNumber;
+using testing::AtLeast;
 using testing::DoAll;
 using testing::Eq;
 using testing::InSequence;
@@ -76,6 +77,68 @@ TEST(ConnectionImplUtility, updateBufferStats) {
   ConnectionImplUtility::updateBufferStats(3, 3, previous_total, counter, gauge);
 }
 
+TEST(AdaptiveReadSize, GrowsToFitBytesRead) {
+  AdaptiveReadSize read_size;
+  EXPECT_EQ(AdaptiveReadSize::MinReadSize, read_size.readSize());
+
+  // Reads that don't fill the read size leave it alone.
+  read_size.onRead(3000);
+  EXPECT_EQ(4096, read_size.readSize());
+
+  // Filling it at least doubles it, and larger reads jump to the next power of two above them.
+  read_size.onRead(4096);
+  EXPECT_EQ(8192, read_size.readSize());
+  read_size.onRead(20000);
+  EXPECT_EQ(32768, read_size.readSize());
+  read_size.onRead(1024 * 1024);
+  EXPECT_EQ(AdaptiveReadSize::MaxReadSize, read_size.readSize());
+}
+
+TEST(AdaptiveReadSize, ShrinksAfterSmallReads) {
+  AdaptiveReadSize read_size;
+  read_size.onRead(16384);
+  EXPECT_EQ(32768, read_size.readSize());
+
+  for (uint32_t i = 1; i < AdaptiveReadSize::ShrinkAfterReads; i++) {
+    read_size.onRead(100);
+    EXPECT_EQ(32768, read_size.readSize());
+  }
+  read_size.onRead(100);
+  EXPECT_EQ(16384, read_size.readSize());
+
+  // A read using at least half of the read size starts the count over.
+  for (uint32_t i = 1; i < AdaptiveReadSize::ShrinkAfterReads; i++) {
+    read_size.onRead(100);
+  }
+  read_size.onRead(8192);
+  read_size.onRead(100);
+  EXPECT_EQ(16384, read_size.readSize());
+
+  for (uint32_t i = 0; i < 10 * AdaptiveReadSize::ShrinkAfterReads; i++) {
+    read_size.onRead(0);
+  }
+  EXPECT_EQ(AdaptiveReadSize::MinReadSize, read_size.readSize());
+}
+
+TEST(AdaptiveReadSize, Limit) {
+  AdaptiveReadSize read_size;
+  read_size.onRead(AdaptiveReadSize::MaxReadSize);
+  EXPECT_EQ(AdaptiveReadSize::MaxReadSize, read_size.readSize());
+
+  read_size.setLimit(10000);
+  EXPECT_EQ(10000, read_size.readSize());
+  read_size.onRead(1024 * 1024);
+  EXPECT_EQ(10000, read_size.readSize());
+
+  // The read size never goes below a page.
+  read_size.setLimit(1024);
+  EXPECT_EQ(AdaptiveReadSize::MinReadSize, read_size.readSize());
+
+  read_size.setLimit(0);
+  read_size.onRead(1024 * 1024);
+  EXPECT_EQ(AdaptiveReadSize::MaxReadSize, read_size.readSize());
+}
+
 class ConnectionImplDeathTest : public testing::TestWithParam<Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, ConnectionImplDeathTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -409,8 +472,9 @@ TEST_P(ConnectionImplTest, SocketOptionsFailureTest) {
 
 struct MockConnectionStats {
   Connection::ConnectionStats toBufferStats() {
-    return {rx_total_,   rx_current_,   tx_total_,
-            tx_current_, &bind_errors_, &delayed_close_timeouts_};
+    return {rx_total_,    rx_current_,   tx_total_,
+            tx_current_,  &bind_errors_, &delayed_close_timeouts_,
+            &read_size_};
   }
 
   StrictMock<Stats::MockCounter> rx_total_;
@@ -419,12 +483,14 @@ struct MockConnectionStats {
   StrictMock<Stats::MockGauge> tx_current_;
   StrictMock<Stats::MockCounter> bind_errors_;
   StrictMock<Stats::MockCounter> delayed_close_timeouts_;
+  NiceMock<Stats::MockHistogram> read_size_;
 };
 
 struct NiceMockConnectionStats {
   Connection::ConnectionStats toBufferStats() {
-    return {rx_total_,   rx_current_,   tx_total_,
-            tx_current_, &bind_errors_, &delayed_close_timeouts_};
+    return {rx_total_,    rx_current_,   tx_total_,
+            tx_current_,  &bind_errors_, &delayed_close_timeouts_,
+            &read_size_};
   }
 
   NiceMock<Stats::MockCounter> rx_total_;
@@ -433,6 +499,7 @@ struct NiceMockConnectionStats {
   NiceMock<Stats::MockGauge> tx_current_;
   NiceMock<Stats::MockCounter> bind_errors_;
   NiceMock<Stats::MockCounter> delayed_close_timeouts_;
+  NiceMock<Stats::MockHistogram> read_size_;
 };
 
 TEST_P(ConnectionImplTest, ConnectionStats) {
@@ -473,6 +540,9 @@ TEST_P(ConnectionImplTest, ConnectionStats) {
   EXPECT_CALL(server_connection_stats.rx_current_, add(4)).InSequence(s2);
   EXPECT_CALL(server_connection_stats.rx_current_, sub(4)).InSequence(s2);
   EXPECT_CALL(server_callbacks_, onEvent(ConnectionEvent::LocalClose)).InSequence(s2);
+  // A fresh connection starts with the smallest read size.
+  EXPECT_CALL(server_connection_stats.read_size_, recordValue(AdaptiveReadSize::MinReadSize))
+      .Times(AtLeast(1));
 
   EXPECT_CALL(*read_filter_, onNewConnection());
   EXPECT_CALL(*read_filter_, onData(_, _))
@@ -2199,9 +2269,9 @@ TEST_P(ReadBufferLimitTest, NoLimit) { readBufferLimitTest(0, 256 * 1024); }
 TEST_P(ReadBufferLimitTest, SomeLimit) {
   const uint32_t read_buffer_limit = 32 * 1024;
   // Envoy has soft limits, so as long as the first read is <= read_buffer_limit - 1 it will do a
-  // second read. The effective chunk size is then read_buffer_limit - 1 + MaxReadSize,
-  // which is currently 16384.
-  readBufferLimitTest(read_buffer_limit, read_buffer_limit - 1 + 16384);
+  // second read. The effective chunk size is then read_buffer_limit - 1 + the read size, which is
+  // capped at read_buffer_limit.
+  readBufferLimitTest(read_buffer_limit, 2 * read_buffer_limit - 1);
 }
 
 class TcpClientConnectionImplTest : public testing::TestWithParam<Address::IpVersion> {
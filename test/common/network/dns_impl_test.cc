@@ -282,6 +282,7 @@ public:
   }
 
   void onReject() override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+  void onAcceptBatch(uint32_t) override {}
 
   void addHosts(const std::string& hostname, const IpList& ip, const RecordType& type) {
     if (type == RecordType::A) {
@@ -0,0 +1,225 @@
+#include <sys/socket.h>
+
+#include <string>
+
+#include "envoy/event/file_event.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+public:
+  IoUringSocketHandleImplTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void SetUp() override {
+    worker_ = static_cast<Event::DispatcherImpl*>(dispatcher_.get())->ioUringWorker();
+    // Without io_uring the dispatcher has no worker, and accepted sockets keep using libevent.
+    EXPECT_EQ(Io::IoUring::isSupported(), worker_ != nullptr);
+    if (worker_ == nullptr) {
+      return;
+    }
+    os_fd_t fds[2];
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_);
+    ASSERT_EQ(0, os_sys_calls_.setsocketblocking(fds[0], false).rc_);
+    ASSERT_EQ(0, os_sys_calls_.setsocketblocking(fds[1], false).rc_);
+    handle_ = std::make_unique<IoUringSocketHandleImpl>(fds[0], *worker_);
+    peer_ = std::make_unique<IoSocketHandleImpl>(fds[1]);
+    file_event_ = handle_->createFileEvent(
+        *dispatcher_, [this](uint32_t events) { events_ |= events; }, Event::FileTriggerType::Edge,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
+
+  // Runs the event loop until the handle is ready for the events.
+  void runUntil(uint32_t events) {
+    while ((events_ & events) != events) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  IoUringWorker* worker_{};
+  std::unique_ptr<IoUringSocketHandleImpl> handle_;
+  IoHandlePtr peer_;
+  Event::FileEventPtr file_event_;
+  uint32_t events_{};
+};
+
+TEST_F(IoUringSocketHandleImplTest, Read) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  EXPECT_TRUE(handle_->ioUringActive());
+  runUntil(Event::FileReadyType::Write);
+  EXPECT_EQ(Event::FileReadyType::Write, events_);
+
+  Buffer::OwnedImpl buffer;
+  Api::IoCallUint64Result result = buffer.read(*handle_, 1024);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_EQ(5, data.write(*peer_).rc_);
+  events_ = 0;
+  runUntil(Event::FileReadyType::Read);
+  result = buffer.read(*handle_, 3);
+  EXPECT_EQ(3, result.rc_);
+  result = buffer.read(*handle_, 1024);
+  EXPECT_EQ(2, result.rc_);
+  EXPECT_EQ("hello", buffer.toString());
+  result = buffer.read(*handle_, 1024);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  // End of stream is reported as readable, and as closed to those only watching for that.
+  peer_->shutdown(ENVOY_SHUT_WR);
+  events_ = 0;
+  runUntil(Event::FileReadyType::Read);
+  result = buffer.read(*handle_, 1024);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.rc_);
+  events_ = 0;
+  file_event_->setEnabled(Event::FileReadyType::Closed);
+  runUntil(Event::FileReadyType::Closed);
+  EXPECT_EQ(Event::FileReadyType::Closed, events_);
+}
+
+TEST_F(IoUringSocketHandleImplTest, Write) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  const std::string data(4 * IoUringSocketHandleImpl::WriteSize + 1, 'a');
+  Buffer::OwnedImpl buffer(data);
+  std::string received;
+  uint32_t writes = 0;
+  while (buffer.length() > 0) {
+    Api::IoCallUint64Result result = buffer.write(*handle_);
+    if (result.ok()) {
+      // Each write takes what fits in the handle's buffer, and the next one has to wait.
+      EXPECT_LE(result.rc_, IoUringSocketHandleImpl::WriteSize);
+      writes++;
+      continue;
+    }
+    EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+    Buffer::OwnedImpl peer_buffer;
+    while (peer_buffer.read(*peer_, 65536).rc_ > 0) {
+    }
+    received.append(peer_buffer.toString());
+    events_ = 0;
+    runUntil(Event::FileReadyType::Write);
+  }
+  EXPECT_EQ(5, writes);
+
+  // Shutting down waits for the pending write.
+  EXPECT_EQ(0, handle_->shutdown(ENVOY_SHUT_WR).rc_);
+  while (true) {
+    Buffer::OwnedImpl peer_buffer;
+    Api::IoCallUint64Result result = peer_buffer.read(*peer_, 65536);
+    received.append(peer_buffer.toString());
+    if (result.ok() && result.rc_ == 0) {
+      break;
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(data, received);
+}
+
+// readv() and writev() copy between the caller's slices and the handle's requests.
+TEST_F(IoUringSocketHandleImplTest, ReadvAndWritev) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  std::string hello("hello");
+  Buffer::RawSlice write_slice{hello.data(), hello.size()};
+  EXPECT_EQ(5, handle_->writev(&write_slice, 1).rc_);
+  hello = "xxxxx";
+  std::string received;
+  while (received.size() < 5) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    Buffer::OwnedImpl peer_buffer;
+    peer_buffer.read(*peer_, 1024);
+    received.append(peer_buffer.toString());
+  }
+  EXPECT_EQ("hello", received);
+
+  Buffer::OwnedImpl data("world");
+  EXPECT_EQ(5, data.write(*peer_).rc_);
+  events_ = 0;
+  runUntil(Event::FileReadyType::Read);
+  char first[2];
+  char second[8];
+  Buffer::RawSlice read_slices[2] = {{first, sizeof(first)}, {second, sizeof(second)}};
+  Api::IoCallUint64Result result = handle_->readv(1024, read_slices, 2);
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ("wo", std::string(first, 2));
+  EXPECT_EQ("rld", std::string(second, 3));
+  result = handle_->readv(1024, read_slices, 2);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ActivateAndSetEnabled) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  file_event_->setEnabled(0);
+  file_event_->activate(Event::FileReadyType::Read);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(Event::FileReadyType::Read, events_);
+
+  // Enabling reports what the handle is ready for right away.
+  events_ = 0;
+  file_event_->setEnabled(Event::FileReadyType::Write);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(Event::FileReadyType::Write, events_);
+}
+
+TEST_F(IoUringSocketHandleImplTest, CloseWithPendingOperations) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  Buffer::OwnedImpl buffer(std::string(IoUringSocketHandleImpl::WriteSize, 'a'));
+  EXPECT_EQ(IoUringSocketHandleImpl::WriteSize, buffer.write(*handle_).rc_);
+  // The read is cancelled, while the write still reaches the peer.
+  file_event_.reset();
+  handle_->close();
+  EXPECT_FALSE(handle_->isOpen());
+  uint64_t received = 0;
+  while (true) {
+    Buffer::OwnedImpl peer_buffer;
+    Api::IoCallUint64Result result = peer_buffer.read(*peer_, 65536);
+    received += result.rc_;
+    if (result.ok() && result.rc_ == 0) {
+      break;
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(IoUringSocketHandleImpl::WriteSize, received);
+}
+
+TEST_F(IoUringSocketHandleImplTest, LevelTriggeredFileEventsUseTheFd) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  os_fd_t fds[2];
+  ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_);
+  IoUringSocketHandleImpl handle(fds[0], *worker_);
+  IoSocketHandleImpl peer(fds[1]);
+  Event::FileEventPtr file_event = handle.createFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Level, Event::FileReadyType::Read);
+  EXPECT_FALSE(handle.ioUringActive());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
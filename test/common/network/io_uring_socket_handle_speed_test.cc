@@ -0,0 +1,180 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares a request/response round trip through an echo server running on a dispatcher, whose
+// socket is either read and written after epoll readiness (first arg 0) or through io_uring
+// (first arg 1), for requests of the size of the second arg. The wakeups counter is the number of
+// times the dispatcher thread blocked per request. The syscalls counter is the number of readv(2),
+// writev(2) and io_uring_enter(2) calls the dispatcher thread made per request, and
+// bytes_per_syscall how many bytes it echoed per such call; neither counts epoll_wait(2), which
+// wakeups approximates.
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/thread.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/threadsafe_singleton_injector.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+class EchoServer {
+public:
+  EchoServer(Event::Dispatcher& dispatcher, IoHandlePtr&& handle) : handle_(std::move(handle)) {
+    file_event_ = handle_->createFileEvent(
+        dispatcher, [this](uint32_t events) { onEvents(events); }, Event::FileTriggerType::Edge,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
+
+private:
+  void onEvents(uint32_t events) {
+    if (events & Event::FileReadyType::Read) {
+      while (buffer_.read(*handle_, 16384).rc_ > 0) {
+      }
+    }
+    while (buffer_.length() > 0 && buffer_.write(*handle_).ok()) {
+    }
+  }
+
+  IoHandlePtr handle_;
+  Event::FileEventPtr file_event_;
+  Buffer::OwnedImpl buffer_;
+};
+
+// Counts the readv(2) and writev(2) calls of one thread.
+class CountingOsSysCalls : public Api::OsSysCallsImpl {
+public:
+  Api::SysCallSizeResult readv(os_fd_t fd, const iovec* iov, int num_iov) override {
+    countCall();
+    return Api::OsSysCallsImpl::readv(fd, iov, num_iov);
+  }
+  Api::SysCallSizeResult writev(os_fd_t fd, const iovec* iov, int num_iov) override {
+    countCall();
+    return Api::OsSysCallsImpl::writev(fd, iov, num_iov);
+  }
+
+  // Start counting the calls of the current thread.
+  void countCurrentThread() { thread_id_ = std::this_thread::get_id(); }
+
+  uint64_t calls() const { return calls_; }
+
+private:
+  void countCall() {
+    if (std::this_thread::get_id() == thread_id_) {
+      calls_++;
+    }
+  }
+
+  std::atomic<std::thread::id> thread_id_{};
+  uint64_t calls_{};
+};
+
+int64_t voluntaryContextSwitches() {
+  struct rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_nvcsw;
+}
+
+} // namespace
+
+static void BM_EchoRoundTrip(benchmark::State& state) {
+  const bool use_io_uring = state.range(0) != 0;
+  const uint32_t request_size = state.range(1);
+  if (!Event::Libevent::Global::initialized()) {
+    Event::Libevent::Global::initialize();
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  IoUringWorker* worker = static_cast<Event::DispatcherImpl*>(dispatcher.get())->ioUringWorker();
+  if (use_io_uring && worker == nullptr) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+
+  CountingOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  os_fd_t fds[2];
+  RELEASE_ASSERT(os_sys_calls.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_ == 0, "");
+  os_sys_calls.setsocketblocking(fds[0], false);
+  IoHandlePtr server_handle;
+  if (use_io_uring) {
+    server_handle = std::make_unique<IoUringSocketHandleImpl>(fds[0], *worker);
+  } else {
+    server_handle = std::make_unique<IoSocketHandleImpl>(fds[0]);
+  }
+  auto server = std::make_unique<EchoServer>(*dispatcher, std::move(server_handle));
+  IoSocketHandleImpl client(fds[1]);
+
+  int64_t context_switches = 0;
+  uint64_t syscalls = 0;
+  dispatcher->post([&]() {
+    context_switches = voluntaryContextSwitches();
+    os_sys_calls.countCurrentThread();
+    syscalls = use_io_uring ? worker->ring().enterCalls() : 0;
+  });
+  Thread::ThreadPtr dispatcher_thread = api->threadFactory().createThread(
+      [&dispatcher]() { dispatcher->run(Event::Dispatcher::RunType::RunUntilExit); });
+
+  const std::string request(request_size, 'a');
+  std::vector<double> latencies_us;
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    Buffer::OwnedImpl buffer(request);
+    while (buffer.length() > 0) {
+      buffer.write(client);
+    }
+    uint64_t received = 0;
+    while (received < request_size) {
+      received += buffer.read(client, request_size - received).rc_;
+    }
+    latencies_us.push_back(std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  }
+
+  dispatcher->post([&]() {
+    context_switches = voluntaryContextSwitches() - context_switches;
+    syscalls = os_sys_calls.calls() + (use_io_uring ? worker->ring().enterCalls() : 0) - syscalls;
+    dispatcher->exit();
+  });
+  dispatcher_thread->join();
+  server.reset();
+  dispatcher.reset();
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  state.counters["p50_us"] = latencies_us[latencies_us.size() / 2];
+  state.counters["p99_us"] = latencies_us[latencies_us.size() * 99 / 100];
+  state.counters["wakeups"] = static_cast<double>(context_switches) / latencies_us.size();
+  state.counters["syscalls"] = static_cast<double>(syscalls) / latencies_us.size();
+  state.counters["bytes_per_syscall"] =
+      2.0 * request_size * latencies_us.size() / std::max<uint64_t>(syscalls, 1);
+}
+BENCHMARK(BM_EchoRoundTrip)
+    ->Args({0, 128})
+    ->Args({1, 128})
+    ->Args({0, 64 * 1024})
+    ->Args({1, 64 * 1024})
+    ->UseRealTime();
+
+} // namespace Network
+} // namespace Envoy
@@ -1,23 +1,31 @@
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/network/exception.h"
 
+#include "common/common/utility.h"
+#include "common/io/io_uring.h"
 #include "common/network/address_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/utility.h"
 
 #include "test/common/network/listener_impl_test_base.h"
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::InSequence;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 
 namespace Envoy {
@@ -107,6 +115,39 @@ TEST_P(ListenerImplTest, SetListeningSocketOptionsError) {
                                         socket->localAddress()->asString()));
 }
 
+// Test that the listener puts its socket in the listening state.
+TEST_P(ListenerImplTest, ListensOnSocket) {
+  Network::MockListenerCallbacks listener_callbacks;
+
+  auto socket = std::make_shared<TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  int accepting = 0;
+  socklen_t len = sizeof(accepting);
+  ASSERT_EQ(0, socket->getSocketOption(SOL_SOCKET, SO_ACCEPTCONN, &accepting, &len).rc_);
+  EXPECT_EQ(0, accepting);
+
+  TestListenerImpl listener(dispatcherImpl(), socket, listener_callbacks, true);
+  ASSERT_EQ(0, socket->getSocketOption(SOL_SOCKET, SO_ACCEPTCONN, &accepting, &len).rc_);
+  EXPECT_EQ(1, accepting);
+}
+
+// Test that an exception is thrown if the socket can't listen.
+TEST_P(ListenerImplTest, ListenError) {
+  Network::MockListenerCallbacks listener_callbacks;
+
+  auto socket = std::make_shared<TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, listen(socket->ioHandle().fd(), SOMAXCONN))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_NOT_SUP}));
+  EXPECT_THROW_WITH_MESSAGE(TestListenerImpl(dispatcherImpl(), socket, listener_callbacks, true),
+                            CreateListenerException,
+                            fmt::format("cannot listen() on socket: {}: {}",
+                                        socket->localAddress()->asString(),
+                                        errorDetails(SOCKET_ERROR_NOT_SUP)));
+}
+
 TEST_P(ListenerImplTest, UseActualDst) {
   auto socket = std::make_shared<TcpListenSocket>(
       Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
@@ -206,6 +247,113 @@ TEST_P(ListenerImplTest, GlobalConnectionLimitEnforcement) {
       {{"overload.global_downstream_max_connections", ""}});
 }
 
+// Each wakeup accepts up to listener.max_accepts_per_wakeup connections, and the listener picks up
+// the remaining ones on the next iterations of the event loop.
+TEST_P(ListenerImplTest, AcceptBatches) {
+  // Required to manipulate runtime values when there is no test server.
+  TestScopedRuntime scoped_runtime;
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues({{"listener.max_accepts_per_wakeup", "2"}});
+  auto socket = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, listener_callbacks, true);
+
+  std::vector<Network::ClientConnectionPtr> client_connections;
+  for (int i = 0; i < 5; ++i) {
+    client_connections.emplace_back(dispatcher_->createClientConnection(
+        socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
+        Network::Test::createRawBufferSocket(), nullptr));
+    client_connections.back()->connect();
+  }
+
+  std::vector<Network::ConnectionSocketPtr> accepted_sockets;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .Times(5)
+      .WillRepeatedly(Invoke([&](Network::ConnectionSocketPtr& accepted_socket) -> void {
+        accepted_sockets.push_back(std::move(accepted_socket));
+      }));
+  {
+    InSequence s;
+    EXPECT_CALL(listener_callbacks, onAcceptBatch(2)).Times(2);
+    EXPECT_CALL(listener_callbacks, onAcceptBatch(1));
+  }
+  while (accepted_sockets.size() < 5) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  // A disabled listener leaves new connections pending until it is enabled again.
+  listener->disable();
+  client_connections.emplace_back(dispatcher_->createClientConnection(
+      socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      Network::Test::createRawBufferSocket(), nullptr));
+  client_connections.back()->connect();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(5, accepted_sockets.size());
+
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& accepted_socket) -> void {
+        accepted_sockets.push_back(std::move(accepted_socket));
+      }));
+  EXPECT_CALL(listener_callbacks, onAcceptBatch(1));
+  listener->enable();
+  while (accepted_sockets.size() < 6) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  for (const auto& conn : client_connections) {
+    conn->close(ConnectionCloseType::NoFlush);
+  }
+}
+
+TEST_P(ListenerImplTest, IoUringDownstreamConnections) {
+  // Required to manipulate runtime values when there is no test server.
+  TestScopedRuntime scoped_runtime;
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.io_uring_downstream_connections", "true"}});
+  auto socket = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, listener_callbacks, true);
+
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      Network::Test::createRawBufferSocket(), nullptr);
+  auto client_read_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+
+  Network::ConnectionPtr server_connection;
+  auto server_read_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  StreamInfo::StreamInfoImpl stream_info(dispatcher_->timeSource());
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& accepted_socket) -> void {
+        // Without io_uring, accepted sockets keep using libevent.
+        EXPECT_EQ(Io::IoUring::isSupported(),
+                  dynamic_cast<IoUringSocketHandleImpl*>(&accepted_socket->ioHandle()) != nullptr);
+        server_connection = dispatcher_->createServerConnection(
+            std::move(accepted_socket), Network::Test::createRawBufferSocket(), stream_info);
+        server_connection->addReadFilter(server_read_filter);
+        Buffer::OwnedImpl data("hello");
+        client_connection->write(data, false);
+      }));
+  EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> FilterStatus {
+        server_connection->write(data, false);
+        return FilterStatus::StopIteration;
+      }));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> FilterStatus {
+        client_connection->close(ConnectionCloseType::NoFlush);
+        server_connection->close(ConnectionCloseType::NoFlush);
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
 TEST_P(ListenerImplTest, WildcardListenerUseActualDst) {
   auto socket =
       std::make_shared<TcpListenSocket>(Network::Test::getAnyAddress(version_), nullptr, true);
@@ -57,6 +57,7 @@ using testing::Matcher;
 using testing::MockFunction;
 using testing::NiceMock;
 using testing::Property;
+using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
 using testing::StartsWith;
@@ -1617,6 +1618,131 @@ TEST_F(RouterTest, TimeoutBudgetHistogramStat) {
   response_decoder->decodeData(data, true);
 }
 
+// Verify the response time of a request is reported to its cluster when it uses the peak EWMA LB.
+TEST_F(RouterTest, PeakEwmaResponseTime) {
+  ON_CALL(*cm_.thread_local_cluster_.cluster_.info_, lbType())
+      .WillByDefault(Return(Upstream::LoadBalancerType::PeakEwma));
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.advanceTimeWait(std::chrono::microseconds(2500));
+  EXPECT_CALL(*cm_.thread_local_cluster_.response_time_observer_,
+              onHostResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(2500)));
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+}
+
+// Verify the response time reported to a peak EWMA cluster starts when the request is sent
+// upstream, not when the downstream request completed.
+TEST_F(RouterTest, PeakEwmaResponseTimeExcludesConnect) {
+  ON_CALL(*cm_.thread_local_cluster_.cluster_.info_, lbType())
+      .WillByDefault(Return(Upstream::LoadBalancerType::PeakEwma));
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  Http::ConnectionPool::Callbacks* pool_callbacks = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            pool_callbacks = &callbacks;
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.advanceTimeWait(std::chrono::microseconds(1000));
+  pool_callbacks->onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+
+  test_time_.advanceTimeWait(std::chrono::microseconds(2500));
+  EXPECT_CALL(*cm_.thread_local_cluster_.response_time_observer_,
+              onHostResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(2500)));
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+}
+
+// Verify a try that times out is reported to a peak EWMA cluster with the time it took.
+TEST_F(RouterTest, PeakEwmaResponseTimePerTryTimeout) {
+  ON_CALL(*cm_.thread_local_cluster_.cluster_.info_, lbType())
+      .WillByDefault(Return(Upstream::LoadBalancerType::PeakEwma));
+  NiceMock<Http::MockRequestEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder&,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            callbacks.onPoolReady(encoder, cm_.conn_pool_.host_, upstream_stream_info_);
+            return nullptr;
+          }));
+  expectPerTryTimerCreate();
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers{{"x-envoy-upstream-rq-per-try-timeout-ms", "5"}};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.advanceTimeWait(std::chrono::milliseconds(5));
+  EXPECT_CALL(*cm_.thread_local_cluster_.response_time_observer_,
+              onHostResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(5000)));
+  EXPECT_CALL(encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  per_try_timeout_->invokeCallback();
+}
+
+// Verify a try that is reset is reported to a peak EWMA cluster with the time it took, and a
+// connection failure is not reported at all.
+TEST_F(RouterTest, PeakEwmaResponseTimeUpstreamReset) {
+  ON_CALL(*cm_.thread_local_cluster_.cluster_.info_, lbType())
+      .WillByDefault(Return(Upstream::LoadBalancerType::PeakEwma));
+  NiceMock<Http::MockRequestEncoder> encoder1;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder&,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_, upstream_stream_info_);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers{{"x-envoy-retry-on", "5xx"}};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.advanceTimeWait(std::chrono::microseconds(1500));
+  EXPECT_CALL(*cm_.thread_local_cluster_.response_time_observer_,
+              onHostResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(1500)));
+  router_.retry_state_->expectResetRetry();
+  encoder1.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure,
+                                absl::string_view(), cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  EXPECT_CALL(*cm_.thread_local_cluster_.response_time_observer_, onHostResponseTime(_, _))
+      .Times(0);
+  EXPECT_CALL(*router_.retry_state_, shouldRetryReset(_, _)).WillOnce(Return(RetryStatus::No));
+  router_.retry_state_->callback_();
+}
+
 // Verify the timeout budget histograms are filled out correctly when using a
 // global and per-try timeout in a failed request.
 TEST_F(RouterTest, TimeoutBudgetHistogramStatFailure) {
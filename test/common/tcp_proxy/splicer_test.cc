@@ -0,0 +1,258 @@
+#include "common/api/os_sys_calls_impl.h"
+#include "common/tcp_proxy/splicer.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+// The splicer is only available on Linux.
+#if defined(__linux__)
+
+class MockSplicerCallbacks : public Splicer::Callbacks {
+public:
+  MOCK_METHOD(void, onSplicedData, (Splicer::Direction direction, uint64_t bytes));
+  MOCK_METHOD(void, onSpliceReadDisable, (Splicer::Direction direction, bool disable));
+  MOCK_METHOD(void, onSpliceEndStream, (Splicer::Direction direction));
+  MOCK_METHOD(void, onSpliceError, (Splicer::Direction direction, int error));
+};
+
+// The descriptors below are never used for real: every system call on them is mocked.
+constexpr int DownstreamFd = 10;
+constexpr int UpstreamFd = 11;
+constexpr int DownstreamDupFd = 20;
+constexpr int UpstreamDupFd = 21;
+// Pipe from downstream to upstream, then pipe from upstream to downstream.
+constexpr int ToUpstreamReadFd = 30;
+constexpr int ToUpstreamWriteFd = 31;
+constexpr int ToDownstreamReadFd = 32;
+constexpr int ToDownstreamWriteFd = 33;
+constexpr uint32_t BufferLimit = 1024;
+constexpr unsigned int SpliceFlags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+
+class SplicerTest : public testing::Test {
+protected:
+  void expectDup() {
+    EXPECT_CALL(linux_os_sys_calls_, fcntl(DownstreamFd, F_DUPFD_CLOEXEC, 0))
+        .WillOnce(Return(Api::SysCallIntResult{DownstreamDupFd, 0}));
+    EXPECT_CALL(linux_os_sys_calls_, fcntl(UpstreamFd, F_DUPFD_CLOEXEC, 0))
+        .WillOnce(Return(Api::SysCallIntResult{UpstreamDupFd, 0}));
+  }
+
+  void expectPipe(int read_fd, int write_fd) {
+    EXPECT_CALL(linux_os_sys_calls_, pipe2(_, O_NONBLOCK | O_CLOEXEC))
+        .WillOnce(Invoke([read_fd, write_fd](int pipefd[2], int) -> Api::SysCallIntResult {
+          pipefd[0] = read_fd;
+          pipefd[1] = write_fd;
+          return {0, 0};
+        }));
+    EXPECT_CALL(linux_os_sys_calls_, fcntl(write_fd, F_SETPIPE_SZ, static_cast<int>(BufferLimit)));
+    EXPECT_CALL(linux_os_sys_calls_, fcntl(write_fd, F_GETPIPE_SZ, 0))
+        .WillOnce(Return(Api::SysCallIntResult{4096, 0}));
+  }
+
+  void expectClose(std::vector<int> fds) {
+    for (const int fd : fds) {
+      EXPECT_CALL(os_sys_calls_, close(fd));
+    }
+  }
+
+  SplicerPtr create() {
+    return Splicer::create(dispatcher_, DownstreamFd, UpstreamFd, BufferLimit, BufferLimit,
+                           callbacks_);
+  }
+
+  // Creates a splicer, capturing the file events of both sockets.
+  SplicerPtr createSplicer() {
+    downstream_event_ = new NiceMock<Event::MockFileEvent>();
+    upstream_event_ = new NiceMock<Event::MockFileEvent>();
+    expectDup();
+    {
+      InSequence s;
+      expectPipe(ToUpstreamReadFd, ToUpstreamWriteFd);
+      expectPipe(ToDownstreamReadFd, ToDownstreamWriteFd);
+    }
+    EXPECT_CALL(dispatcher_, createFileEvent_(DownstreamDupFd, _, Event::FileTriggerType::Level,
+                                              Event::FileReadyType::Read))
+        .WillOnce(Invoke([this](os_fd_t, Event::FileReadyCb cb, Event::FileTriggerType,
+                                uint32_t) -> Event::FileEvent* {
+          downstream_cb_ = cb;
+          return downstream_event_;
+        }));
+    EXPECT_CALL(dispatcher_, createFileEvent_(UpstreamDupFd, _, Event::FileTriggerType::Level,
+                                              Event::FileReadyType::Read))
+        .WillOnce(Invoke([this](os_fd_t, Event::FileReadyCb cb, Event::FileTriggerType,
+                                uint32_t) -> Event::FileEvent* {
+          upstream_cb_ = cb;
+          return upstream_event_;
+        }));
+    SplicerPtr splicer = create();
+    EXPECT_NE(nullptr, splicer);
+    return splicer;
+  }
+
+  // Makes a FIONREAD ioctl on the downstream socket report pending bytes.
+  void expectPendingDownstreamData(int pending) {
+    EXPECT_CALL(os_sys_calls_, ioctl(DownstreamDupFd, FIONREAD, _))
+        .WillOnce(Invoke([pending](os_fd_t, unsigned long int, void* argp) {
+          *static_cast<int*>(argp) = pending;
+          return Api::SysCallIntResult{0, 0};
+        }));
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<MockSplicerCallbacks> callbacks_;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+  // Owned by the splicer.
+  Event::MockFileEvent* downstream_event_{};
+  Event::MockFileEvent* upstream_event_{};
+  Event::FileReadyCb downstream_cb_;
+  Event::FileReadyCb upstream_cb_;
+};
+
+TEST_F(SplicerTest, DupFailure) {
+  EXPECT_CALL(linux_os_sys_calls_, fcntl(DownstreamFd, F_DUPFD_CLOEXEC, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  EXPECT_CALL(os_sys_calls_, close(_)).Times(0);
+  EXPECT_EQ(nullptr, create());
+}
+
+TEST_F(SplicerTest, PipeFailure) {
+  expectDup();
+  EXPECT_CALL(linux_os_sys_calls_, pipe2(_, _)).WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  expectClose({DownstreamDupFd, UpstreamDupFd});
+  EXPECT_EQ(nullptr, create());
+}
+
+TEST_F(SplicerTest, PipeSizeFailure) {
+  expectDup();
+  EXPECT_CALL(linux_os_sys_calls_, pipe2(_, _))
+      .WillOnce(Invoke([](int pipefd[2], int) -> Api::SysCallIntResult {
+        pipefd[0] = ToUpstreamReadFd;
+        pipefd[1] = ToUpstreamWriteFd;
+        return {0, 0};
+      }));
+  EXPECT_CALL(linux_os_sys_calls_, fcntl(ToUpstreamWriteFd, F_GETPIPE_SZ, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  expectClose({DownstreamDupFd, UpstreamDupFd, ToUpstreamReadFd, ToUpstreamWriteFd});
+  EXPECT_EQ(nullptr, create());
+}
+
+// A read that drains the socket below the high watermark leaves reading enabled, even if the
+// data can't be flushed yet.
+TEST_F(SplicerTest, ReadsBelowHighWatermark) {
+  SplicerPtr splicer = createSplicer();
+
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(DownstreamDupFd, ToUpstreamWriteFd, BufferLimit, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{100, 0}));
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(DownstreamDupFd, ToUpstreamWriteFd, BufferLimit - 100, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  expectPendingDownstreamData(0);
+  EXPECT_CALL(linux_os_sys_calls_, splice(ToUpstreamReadFd, UpstreamDupFd, 100, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  EXPECT_CALL(callbacks_, onSpliceReadDisable(_, _)).Times(0);
+  EXPECT_CALL(*downstream_event_, setEnabled(Event::FileReadyType::Read));
+  EXPECT_CALL(*upstream_event_,
+              setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  downstream_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ(100, splicer->bufferedBytes(Splicer::Direction::DownstreamToUpstream));
+
+  expectClose({DownstreamDupFd, UpstreamDupFd, ToUpstreamReadFd, ToUpstreamWriteFd,
+               ToDownstreamReadFd, ToDownstreamWriteFd});
+}
+
+// A pipe that runs out of room below its high watermark while the socket still has data stops
+// reading until the pipe has been flushed, without raising the watermark callbacks.
+TEST_F(SplicerTest, PipeFullBelowHighWatermark) {
+  SplicerPtr splicer = createSplicer();
+
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(DownstreamDupFd, ToUpstreamWriteFd, BufferLimit, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{100, 0}));
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(DownstreamDupFd, ToUpstreamWriteFd, BufferLimit - 100, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  expectPendingDownstreamData(50);
+  EXPECT_CALL(linux_os_sys_calls_, splice(ToUpstreamReadFd, UpstreamDupFd, 100, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  EXPECT_CALL(callbacks_, onSpliceReadDisable(_, _)).Times(0);
+  EXPECT_CALL(*downstream_event_, setEnabled(0));
+  EXPECT_CALL(*upstream_event_,
+              setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  downstream_cb_(Event::FileReadyType::Read);
+
+  // Flushing resumes reading.
+  EXPECT_CALL(linux_os_sys_calls_, splice(ToUpstreamReadFd, UpstreamDupFd, 100, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{100, 0}));
+  EXPECT_CALL(callbacks_, onSplicedData(Splicer::Direction::DownstreamToUpstream, 100));
+  EXPECT_CALL(*downstream_event_, setEnabled(Event::FileReadyType::Read));
+  EXPECT_CALL(*upstream_event_, setEnabled(Event::FileReadyType::Read));
+  upstream_cb_(Event::FileReadyType::Write);
+
+  expectClose({DownstreamDupFd, UpstreamDupFd, ToUpstreamReadFd, ToUpstreamWriteFd,
+               ToDownstreamReadFd, ToDownstreamWriteFd});
+}
+
+// Reading stops once the pipe reaches the high watermark derived from the buffer limit.
+TEST_F(SplicerTest, HighWatermark) {
+  SplicerPtr splicer = createSplicer();
+
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(DownstreamDupFd, ToUpstreamWriteFd, BufferLimit, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{BufferLimit, 0}));
+  EXPECT_CALL(callbacks_, onSpliceReadDisable(Splicer::Direction::DownstreamToUpstream, true));
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(ToUpstreamReadFd, UpstreamDupFd, BufferLimit, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  EXPECT_CALL(*downstream_event_, setEnabled(0));
+  EXPECT_CALL(*upstream_event_,
+              setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  downstream_cb_(Event::FileReadyType::Read);
+
+  // Reading resumes once the pipe drained to the low watermark.
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(ToUpstreamReadFd, UpstreamDupFd, BufferLimit, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{BufferLimit / 2, 0}));
+  EXPECT_CALL(linux_os_sys_calls_,
+              splice(ToUpstreamReadFd, UpstreamDupFd, BufferLimit / 2, SpliceFlags))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  EXPECT_CALL(callbacks_, onSplicedData(Splicer::Direction::DownstreamToUpstream, BufferLimit / 2));
+  EXPECT_CALL(callbacks_, onSpliceReadDisable(Splicer::Direction::DownstreamToUpstream, false));
+  EXPECT_CALL(*downstream_event_, setEnabled(Event::FileReadyType::Read));
+  EXPECT_CALL(*upstream_event_,
+              setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  upstream_cb_(Event::FileReadyType::Write);
+
+  expectClose({DownstreamDupFd, UpstreamDupFd, ToUpstreamReadFd, ToUpstreamWriteFd,
+               ToDownstreamReadFd, ToDownstreamWriteFd});
+}
+
+#endif
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
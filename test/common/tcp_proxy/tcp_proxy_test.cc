@@ -995,6 +995,22 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(DefaultRoutes)) {
   EXPECT_EQ(std::string("fake_cluster"), config_->getRouteFromEntries(connection)->clusterName());
 }
 
+// Tests that a connection with data already buffered is proxied as usual rather than spliced.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(NoSpliceWithBufferedData)) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, bufferedBytes()).WillRepeatedly(Return(5));
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0U, config_->stats().downstream_cx_spliced_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
 // Tests that half-closes are proxied and don't themselves cause any connection to be closed.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(HalfCloseProxy)) {
   setup(1);
@@ -0,0 +1,134 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/common/thread.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+#include "common/thread_local/thread_local_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace ThreadLocal {
+namespace {
+
+struct VersionObject : public ThreadLocalObject {
+  explicit VersionObject(uint64_t version) : version_(version) {}
+  const uint64_t version_;
+};
+
+constexpr uint64_t UpdatesPerIteration = 1000;
+
+// Registers state.range(0) workers, each running a dispatcher on its own thread, with a
+// ThreadLocal::InstanceImpl, and measures how fast a slot can be updated until every worker sees
+// the last version.
+class SlotUpdateBenchmark {
+public:
+  explicit SlotUpdateBenchmark(uint32_t num_workers) : api_(Api::createApiForTest()) {
+    if (!Libevent::Global::initialized()) {
+      Libevent::Global::initialize();
+    }
+    main_dispatcher_ = api_->allocateDispatcher("main_thread");
+    tls_.registerThread(*main_dispatcher_, true);
+    for (uint32_t i = 0; i < num_workers; i++) {
+      workers_.push_back(api_->allocateDispatcher("worker_thread"));
+      Event::Dispatcher& dispatcher = *workers_.back();
+      tls_.registerThread(dispatcher, false);
+      threads_.push_back(api_->threadFactory().createThread(
+          [&dispatcher]() { dispatcher.run(Event::Dispatcher::RunType::RunUntilExit); }));
+    }
+    slot_ = tls_.allocateSlot();
+  }
+
+  ~SlotUpdateBenchmark() {
+    tls_.shutdownGlobalThreading();
+    for (Event::DispatcherPtr& worker : workers_) {
+      Event::Dispatcher& dispatcher = *worker;
+      dispatcher.post([this, &dispatcher]() {
+        tls_.shutdownThread();
+        dispatcher.exit();
+      });
+    }
+    for (Thread::ThreadPtr& thread : threads_) {
+      thread->join();
+    }
+    slot_.reset();
+    tls_.shutdownThread();
+  }
+
+  // Waits until each worker sees version from the slot.
+  void waitForWorkers(uint64_t version) {
+    std::atomic<uint32_t> pending{static_cast<uint32_t>(workers_.size())};
+    for (Event::DispatcherPtr& worker : workers_) {
+      worker->post([this, version, &pending]() {
+        while (slot_->getTyped<VersionObject>().version_ != version) {
+          std::this_thread::yield();
+        }
+        pending--;
+      });
+    }
+    while (pending != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  Api::ApiPtr api_;
+  InstanceImpl tls_;
+  Event::DispatcherPtr main_dispatcher_;
+  std::vector<Event::DispatcherPtr> workers_;
+  std::vector<Thread::ThreadPtr> threads_;
+  SlotPtr slot_;
+};
+
+// Updates with set(), which posts the new object to every worker.
+void BM_SlotSet(benchmark::State& state) {
+  SlotUpdateBenchmark bench(state.range(0));
+  uint64_t version = 0;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < UpdatesPerIteration; i++) {
+      auto object = std::make_shared<VersionObject>(++version);
+      bench.slot_->set(
+          [object](Event::Dispatcher&) -> ThreadLocalObjectSharedPtr { return object; });
+    }
+    bench.waitForWorkers(version);
+  }
+  state.SetItemsProcessed(version);
+}
+BENCHMARK(BM_SlotSet)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Updates with publish(), which the workers pick up on their next access.
+void BM_SlotPublish(benchmark::State& state) {
+  SlotUpdateBenchmark bench(state.range(0));
+  uint64_t version = 0;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < UpdatesPerIteration; i++) {
+      bench.slot_->publish(std::make_shared<VersionObject>(++version));
+    }
+    bench.waitForWorkers(version);
+  }
+  state.SetItemsProcessed(version);
+}
+BENCHMARK(BM_SlotPublish)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Reads a published slot, to show the cost of the version check on get().
+void BM_SlotPublishedGet(benchmark::State& state) {
+  SlotUpdateBenchmark bench(1);
+  bench.slot_->publish(std::make_shared<VersionObject>(1));
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    sum += bench.slot_->getTyped<VersionObject>().version_;
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_SlotPublishedGet);
+
+} // namespace
+} // namespace ThreadLocal
+} // namespace Envoy
@@ -11,6 +11,7 @@ using testing::_;
 using testing::InSequence;
 using testing::Ref;
 using testing::ReturnPointee;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace ThreadLocal {
@@ -166,6 +167,42 @@ TEST_F(ThreadLocalInstanceImplTest, UpdateCallback) {
   tls_.shutdownThread();
 }
 
+// Published objects are picked up on the next get() without any posts to the other threads, and
+// the replaced object is released from the event loop of the thread that held it.
+TEST_F(ThreadLocalInstanceImplTest, Publish) {
+  SlotPtr slot = tls_.allocateSlot();
+  EXPECT_FALSE(slot->currentThreadRegistered());
+  EXPECT_CALL(main_dispatcher_, post(_)).Times(0);
+  EXPECT_CALL(thread_dispatcher_, post(_)).Times(0);
+
+  auto object1 = std::make_shared<TestThreadLocalObject>();
+  slot->publish(object1);
+  EXPECT_TRUE(slot->currentThreadRegistered());
+  EXPECT_EQ(object1.get(), &slot->getTyped<TestThreadLocalObject>());
+
+  auto object2 = std::make_shared<TestThreadLocalObject>();
+  slot->publish(object2);
+  TestThreadLocalObject& object_ref1 = *object1;
+  object1.reset();
+  // The mock dispatchers run posts inline, so this thread picked the worker dispatcher up when it
+  // was registered.
+  Event::PostCb release;
+  EXPECT_CALL(thread_dispatcher_, post(_)).WillOnce(SaveArg<0>(&release));
+  EXPECT_EQ(object2.get(), &slot->getTyped<TestThreadLocalObject>());
+  // The current version is cached, so there is nothing to release.
+  EXPECT_EQ(object2.get(), &slot->getTyped<TestThreadLocalObject>());
+
+  EXPECT_CALL(object_ref1, onDestroy());
+  release();
+  release = nullptr;
+
+  tls_.shutdownGlobalThreading();
+  slot.reset();
+  EXPECT_CALL(*object2, onDestroy());
+  object2.reset();
+  tls_.shutdownThread();
+}
+
 // TODO(ramaraochavali): Run this test with real threads. The current issue in the unit
 // testing environment is, the post to main_dispatcher is not working as expected.
 
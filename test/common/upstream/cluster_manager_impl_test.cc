@@ -519,7 +519,8 @@ TEST_P(ClusterManagerSubsetInitializationTest, SubsetLoadBalancerInitialization)
   const std::string yaml = fmt::format(yamlPattern, cluster_type, policy_name);
 
   if (GetParam() == envoy::config::cluster::v3::Cluster::hidden_envoy_deprecated_ORIGINAL_DST_LB ||
-      GetParam() == envoy::config::cluster::v3::Cluster::CLUSTER_PROVIDED) {
+      GetParam() == envoy::config::cluster::v3::Cluster::CLUSTER_PROVIDED ||
+      GetParam() == envoy::config::cluster::v3::Cluster::PEAK_EWMA) {
     EXPECT_THROW_WITH_MESSAGE(
         create(parseBootstrapFromV3Yaml(yaml)), EnvoyException,
         fmt::format("cluster: LB policy {} cannot be combined with lb_subset_config",
@@ -674,6 +675,51 @@ TEST_F(ClusterManagerImplTest, RingHashLoadBalancerV2Initialization) {
   create(parseBootstrapFromV3Yaml(yaml));
 }
 
+// Verify that response times reported to the cluster reach its peak EWMA LB.
+TEST_F(ClusterManagerImplTest, PeakEwmaLoadBalancerResponseTime) {
+  const std::string yaml = R"EOF(
+ static_resources:
+  clusters:
+  - name: cluster_1
+    connect_timeout: 0.250s
+    type: STATIC
+    lb_policy: PEAK_EWMA
+    peak_ewma_lb_config:
+      choice_count: 3
+      decay_time: 100s
+    load_assignment:
+      cluster_name: cluster_1
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 8000
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 8001
+  )EOF";
+  create(parseBootstrapFromV3Yaml(yaml));
+
+  ThreadLocalCluster* tlc = cluster_manager_->get("cluster_1");
+  ASSERT_NE(nullptr, tlc);
+  auto* lb = dynamic_cast<PeakEwmaLoadBalancer*>(&tlc->loadBalancer());
+  ASSERT_NE(nullptr, lb);
+
+  const HostSharedPtr host = tlc->prioritySet().hostSetsPerPriority()[0]->hosts()[0];
+  EXPECT_EQ(0, lb->hostCost(*host));
+  HostResponseTimeObserverSharedPtr observer = tlc->hostResponseTimeObserver().lock();
+  ASSERT_NE(nullptr, observer);
+  observer->onHostResponseTime(*host, std::chrono::microseconds(1500));
+  EXPECT_NEAR(1500, lb->hostCost(*host), 1);
+  observer.reset();
+
+  factory_.tls_.shutdownThread();
+}
+
 // Verify EDS clusters have EDS config.
 TEST_F(ClusterManagerImplTest, EdsClustersRequireEdsConfig) {
   const std::string yaml = R"EOF(
@@ -1868,6 +1914,140 @@ TEST_F(ClusterManagerImplTest, DynamicHostRemove) {
   factory_.tls_.shutdownThread();
 }
 
+// Verify that a cluster that prefetches on host add establishes a connection to each new host,
+// in the pool used by requests without socket or transport socket options.
+TEST_F(ClusterManagerImplTest, PrefetchOnHostAdd) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STRICT_DNS
+      lb_policy: ROUND_ROBIN
+      prefetch_policy:
+        prefetch_on_host_add: true
+      dns_resolvers:
+        - socket_address:
+            address: 1.2.3.4
+            port_value: 80
+      load_assignment:
+        cluster_name: cluster_1
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11001
+  )EOF";
+
+  std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
+  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_, _)).WillOnce(Return(dns_resolver));
+
+  Network::DnsResolver::ResolveCb dns_callback;
+  new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  Network::MockActiveDnsQuery active_dns_query;
+  EXPECT_CALL(*dns_resolver, resolve(_, _, _))
+      .WillRepeatedly(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  create(parseBootstrapFromV3Yaml(yaml));
+
+  std::vector<Http::ConnectionPool::MockInstance*> pools;
+  EXPECT_CALL(factory_, allocateConnPool_(_, Eq(nullptr), Eq(nullptr)))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](HostConstSharedPtr, Network::ConnectionSocket::OptionsSharedPtr,
+                                 Network::TransportSocketOptionsSharedPtr) {
+        auto* pool = new NiceMock<Http::ConnectionPool::MockInstance>();
+        EXPECT_CALL(*pool, maybePrefetch(1.0)).WillOnce(Return(true));
+        pools.push_back(pool);
+        return pool;
+      }));
+  dns_callback(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
+  ASSERT_EQ(2U, pools.size());
+  EXPECT_NE(pools[0], pools[1]);
+
+  // Requests without options are served by the warmed pools.
+  Http::ConnectionPool::Instance* cp = cluster_manager_->httpConnPoolForCluster(
+      "cluster_1", ResourcePriority::Default, Http::Protocol::Http11, nullptr);
+  EXPECT_TRUE(cp == pools[0] || cp == pools[1]);
+}
+
+// Verify that a cluster that uses the downstream protocol doesn't prefetch on host add, as the
+// pool a request will use isn't known until it arrives.
+TEST_F(ClusterManagerImplTest, NoPrefetchOnHostAddWithDownstreamProtocol) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STRICT_DNS
+      lb_policy: ROUND_ROBIN
+      protocol_selection: USE_DOWNSTREAM_PROTOCOL
+      prefetch_policy:
+        prefetch_on_host_add: true
+      dns_resolvers:
+        - socket_address:
+            address: 1.2.3.4
+            port_value: 80
+      load_assignment:
+        cluster_name: cluster_1
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11001
+  )EOF";
+
+  std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
+  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_, _)).WillOnce(Return(dns_resolver));
+
+  Network::DnsResolver::ResolveCb dns_callback;
+  new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  Network::MockActiveDnsQuery active_dns_query;
+  EXPECT_CALL(*dns_resolver, resolve(_, _, _))
+      .WillRepeatedly(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  create(parseBootstrapFromV3Yaml(yaml));
+
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _)).Times(0);
+  dns_callback(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
+}
+
+// Verify that the main thread, which doesn't route requests, doesn't prefetch connections.
+TEST_F(ClusterManagerImplTest, NoPrefetchOnHostAddOnMainThread) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      prefetch_policy:
+        prefetch_on_host_add: true
+      load_assignment:
+        cluster_name: cluster_1
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11001
+  )EOF";
+
+  // The thread local cluster manager is only created on the thread of the main dispatcher.
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _)).Times(0);
+  cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+      parseBootstrapFromV3Yaml(yaml), factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+      factory_.random_, factory_.local_info_, log_manager_, factory_.tls_.dispatcher_, admin_,
+      validation_context_, *api_, http_context_, grpc_context_);
+  EXPECT_EQ(
+      1UL,
+      cluster_manager_->get("cluster_1")->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
 TEST_F(ClusterManagerImplTest, DynamicHostRemoveWithTls) {
   const std::string yaml = R"EOF(
   static_resources:
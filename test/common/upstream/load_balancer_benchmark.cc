@@ -4,14 +4,18 @@
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
+#include "common/config/metadata.h"
+#include "common/config/well_known_names.h"
 #include "common/memory/stats.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/subset_lb.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "benchmark/benchmark.h"
 
@@ -52,6 +56,7 @@ public:
   ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
   NiceMock<Runtime::MockLoader> runtime_;
   Runtime::RandomGeneratorImpl random_;
+  Event::SimulatedTimeSystem time_system_;
   envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
   std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
 };
@@ -129,8 +134,9 @@ public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
     config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
     config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
-    ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
-        priority_set_, stats_, stats_store_, runtime_, random_, config_, common_config_);
+    ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_store_,
+                                                           runtime_, random_, config_,
+                                                           common_config_, time_system_);
   }
 
   absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> config_;
@@ -142,7 +148,7 @@ public:
   MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
-                                                      random_, common_config_);
+                                                      random_, common_config_, time_system_);
   }
 
   std::unique_ptr<MaglevLoadBalancer> maglev_lb_;
@@ -205,6 +211,66 @@ BENCHMARK(BM_MaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(benchmark::kMillisecond);
 
+// Replaces the last num_replaced hosts of the tester with new hosts, which rebuilds the load
+// balancer. Only the update itself is timed.
+void replaceHosts(benchmark::State& state, BaseTester& tester, uint64_t num_replaced,
+                  uint64_t generation) {
+  state.PauseTiming();
+  const HostVector& current = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  HostVector hosts(current.begin(), current.end() - num_replaced);
+  HostVector removed(current.end() - num_replaced, current.end());
+  HostVector added;
+  for (uint64_t i = 0; i < num_replaced; i++) {
+    added.push_back(makeTestHost(
+        tester.info_,
+        fmt::format("tcp://10.1.{}.{}:{}", i / 256, i % 256, 1024 + generation % 60000)));
+  }
+  hosts.insert(hosts.end(), added.begin(), added.end());
+  HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+  HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+  state.ResumeTiming();
+
+  tester.priority_set_.updateHosts(
+      0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {}, added, removed,
+      absl::nullopt);
+}
+
+void BM_RingHashLoadBalancerRebuildRing(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t num_replaced = state.range(2);
+  RingHashTester tester(num_hosts, min_ring_size);
+  tester.ring_hash_lb_->initialize();
+
+  uint64_t generation = 0;
+  for (auto _ : state) {
+    replaceHosts(state, tester, num_replaced, generation++);
+  }
+}
+BENCHMARK(BM_RingHashLoadBalancerRebuildRing)
+    ->Args({500, 256000, 1})
+    ->Args({500, 256000, 50})
+    ->Args({5000, 1024 * 1024, 1})
+    ->Args({5000, 1024 * 1024, 50})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MaglevLoadBalancerRebuildTable(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_replaced = state.range(1);
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+
+  uint64_t generation = 0;
+  for (auto _ : state) {
+    replaceHosts(state, tester, num_replaced, generation++);
+  }
+}
+BENCHMARK(BM_MaglevLoadBalancerRebuildTable)
+    ->Args({500, 1})
+    ->Args({5000, 1})
+    ->Args({5000, 50})
+    ->Unit(benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -302,6 +368,29 @@ BENCHMARK(BM_RingHashLoadBalancerChooseHost)
     ->Args({500, 256000, 100000})
     ->Unit(benchmark::kMillisecond);
 
+// Measures the latency of a single host selection as the ring grows out of the CPU caches. Keys
+// are hashed with hashInt() so that consecutive lookups land on unrelated parts of the ring.
+void BM_RingHashLoadBalancerChooseHostLatency(benchmark::State& state) {
+  const uint64_t ring_size = state.range(0);
+  RingHashTester tester(100, ring_size);
+  tester.ring_hash_lb_->initialize();
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create();
+  TestLoadBalancerContext context;
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    context.hash_key_ = hashInt(i++);
+    benchmark::DoNotOptimize(lb->chooseHost(&context));
+  }
+  state.counters["ring_size"] = tester.ring_hash_lb_->stats().size_.value();
+}
+BENCHMARK(BM_RingHashLoadBalancerChooseHostLatency)
+    ->Arg(1024)
+    ->Arg(16384)
+    ->Arg(262144)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024);
+
 void BM_MaglevLoadBalancerChooseHost(benchmark::State& state) {
   for (auto _ : state) {
     // Do not time the creation of the table.
@@ -485,6 +574,163 @@ BENCHMARK(BM_MaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(benchmark::kMillisecond);
 
+class SubsetTester : public BaseTester {
+public:
+  // Creates SubsetHosts hosts with num_keys metadata keys, selected by a single subset selector.
+  // The first key is a list with a value per subset, which list_as_any turns into num_subsets
+  // subsets of one host each. The other keys have a few values shared by many hosts. Each subset
+  // filters all hosts when it is created, so fewer hosts keep the build from dominating the
+  // benchmark.
+  SubsetTester(uint64_t num_keys, uint64_t num_subsets) : BaseTester(0) {
+    envoy::config::cluster::v3::Cluster::LbSubsetConfig subset_config;
+    subset_config.set_fallback_policy(
+        envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK);
+    subset_config.set_list_as_any(true);
+    auto* selector = subset_config.add_subset_selectors();
+    for (uint64_t j = 0; j < num_keys; j++) {
+      selector->add_keys(fmt::format("key{:02}", j));
+    }
+
+    HostVector hosts;
+    const uint64_t subsets_per_host = num_subsets / SubsetHosts;
+    for (uint64_t i = 0; i < SubsetHosts; i++) {
+      envoy::config::core::v3::Metadata metadata;
+      auto* values = Config::Metadata::mutableMetadataValue(
+                         metadata, Config::MetadataFilters::get().ENVOY_LB, "key00")
+                         .mutable_list_value();
+      for (uint64_t k = 0; k < subsets_per_host; k++) {
+        values->add_values()->set_string_value(fmt::format("value{}", i * subsets_per_host + k));
+      }
+      for (uint64_t j = 1; j < num_keys; j++) {
+        Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                               fmt::format("key{:02}", j))
+            .set_string_value(fmt::format("value{}", i % 4));
+      }
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.0.{}:6379", i), metadata));
+    }
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              hosts, {}, absl::nullopt);
+    subset_info_ = std::make_unique<LoadBalancerSubsetInfoImpl>(subset_config);
+  }
+
+  static constexpr uint64_t SubsetHosts = 100;
+
+  void initialize() {
+    lb_ = std::make_unique<SubsetLoadBalancer>(
+        LoadBalancerType::Random, priority_set_, nullptr, stats_, stats_store_, runtime_, random_,
+        *subset_info_, absl::nullopt, absl::nullopt, common_config_, time_system_);
+  }
+
+  std::unique_ptr<LoadBalancerSubsetInfoImpl> subset_info_;
+  std::unique_ptr<SubsetLoadBalancer> lb_;
+};
+
+class SubsetMetadataMatchCriterion : public Router::MetadataMatchCriterion {
+public:
+  SubsetMetadataMatchCriterion(const std::string& name, const HashedValue& value)
+      : name_(name), value_(value) {}
+
+  // Router::MetadataMatchCriterion
+  const std::string& name() const override { return name_; }
+  const HashedValue& value() const override { return value_; }
+
+private:
+  const std::string name_;
+  const HashedValue value_;
+};
+
+class SubsetMetadataMatchCriteria : public Router::MetadataMatchCriteria {
+public:
+  // Matches the subset with the given index of SubsetTester.
+  SubsetMetadataMatchCriteria(uint64_t num_keys, uint64_t num_subsets, uint64_t subset) {
+    const uint64_t host = subset / (num_subsets / SubsetTester::SubsetHosts);
+    for (uint64_t j = 0; j < num_keys; j++) {
+      ProtobufWkt::Value value;
+      value.set_string_value(fmt::format("value{}", j == 0 ? subset : host % 4));
+      criteria_.push_back(std::make_shared<const SubsetMetadataMatchCriterion>(
+          fmt::format("key{:02}", j), HashedValue(value)));
+    }
+  }
+
+  // Router::MetadataMatchCriteria
+  const std::vector<Router::MetadataMatchCriterionConstSharedPtr>&
+  metadataMatchCriteria() const override {
+    return criteria_;
+  }
+  Router::MetadataMatchCriteriaConstPtr
+  mergeMatchCriteria(const ProtobufWkt::Struct&) const override {
+    return nullptr;
+  }
+  Router::MetadataMatchCriteriaConstPtr
+  filterMatchCriteria(const std::set<std::string>&) const override {
+    return nullptr;
+  }
+
+private:
+  std::vector<Router::MetadataMatchCriterionConstSharedPtr> criteria_;
+};
+
+class SubsetLoadBalancerContext : public LoadBalancerContextBase {
+public:
+  SubsetLoadBalancerContext(uint64_t num_keys, uint64_t num_subsets, uint64_t subset)
+      : criteria_(num_keys, num_subsets, subset) {}
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return &criteria_; }
+
+private:
+  SubsetMetadataMatchCriteria criteria_;
+};
+
+void BM_SubsetLoadBalancerBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_keys = state.range(0);
+    const uint64_t num_subsets = state.range(1);
+    SubsetTester tester(num_keys, num_subsets);
+
+    // We are only interested in timing the initial build of the subsets.
+    state.ResumeTiming();
+    tester.initialize();
+    state.PauseTiming();
+    tester.lb_.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerBuild)
+    ->Args({1, 10000})
+    ->Args({50, 1000})
+    ->Args({50, 10000})
+    ->Unit(benchmark::kMillisecond);
+
+// Measures finding the subset for a request's metadata match criteria, along with choosing a host
+// from it.
+void BM_SubsetLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_keys = state.range(0);
+  const uint64_t num_subsets = state.range(1);
+  SubsetTester tester(num_keys, num_subsets);
+  tester.initialize();
+  // Requests cycle through a sample of the subsets, as building criteria for every subset would
+  // dominate the benchmark's memory.
+  std::vector<std::unique_ptr<SubsetLoadBalancerContext>> contexts;
+  for (uint64_t i = 0; i < num_subsets; i += std::max<uint64_t>(num_subsets / 1000, 1)) {
+    contexts.push_back(std::make_unique<SubsetLoadBalancerContext>(num_keys, num_subsets, i));
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    HostConstSharedPtr host = tester.lb_->chooseHost(contexts[i++ % contexts.size()].get());
+    benchmark::DoNotOptimize(host);
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerChooseHost)
+    ->Args({1, 10000})
+    ->Args({10, 10000})
+    ->Args({50, 1000})
+    ->Args({50, 10000});
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <set>
 #include <string>
@@ -13,6 +15,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -1558,6 +1561,187 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, LeastRequestLoadBalancerTest,
                          ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void init() {
+    lb_ = std::make_unique<PeakEwmaLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_,
+                                                 common_config_, peak_ewma_lb_config_,
+                                                 time_system_);
+  }
+
+  // Adds the hosts to the cluster so that the LB tracks their latency.
+  void addHosts(const HostVector& hosts) {
+    hostSet().healthy_hosts_.insert(hostSet().healthy_hosts_.end(), hosts.begin(), hosts.end());
+    hostSet().hosts_ = hostSet().healthy_hosts_;
+    hostSet().runCallbacks(hosts, {});
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig> peak_ewma_lb_config_;
+  std::unique_ptr<PeakEwmaLoadBalancer> lb_;
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) {
+  init();
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PrefersLowerLatency) {
+  init();
+  stats_.max_host_weight_.set(1UL);
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[0], std::chrono::milliseconds(10));
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[1], std::chrono::milliseconds(1));
+  EXPECT_EQ(10000, lb_->hostCost(*hostSet().healthy_hosts_[0]));
+  EXPECT_EQ(1000, lb_->hostCost(*hostSet().healthy_hosts_[1]));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // Active requests scale the cost of a host.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(10);
+  EXPECT_EQ(11000, lb_->hostCost(*hostSet().healthy_hosts_[1]));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PeakAndDecay) {
+  peak_ewma_lb_config_.emplace();
+  peak_ewma_lb_config_->mutable_decay_time()->set_seconds(10);
+  init();
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80")});
+  const Host& host = *hostSet().healthy_hosts_[0];
+
+  // A slower response replaces the estimate at once.
+  lb_->onHostResponseTime(host, std::chrono::milliseconds(1));
+  lb_->onHostResponseTime(host, std::chrono::milliseconds(100));
+  EXPECT_EQ(100000, lb_->hostCost(host));
+
+  // Without responses the estimate decays by 1/e every decay_time.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_NEAR(100000 * std::exp(-1), lb_->hostCost(host), 0.01);
+
+  // A faster response is averaged in, weighted by the time since the last one.
+  lb_->onHostResponseTime(host, std::chrono::milliseconds(1));
+  EXPECT_NEAR(100000 * std::exp(-1) + 1000 * (1 - std::exp(-1)), lb_->hostCost(host), 0.01);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, UnknownLatencyPenalty) {
+  init();
+  stats_.max_host_weight_.set(1UL);
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+
+  // A host without an estimate is the cheapest while idle, and the most expensive once it has
+  // requests in flight.
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[1], std::chrono::milliseconds(50));
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(5);
+  EXPECT_EQ(0, lb_->hostCost(*hostSet().healthy_hosts_[0]));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, IgnoresRemovedHosts) {
+  init();
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[0], std::chrono::milliseconds(1));
+
+  HostVector removed{hostSet().healthy_hosts_[1]};
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 1);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, removed);
+
+  // The remaining host keeps its estimate, while late responses of the removed one are dropped.
+  EXPECT_EQ(1000, lb_->hostCost(*hostSet().healthy_hosts_[0]));
+  lb_->onHostResponseTime(*removed[0], std::chrono::milliseconds(1));
+  EXPECT_EQ(0, lb_->hostCost(*removed[0]));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, SlowStart) {
+  peak_ewma_lb_config_.emplace();
+  peak_ewma_lb_config_->mutable_slow_start_window()->set_seconds(10);
+  init();
+  stats_.max_host_weight_.set(1UL);
+
+  // The first host joins an empty cluster and skips slow start.
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80")});
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[0], std::chrono::milliseconds(1));
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:81")});
+
+  // The new host is cheaper, but at the start of the window it is only eligible 10% of the time.
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(0))
+      .WillOnce(Return(1))
+      .WillOnce(Return(101))
+      .WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(0))
+      .WillOnce(Return(1))
+      .WillOnce(Return(99))
+      .WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // Half way through the window it is eligible half of the time.
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(0))
+      .WillOnce(Return(1))
+      .WillOnce(Return(499))
+      .WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // After the window it is treated like any other host.
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, WeightImbalance) {
+  init();
+  stats_.max_host_weight_.set(2UL);
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+            makeTestHost(info_, "tcp://127.0.0.1:81", 2)});
+
+  // With a 9ms estimate, hosts[1] has a fifth of the weight of hosts[0]. Refresh the EDF schedule
+  // so that it starts from the new weights.
+  lb_->onHostResponseTime(*hostSet().healthy_hosts_[1], std::chrono::milliseconds(9));
+  hostSet().runCallbacks({}, {});
+
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  uint32_t host_0_picks = 0;
+  for (uint32_t i = 0; i < 60; ++i) {
+    if (lb_->chooseHost(nullptr) == hostSet().healthy_hosts_[0]) {
+      host_0_picks++;
+    }
+  }
+  EXPECT_NEAR(50, host_0_picks, 1);
+}
+
+// Hosts in slow start are known before the EDF schedule is rebuilt with them, so they start with a
+// fraction of their weight.
+TEST_P(PeakEwmaLoadBalancerTest, SlowStartWeight) {
+  peak_ewma_lb_config_.emplace();
+  peak_ewma_lb_config_->mutable_slow_start_window()->set_seconds(10);
+  init();
+  stats_.max_host_weight_.set(2UL);
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80", 1)});
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:81", 2)});
+
+  // hosts[1] starts with a tenth of its weight of 2, so it is first due after four picks of
+  // hosts[0] rather than before the first one.
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 class RandomLoadBalancerTest : public LoadBalancerTestBase {
 public:
   void init() {
@@ -6,6 +6,7 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -42,7 +43,7 @@ public:
 
   void init(uint32_t table_size) {
     lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
-                                               random_, common_config_, table_size);
+                                               random_, common_config_, time_system_, table_size);
     lb_->initialize();
   }
 
@@ -54,6 +55,7 @@ public:
   envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  Event::SimulatedTimeSystem time_system_;
   std::unique_ptr<MaglevLoadBalancer> lb_;
 };
 
@@ -12,6 +12,7 @@
 using testing::_;
 using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Upstream {
@@ -93,11 +94,14 @@ TEST(ResourceManagerImplTest, RemainingResourceGauges) {
   EXPECT_EQ(1U, resource_manager.connections().max());
   EXPECT_EQ(1U, stats.remaining_cx_.value());
   EXPECT_EQ(0U, resource_manager.connections().count());
+  EXPECT_EQ(0U, stats.cx_open_.value());
   resource_manager.connections().inc();
   EXPECT_EQ(1U, resource_manager.connections().count());
   EXPECT_EQ(0U, stats.remaining_cx_.value());
+  EXPECT_EQ(1U, stats.cx_open_.value());
   resource_manager.connections().dec();
   EXPECT_EQ(1U, stats.remaining_cx_.value());
+  EXPECT_EQ(0U, stats.cx_open_.value());
 
   // Test remaining_pending_ gauge
   EXPECT_EQ(2U, resource_manager.pendingRequests().max());
@@ -164,6 +168,35 @@ TEST(ResourceManagerImplTest, RetryBudgetOverrideGauge) {
   EXPECT_EQ(0U, stats.remaining_retries_.value());
   rm.retries().dec();
 }
+
+// Every worker updates the gauges, so they are only written when their value changes.
+TEST(ResourceManagerImplTest, GaugesOnlySetOnChange) {
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Stats::MockGauge> open;
+  NiceMock<Stats::MockGauge> remaining;
+  ON_CALL(open, set(_)).WillByDefault(SaveArg<0>(&open.value_));
+  ON_CALL(remaining, set(_)).WillByDefault(SaveArg<0>(&remaining.value_));
+
+  EXPECT_CALL(remaining, set(1));
+  ManagedResourceImpl resource(1, runtime, "max_requests", open, remaining);
+  EXPECT_TRUE(resource.canCreate());
+
+  EXPECT_CALL(remaining, set(0));
+  EXPECT_CALL(open, set(1));
+  resource.inc();
+  EXPECT_FALSE(resource.canCreate());
+
+  // Past the max, neither gauge changes.
+  EXPECT_CALL(remaining, set(_)).Times(0);
+  EXPECT_CALL(open, set(_)).Times(0);
+  resource.inc();
+  resource.dec();
+
+  EXPECT_CALL(remaining, set(1));
+  EXPECT_CALL(open, set(0));
+  resource.dec();
+  EXPECT_TRUE(resource.canCreate());
+}
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/router/router.h"
@@ -14,6 +16,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -54,7 +57,7 @@ public:
 
   void init() {
     lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
-                                                 random_, config_, common_config_);
+                                                 random_, config_, common_config_, time_system_);
     lb_->initialize();
   }
 
@@ -72,6 +75,7 @@ public:
   envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  Event::SimulatedTimeSystem time_system_;
   std::unique_ptr<RingHashLoadBalancer> lb_;
 };
 
@@ -165,6 +169,61 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
 }
 
+// Rings rebuilt from the previous ring after host changes are the same as rings built from
+// scratch with the new hosts.
+TEST_P(RingHashLoadBalancerTest, IncrementalRebuild) {
+  for (uint32_t i = 0; i < 20; ++i) {
+    hostSet().hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i), i % 3 + 1));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(1024);
+  init();
+  EXPECT_EQ("ring_hash_lb.rebuild_time_us", lb_->stats().rebuild_time_us_.name());
+
+  auto expect_same_as_full_build = [this]() {
+    NiceMock<MockPrioritySet> priority_set;
+    MockHostSet& host_set = *priority_set.getMockHostSet(GetParam() ? 0 : 1);
+    host_set.hosts_ = hostSet().hosts_;
+    host_set.healthy_hosts_ = hostSet().healthy_hosts_;
+    RingHashLoadBalancer full_build(priority_set, stats_, stats_store_, runtime_, random_, config_,
+                                    common_config_, time_system_);
+    full_build.initialize();
+
+    LoadBalancerPtr lb = lb_->factory()->create();
+    LoadBalancerPtr full_build_lb = full_build.factory()->create();
+    for (uint64_t i = 0; i < 10000; ++i) {
+      TestLoadBalancerContext context(i * (std::numeric_limits<uint64_t>::max() / 10000) + i);
+      EXPECT_EQ(full_build_lb->chooseHost(&context), lb->chooseHost(&context));
+    }
+  };
+
+  // Replace some hosts, keeping the weights.
+  hostSet().hosts_.erase(hostSet().hosts_.begin() + 5);
+  hostSet().hosts_.erase(hostSet().hosts_.begin());
+  hostSet().hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:200", 2));
+  hostSet().hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:201", 3));
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  expect_same_as_full_build();
+
+  // Change a weight, which changes the number of hashes of every host.
+  hostSet().hosts_[3] = makeTestHost(
+      info_, fmt::format("tcp://{}", hostSet().hosts_[3]->address()->asString()), 7);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  expect_same_as_full_build();
+
+  // Reorder the hosts and drop some of them from the healthy hosts.
+  std::reverse(hostSet().hosts_.begin(), hostSet().hosts_.end());
+  hostSet().healthy_hosts_ = {hostSet().hosts_.begin(), hostSet().hosts_.begin() + 12};
+  hostSet().runCallbacks({}, {});
+  expect_same_as_full_build();
+}
+
 // Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
 TEST_P(RingHashFailoverTest, BasicFailover) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
@@ -773,6 +832,37 @@ TEST_P(RingHashLoadBalancerTest, LopsidedWeightSmallScale) {
   }
 }
 
+// The Eytzinger search finds the same entry as a binary search of the sorted hashes, for trees of
+// any shape, and with hashes repeated.
+TEST(EytzingerSearchTest, MatchesLowerBound) {
+  for (uint64_t size = 1; size <= 70; ++size) {
+    std::vector<uint64_t> sorted;
+    for (uint64_t i = 0; i < size; ++i) {
+      // Every third hash repeats the one before it.
+      sorted.push_back(10 * (i - i / 3));
+    }
+    std::vector<uint64_t> hashes(size + 1);
+    std::vector<uint64_t> entries(size + 1);
+    EytzingerSearch::layOut(size, [&](uint64_t node, uint64_t entry) {
+      hashes[node] = sorted[entry];
+      entries[node] = entry;
+    });
+
+    for (uint64_t h = 0; h <= sorted.back() + 1; ++h) {
+      const auto it = std::lower_bound(sorted.begin(), sorted.end(), h);
+      const uint64_t node = EytzingerSearch::lowerBound(hashes.data(), size, h);
+      if (it == sorted.end()) {
+        // Past the last hash, which wraps around to the first entry.
+        EXPECT_EQ(0, node) << "size " << size << " hash " << h;
+      } else {
+        ASSERT_NE(0, node) << "size " << size << " hash " << h;
+        EXPECT_EQ(static_cast<uint64_t>(it - sorted.begin()), entries[node])
+            << "size " << size << " hash " << h;
+      }
+    }
+  }
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
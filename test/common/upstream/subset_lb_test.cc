@@ -18,6 +18,7 @@
 #include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
@@ -189,7 +190,7 @@ public:
 
     lb_ = std::make_shared<SubsetLoadBalancer>(
         lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_, random_, subset_info_,
-        ring_hash_lb_config_, least_request_lb_config_, common_config_);
+        ring_hash_lb_config_, least_request_lb_config_, common_config_, time_system_);
   }
 
   void zoneAwareInit(const std::vector<HostURLMetadataMap>& host_metadata_per_locality,
@@ -238,7 +239,8 @@ public:
 
     lb_ = std::make_shared<SubsetLoadBalancer>(
         lb_type_, priority_set_, &local_priority_set_, stats_, stats_store_, runtime_, random_,
-        subset_info_, ring_hash_lb_config_, least_request_lb_config_, common_config_);
+        subset_info_, ring_hash_lb_config_, least_request_lb_config_, common_config_,
+        time_system_);
   }
 
   HostSharedPtr makeHost(const std::string& url, const HostMetadata& metadata) {
@@ -464,6 +466,7 @@ public:
   envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  Event::SimulatedTimeSystem time_system_;
   Stats::IsolatedStoreImpl stats_store_;
   ClusterStats stats_;
   PrioritySetImpl local_priority_set_;
@@ -1193,6 +1196,36 @@ TEST_P(SubsetLoadBalancerTest, UpdateRemovingLastSubsetHost) {
   EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
 }
 
+// Subsets are found through an index that is rebuilt on updates, so subsets created or purged by an
+// update must be found, or not, right after it.
+TEST_P(SubsetLoadBalancerTest, FindsSubsetsCreatedAndPurgedByUpdates) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {makeSelector({"version"}),
+                                                     makeSelector({"stage", "version"})};
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({{"tcp://127.0.0.1:80", {{"version", "1.0"}}}});
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_prod_11({{"stage", "prod"}, {"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_prod_11));
+
+  HostSharedPtr host_v11 = makeHost("tcp://127.0.0.1:81", {{"version", "1.1"}, {"stage", "prod"}});
+  modifyHosts({host_v11}, {});
+  EXPECT_EQ(host_v11, lb_->chooseHost(&context_11));
+  EXPECT_EQ(host_v11, lb_->chooseHost(&context_prod_11));
+
+  modifyHosts({}, {host_v11});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_prod_11));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+}
+
 TEST_P(SubsetLoadBalancerTest, UpdateRemovingUnknownHost) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
       .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
@@ -1422,7 +1455,8 @@ TEST_F(SubsetLoadBalancerTest, IgnoresHostsWithoutMetadata) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
 
   TestLoadBalancerContext context_version({{"version", "1.0"}});
 
@@ -1841,7 +1875,8 @@ TEST_F(SubsetLoadBalancerTest, DisabledLocalityWeightAwareness) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
 
   TestLoadBalancerContext context({{"version", "1.1"}});
 
@@ -1864,7 +1899,8 @@ TEST_F(SubsetLoadBalancerTest, DoesNotCheckHostHealth) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
 }
 
 TEST_F(SubsetLoadBalancerTest, EnabledLocalityWeightAwareness) {
@@ -1887,7 +1923,8 @@ TEST_F(SubsetLoadBalancerTest, EnabledLocalityWeightAwareness) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
 
   TestLoadBalancerContext context({{"version", "1.1"}});
 
@@ -1922,7 +1959,8 @@ TEST_F(SubsetLoadBalancerTest, EnabledScaleLocalityWeights) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
   TestLoadBalancerContext context({{"version", "1.1"}});
 
   // Since we scale the locality weights by number of hosts removed, we expect to see the second
@@ -1967,7 +2005,8 @@ TEST_F(SubsetLoadBalancerTest, EnabledScaleLocalityWeightsRounding) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
   TestLoadBalancerContext context({{"version", "1.0"}});
 
   // We expect to see a 33/66 split because 2 * 1 / 2 = 1 and 2 * 3 / 4 = 1.5 -> 2
@@ -1999,7 +2038,8 @@ TEST_F(SubsetLoadBalancerTest, ScaleLocalityWeightsWithNoLocalityWeights) {
 
   lb_ = std::make_shared<SubsetLoadBalancer>(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                              runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                             least_request_lb_config_, common_config_);
+                                             least_request_lb_config_, common_config_,
+                                             time_system_);
 }
 
 TEST_P(SubsetLoadBalancerTest, GaugesUpdatedOnDestroy) {
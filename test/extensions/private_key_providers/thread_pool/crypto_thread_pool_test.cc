@@ -0,0 +1,51 @@
+#include <atomic>
+
+#include "extensions/private_key_providers/thread_pool/crypto_thread_pool.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/blocking_counter.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+TEST(CryptoThreadPoolTest, RunsAllJobs) {
+  CryptoThreadPool pool(Thread::threadFactoryForTest(), 4);
+  EXPECT_EQ(4, pool.threadCount());
+
+  constexpr int jobs = 1000;
+  std::atomic<int> ran{0};
+  absl::BlockingCounter done(jobs);
+  for (int i = 0; i < jobs; i++) {
+    pool.post([&ran, &done]() {
+      ran++;
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  EXPECT_EQ(jobs, ran.load());
+}
+
+TEST(CryptoThreadPoolTest, DestroyWithQueuedJobs) {
+  std::atomic<int> ran{0};
+  {
+    CryptoThreadPool pool(Thread::threadFactoryForTest(), 1);
+    for (int i = 0; i < 100; i++) {
+      pool.post([&ran]() { ran++; });
+    }
+  }
+  // Queued jobs may or may not have run, but destruction must not hang or run jobs afterwards.
+  const int ran_at_destruction = ran.load();
+  EXPECT_LE(ran_at_destruction, 100);
+  EXPECT_EQ(ran_at_destruction, ran.load());
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,278 @@
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+
+#include "common/common/assert.h"
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/private_key_providers/thread_pool/config.h"
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_replace.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+class ThreadPoolPrivateKeyProviderTest : public testing::Test {
+protected:
+  ThreadPoolPrivateKeyProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        pool_(std::make_shared<CryptoThreadPool>(Thread::threadFactoryForTest(), 2)),
+        ssl_ctx_(SSL_CTX_new(TLS_method())), ssl_(SSL_new(ssl_ctx_.get())) {}
+
+  void createProvider(const std::string& key_file) {
+    envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig config;
+    config.mutable_private_key()->set_filename(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    provider_ = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, *api_, pool_);
+    provider_->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  }
+
+  bssl::UniquePtr<X509> readCert(const std::string& cert_file) {
+    const std::string pem = api_->fileSystem().fileReadToEnd(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + cert_file));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+    return bssl::UniquePtr<X509>(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+  }
+
+  bssl::UniquePtr<EVP_PKEY> readKey(const std::string& key_file) {
+    const std::string pem = api_->fileSystem().fileReadToEnd(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), pem.size()));
+    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  }
+
+  // Runs an asynchronous signing operation to completion and verifies the signature.
+  void signAndVerify(const std::string& key_file, uint16_t signature_algorithm) {
+    createProvider(key_file);
+    const SSL_PRIVATE_KEY_METHOD* method = provider_->getBoringSslPrivateKeyMethod().get();
+    const std::string input = "handshake transcript";
+    std::vector<uint8_t> out(1024);
+    size_t out_len = 0;
+
+    EXPECT_EQ(ssl_private_key_retry,
+              method->sign(ssl_.get(), out.data(), &out_len, out.size(), signature_algorithm,
+                           reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+    // Not finished until the completion is delivered on the dispatcher.
+    EXPECT_EQ(ssl_private_key_retry,
+              method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+    EXPECT_EQ(ssl_private_key_success,
+              method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+    verify(key_file, signature_algorithm, input, out.data(), out_len);
+  }
+
+  void verify(const std::string& key_file, uint16_t signature_algorithm, const std::string& input,
+              const uint8_t* signature, size_t signature_len) {
+    bssl::UniquePtr<EVP_PKEY> pkey = readKey(key_file);
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    ASSERT_EQ(1, EVP_DigestVerifyInit(ctx.get(), &pctx,
+                                      SSL_get_signature_algorithm_digest(signature_algorithm),
+                                      nullptr, pkey.get()));
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm)) {
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING));
+      ASSERT_EQ(1, EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1));
+    }
+    EXPECT_EQ(1, EVP_DigestVerify(ctx.get(), signature, signature_len,
+                                  reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  CryptoThreadPoolSharedPtr pool_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+  testing::StrictMock<MockPrivateKeyConnectionCallbacks> callbacks_;
+  std::unique_ptr<ThreadPoolPrivateKeyMethodProvider> provider_;
+};
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, RsaPkcs1Sign) {
+  signAndVerify("san_dns_key.pem", SSL_SIGN_RSA_PKCS1_SHA256);
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, RsaPssSign) {
+  signAndVerify("san_dns_key.pem", SSL_SIGN_RSA_PSS_RSAE_SHA256);
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, EcdsaSign) {
+  signAndVerify("selfsigned_ecdsa_p256_key.pem", SSL_SIGN_ECDSA_SECP256R1_SHA256);
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// A signature algorithm that doesn't match the key type fails once completed.
+TEST_F(ThreadPoolPrivateKeyProviderTest, MismatchedSignatureAlgorithm) {
+  createProvider("selfsigned_ecdsa_p256_key.pem");
+  const SSL_PRIVATE_KEY_METHOD* method = provider_->getBoringSslPrivateKeyMethod().get();
+  const uint8_t input[] = {1, 2, 3};
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+
+  EXPECT_EQ(ssl_private_key_retry, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                SSL_SIGN_RSA_PKCS1_SHA256, input, sizeof(input)));
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(ssl_private_key_failure,
+            method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// The completion isn't delivered once the connection has gone away.
+TEST_F(ThreadPoolPrivateKeyProviderTest, UnregisterWhilePending) {
+  createProvider("san_dns_key.pem");
+  const SSL_PRIVATE_KEY_METHOD* method = provider_->getBoringSslPrivateKeyMethod().get();
+  const uint8_t input[] = {1, 2, 3};
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+
+  EXPECT_EQ(ssl_private_key_retry, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                SSL_SIGN_RSA_PKCS1_SHA256, input, sizeof(input)));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+  // Destroying the pool joins its threads, after which nothing else can be posted.
+  pool_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, NoConnection) {
+  createProvider("san_dns_key.pem");
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+  const SSL_PRIVATE_KEY_METHOD* method = provider_->getBoringSslPrivateKeyMethod().get();
+  const uint8_t input[] = {1, 2, 3};
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+
+  EXPECT_EQ(ssl_private_key_failure, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                  SSL_SIGN_RSA_PKCS1_SHA256, input, sizeof(input)));
+  EXPECT_EQ(ssl_private_key_failure,
+            method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+}
+
+// A context with an RSA and an ECDSA certificate that both use the provider registers two
+// providers with each connection. The handshake uses the key of the certificate it selected.
+TEST_F(ThreadPoolPrivateKeyProviderTest, TwoProvidersOneConnection) {
+  createProvider("san_dns_key.pem");
+  envoy::extensions::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+      config;
+  config.mutable_private_key()->set_filename(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/"
+      "selfsigned_ecdsa_p256_key.pem"));
+  ThreadPoolPrivateKeyMethodProvider ecdsa_provider(config, *api_, pool_);
+  ecdsa_provider.registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  const SSL_PRIVATE_KEY_METHOD* method = provider_->getBoringSslPrivateKeyMethod().get();
+  const std::string input = "handshake transcript";
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+
+  // Without a selected certificate, the key to use is unknown.
+  EXPECT_EQ(ssl_private_key_failure,
+            method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                         reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+
+  ASSERT_EQ(1, SSL_use_certificate(ssl_.get(), readCert("selfsigned_ecdsa_p256_cert.pem").get()));
+  EXPECT_EQ(ssl_private_key_retry,
+            method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256,
+                         reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(ssl_private_key_success,
+            method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+  verify("selfsigned_ecdsa_p256_key.pem", SSL_SIGN_ECDSA_SECP256R1_SHA256, input, out.data(),
+         out_len);
+
+  ecdsa_provider.unregisterPrivateKeyMethod(ssl_.get());
+  EXPECT_NE(nullptr,
+            SSL_get_ex_data(ssl_.get(), ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+  provider_->unregisterPrivateKeyMethod(ssl_.get());
+  EXPECT_EQ(nullptr,
+            SSL_get_ex_data(ssl_.get(), ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InvalidKey) {
+  envoy::extensions::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+      config;
+  config.mutable_private_key()->set_inline_string("not a key");
+  EXPECT_THROW_WITH_MESSAGE(ThreadPoolPrivateKeyMethodProvider(config, *api_, pool_),
+                            EnvoyException,
+                            "Failed to load private key for the thread pool private key provider");
+}
+
+TEST(ThreadPoolPrivateKeyMethodFactoryTest, SharesThreadPool) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ON_CALL(factory_context, singletonManager()).WillByDefault(ReturnRef(singleton_manager));
+
+  const std::string yaml = R"EOF(
+    provider_name: envoy.tls.key_providers.thread_pool
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.private_key_providers.thread_pool.v3alpha.ThreadPoolPrivateKeyMethodConfig
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+      thread_count: 3
+)EOF";
+  envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(yaml), config);
+
+  ThreadPoolPrivateKeyMethodFactory factory;
+  Ssl::PrivateKeyMethodProviderSharedPtr provider1 =
+      factory.createPrivateKeyMethodProviderInstance(config, factory_context);
+  Ssl::PrivateKeyMethodProviderSharedPtr provider2 =
+      factory.createPrivateKeyMethodProviderInstance(config, factory_context);
+  EXPECT_NE(nullptr, provider1->getBoringSslPrivateKeyMethod());
+  EXPECT_NE(nullptr, provider2->getBoringSslPrivateKeyMethod());
+  EXPECT_TRUE(provider1->checkFips());
+
+  // The shared pool already has 3 threads.
+  TestUtility::loadFromYaml(TestEnvironment::substitute(absl::StrReplaceAll(
+                                yaml, {{"thread_count: 3", "thread_count: 4"}})),
+                            config);
+  EXPECT_THROW_WITH_MESSAGE(
+      factory.createPrivateKeyMethodProviderInstance(config, factory_context), EnvoyException,
+      "thread pool private key provider: thread_count 4 conflicts with the existing crypto thread "
+      "pool of 3 threads");
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -165,7 +165,7 @@ public:
     EXPECT_EQ(&envoy_quic_session_, &read_filter_->callbacks_->connection());
     read_filter_->callbacks_->connection().addConnectionCallbacks(network_connection_callbacks_);
     read_filter_->callbacks_->connection().setConnectionStats(
-        {read_total_, read_current_, write_total_, write_current_, nullptr, nullptr});
+        {read_total_, read_current_, write_total_, write_current_, nullptr, nullptr, nullptr});
     EXPECT_EQ(&read_total_, &quic_connection_->connectionStats().read_total_);
     EXPECT_CALL(*read_filter_, onNewConnection()).WillOnce(Invoke([this]() {
       // Create ServerConnection instance and setup callbacks for it.
@@ -747,7 +747,7 @@ TEST_P(EnvoyQuicServerSessionTest, InitializeFilterChain) {
     filter_manager.addReadFilter(read_filter_);
     read_filter_->callbacks_->connection().addConnectionCallbacks(network_connection_callbacks_);
     read_filter_->callbacks_->connection().setConnectionStats(
-        {read_total_, read_current_, write_total_, write_current_, nullptr, nullptr});
+        {read_total_, read_current_, write_total_, write_current_, nullptr, nullptr, nullptr});
   }};
   EXPECT_CALL(filter_chain, networkFilterFactories()).WillOnce(ReturnRef(filter_factory));
   EXPECT_CALL(*read_filter_, onNewConnection())
@@ -0,0 +1,97 @@
+#include <string>
+
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ServerSessionCacheTest : public testing::Test {
+protected:
+  ServerSessionCacheTest() : ctx_(SSL_CTX_new(TLS_method())) {}
+
+  bssl::UniquePtr<SSL_SESSION> makeSession(const std::string& id) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id(session.get(), reinterpret_cast<const uint8_t*>(id.data()),
+                                     id.size()));
+    SSL_SESSION_set_time(session.get(), Now);
+    SSL_SESSION_set_timeout(session.get(), Timeout);
+    return session;
+  }
+
+  static constexpr uint64_t Now = 1000000;
+  static constexpr uint32_t Timeout = 300;
+
+  bssl::UniquePtr<SSL_CTX> ctx_;
+};
+
+TEST_F(ServerSessionCacheTest, InsertLookup) {
+  ServerSessionCache cache(16);
+  EXPECT_EQ(nullptr, cache.lookup("session_1", Now));
+
+  bssl::UniquePtr<SSL_SESSION> session = makeSession("session_1");
+  SSL_SESSION* raw_session = session.get();
+  EXPECT_EQ(0, cache.insert(std::move(session)));
+  EXPECT_EQ(1, cache.size());
+
+  bssl::UniquePtr<SSL_SESSION> found = cache.lookup("session_1", Now);
+  EXPECT_EQ(raw_session, found.get());
+  EXPECT_EQ("session_1", ServerSessionCache::sessionId(found.get()));
+
+  // The reference returned by lookup() outlives the cache entry.
+  EXPECT_EQ(0, cache.insert(makeSession("session_1")));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_NE(raw_session, cache.lookup("session_1", Now).get());
+  EXPECT_EQ("session_1", ServerSessionCache::sessionId(found.get()));
+}
+
+TEST_F(ServerSessionCacheTest, ReplaceSameId) {
+  ServerSessionCache cache(4);
+  EXPECT_EQ(0, cache.insert(makeSession("session")));
+  bssl::UniquePtr<SSL_SESSION> session = makeSession("session");
+  SSL_SESSION* raw_session = session.get();
+  EXPECT_EQ(0, cache.insert(std::move(session)));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(raw_session, cache.lookup("session", Now).get());
+}
+
+TEST_F(ServerSessionCacheTest, Bounded) {
+  ServerSessionCache cache(32);
+  size_t evicted = 0;
+  for (int i = 0; i < 1000; i++) {
+    evicted += cache.insert(makeSession(std::to_string(i)));
+  }
+  EXPECT_LE(cache.size(), 32);
+  EXPECT_EQ(1000, cache.size() + evicted);
+}
+
+TEST_F(ServerSessionCacheTest, EvictsLeastRecentlyUsed) {
+  // A single shard, so that eviction order is deterministic.
+  ServerSessionCache cache(1);
+  EXPECT_EQ(0, cache.insert(makeSession("a")));
+  EXPECT_EQ(1, cache.insert(makeSession("b")));
+  EXPECT_EQ(nullptr, cache.lookup("a", Now));
+  EXPECT_NE(nullptr, cache.lookup("b", Now));
+}
+
+TEST_F(ServerSessionCacheTest, ExpiredSessionRemovedOnLookup) {
+  ServerSessionCache cache(16);
+  EXPECT_EQ(0, cache.insert(makeSession("session")));
+
+  EXPECT_NE(nullptr, cache.lookup("session", Now + Timeout - 1));
+  EXPECT_EQ(1, cache.size());
+
+  EXPECT_EQ(nullptr, cache.lookup("session", Now + Timeout));
+  EXPECT_EQ(0, cache.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -2462,6 +2462,103 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that data and half-close go through once the record layer is offloaded to kernel TLS. If
+// the kernel doesn't support it, the connection must keep working through BoringSSL.
+TEST_P(SslSocketTest, KernelTlsOffloadHalfClose) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_certificates.pem"
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ContextManagerImpl manager(time_system_);
+  Stats::TestUtil::TestStore server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(std::move(server_cfg), manager,
+                                                   server_stats_store, std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::MockConnectionHandler connection_handler;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, listener_callbacks, true);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      kernel_tls_offload: true
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+  )EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   client_stats_store);
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, true);
+      }));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> Network::FilterStatus {
+        Buffer::OwnedImpl buffer("world");
+        client_connection->write(buffer, true);
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("world"), true));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.ktls_offloaded").value() +
+                     server_stats_store.counter("ssl.ktls_offload_skipped").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.ktls_offloaded").value() +
+                     client_stats_store.counter("ssl.ktls_offload_skipped").value());
+}
+
 TEST_P(SslSocketTest, ClientAuthMultipleCAs) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3512,6 +3609,155 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls13) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Test session resumption through the sharded server-side session cache, with session tickets
+// disabled so that only session IDs can be used.
+TEST_P(SslSocketTest, ServerSessionCacheResumptionTls12) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+  disable_stateless_session_resumption: true
+  max_session_cache_size: 16
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
+}
+
+// Make sure session IDs aren't resumed when the server-side session cache is disabled.
+TEST_P(SslSocketTest, ServerSessionCacheDisabledTls12) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+  disable_stateless_session_resumption: true
+  max_session_cache_size: 0
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, false, GetParam());
+}
+
+// Test that upstream session keys are stored per upstream address, so that a session is not
+// offered to a different upstream that uses the same (here, no) SNI value.
+TEST_P(SslSocketTest, ClientSessionKeysPerUpstreamAddress) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+)EOF";
+
+  ContextManagerImpl manager(time_system_);
+  Stats::TestUtil::TestStore server_stats_store;
+  Api::ApiPtr server_api = Api::createApiForTest(server_stats_store, time_system_);
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext>
+      server_factory_context;
+  ON_CALL(server_factory_context, api()).WillByDefault(ReturnRef(*server_api));
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_ctx_proto;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_ctx_proto);
+  ServerSslSocketFactory server_ssl_socket_factory(
+      std::make_unique<ServerContextConfigImpl>(server_ctx_proto, server_factory_context), manager,
+      server_stats_store, std::vector<std::string>{});
+
+  Stats::TestUtil::TestStore client_stats_store;
+  Api::ApiPtr client_api = Api::createApiForTest(client_stats_store, time_system_);
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext>
+      client_factory_context;
+  ON_CALL(client_factory_context, api()).WillByDefault(ReturnRef(*client_api));
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_ctx_proto;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), client_ctx_proto);
+  ClientSslSocketFactory client_ssl_socket_factory(
+      std::make_unique<ClientContextConfigImpl>(client_ctx_proto, client_factory_context), manager,
+      client_stats_store);
+
+  Event::DispatcherPtr dispatcher(server_api->allocateDispatcher("test_thread"));
+  auto socket_a = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  auto socket_b = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  NiceMock<Network::MockListenerCallbacks> listener_callbacks;
+  Network::ListenerPtr listener_a = dispatcher->createListener(socket_a, listener_callbacks, true);
+  Network::ListenerPtr listener_b = dispatcher->createListener(socket_b, listener_callbacks, true);
+
+  Network::ConnectionPtr server_connection;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr),
+            stream_info_);
+      }));
+
+  // Complete a handshake with the upstream at socket_a, so that its session is stored.
+  Network::ClientConnectionPtr client_connection = dispatcher->createClientConnection(
+      socket_a->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  NiceMock<Network::MockConnectionCallbacks> client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher->exit(); }));
+  client_connection->connect();
+  dispatcher->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(0UL, client_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_cache_miss").value());
+
+  // The session is looked up when the connection is created, so the connections below don't
+  // need to connect.
+  Network::ClientConnectionPtr client_connection_b = dispatcher->createClientConnection(
+      socket_b->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  EXPECT_EQ(0UL, client_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(2UL, client_stats_store.counter("ssl.session_cache_miss").value());
+
+  Network::ClientConnectionPtr client_connection_a = dispatcher->createClientConnection(
+      socket_a->localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(2UL, client_stats_store.counter("ssl.session_cache_miss").value());
+
+  client_connection_a->close(Network::ConnectionCloseType::NoFlush);
+  client_connection_b->close(Network::ConnectionCloseType::NoFlush);
+  client_connection->close(Network::ConnectionCloseType::NoFlush);
+  server_connection->close(Network::ConnectionCloseType::NoFlush);
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+}
+
 TEST_P(SslSocketTest, SslError) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
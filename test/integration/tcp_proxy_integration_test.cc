@@ -536,6 +536,108 @@ TEST_P(TcpProxyIntegrationTest, TestCloseOnHealthFailure) {
   ASSERT_TRUE(fake_upstream_connection->waitForDisconnect(true));
 }
 
+class TcpProxySpliceIntegrationTest : public TcpProxyIntegrationTest {
+public:
+  void initialize() override {
+    config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+      auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+      auto* filter_chain = listener->mutable_filter_chains(0);
+      auto* config_blob = filter_chain->mutable_filters(0)->mutable_typed_config();
+
+      ASSERT_TRUE(
+          config_blob->Is<API_NO_BOOST(envoy::config::filter::network::tcp_proxy::v2::TcpProxy)>());
+      auto v2_config = MessageUtil::anyConvert<API_NO_BOOST(
+          envoy::config::filter::network::tcp_proxy::v2::TcpProxy)>(*config_blob);
+      envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy tcp_proxy_config;
+      tcp_proxy_config.set_stat_prefix(v2_config.stat_prefix());
+      tcp_proxy_config.set_cluster(v2_config.cluster());
+      tcp_proxy_config.set_use_splice(true);
+      config_blob->PackFrom(tcp_proxy_config);
+    });
+    TcpProxyIntegrationTest::initialize();
+  }
+
+  void expectSpliced(uint64_t rx_bytes, uint64_t tx_bytes) {
+#if defined(__linux__)
+    EXPECT_EQ(1, test_server_->counter("tcp.tcp_stats.downstream_cx_spliced_total")->value());
+    test_server_->waitForCounterEq("tcp.tcp_stats.downstream_cx_rx_bytes_spliced", rx_bytes);
+    test_server_->waitForCounterEq("tcp.tcp_stats.downstream_cx_tx_bytes_spliced", tx_bytes);
+#else
+    UNREFERENCED_PARAMETER(rx_bytes);
+    UNREFERENCED_PARAMETER(tx_bytes);
+#endif
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(TcpProxyIntegrationTestParams, TcpProxySpliceIntegrationTest,
+                         testing::ValuesIn(getProtocolTestParams()), protocolTestParamsToString);
+
+// Test that data and half closes are forwarded in both directions when splicing.
+TEST_P(TcpProxySpliceIntegrationTest, HalfCloseBothDirections) {
+  initialize();
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+
+  ASSERT_TRUE(tcp_client->write("hello"));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->write("world", true));
+  tcp_client->waitForData("world");
+  tcp_client->waitForHalfClose();
+
+  ASSERT_TRUE(tcp_client->write("hello", true));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(10));
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+
+  expectSpliced(10, 5);
+  EXPECT_EQ(10, test_server_->counter("tcp.tcp_stats.downstream_cx_rx_bytes_total")->value());
+  EXPECT_EQ(5, test_server_->counter("tcp.tcp_stats.downstream_cx_tx_bytes_total")->value());
+}
+
+// Test that flow control holds when the pipes are much smaller than the data.
+TEST_P(TcpProxySpliceIntegrationTest, LargeWrites) {
+  config_helper_.setBufferLimits(16 * 1024, 16 * 1024);
+  initialize();
+
+  const std::string data(4 * 1024 * 1024, 'a');
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  ASSERT_TRUE(tcp_client->write(data));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(data.size()));
+  ASSERT_TRUE(fake_upstream_connection->write(data));
+  tcp_client->waitForData(data);
+  tcp_client->close();
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->close());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+
+  expectSpliced(data.size(), data.size());
+  EXPECT_EQ(
+      test_server_->counter("tcp.tcp_stats.downstream_flow_control_paused_reading_total")->value(),
+      test_server_->counter("tcp.tcp_stats.downstream_flow_control_resumed_reading_total")
+          ->value());
+}
+
+// Test that an upstream close is forwarded after the data that preceded it.
+TEST_P(TcpProxySpliceIntegrationTest, UpstreamDisconnect) {
+  initialize();
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  ASSERT_TRUE(tcp_client->write("hello"));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->write("world"));
+  ASSERT_TRUE(fake_upstream_connection->close());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForHalfClose();
+  tcp_client->close();
+
+  EXPECT_EQ("world", tcp_client->data());
+}
+
 class TcpProxyMetadataMatchIntegrationTest : public TcpProxyIntegrationTest {
 public:
   void initialize() override;
@@ -88,6 +88,7 @@ public:
   MOCK_METHOD(SysCallIntResult, shutdown, (os_fd_t sockfd, int how));
   MOCK_METHOD(SysCallIntResult, socketpair, (int domain, int type, int protocol, os_fd_t sv[2]));
   MOCK_METHOD(SysCallIntResult, listen, (os_fd_t sockfd, int backlog));
+  MOCK_METHOD(SysCallSocketResult, accept, (os_fd_t sockfd, sockaddr* addr, socklen_t* addrlen));
   MOCK_METHOD(SysCallSizeResult, write, (os_fd_t sockfd, const void* buffer, size_t length));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
 
@@ -101,6 +102,9 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD(SysCallIntResult, sched_getaffinity, (pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD(SysCallSizeResult, splice, (int fd_in, int fd_out, size_t len, unsigned int flags));
+  MOCK_METHOD(SysCallIntResult, pipe2, (int pipefd[2], int flags));
+  MOCK_METHOD(SysCallIntResult, fcntl, (int fd, int cmd, int arg));
 };
 #endif
 
@@ -25,6 +25,7 @@ MockBufferBase<Buffer::OwnedImpl>::MockBufferBase(std::function<void()>, std::fu
 template <> MockBufferBase<Buffer::OwnedImpl>::MockBufferBase() : Buffer::OwnedImpl() {}
 
 MockBufferFactory::MockBufferFactory() = default;
+
 MockBufferFactory::~MockBufferFactory() = default;
 
 } // namespace Envoy
@@ -80,6 +80,10 @@ public:
     return timer;
   }
 
+  // Coarse timers are created through createTimer_() as well, so that tests expecting a timer
+  // don't depend on its granularity.
+  Event::TimerPtr createCoarseTimer(Event::TimerCb cb) override { return createTimer(cb); }
+
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override {
     auto schedulable_cb = Event::SchedulableCallbackPtr{createSchedulableCallback_(cb)};
     // Assert that schedulable_cb is not null to avoid confusing test failures down the line.
@@ -131,6 +135,7 @@ public:
   MOCK_METHOD(Thread::ThreadId, getCurrentThreadId, ());
   MOCK_METHOD(MonotonicTime, approximateMonotonicTime, (), (const));
   MOCK_METHOD(void, updateApproximateMonotonicTime, ());
+  MOCK_METHOD(double, loopUtilization, (), (const));
 
   GlobalTimeSystem time_system_;
   std::list<DeferredDeletablePtr> to_delete_;
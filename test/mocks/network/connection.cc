@@ -74,6 +74,12 @@ template <class T> static void initializeMockConnection(T& connection) {
 
   ON_CALL(connection, streamInfo()).WillByDefault(ReturnRef(connection.stream_info_));
   ON_CALL(Const(connection), streamInfo()).WillByDefault(ReturnRef(connection.stream_info_));
+  ON_CALL(connection, setBufferMemoryAccount(_))
+      .WillByDefault(Invoke([&connection](const Buffer::BufferMemoryAccountSharedPtr& account) {
+        connection.buffer_memory_account_ = account;
+      }));
+  ON_CALL(connection, bufferMemoryAccount())
+      .WillByDefault(ReturnRef(connection.buffer_memory_account_));
 }
 
 MockConnection::MockConnection() {
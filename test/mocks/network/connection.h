@@ -43,6 +43,7 @@ public:
   bool read_enabled_{true};
   testing::NiceMock<StreamInfo::MockStreamInfo> stream_info_;
   Connection::State state_{Connection::State::Open};
+  Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
 };
 
 class MockConnection : public Connection, public MockConnectionBase {
@@ -78,6 +79,11 @@ public:
   MOCK_METHOD(void, write, (Buffer::Instance & data, bool end_stream));
   MOCK_METHOD(void, setBufferLimits, (uint32_t limit));
   MOCK_METHOD(uint32_t, bufferLimit, (), (const));
+  MOCK_METHOD(void, setBufferMemoryAccount, (const Buffer::BufferMemoryAccountSharedPtr& account));
+  MOCK_METHOD(const Buffer::BufferMemoryAccountSharedPtr&, bufferMemoryAccount, (), (const));
+  MOCK_METHOD(uint64_t, shrinkBuffers, ());
+  MOCK_METHOD(uint64_t, bufferedBytes, (), (const));
+  MOCK_METHOD(const IoHandle&, ioHandle, (), (const));
   MOCK_METHOD(bool, localAddressRestored, (), (const));
   MOCK_METHOD(bool, aboveHighWatermark, (), (const));
   MOCK_METHOD(const Network::ConnectionSocket::OptionsSharedPtr&, socketOptions, (), (const));
@@ -124,6 +130,11 @@ public:
   MOCK_METHOD(void, write, (Buffer::Instance & data, bool end_stream));
   MOCK_METHOD(void, setBufferLimits, (uint32_t limit));
   MOCK_METHOD(uint32_t, bufferLimit, (), (const));
+  MOCK_METHOD(void, setBufferMemoryAccount, (const Buffer::BufferMemoryAccountSharedPtr& account));
+  MOCK_METHOD(const Buffer::BufferMemoryAccountSharedPtr&, bufferMemoryAccount, (), (const));
+  MOCK_METHOD(uint64_t, shrinkBuffers, ());
+  MOCK_METHOD(uint64_t, bufferedBytes, (), (const));
+  MOCK_METHOD(const IoHandle&, ioHandle, (), (const));
   MOCK_METHOD(bool, localAddressRestored, (), (const));
   MOCK_METHOD(bool, aboveHighWatermark, (), (const));
   MOCK_METHOD(const Network::ConnectionSocket::OptionsSharedPtr&, socketOptions, (), (const));
@@ -173,6 +184,11 @@ public:
   MOCK_METHOD(void, write, (Buffer::Instance & data, bool end_stream));
   MOCK_METHOD(void, setBufferLimits, (uint32_t limit));
   MOCK_METHOD(uint32_t, bufferLimit, (), (const));
+  MOCK_METHOD(void, setBufferMemoryAccount, (const Buffer::BufferMemoryAccountSharedPtr& account));
+  MOCK_METHOD(const Buffer::BufferMemoryAccountSharedPtr&, bufferMemoryAccount, (), (const));
+  MOCK_METHOD(uint64_t, shrinkBuffers, ());
+  MOCK_METHOD(uint64_t, bufferedBytes, (), (const));
+  MOCK_METHOD(const IoHandle&, ioHandle, (), (const));
   MOCK_METHOD(bool, localAddressRestored, (), (const));
   MOCK_METHOD(bool, aboveHighWatermark, (), (const));
   MOCK_METHOD(const Network::ConnectionSocket::OptionsSharedPtr&, socketOptions, (), (const));
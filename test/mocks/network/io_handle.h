@@ -20,6 +20,8 @@ public:
               (uint64_t max_length, Buffer::RawSlice* slices, uint64_t num_slice));
   MOCK_METHOD(Api::IoCallUint64Result, writev,
               (const Buffer::RawSlice* slices, uint64_t num_slice));
+  MOCK_METHOD(Api::IoCallUint64Result, read, (Buffer::Instance & buffer, uint64_t max_length));
+  MOCK_METHOD(Api::IoCallUint64Result, write, (Buffer::Instance & buffer));
   MOCK_METHOD(Api::IoCallUint64Result, sendmsg,
               (const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                const Address::Ip* self_ip, const Address::Instance& peer_address));
@@ -37,6 +39,10 @@ public:
   MOCK_METHOD(Api::SysCallIntResult, getOption,
               (int level, int optname, void* optval, socklen_t* optlen));
   MOCK_METHOD(Api::SysCallIntResult, setBlocking, (bool blocking));
+  MOCK_METHOD(Api::SysCallIntResult, shutdown, (int how));
+  MOCK_METHOD(Event::FileEventPtr, createFileEvent,
+              (Event::Dispatcher & dispatcher, Event::FileReadyCb cb,
+               Event::FileTriggerType trigger, uint32_t events));
   MOCK_METHOD(absl::optional<int>, domain, ());
   MOCK_METHOD(Address::InstanceConstSharedPtr, localAddress, ());
   MOCK_METHOD(Address::InstanceConstSharedPtr, peerAddress, ());
@@ -172,6 +172,7 @@ MockResolvedAddress::~MockResolvedAddress() = default;
 
 MockTransportSocketCallbacks::MockTransportSocketCallbacks() {
   ON_CALL(*this, connection()).WillByDefault(ReturnRef(connection_));
+  ON_CALL(*this, readSize()).WillByDefault(Return(16384));
 }
 MockTransportSocketCallbacks::~MockTransportSocketCallbacks() = default;
 
@@ -194,6 +195,9 @@ MockUdpListenerReadFilter::~MockUdpListenerReadFilter() = default;
 MockUdpListenerFilterManager::MockUdpListenerFilterManager() = default;
 MockUdpListenerFilterManager::~MockUdpListenerFilterManager() = default;
 
+MockBalancedConnectionHandler::MockBalancedConnectionHandler() = default;
+MockBalancedConnectionHandler::~MockBalancedConnectionHandler() = default;
+
 MockConnectionBalancer::MockConnectionBalancer() = default;
 MockConnectionBalancer::~MockConnectionBalancer() = default;
 
@@ -131,6 +131,7 @@ public:
 
   MOCK_METHOD(void, onAccept_, (ConnectionSocketPtr & socket));
   MOCK_METHOD(void, onReject, ());
+  MOCK_METHOD(void, onAcceptBatch, (uint32_t accepted));
 };
 
 class MockUdpListenerCallbacks : public UdpListenerCallbacks {
@@ -392,6 +393,7 @@ public:
   MOCK_METHOD(void, stopListeners, ());
   MOCK_METHOD(void, disableListeners, ());
   MOCK_METHOD(void, enableListeners, ());
+  MOCK_METHOD(void, reclaimConnectionMemory, (uint32_t max_close, uint64_t min_close_bytes));
   MOCK_METHOD(const std::string&, statPrefix, (), (const));
 };
 
@@ -447,6 +449,7 @@ public:
   MOCK_METHOD(Connection&, connection, ());
   MOCK_METHOD(bool, shouldDrainReadBuffer, ());
   MOCK_METHOD(void, setReadBufferReady, ());
+  MOCK_METHOD(uint64_t, readSize, (), (const));
   MOCK_METHOD(void, raiseEvent, (ConnectionEvent));
   MOCK_METHOD(void, flushWriteBuffer, ());
 
@@ -496,6 +499,17 @@ public:
   MOCK_METHOD(void, addReadFilter_, (Network::UdpListenerReadFilterPtr&));
 };
 
+class MockBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  MockBalancedConnectionHandler();
+  ~MockBalancedConnectionHandler() override;
+
+  MOCK_METHOD(uint64_t, numConnections, (), (const));
+  MOCK_METHOD(void, incNumConnections, ());
+  MOCK_METHOD(double, loopUtilization, (), (const));
+  MOCK_METHOD(void, post, (Network::ConnectionSocketPtr && socket));
+};
+
 class MockConnectionBalancer : public ConnectionBalancer {
 public:
   MockConnectionBalancer();
@@ -48,6 +48,9 @@ public:
   MOCK_METHOD(bool, mutexTracingEnabled, (), (const));
   MOCK_METHOD(bool, fakeSymbolTableEnabled, (), (const));
   MOCK_METHOD(bool, cpusetThreadsEnabled, (), (const));
+  MOCK_METHOD(const std::vector<uint32_t>&, workerCpuAffinity, (), (const));
+  MOCK_METHOD(const std::vector<uint32_t>&, mainThreadCpuAffinity, (), (const));
+  MOCK_METHOD(bool, numaLocalMemory, (), (const));
   MOCK_METHOD(const std::vector<std::string>&, disabledExtensions, (), (const));
   MOCK_METHOD(Server::CommandLineOptionsPtr, toCommandLineOptions, (), (const));
 
@@ -70,6 +73,9 @@ public:
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  std::vector<uint32_t> worker_cpu_affinity_;
+  std::vector<uint32_t> main_thread_cpu_affinity_;
+  bool numa_local_memory_{};
   std::vector<std::string> disabled_extensions_;
 };
 } // namespace Server
@@ -11,6 +11,8 @@ namespace Server {
 using ::testing::ReturnRef;
 MockOverloadManager::MockOverloadManager() {
   ON_CALL(*this, getThreadLocalOverloadState()).WillByDefault(ReturnRef(overload_state_));
+  ON_CALL(*this, getThreadLocalStreamMemoryTracker())
+      .WillByDefault(ReturnRef(stream_memory_tracker_));
 }
 
 MockOverloadManager::~MockOverloadManager() = default;
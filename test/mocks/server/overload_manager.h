@@ -4,6 +4,8 @@
 
 #include "envoy/server/overload_manager.h"
 
+#include "common/http/stream_memory_tracker_impl.h"
+
 #include "gmock/gmock.h"
 
 namespace Envoy {
@@ -19,8 +21,10 @@ public:
               (const std::string& action, Event::Dispatcher& dispatcher,
                OverloadActionCb callback));
   MOCK_METHOD(ThreadLocalOverloadState&, getThreadLocalOverloadState, ());
+  MOCK_METHOD(Http::StreamMemoryTracker&, getThreadLocalStreamMemoryTracker, ());
 
   ThreadLocalOverloadState overload_state_;
+  Http::StreamMemoryTrackerImpl stream_memory_tracker_;
 };
 } // namespace Server
 } // namespace Envoy
@@ -83,6 +83,7 @@ public:
   MOCK_METHOD(const CertificateValidationContextConfig*, certificateValidationContext, (), (const));
   MOCK_METHOD(unsigned, minProtocolVersion, (), (const));
   MOCK_METHOD(unsigned, maxProtocolVersion, (), (const));
+  MOCK_METHOD(bool, kernelTlsOffload, (), (const));
   MOCK_METHOD(bool, isReady, (), (const));
   MOCK_METHOD(void, setSecretUpdateCallback, (std::function<void()> callback));
 
@@ -105,6 +106,7 @@ public:
   MOCK_METHOD(const CertificateValidationContextConfig*, certificateValidationContext, (), (const));
   MOCK_METHOD(unsigned, minProtocolVersion, (), (const));
   MOCK_METHOD(unsigned, maxProtocolVersion, (), (const));
+  MOCK_METHOD(bool, kernelTlsOffload, (), (const));
   MOCK_METHOD(bool, isReady, (), (const));
   MOCK_METHOD(absl::optional<std::chrono::seconds>, sessionTimeout, (), (const));
   MOCK_METHOD(void, setSecretUpdateCallback, (std::function<void()> callback));
@@ -112,6 +114,7 @@ public:
   MOCK_METHOD(bool, requireClientCertificate, (), (const));
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
+  MOCK_METHOD(absl::optional<uint32_t>, maxSessionCacheSize, (), (const));
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
@@ -80,6 +80,9 @@ public:
         parent_.data_[index_] = cb(parent_.dispatcher_);
       }
     }
+    void publish(ThreadLocalObjectSharedPtr object) override {
+      parent_.data_[index_] = std::move(object);
+    }
 
     MockInstance& parent_;
     const uint32_t index_;
@@ -91,8 +91,9 @@ HostSet& MockPrioritySet::getHostSet(uint32_t priority) {
 }
 void MockPrioritySet::runUpdateCallbacks(uint32_t priority, const HostVector& hosts_added,
                                          const HostVector& hosts_removed) {
-  member_update_cb_helper_.runCallbacks(hosts_added, hosts_removed);
+  // Like PrioritySetImpl, the priority callbacks run first.
   priority_update_cb_helper_.runCallbacks(priority, hosts_added, hosts_removed);
+  member_update_cb_helper_.runCallbacks(hosts_added, hosts_removed);
 }
 
 MockRetryPriority::~MockRetryPriority() = default;
@@ -120,10 +121,15 @@ MockLoadBalancer::~MockLoadBalancer() = default;
 MockThreadAwareLoadBalancer::MockThreadAwareLoadBalancer() = default;
 MockThreadAwareLoadBalancer::~MockThreadAwareLoadBalancer() = default;
 
+MockHostResponseTimeObserver::MockHostResponseTimeObserver() = default;
+MockHostResponseTimeObserver::~MockHostResponseTimeObserver() = default;
+
 MockThreadLocalCluster::MockThreadLocalCluster() {
   ON_CALL(*this, prioritySet()).WillByDefault(ReturnRef(cluster_.priority_set_));
   ON_CALL(*this, info()).WillByDefault(Return(cluster_.info_));
   ON_CALL(*this, loadBalancer()).WillByDefault(ReturnRef(lb_));
+  ON_CALL(*this, hostResponseTimeObserver())
+      .WillByDefault(Return(HostResponseTimeObserverWeakPtr(response_time_observer_)));
 }
 
 MockThreadLocalCluster::~MockThreadLocalCluster() = default;
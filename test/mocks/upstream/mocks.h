@@ -235,6 +235,16 @@ public:
   MOCK_METHOD(void, initialize, ());
 };
 
+class MockHostResponseTimeObserver : public HostResponseTimeObserver {
+public:
+  MockHostResponseTimeObserver();
+  ~MockHostResponseTimeObserver() override;
+
+  // Upstream::HostResponseTimeObserver
+  MOCK_METHOD(void, onHostResponseTime,
+              (const HostDescription& host, std::chrono::microseconds response_time));
+};
+
 class MockThreadLocalCluster : public ThreadLocalCluster {
 public:
   MockThreadLocalCluster();
@@ -244,9 +254,12 @@ public:
   MOCK_METHOD(const PrioritySet&, prioritySet, ());
   MOCK_METHOD(ClusterInfoConstSharedPtr, info, ());
   MOCK_METHOD(LoadBalancer&, loadBalancer, ());
+  MOCK_METHOD(HostResponseTimeObserverWeakPtr, hostResponseTimeObserver, ());
 
   NiceMock<MockClusterMockPrioritySet> cluster_;
   NiceMock<MockLoadBalancer> lb_;
+  std::shared_ptr<NiceMock<MockHostResponseTimeObserver>> response_time_observer_{
+      new NiceMock<MockHostResponseTimeObserver>()};
 };
 
 class MockClusterManagerFactory : public ClusterManagerFactory {
@@ -319,6 +319,48 @@ TEST_F(ConnectionHandlerTest, ListenerConnectionLimitEnforced) {
   EXPECT_CALL(*listener2, onDestroy());
 }
 
+TEST_F(ConnectionHandlerTest, ReclaimConnectionMemory) {
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, false, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillRepeatedly(Return(filter_chain_.get()));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+  std::vector<NiceMock<Network::MockConnection>*> connections;
+  for (int i = 0; i < 3; i++) {
+    auto connection = new NiceMock<Network::MockConnection>();
+    connections.push_back(connection);
+    EXPECT_CALL(dispatcher_, createServerConnection_()).WillOnce(Return(connection));
+    listener_callbacks->onAccept(
+        Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+    ASSERT_NE(nullptr, connection->bufferMemoryAccount());
+    EXPECT_CALL(*connection, shrinkBuffers()).WillOnce(Return(10));
+  }
+  EXPECT_EQ(3, handler_->numConnections());
+
+  connections[0]->bufferMemoryAccount()->charge(512);
+  connections[1]->bufferMemoryAccount()->charge(4096);
+  connections[2]->bufferMemoryAccount()->charge(2048);
+  EXPECT_EQ(0, TestUtility::findGauge(stats_store_, "downstream_cx_buffered_bytes")->value());
+
+  // Only the connection buffering the most data is closed. The one below the minimum never is.
+  EXPECT_CALL(*connections[0], close(_)).Times(0);
+  EXPECT_CALL(*connections[1], close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connections[2], close(_)).Times(0);
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  handler_->reclaimConnectionMemory(1, 1024);
+  EXPECT_EQ(2, handler_->numConnections());
+  EXPECT_EQ(30,
+            TestUtility::findCounter(stats_store_, "downstream_cx_buffer_bytes_released")->value());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "downstream_cx_overload_memory_close")->value());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, RemoveListener) {
   InSequence s;
 
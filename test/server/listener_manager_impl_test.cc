@@ -19,6 +19,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/listener_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -39,9 +40,11 @@ namespace Server {
 namespace {
 
 using testing::AtLeast;
+using testing::DoAll;
 using testing::InSequence;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SetArgPointee;
 using testing::Throw;
 
 class ListenerManagerImplWithDispatcherStatsTest : public ListenerManagerImplTest {
@@ -3793,6 +3796,112 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
   EXPECT_EQ(0, manager_->listeners().size());
 }
 
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortSteeringRequiresReusePort) {
+  auto listener = createIPv4Listener("SteeringListener");
+  listener.set_reuse_port_steering(envoy::config::listener::v3::Listener::INCOMING_CPU);
+
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1111': reuse_port_steering requires "
+                            "reuse_port on a TCP listener");
+  EXPECT_EQ(0, manager_->listeners().size());
+}
+
+#if defined(__linux__)
+// Connections received by a CPU a worker is pinned to go to the worker's socket, the others are
+// spread by CPU number.
+TEST(ListenSocketFactoryImplTest, IncomingCpuSteeringFilter) {
+  const std::vector<sock_filter> filter =
+      ListenSocketFactoryImpl::buildIncomingCpuSteeringFilter({absl::nullopt, 3, absl::nullopt});
+  ASSERT_EQ(5, filter.size());
+  EXPECT_EQ(BPF_LD | BPF_W | BPF_ABS, filter[0].code);
+  EXPECT_EQ(static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU), filter[0].k);
+  EXPECT_EQ(BPF_JMP | BPF_JEQ | BPF_K, filter[1].code);
+  EXPECT_EQ(3, filter[1].k);
+  EXPECT_EQ(BPF_RET | BPF_K, filter[2].code);
+  EXPECT_EQ(1, filter[2].k);
+  EXPECT_EQ(BPF_ALU | BPF_MOD | BPF_K, filter[3].code);
+  EXPECT_EQ(3, filter[3].k);
+  EXPECT_EQ(BPF_RET | BPF_A, filter[4].code);
+}
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+// The worker's CPU comes from the mockable sched_getaffinity(), and the socket listens as it is
+// recorded, so that its index in the group matches the record.
+TEST_F(ListenerManagerImplTest, IncomingCpuSteeringRecordsWorkerCpu) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  const std::string listener_name = "foo";
+  auto socket = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  ListenSocketFactoryImpl socket_factory(
+      listener_factory_, Network::Utility::parseInternetAddress("127.0.0.1", 1234),
+      Network::Socket::Type::Stream, nullptr, true, listener_name, true, true);
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(3, &cpus);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, _)).WillOnce(Return(socket));
+  EXPECT_CALL(linux_os_sys_calls, sched_getaffinity(0, _, _))
+      .WillOnce(DoAll(SetArgPointee<2>(cpus), Return(Api::SysCallIntResult{0, 0})));
+  EXPECT_CALL(os_sys_calls_, listen(_, Network::ListenerImpl::ListenBacklog))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, _, _))
+      .WillOnce(Invoke([](os_fd_t, int, int, const void* optval, socklen_t) -> int {
+        const auto* prog = static_cast<const sock_fprog*>(optval);
+        EXPECT_EQ(5, prog->len);
+        EXPECT_EQ(3, prog->filter[1].k);
+        return 0;
+      }));
+  EXPECT_EQ(socket, socket_factory.getListenSocket());
+}
+
+// Releasing a socket closes it and moves the last socket to its index, as the kernel does, and
+// the program is attached again for the remaining sockets.
+TEST_F(ListenerManagerImplTest, IncomingCpuSteeringFollowsClosedSockets) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  const std::string listener_name = "foo";
+  ListenSocketFactoryImpl socket_factory(
+      listener_factory_, Network::Utility::parseInternetAddress("127.0.0.1", 1234),
+      Network::Socket::Type::Stream, nullptr, true, listener_name, true, true);
+
+  std::vector<std::shared_ptr<NiceMock<Network::MockListenSocket>>> sockets;
+  std::vector<Network::SocketSharedPtr> handed_out;
+  std::vector<uint32_t> attached_cpus;
+  ON_CALL(os_sys_calls_, listen(_, _)).WillByDefault(Return(Api::SysCallIntResult{0, 0}));
+  ON_CALL(os_sys_calls_, setsockopt_(_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, _, _))
+      .WillByDefault(
+          Invoke([&attached_cpus](os_fd_t, int, int, const void* optval, socklen_t) -> int {
+            // Every recorded socket has a CPU, so the program has one comparison per socket.
+            const auto* prog = static_cast<const sock_fprog*>(optval);
+            attached_cpus.clear();
+            for (uint32_t i = 1; i + 2 < prog->len; i += 2) {
+              attached_cpus.push_back(prog->filter[i].k);
+            }
+            return 0;
+          }));
+  for (uint32_t cpu = 0; cpu < 3; cpu++) {
+    sockets.push_back(std::make_shared<NiceMock<Network::MockListenSocket>>());
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, _))
+        .WillOnce(Return(sockets.back()));
+    EXPECT_CALL(linux_os_sys_calls, sched_getaffinity(0, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(cpus), Return(Api::SysCallIntResult{0, 0})));
+    handed_out.push_back(socket_factory.getListenSocket());
+  }
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}), attached_cpus);
+
+  EXPECT_CALL(*sockets[0], close());
+  handed_out[0].reset();
+  EXPECT_EQ(std::vector<uint32_t>({2, 1}), attached_cpus);
+  EXPECT_CALL(*sockets[1], close());
+  handed_out[1].reset();
+  EXPECT_EQ(std::vector<uint32_t>({2}), attached_cpus);
+}
+#endif
+#endif
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, LiteralSockoptListenerEnabled) {
   const envoy::config::listener::v3::Listener listener = parseListenerFromV2Yaml(R"EOF(
     name: SockoptsListener
@@ -35,6 +35,8 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::ElementsAre;
+
 namespace Envoy {
 namespace {
 
@@ -87,7 +89,8 @@ TEST_F(OptionsImplTest, All) {
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
       "--disable-hot-restart --cpuset-threads --allow-unknown-static-fields "
       "--reject-unknown-dynamic-fields --use-fake-symbol-table 0 --base-id 5 "
-      "--use-dynamic-base-id --base-id-path /foo/baz");
+      "--use-dynamic-base-id --base-id-path /foo/baz --worker-cpu-affinity 0-1,4 "
+      "--main-thread-cpu-affinity 7 --numa-local-memory");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -112,6 +115,9 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(5U, options->baseId());
   EXPECT_TRUE(options->useDynamicBaseId());
   EXPECT_EQ("/foo/baz", options->baseIdPath());
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 4}), options->workerCpuAffinity());
+  EXPECT_EQ(std::vector<uint32_t>({7}), options->mainThreadCpuAffinity());
+  EXPECT_TRUE(options->numaLocalMemory());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -171,6 +177,9 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setAllowUnkownFields(true);
   options->setRejectUnknownFieldsDynamic(true);
   options->setFakeSymbolTableEnabled(!options->fakeSymbolTableEnabled());
+  options->setWorkerCpuAffinity({2, 3});
+  options->setMainThreadCpuAffinity({0});
+  options->setNumaLocalMemory(true);
 
   EXPECT_EQ(109876, options->baseId());
   EXPECT_EQ(42U, options->concurrency());
@@ -199,6 +208,9 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_TRUE(options->allowUnknownStaticFields());
   EXPECT_TRUE(options->rejectUnknownDynamicFields());
   EXPECT_EQ(!fake_symbol_table_enabled, options->fakeSymbolTableEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({2, 3}), options->workerCpuAffinity());
+  EXPECT_EQ(std::vector<uint32_t>({0}), options->mainThreadCpuAffinity());
+  EXPECT_TRUE(options->numaLocalMemory());
 
   // Validate that CommandLineOptions is constructed correctly.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -228,6 +240,9 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
   EXPECT_EQ(options->cpusetThreadsEnabled(), command_line_options->cpuset_threads());
+  EXPECT_THAT(command_line_options->worker_cpu_affinity(), ElementsAre(2, 3));
+  EXPECT_THAT(command_line_options->main_thread_cpu_affinity(), ElementsAre(0));
+  EXPECT_TRUE(command_line_options->numa_local_memory());
 }
 
 TEST_F(OptionsImplTest, DefaultParams) {
@@ -241,6 +256,9 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(spdlog::level::warn, options->logLevel());
   EXPECT_FALSE(options->hotRestartDisabled());
   EXPECT_FALSE(options->cpusetThreadsEnabled());
+  EXPECT_TRUE(options->workerCpuAffinity().empty());
+  EXPECT_TRUE(options->mainThreadCpuAffinity().empty());
+  EXPECT_FALSE(options->numaLocalMemory());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -423,6 +441,13 @@ TEST_F(OptionsImplTest, SetCpusetOnly) {
   EXPECT_NE(options->concurrency(), 0);
 }
 
+TEST_F(OptionsImplTest, InvalidCpuAffinity) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --worker-cpu-affinity 3-1"),
+                          MalformedArgvException, "error: invalid CPU list '3-1'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --main-thread-cpu-affinity a"),
+                          MalformedArgvException, "error: invalid CPU list 'a'");
+}
+
 TEST_F(OptionsImplTest, LogFormatDefault) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl({"envoy", "-c", "hello"});
   EXPECT_EQ(options->logFormat(), "[%Y-%m-%d %T.%e][%t][%l][%n] [%g:%#] %v");
@@ -381,6 +381,22 @@ TEST_F(OverloadManagerImplTest, DuplicateTrigger) {
   EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException, "Duplicate trigger .*");
 }
 
+TEST_F(OverloadManagerImplTest, ThreadLocalStreamMemoryTracker) {
+  setDispatcherExpectation();
+
+  auto manager(createOverloadManager(getConfig()));
+  manager->start();
+
+  bool reset = false;
+  Http::StreamMemoryTracker& tracker = manager->getThreadLocalStreamMemoryTracker();
+  Buffer::StreamBufferMemoryAccountSharedPtr account =
+      tracker.createStreamAccount(nullptr, [&reset]() { reset = true; });
+  account->charge(100);
+  EXPECT_EQ(100, manager->getThreadLocalStreamMemoryTracker().resetLargestStreams(1, 0));
+  EXPECT_TRUE(reset);
+  account->credit(100);
+}
+
 TEST_F(OverloadManagerImplTest, Shutdown) {
   setDispatcherExpectation();
 
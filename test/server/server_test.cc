@@ -5,6 +5,8 @@
 #include "envoy/server/bootstrap_extension_config.h"
 
 #include "common/common/assert.h"
+#include "common/common/cpu_affinity.h"
+#include "common/common/sharded_counter.h"
 #include "common/common/version.h"
 #include "common/network/address_impl.h"
 #include "common/network/listen_socket_impl.h"
@@ -169,6 +171,10 @@ public:
 // Class creates minimally viable server instance for testing.
 class ServerInstanceImplTestBase {
 protected:
+  // The server sets the default shard count from its concurrency, which would otherwise leak into
+  // the tests that follow.
+  ~ServerInstanceImplTestBase() { ShardedCounter::setDefaultShardCount(1); }
+
   void initialize(const std::string& bootstrap_path) { initialize(bootstrap_path, false); }
 
   void initialize(const std::string& bootstrap_path, const bool use_intializing_instance) {
@@ -464,6 +470,22 @@ TEST_P(ServerInstanceImplTest, V2ConfigOnly) {
   }
 }
 
+#if defined(__linux__)
+// The CPUs of the process are captured before the main thread is pinned, and the main thread gets
+// them back when the server is destroyed.
+TEST_P(ServerInstanceImplTest, MainThreadCpuAffinity) {
+  const std::vector<uint32_t> cpus = CpuAffinity::currentThreadCpus();
+  if (cpus.size() < 2) {
+    return;
+  }
+  options_.main_thread_cpu_affinity_ = {cpus.back()};
+  EXPECT_NO_THROW(initialize("test/server/test_data/server/empty_bootstrap.yaml"));
+  EXPECT_EQ(std::vector<uint32_t>({cpus.back()}), CpuAffinity::currentThreadCpus());
+  server_.reset();
+  EXPECT_EQ(cpus, CpuAffinity::currentThreadCpus());
+}
+#endif
+
 TEST_P(ServerInstanceImplTest, Stats) {
   options_.service_cluster_name_ = "some_cluster_name";
   options_.service_node_name_ = "some_node_name";
@@ -472,6 +494,7 @@ TEST_P(ServerInstanceImplTest, Stats) {
   EXPECT_NO_THROW(initialize("test/server/test_data/server/empty_bootstrap.yaml"));
   EXPECT_NE(nullptr, TestUtility::findCounter(stats_store_, "server.watchdog_miss"));
   EXPECT_EQ(2L, TestUtility::findGauge(stats_store_, "server.concurrency")->value());
+  EXPECT_EQ(2U, ShardedCounter::defaultShardCount());
   EXPECT_EQ(3L, TestUtility::findGauge(stats_store_, "server.hot_restart_epoch")->value());
 
 // The ENVOY_BUG stat works in release mode.
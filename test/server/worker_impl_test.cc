@@ -2,6 +2,7 @@
 
 #include "common/api/api_impl.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "server/worker_impl.h"
 
@@ -30,7 +31,7 @@ public:
       : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("worker_test")),
         no_exit_timer_(dispatcher_->createTimer([]() -> void {})),
         worker_(tls_, hooks_, std::move(dispatcher_), Network::ConnectionHandlerPtr{handler_},
-                overload_manager_, *api_) {
+                overload_manager_, *api_, CpuAffinity()) {
     // In the real worker the watchdog has timers that prevent exit. Here we need to prevent event
     // loop exit since we use mock timers.
     no_exit_timer_->enableTimer(std::chrono::hours(1));
@@ -158,6 +159,39 @@ TEST_F(WorkerImplTest, ListenerException) {
   worker_.stop();
 }
 
+// A pinned worker runs on its CPU, and reports it in its stats.
+TEST_F(WorkerImplTest, PinnedWorker) {
+  const std::vector<uint32_t> cpus = CpuAffinity::currentThreadCpus();
+  if (cpus.empty()) {
+    return;
+  }
+  // Declared first, as the dispatcher's stats outlive the worker's thread.
+  Stats::IsolatedStoreImpl store;
+  Network::MockConnectionHandler* handler = new Network::MockConnectionHandler();
+  Event::DispatcherPtr dispatcher = api_->allocateDispatcher("worker_pinned");
+  Event::TimerPtr no_exit_timer = dispatcher->createTimer([]() -> void {});
+  no_exit_timer->enableTimer(std::chrono::hours(1));
+  WorkerImpl worker(tls_, hooks_, std::move(dispatcher), Network::ConnectionHandlerPtr{handler},
+                    overload_manager_, *api_, CpuAffinity({cpus.back()}, false));
+
+  worker.initializeStats(store);
+  EXPECT_EQ(cpus.back(), TestUtility::findGauge(store, "worker_pinned.cpu")->value());
+
+  NiceMock<Network::MockListenerConfig> listener;
+  ConditionalInitializer ci;
+  EXPECT_CALL(*handler, addListener(_, _)).WillOnce(InvokeWithoutArgs([&cpus]() -> void {
+    EXPECT_EQ(std::vector<uint32_t>({cpus.back()}), CpuAffinity::currentThreadCpus());
+  }));
+  worker.addListener(absl::nullopt, listener, [&ci](bool success) -> void {
+    EXPECT_TRUE(success);
+    ci.setReady();
+  });
+  worker.start(guard_dog_);
+  ci.waitReady();
+  worker.stop();
+  no_exit_timer.reset();
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy